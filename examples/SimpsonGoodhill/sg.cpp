@@ -38,6 +38,8 @@ struct SimpsonGoodhill
             this->vis(i);
             if (i%100 == 0) { std::cout << "step " << i << "\n"; }
         }
+        // Write out the last movie frames before waiting on the user
+        this->v->finishImageWrites();
         std::cout << "Done simulating\n";
         this->v->keepOpen();
     }
@@ -59,7 +61,8 @@ struct SimpsonGoodhill
             frame.fill('0');
             frame << stepnum;
             frame << ".png";
-            this->v->saveImage(frame.str());
+            // Frames are encoded on worker threads, so the simulation need not wait for them
+            this->v->saveImageAsync (frame.str());
         }
     }
 
@@ -356,6 +356,6 @@ F objective_hg (const morph::vvec<F>& params)
     // Find the hex nearest the coordinate defined by params and return its value
     morph::vvec<float> _params = params.as_float();
     morph::vec<float, 2> coord = { _params[0], _params[1] };
-    std::list<morph::Hex>::iterator hn = hg->findHexNearest (coord);
+    morph::hexlist::iterator hn = hg->findHexNearest (coord);
     return obj_f[hn->vi];
 }
@@ -0,0 +1,31 @@
+// Make a figure of a graph without a window, e.g. on a cluster node with no display. Run with an
+// argument to set the exponent of the graphed function; the figure is saved in graph_headless_N.png
+#include <morph/VisualHeadless.h>
+#include <morph/GraphVisual.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <string>
+
+int main (int argc, char** argv)
+{
+    int n = argc > 1 ? std::stoi (argv[1]) : 3;
+
+    // A windowless scene. The figure is 1600x1200 pixels, rendered at twice that size and
+    // filtered down (supersampled) for smooth lines and text.
+    morph::VisualHeadless v(1600, 1200, "", 2);
+    auto gv = std::make_unique<morph::GraphVisual<double>> (morph::vec<float>({0,0,0}));
+    v.bindmodel (gv);
+    morph::vvec<double> x;
+    x.linspace (-0.5, 0.8, 14);
+    gv->setdata (x, x.pow(n));
+    gv->ylabel = "x^" + std::to_string (n);
+    gv->finalize();
+    v.addVisualModel (gv);
+
+    // Render once, then save the frame
+    v.render();
+    std::string fname = "graph_headless_" + std::to_string (n) + ".png";
+    morph::vec<int, 2> dims = v.saveImage (fname);
+    std::cout << "Saved " << dims[0] << "x" << dims[1] << " figure in " << fname << std::endl;
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * A graph of a long stream of data. Each frame, many points are appended to a streaming dataset,
+ * which keeps the latest points in a ring buffer and shows a sliding window of them, decimated to
+ * the width of the graph. The cost of each frame does not grow as points are added.
+ */
+#include <morph/Visual.h>
+#include <morph/GraphVisual.h>
+#include <iostream>
+#include <random>
+#include <cmath>
+
+int main()
+{
+    int rtn = 0;
+
+    morph::Visual v(1024, 768, "Streaming graph");
+    v.backgroundWhite();
+
+    try {
+        auto gv = std::make_unique<morph::GraphVisual<double>> (morph::vec<float>({-0.6f, -0.4f, 0.0f}));
+        v.bindmodel (gv);
+        gv->setsize (1.33, 1);
+        gv->policy = morph::stylepolicy::lines;
+        gv->prepdata ("signal");
+        // Keep the latest million points, show the last 20 units of x in 1024 columns
+        gv->setstreaming (0, 1000000, 20.0, 1024);
+        gv->xlabel = "t";
+        gv->ylabel = "signal";
+        gv->finalize();
+        auto gvp = v.addVisualModel (gv);
+
+        std::mt19937 rng (1);
+        std::normal_distribution<double> noise (0.0, 0.1);
+        double t = 0.0;
+        while (v.readyToFinish() == false) {
+            v.poll();
+            // Append 2000 points per frame
+            for (int i = 0; i < 2000; ++i) {
+                t += 0.0005;
+                gvp->append (t, std::sin (t) + noise (rng), 0);
+            }
+            v.render();
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Caught exception: " << e.what() << std::endl;
+        rtn = -1;
+    }
+
+    return rtn;
+}
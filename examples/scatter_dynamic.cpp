@@ -32,6 +32,8 @@ int main()
     sv->setScalarData (&data);
     sv->radiusFixed = 0.03f;
     sv->cm.setType (morph::ColourMapType::Plasma);
+    // Draw the spheres with GPU instancing, so that updates only re-write the per-sphere data
+    sv->instancing = true;
     // Finalize (build the model and add to the Visual), even though there's no data or points to show yet
     sv->finalize();
     auto svp = v.addVisualModel (sv); // When you add the model to the Visual, it takes
@@ -62,9 +64,10 @@ int main()
         }
         q++;
 
-        // On each loop, just call VisualModel::reinit(). This re-builds the OpenGL
-        // model using the now changed content of 'points' and 'data'
-        svp->reinit();
+        // On each loop, just call updateData(). For an instanced ScatterVisual, this
+        // re-computes only the instance data from the now changed content of 'points'
+        // and 'data' (VisualModel::reinit() would re-build the entire model).
+        svp->updateData (&data);
 
         v.wait (0.008);
         v.render();
@@ -7,14 +7,16 @@
 #include <vector>
 #include <array>
 #include <sstream>
-#include <morph/RD_Base.h>
+#include <morph/RD_Integrator.h>
 #include <morph/HdfData.h>
 
 /*!
- * Two component Schnakenberg Reaction Diffusion system
+ * Two component Schnakenberg Reaction Diffusion system. The time integration (4th order
+ * Runge-Kutta by default; see RD_Integrator::method) is carried out by RD_Integrator. This
+ * class supplies the reaction terms.
  */
 template <class Flt>
-class RD_Schnakenberg : public morph::RD_Base<Flt>
+class RD_Schnakenberg : public morph::RD_Integrator<Flt, 2>
 {
 public:
     /*!
@@ -46,9 +48,9 @@ public:
     alignas(Flt) Flt D_B = 0.1;
 
     /*!
-     * Simple constructor; no arguments. Simply call RD_Base constructor.
+     * Simple constructor; no arguments. Simply call RD_Integrator constructor.
      */
-    RD_Schnakenberg() : morph::RD_Base<Flt>() {}
+    RD_Schnakenberg() : morph::RD_Integrator<Flt, 2>() {}
 
     /*!
      * Destructor
@@ -61,12 +63,14 @@ public:
     void allocate()
     {
         // Always call allocate() from the base class first.
-        morph::RD_Base<Flt>::allocate();
+        morph::RD_Integrator<Flt, 2>::allocate();
         // Resize and zero-initialise the various containers. Note that the size of a
         // 'vector variable' is given by the number of hexes in the hex grid which is
         // a member of this class (via its parent, RD_Base)
         this->resize_vector_variable (this->A);
         this->resize_vector_variable (this->B);
+        // The variables that RD_Integrator integrates
+        this->vars = { &this->A, &this->B };
     }
 
     /*!
@@ -103,157 +107,19 @@ public:
     }
 
     /*!
-     * Schnakenberg computation for reagent A
-     */
-    void compute_dAdt (std::vector<Flt>& A_, std::vector<Flt>& dAdt)
-    {
-        std::vector<Flt> lapA(this->nhex, 0.0);
-        this->compute_laplace (A_, lapA);
-#pragma omp parallel for
-        for (unsigned int h=0; h<this->nhex; ++h) {
-            dAdt[h] = this->k1 - (this->k2 * A_[h])
-                + (this->k3 * A_[h] * A_[h] * this->B[h]) + this->D_A * lapA[h];
-        }
-    }
-
-    /*!
-     * Schnakenberg computation for reagent B
-     */
-    void compute_dBdt (std::vector<Flt>& B_, std::vector<Flt>& dBdt)
-    {
-        std::vector<Flt> lapB(this->nhex, 0.0);
-        this->compute_laplace (B_, lapB);
-#pragma omp parallel for
-        for (unsigned int h=0; h<this->nhex; ++h) {
-            // G = k4        - k3 A^2 B
-            dBdt[h] = this->k4 - (this->k3 * this->A[h] * this->A[h] * B_[h]) + this->D_B * lapB[h];
-        }
-    }
-
-    /*!
-     * Simulate one timestep of the model
+     * Simulate one timestep of the model. A and B are integrated together (the hand written
+     * loops that this replaces integrated A over the whole step, then B with the new A).
      */
     void step()
     {
         this->stepCount++;
-
-        // 1. 4th order Runge-Kutta computation for A
-        {
-            // Atst: "A at a test point". Atst is a temporary estimate for A.
-            std::vector<Flt> Atst(this->nhex, 0.0);
-            std::vector<Flt> dAdt(this->nhex, 0.0);
-            std::vector<Flt> K1(this->nhex, 0.0);
-            std::vector<Flt> K2(this->nhex, 0.0);
-            std::vector<Flt> K3(this->nhex, 0.0);
-            std::vector<Flt> K4(this->nhex, 0.0);
-
-            /*
-             * Stage 1
-             */
-            this->compute_dAdt (this->A, dAdt);
-#pragma omp parallel for
-            for (unsigned int h=0; h<this->nhex; ++h) {
-                K1[h] = dAdt[h] * this->dt;
-                Atst[h] = this->A[h] + K1[h] * 0.5 ;
-            }
-
-            /*
-             * Stage 2
-             */
-            this->compute_dAdt (Atst, dAdt);
-#pragma omp parallel for
-            for (unsigned int h=0; h<this->nhex; ++h) {
-                K2[h] = dAdt[h] * this->dt;
-                Atst[h] = this->A[h] + K2[h] * 0.5;
-            }
-
-            /*
-             * Stage 3
-             */
-            this->compute_dAdt (Atst, dAdt);
-#pragma omp parallel for
-            for (unsigned int h=0; h<this->nhex; ++h) {
-                K3[h] = dAdt[h] * this->dt;
-                Atst[h] = this->A[h] + K3[h];
-            }
-
-            /*
-             * Stage 4
-             */
-            this->compute_dAdt (Atst, dAdt);
-#pragma omp parallel for
-            for (unsigned int h=0; h<this->nhex; ++h) {
-                K4[h] = dAdt[h] * this->dt;
-            }
-
-            /*
-             * Final sum together. This could be incorporated in the for loop for
-             * Stage 4, but I've separated it out for pedagogy.
-             */
-#pragma omp parallel for
-            for (unsigned int h=0; h<this->nhex; ++h) {
-                A[h] += ((K1[h] + 2.0 * (K2[h] + K3[h]) + K4[h])/(Flt)6.0);
-            }
-        }
-
-        // 2. 4th order Runge-Kutta computation of B
-        {
-            // Btst: "B at a test point". Btst is a temporary estimate for B.
-            std::vector<Flt> Btst(this->nhex, 0.0);
-            std::vector<Flt> dBdt(this->nhex, 0.0);
-            std::vector<Flt> K1(this->nhex, 0.0);
-            std::vector<Flt> K2(this->nhex, 0.0);
-            std::vector<Flt> K3(this->nhex, 0.0);
-            std::vector<Flt> K4(this->nhex, 0.0);
-
-            /*
-             * Stage 1
-             */
-            this->compute_dBdt (this->B, dBdt);
-#pragma omp parallel for
-            for (unsigned int h=0; h<this->nhex; ++h) {
-                K1[h] = dBdt[h] * this->dt;
-                Btst[h] = this->B[h] + K1[h] * 0.5 ;
-            }
-
-            /*
-             * Stage 2
-             */
-            this->compute_dBdt (Btst, dBdt);
-#pragma omp parallel for
-            for (unsigned int h=0; h<this->nhex; ++h) {
-                K2[h] = dBdt[h] * this->dt;
-                Btst[h] = this->B[h] + K2[h] * 0.5;
-            }
-
-            /*
-             * Stage 3
-             */
-            this->compute_dBdt (Btst, dBdt);
-#pragma omp parallel for
-            for (unsigned int h=0; h<this->nhex; ++h) {
-                K3[h] = dBdt[h] * this->dt;
-                Btst[h] = this->B[h] + K3[h];
-            }
-
-            /*
-             * Stage 4
-             */
-            this->compute_dBdt (Btst, dBdt);
-#pragma omp parallel for
-            for (unsigned int h=0; h<this->nhex; ++h) {
-                K4[h] = dBdt[h] * this->dt;
-            }
-
-            /*
-             * Final sum together. This could be incorporated in the for loop for
-             * Stage 4, but I've separated it out for pedagogy.
-             */
-#pragma omp parallel for
-            for (unsigned int h=0; h<this->nhex; ++h) {
-                B[h] += ((K1[h] + 2.0 * (K2[h] + K3[h]) + K4[h])/(Flt)6.0);
-            }
-        }
+        this->D = { this->D_A, this->D_B };
+        this->integrate ([this](const std::array<Flt, 2>& u, unsigned int) {
+            // F = k1 - k2 A + k3 A^2 B and G = k4 - k3 A^2 B
+            const Flt a2b = this->k3 * u[0] * u[0] * u[1];
+            std::array<Flt, 2> r = { this->k1 - (this->k2 * u[0]) + a2b, this->k4 - a2b };
+            return r;
+        });
     }
 
 }; // RD_Schnakenberg
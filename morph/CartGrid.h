@@ -22,6 +22,7 @@
 #include <morph/vvec.h>
 #include <morph/scale.h>
 #include <morph/range.h>
+#include <morph/lattice_index.h>
 
 // If the CartGrid::save and CartGrid::load methods are required, define
 // CARTGRID_COMPILE_LOAD_AND_SAVE. A link to libhdf5 will be required in your program.
@@ -211,6 +212,16 @@ namespace morph {
             return rtn;
         }
 
+        /*!
+         * Build a lattice_index over the elements of this CartGrid. Its nearest() method
+         * returns the d_ index of the element nearest to a position in O(1) time, for any
+         * boundary shape. The index must be re-made if the CartGrid is changed.
+         */
+        morph::lattice_index spatial_index() const
+        {
+            return morph::lattice_index (this->d_x, this->d_y, { this->d, 0.0f }, { 0.0f, this->v });
+        }
+
         // Width and height of a CartGrid that happens to be of type GridDomainShape::Rectangle.
         int w_px = -1;
         int h_px = -1;
@@ -108,6 +108,9 @@ namespace morph {
                 this->computeTube (rt, rb, this->border_colour, this->border_colour, bthick, 12);
                 this->computeTube (rb, lb, this->border_colour, this->border_colour, bthick, 12);
             }
+
+            // If gpuColourMap is set, colour the rects in the shader
+            this->setupScalarColouring (this->cartVisMode == CartVisMode::Triangles ? 1u : 5u);
         }
 
         // Initialize vertex buffer objects and vertex array object.
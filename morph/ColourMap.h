@@ -6,6 +6,8 @@
 #include <morph/colourmaps_cet.h>     // Colour map tables from CET
 
 #include <string_view>
+#include <vector>
+#include <span>
 #include <stdexcept>
 #include <cmath>
 #include <cstdint>
@@ -1857,34 +1859,79 @@ namespace morph {
             return ColourMap<T>::hsv2rgb (hsv);
         }
 
-        //! Convert the scalar datum into an RGB (or BGR) colour
-        std::array<float, 3> convert (T _datum) const
+        /*!
+         * Convert data into colours, writing the red, green and blue values for each datum
+         * consecutively into rgb_out, which must have 3 * data.size() elements. This is the fast
+         * path for large arrays of data (the vertexColors of a GridVisual, for example). The
+         * colour map type is dispatched once, rather than once per datum, and the table-based maps
+         * are converted in one simple loop. The colours are the same as those given by
+         * convert (T).
+         */
+        void convert (std::span<const T> data, std::span<float> rgb_out) const
         {
-            float datum = 0.0f;
-
-            // Convert T into a suitable value (with a suitable scaling as necessary) to
-            // make the conversion to array<float,3> colour.
-            if constexpr (std::is_same<std::decay_t<T>, double>::value == true) {
-                // Copy, enforce range
-                datum = _datum > T{1} ? 1.0f : static_cast<float>(_datum);
-                datum = datum < T{0} ? 0.0f : datum;
-
-            } else if constexpr (std::is_same<std::decay_t<T>, float>::value == true) {
-                // Copy, and enforce range of datum
-                datum = _datum > T{1} ? 1.0f : _datum;
-                datum = datum < T{0} ? 0.0f : datum;
-
-            } else if constexpr (std::is_same<std::decay_t<T>, bool>::value == true) {
-                datum = _datum ? 1.0f : 0.0f;
-
-            } else if constexpr (std::is_integral<std::decay_t<T>>::value == true) {
-                // For integral types, there's a 'max input range' value
-                datum = _datum < 0 ? 0.0f : (float)_datum / static_cast<float>(this->range_max);
-                datum = datum > 1.0f ? 1.0f : datum;
+            if (rgb_out.size() != 3u * data.size()) {
+                throw std::runtime_error ("ColourMap::convert: rgb_out must have 3 elements per datum");
+            }
+            const std::size_t n = data.size();
+            const T* in = data.data();
+            float* out = rgb_out.data();
+            const std::span<const std::array<float, 3>> tbl = this->lookup_table();
+            if (tbl.empty()) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const std::array<float, 3> c = this->convert (in[i]);
+                    out[3 * i] = c[0];
+                    out[3 * i + 1] = c[1];
+                    out[3 * i + 2] = c[2];
+                }
+                return;
+            }
+            const std::array<float, 3>* lut = tbl.data();
+            const std::size_t lut_n = tbl.size();
+            const std::array<float, 3> nanc = ColourMap<T>::nanColour (this->type);
+            for (std::size_t i = 0; i < n; ++i) {
+                const float datum = this->to_unit (in[i]);
+                const std::array<float, 3>& c = std::isnan (datum) ? nanc : lut[ColourMap<T>::table_index (datum, lut_n)];
+                out[3 * i] = c[0];
+                out[3 * i + 1] = c[1];
+                out[3 * i + 2] = c[2];
+            }
+        }
 
-            } else {
-                throw std::runtime_error ("Unhandled ColourMap data type.");
+        /*!
+         * The colour map as a table of RGB triplets for data evenly spaced from 0 to 1, such as
+         * is needed for a colour map texture. A datum x in [0, 1] has the colour of the entry
+         * nearest to x * (entries - 1), as in convert (T). The maps that are tables of colours
+         * give their own table; computed maps (such as the monochrome and HSV maps) are
+         * sampled at \a n points.
+         */
+        std::vector<float> rgb_table (const std::size_t n = 256) const
+        {
+            std::vector<float> rgb;
+            const std::span<const std::array<float, 3>> tbl = this->lookup_table();
+            if (!tbl.empty()) {
+                rgb.reserve (3u * tbl.size());
+                for (const std::array<float, 3>& c : tbl) { rgb.insert (rgb.end(), c.begin(), c.end()); }
+                return rgb;
+            }
+            if (n < 2u) { throw std::runtime_error ("ColourMap::rgb_table: need at least two entries"); }
+            rgb.reserve (3u * n);
+            for (std::size_t i = 0; i < n; ++i) {
+                const float x = static_cast<float>(i) / static_cast<float>(n - 1u);
+                std::array<float, 3> c = {};
+                if constexpr (std::is_floating_point<std::decay_t<T>>::value == true) {
+                    c = this->convert (static_cast<T>(x));
+                } else {
+                    c = this->convert (static_cast<T>(std::round (x * static_cast<float>(this->range_max))));
+                }
+                rgb.insert (rgb.end(), c.begin(), c.end());
             }
+            return rgb;
+        }
+
+        //! Convert the scalar datum into an RGB (or BGR) colour
+        std::array<float, 3> convert (T _datum) const
+        {
+            const float datum = this->to_unit (_datum);
 
             std::array<float, 3> c = {0.0f, 0.0f, 0.0f};
 
@@ -1894,22 +1941,11 @@ namespace morph {
                 if (std::isnan(datum) == true) { c = ColourMap<T>::nanColour(this->type); return c; }
             }
 
-            switch (this->type) {
-            case ColourMapType::Jet:
-            {
-                // Note that I now give you CET_R4 instead of the jet algorithm
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_R4.size()-1))));
-                c = morph::cet::cm_CET_R4[datum_i];
+            // Most colour maps are tables of colours
+            const std::span<const std::array<float, 3>> tbl = this->lookup_table();
+            if (!tbl.empty()) { return tbl[ColourMap<T>::table_index (datum, tbl.size())]; }
 
-                break;
-            }
-            case ColourMapType::Rainbow:
-            {
-                // Note that I now give you CET_C6 instead of the simplistically computed rainbow map
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C6.size()-1))));
-                c = morph::cet::cm_CET_C6[datum_i];
-                break;
-            }
+            switch (this->type) {
             case ColourMapType::RainbowZeroBlack:
             {
                 if (datum != T{0}) {
@@ -1928,290 +1964,6 @@ namespace morph {
                 }
                 break;
             }
-            case ColourMapType::Magma:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cm_magma.size()-1))));
-                c = morph::cm_magma[datum_i];
-                break;
-            }
-            case ColourMapType::Inferno:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cm_inferno.size()-1))));
-                c = morph::cm_inferno[datum_i];
-                break;
-            }
-            case ColourMapType::Plasma:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cm_plasma.size()-1))));
-                c = morph::cm_plasma[datum_i];
-                break;
-            }
-            case ColourMapType::Viridis:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cm_viridis.size()-1))));
-                c = morph::cm_viridis[datum_i];
-                break;
-            }
-            case ColourMapType::Cividis:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cm_cividis.size()-1))));
-                c = morph::cm_cividis[datum_i];
-                break;
-            }
-            case ColourMapType::Twilight:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cm_twilight.size()-1))));
-                c = morph::cm_twilight[datum_i];
-                break;
-            }
-            case ColourMapType::Petrov:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cm_petrov.size()-1))));
-                c = morph::cm_petrov[datum_i];
-                break;
-            }
-
-            case ColourMapType::Devon:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_devon.size()-1))));
-                c = morph::crameri::cm_devon[datum_i];
-                break;
-            }
-            case ColourMapType::NaviaW:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_naviaW.size()-1))));
-                c = morph::crameri::cm_naviaW[datum_i];
-                break;
-            }
-            case ColourMapType::BrocO:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_brocO.size()-1))));
-                c = morph::crameri::cm_brocO[datum_i];
-                break;
-            }
-            case ColourMapType::Acton:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_acton.size()-1))));
-                c = morph::crameri::cm_acton[datum_i];
-                break;
-            }
-            case ColourMapType::Batlow:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_batlow.size()-1))));
-                c = morph::crameri::cm_batlow[datum_i];
-                break;
-            }
-            case ColourMapType::Berlin:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_berlin.size()-1))));
-                c = morph::crameri::cm_berlin[datum_i];
-                break;
-            }
-            case ColourMapType::Tofino:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_tofino.size()-1))));
-                c = morph::crameri::cm_tofino[datum_i];
-                break;
-            }
-            case ColourMapType::Broc:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_broc.size()-1))));
-                c = morph::crameri::cm_broc[datum_i];
-                break;
-            }
-            case ColourMapType::CorkO:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_corkO.size()-1))));
-                c = morph::crameri::cm_corkO[datum_i];
-                break;
-            }
-            case ColourMapType::Lapaz:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_lapaz.size()-1))));
-                c = morph::crameri::cm_lapaz[datum_i];
-                break;
-            }
-            case ColourMapType::BamO:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_bamO.size()-1))));
-                c = morph::crameri::cm_bamO[datum_i];
-                break;
-            }
-            case ColourMapType::Vanimo:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_vanimo.size()-1))));
-                c = morph::crameri::cm_vanimo[datum_i];
-                break;
-            }
-            case ColourMapType::Lajolla:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_lajolla.size()-1))));
-                c = morph::crameri::cm_lajolla[datum_i];
-                break;
-            }
-            case ColourMapType::Lisbon:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_lisbon.size()-1))));
-                c = morph::crameri::cm_lisbon[datum_i];
-                break;
-            }
-            case ColourMapType::GrayC:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_grayC.size()-1))));
-                c = morph::crameri::cm_grayC[datum_i];
-                break;
-            }
-            case ColourMapType::Roma:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_roma.size()-1))));
-                c = morph::crameri::cm_roma[datum_i];
-                break;
-            }
-            case ColourMapType::Vik:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_vik.size()-1))));
-                c = morph::crameri::cm_vik[datum_i];
-                break;
-            }
-            case ColourMapType::Navia:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_navia.size()-1))));
-                c = morph::crameri::cm_navia[datum_i];
-                break;
-            }
-            case ColourMapType::Bilbao:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_bilbao.size()-1))));
-                c = morph::crameri::cm_bilbao[datum_i];
-                break;
-            }
-            case ColourMapType::Turku:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_turku.size()-1))));
-                c = morph::crameri::cm_turku[datum_i];
-                break;
-            }
-            case ColourMapType::Lipari:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_lipari.size()-1))));
-                c = morph::crameri::cm_lipari[datum_i];
-                break;
-            }
-            case ColourMapType::VikO:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_vikO.size()-1))));
-                c = morph::crameri::cm_vikO[datum_i];
-                break;
-            }
-            case ColourMapType::BatlowK:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_batlowK.size()-1))));
-                c = morph::crameri::cm_batlowK[datum_i];
-                break;
-            }
-            case ColourMapType::Oslo:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_oslo.size()-1))));
-                c = morph::crameri::cm_oslo[datum_i];
-                break;
-            }
-            case ColourMapType::Oleron:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_oleron.size()-1))));
-                c = morph::crameri::cm_oleron[datum_i];
-                break;
-            }
-            case ColourMapType::Davos:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_davos.size()-1))));
-                c = morph::crameri::cm_davos[datum_i];
-                break;
-            }
-            case ColourMapType::Fes:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_fes.size()-1))));
-                c = morph::crameri::cm_fes[datum_i];
-                break;
-            }
-            case ColourMapType::Managua:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_managua.size()-1))));
-                c = morph::crameri::cm_managua[datum_i];
-                break;
-            }
-            case ColourMapType::Glasgow:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_glasgow.size()-1))));
-                c = morph::crameri::cm_glasgow[datum_i];
-                break;
-            }
-            case ColourMapType::Tokyo:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_tokyo.size()-1))));
-                c = morph::crameri::cm_tokyo[datum_i];
-                break;
-            }
-            case ColourMapType::Bukavu:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_bukavu.size()-1))));
-                c = morph::crameri::cm_bukavu[datum_i];
-                break;
-            }
-            case ColourMapType::Bamako:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_bamako.size()-1))));
-                c = morph::crameri::cm_bamako[datum_i];
-                break;
-            }
-            case ColourMapType::BatlowW:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_batlowW.size()-1))));
-                c = morph::crameri::cm_batlowW[datum_i];
-                break;
-            }
-            case ColourMapType::Nuuk:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_nuuk.size()-1))));
-                c = morph::crameri::cm_nuuk[datum_i];
-                break;
-            }
-            case ColourMapType::Cork:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_cork.size()-1))));
-                c = morph::crameri::cm_cork[datum_i];
-                break;
-            }
-            case ColourMapType::Hawaii:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_hawaii.size()-1))));
-                c = morph::crameri::cm_hawaii[datum_i];
-                break;
-            }
-            case ColourMapType::Bam:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_bam.size()-1))));
-                c = morph::crameri::cm_bam[datum_i];
-                break;
-            }
-            case ColourMapType::Imola:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_imola.size()-1))));
-                c = morph::crameri::cm_imola[datum_i];
-                break;
-            }
-            case ColourMapType::RomaO:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_romaO.size()-1))));
-                c = morph::crameri::cm_romaO[datum_i];
-                break;
-            }
-            case ColourMapType::Buda:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::crameri::cm_buda.size()-1))));
-                c = morph::crameri::cm_buda[datum_i];
-                break;
-            }
-
             case ColourMapType::Fire:
             {
                 lenthe::colormap::ramp::fire<float> (datum, c.data());
@@ -2253,361 +2005,6 @@ namespace morph {
                 break;
             }
 
-            case ColourMapType::CET_L02:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L02.size()-1))));
-                c = morph::cet::cm_CET_L02[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L13:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L13.size()-1))));
-                c = morph::cet::cm_CET_L13[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C4:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C4.size()-1))));
-                c = morph::cet::cm_CET_C4[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D04:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D04.size()-1))));
-                c = morph::cet::cm_CET_D04[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L12:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L12.size()-1))));
-                c = morph::cet::cm_CET_L12[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C1s:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C1s.size()-1))));
-                c = morph::cet::cm_CET_C1s[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L01:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L01.size()-1))));
-                c = morph::cet::cm_CET_L01[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C5:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C5.size()-1))));
-                c = morph::cet::cm_CET_C5[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D11:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D11.size()-1))));
-                c = morph::cet::cm_CET_D11[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L04:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L04.size()-1))));
-                c = morph::cet::cm_CET_L04[datum_i];
-                break;
-            }
-            case ColourMapType::CET_CBL2:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_CBL2.size()-1))));
-                c = morph::cet::cm_CET_CBL2[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C4s:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C4s.size()-1))));
-                c = morph::cet::cm_CET_C4s[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L15:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L15.size()-1))));
-                c = morph::cet::cm_CET_L15[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L20:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L20.size()-1))));
-                c = morph::cet::cm_CET_L20[datum_i];
-                break;
-            }
-            case ColourMapType::CET_CBD1:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_CBD1.size()-1))));
-                c = morph::cet::cm_CET_CBD1[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D06:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D06.size()-1))));
-                c = morph::cet::cm_CET_D06[datum_i];
-                break;
-            }
-            case ColourMapType::CET_I3:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_I3.size()-1))));
-                c = morph::cet::cm_CET_I3[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D01A:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D01A.size()-1))));
-                c = morph::cet::cm_CET_D01A[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L16:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L16.size()-1))));
-                c = morph::cet::cm_CET_L16[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L06:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L06.size()-1))));
-                c = morph::cet::cm_CET_L06[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C2s:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C2s.size()-1))));
-                c = morph::cet::cm_CET_C2s[datum_i];
-                break;
-            }
-            case ColourMapType::CET_I1:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_I1.size()-1))));
-                c = morph::cet::cm_CET_I1[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C7s:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C7s.size()-1))));
-                c = morph::cet::cm_CET_C7s[datum_i];
-                break;
-            }
-            case ColourMapType::CET_I2:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_I2.size()-1))));
-                c = morph::cet::cm_CET_I2[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C6s:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C6s.size()-1))));
-                c = morph::cet::cm_CET_C6s[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C6:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C6.size()-1))));
-                c = morph::cet::cm_CET_C6[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L05:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L05.size()-1))));
-                c = morph::cet::cm_CET_L05[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D08:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D08.size()-1))));
-                c = morph::cet::cm_CET_D08[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L03:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L03.size()-1))));
-                c = morph::cet::cm_CET_L03[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L14:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L14.size()-1))));
-                c = morph::cet::cm_CET_L14[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C2:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C2.size()-1))));
-                c = morph::cet::cm_CET_C2[datum_i];
-                break;
-            }
-            case ColourMapType::CET_R3:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_R3.size()-1))));
-                c = morph::cet::cm_CET_R3[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D01:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D01.size()-1))));
-                c = morph::cet::cm_CET_D01[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C1:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C1.size()-1))));
-                c = morph::cet::cm_CET_C1[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D02:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D02.size()-1))));
-                c = morph::cet::cm_CET_D02[datum_i];
-                break;
-            }
-            case ColourMapType::CET_CBC1:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_CBC1.size()-1))));
-                c = morph::cet::cm_CET_CBC1[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D09:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D09.size()-1))));
-                c = morph::cet::cm_CET_D09[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L10:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L10.size()-1))));
-                c = morph::cet::cm_CET_L10[datum_i];
-                break;
-            }
-            case ColourMapType::CET_R1:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_R1.size()-1))));
-                c = morph::cet::cm_CET_R1[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C3:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C3.size()-1))));
-                c = morph::cet::cm_CET_C3[datum_i];
-                break;
-            }
-            case ColourMapType::CET_CBL1:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_CBL1.size()-1))));
-                c = morph::cet::cm_CET_CBL1[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C3s:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C3s.size()-1))));
-                c = morph::cet::cm_CET_C3s[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C5s:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C5s.size()-1))));
-                c = morph::cet::cm_CET_C5s[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L08:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L08.size()-1))));
-                c = morph::cet::cm_CET_L08[datum_i];
-                break;
-            }
-            case ColourMapType::CET_R4:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_R4.size()-1))));
-                c = morph::cet::cm_CET_R4[datum_i];
-                break;
-            }
-            case ColourMapType::CET_R2:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_R2.size()-1))));
-                c = morph::cet::cm_CET_R2[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L11:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L11.size()-1))));
-                c = morph::cet::cm_CET_L11[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D10:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D10.size()-1))));
-                c = morph::cet::cm_CET_D10[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D07:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D07.size()-1))));
-                c = morph::cet::cm_CET_D07[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L17:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L17.size()-1))));
-                c = morph::cet::cm_CET_L17[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D12:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D12.size()-1))));
-                c = morph::cet::cm_CET_D12[datum_i];
-                break;
-            }
-            case ColourMapType::CET_CBC2:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_CBC2.size()-1))));
-                c = morph::cet::cm_CET_CBC2[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D13:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D13.size()-1))));
-                c = morph::cet::cm_CET_D13[datum_i];
-                break;
-            }
-            case ColourMapType::CET_D03:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_D03.size()-1))));
-                c = morph::cet::cm_CET_D03[datum_i];
-                break;
-            }
-            case ColourMapType::CET_C7:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_C7.size()-1))));
-                c = morph::cet::cm_CET_C7[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L07:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L07.size()-1))));
-                c = morph::cet::cm_CET_L07[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L09:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L09.size()-1))));
-                c = morph::cet::cm_CET_L09[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L18:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L18.size()-1))));
-                c = morph::cet::cm_CET_L18[datum_i];
-                break;
-            }
-            case ColourMapType::CET_L19:
-            {
-                size_t datum_i = static_cast<size_t>( std::abs (std::round (datum * static_cast<float>(morph::cet::cm_CET_L19.size()-1))));
-                c = morph::cet::cm_CET_L19[datum_i];
-                break;
-            }
-
 
             case ColourMapType::Greyscale:
             {
@@ -3053,6 +2450,162 @@ namespace morph {
         }
 
     private:
+        //! Convert T into a float in the range [0, 1] (or NaN) to look up a colour for
+        float to_unit (const T _datum) const
+        {
+            float datum = 0.0f;
+            if constexpr (std::is_same<std::decay_t<T>, double>::value == true) {
+                // Copy, enforce range
+                datum = _datum > T{1} ? 1.0f : static_cast<float>(_datum);
+                datum = datum < T{0} ? 0.0f : datum;
+
+            } else if constexpr (std::is_same<std::decay_t<T>, float>::value == true) {
+                // Copy, and enforce range of datum
+                datum = _datum > T{1} ? 1.0f : _datum;
+                datum = datum < T{0} ? 0.0f : datum;
+
+            } else if constexpr (std::is_same<std::decay_t<T>, bool>::value == true) {
+                datum = _datum ? 1.0f : 0.0f;
+
+            } else if constexpr (std::is_integral<std::decay_t<T>>::value == true) {
+                // For integral types, there's a 'max input range' value
+                datum = _datum < 0 ? 0.0f : (float)_datum / static_cast<float>(this->range_max);
+                datum = datum > 1.0f ? 1.0f : datum;
+
+            } else {
+                throw std::runtime_error ("Unhandled ColourMap data type.");
+            }
+            return datum;
+        }
+
+        /*!
+         * The index of the entry nearest to datum (in [0, 1]) in a table of n colours. This is
+         * std::round (datum * (n-1)), computed without a library call (the subtraction is exact).
+         */
+        static std::size_t table_index (const float datum, const std::size_t n)
+        {
+            const float r = datum * static_cast<float>(n - 1);
+            const std::size_t i = static_cast<std::size_t>(r);
+            return (r - static_cast<float>(i)) >= 0.5f ? i + 1 : i;
+        }
+
+        //! The table of colours for this->type, or an empty span if the map is computed
+        std::span<const std::array<float, 3>> lookup_table() const
+        {
+            switch (this->type) {
+            // Note that Jet gives you CET_R4 and Rainbow gives you CET_C6
+            case ColourMapType::Jet: { return morph::cet::cm_CET_R4; }
+            case ColourMapType::Rainbow: { return morph::cet::cm_CET_C6; }
+            case ColourMapType::Magma: { return morph::cm_magma; }
+            case ColourMapType::Inferno: { return morph::cm_inferno; }
+            case ColourMapType::Plasma: { return morph::cm_plasma; }
+            case ColourMapType::Viridis: { return morph::cm_viridis; }
+            case ColourMapType::Cividis: { return morph::cm_cividis; }
+            case ColourMapType::Twilight: { return morph::cm_twilight; }
+            case ColourMapType::Petrov: { return morph::cm_petrov; }
+            case ColourMapType::Devon: { return morph::crameri::cm_devon; }
+            case ColourMapType::NaviaW: { return morph::crameri::cm_naviaW; }
+            case ColourMapType::BrocO: { return morph::crameri::cm_brocO; }
+            case ColourMapType::Acton: { return morph::crameri::cm_acton; }
+            case ColourMapType::Batlow: { return morph::crameri::cm_batlow; }
+            case ColourMapType::Berlin: { return morph::crameri::cm_berlin; }
+            case ColourMapType::Tofino: { return morph::crameri::cm_tofino; }
+            case ColourMapType::Broc: { return morph::crameri::cm_broc; }
+            case ColourMapType::CorkO: { return morph::crameri::cm_corkO; }
+            case ColourMapType::Lapaz: { return morph::crameri::cm_lapaz; }
+            case ColourMapType::BamO: { return morph::crameri::cm_bamO; }
+            case ColourMapType::Vanimo: { return morph::crameri::cm_vanimo; }
+            case ColourMapType::Lajolla: { return morph::crameri::cm_lajolla; }
+            case ColourMapType::Lisbon: { return morph::crameri::cm_lisbon; }
+            case ColourMapType::GrayC: { return morph::crameri::cm_grayC; }
+            case ColourMapType::Roma: { return morph::crameri::cm_roma; }
+            case ColourMapType::Vik: { return morph::crameri::cm_vik; }
+            case ColourMapType::Navia: { return morph::crameri::cm_navia; }
+            case ColourMapType::Bilbao: { return morph::crameri::cm_bilbao; }
+            case ColourMapType::Turku: { return morph::crameri::cm_turku; }
+            case ColourMapType::Lipari: { return morph::crameri::cm_lipari; }
+            case ColourMapType::VikO: { return morph::crameri::cm_vikO; }
+            case ColourMapType::BatlowK: { return morph::crameri::cm_batlowK; }
+            case ColourMapType::Oslo: { return morph::crameri::cm_oslo; }
+            case ColourMapType::Oleron: { return morph::crameri::cm_oleron; }
+            case ColourMapType::Davos: { return morph::crameri::cm_davos; }
+            case ColourMapType::Fes: { return morph::crameri::cm_fes; }
+            case ColourMapType::Managua: { return morph::crameri::cm_managua; }
+            case ColourMapType::Glasgow: { return morph::crameri::cm_glasgow; }
+            case ColourMapType::Tokyo: { return morph::crameri::cm_tokyo; }
+            case ColourMapType::Bukavu: { return morph::crameri::cm_bukavu; }
+            case ColourMapType::Bamako: { return morph::crameri::cm_bamako; }
+            case ColourMapType::BatlowW: { return morph::crameri::cm_batlowW; }
+            case ColourMapType::Nuuk: { return morph::crameri::cm_nuuk; }
+            case ColourMapType::Cork: { return morph::crameri::cm_cork; }
+            case ColourMapType::Hawaii: { return morph::crameri::cm_hawaii; }
+            case ColourMapType::Bam: { return morph::crameri::cm_bam; }
+            case ColourMapType::Imola: { return morph::crameri::cm_imola; }
+            case ColourMapType::RomaO: { return morph::crameri::cm_romaO; }
+            case ColourMapType::Buda: { return morph::crameri::cm_buda; }
+            case ColourMapType::CET_L02: { return morph::cet::cm_CET_L02; }
+            case ColourMapType::CET_L13: { return morph::cet::cm_CET_L13; }
+            case ColourMapType::CET_C4: { return morph::cet::cm_CET_C4; }
+            case ColourMapType::CET_D04: { return morph::cet::cm_CET_D04; }
+            case ColourMapType::CET_L12: { return morph::cet::cm_CET_L12; }
+            case ColourMapType::CET_C1s: { return morph::cet::cm_CET_C1s; }
+            case ColourMapType::CET_L01: { return morph::cet::cm_CET_L01; }
+            case ColourMapType::CET_C5: { return morph::cet::cm_CET_C5; }
+            case ColourMapType::CET_D11: { return morph::cet::cm_CET_D11; }
+            case ColourMapType::CET_L04: { return morph::cet::cm_CET_L04; }
+            case ColourMapType::CET_CBL2: { return morph::cet::cm_CET_CBL2; }
+            case ColourMapType::CET_C4s: { return morph::cet::cm_CET_C4s; }
+            case ColourMapType::CET_L15: { return morph::cet::cm_CET_L15; }
+            case ColourMapType::CET_L20: { return morph::cet::cm_CET_L20; }
+            case ColourMapType::CET_CBD1: { return morph::cet::cm_CET_CBD1; }
+            case ColourMapType::CET_D06: { return morph::cet::cm_CET_D06; }
+            case ColourMapType::CET_I3: { return morph::cet::cm_CET_I3; }
+            case ColourMapType::CET_D01A: { return morph::cet::cm_CET_D01A; }
+            case ColourMapType::CET_L16: { return morph::cet::cm_CET_L16; }
+            case ColourMapType::CET_L06: { return morph::cet::cm_CET_L06; }
+            case ColourMapType::CET_C2s: { return morph::cet::cm_CET_C2s; }
+            case ColourMapType::CET_I1: { return morph::cet::cm_CET_I1; }
+            case ColourMapType::CET_C7s: { return morph::cet::cm_CET_C7s; }
+            case ColourMapType::CET_I2: { return morph::cet::cm_CET_I2; }
+            case ColourMapType::CET_C6s: { return morph::cet::cm_CET_C6s; }
+            case ColourMapType::CET_C6: { return morph::cet::cm_CET_C6; }
+            case ColourMapType::CET_L05: { return morph::cet::cm_CET_L05; }
+            case ColourMapType::CET_D08: { return morph::cet::cm_CET_D08; }
+            case ColourMapType::CET_L03: { return morph::cet::cm_CET_L03; }
+            case ColourMapType::CET_L14: { return morph::cet::cm_CET_L14; }
+            case ColourMapType::CET_C2: { return morph::cet::cm_CET_C2; }
+            case ColourMapType::CET_R3: { return morph::cet::cm_CET_R3; }
+            case ColourMapType::CET_D01: { return morph::cet::cm_CET_D01; }
+            case ColourMapType::CET_C1: { return morph::cet::cm_CET_C1; }
+            case ColourMapType::CET_D02: { return morph::cet::cm_CET_D02; }
+            case ColourMapType::CET_CBC1: { return morph::cet::cm_CET_CBC1; }
+            case ColourMapType::CET_D09: { return morph::cet::cm_CET_D09; }
+            case ColourMapType::CET_L10: { return morph::cet::cm_CET_L10; }
+            case ColourMapType::CET_R1: { return morph::cet::cm_CET_R1; }
+            case ColourMapType::CET_C3: { return morph::cet::cm_CET_C3; }
+            case ColourMapType::CET_CBL1: { return morph::cet::cm_CET_CBL1; }
+            case ColourMapType::CET_C3s: { return morph::cet::cm_CET_C3s; }
+            case ColourMapType::CET_C5s: { return morph::cet::cm_CET_C5s; }
+            case ColourMapType::CET_L08: { return morph::cet::cm_CET_L08; }
+            case ColourMapType::CET_R4: { return morph::cet::cm_CET_R4; }
+            case ColourMapType::CET_R2: { return morph::cet::cm_CET_R2; }
+            case ColourMapType::CET_L11: { return morph::cet::cm_CET_L11; }
+            case ColourMapType::CET_D10: { return morph::cet::cm_CET_D10; }
+            case ColourMapType::CET_D07: { return morph::cet::cm_CET_D07; }
+            case ColourMapType::CET_L17: { return morph::cet::cm_CET_L17; }
+            case ColourMapType::CET_D12: { return morph::cet::cm_CET_D12; }
+            case ColourMapType::CET_CBC2: { return morph::cet::cm_CET_CBC2; }
+            case ColourMapType::CET_D13: { return morph::cet::cm_CET_D13; }
+            case ColourMapType::CET_D03: { return morph::cet::cm_CET_D03; }
+            case ColourMapType::CET_C7: { return morph::cet::cm_CET_C7; }
+            case ColourMapType::CET_L07: { return morph::cet::cm_CET_L07; }
+            case ColourMapType::CET_L09: { return morph::cet::cm_CET_L09; }
+            case ColourMapType::CET_L18: { return morph::cet::cm_CET_L18; }
+            case ColourMapType::CET_L19: { return morph::cet::cm_CET_L19; }
+            default: { return {}; }
+            }
+        }
+
         /*!
          * @param datum gray value from 0.0 to 1.0
          *
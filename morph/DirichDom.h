@@ -116,7 +116,7 @@ namespace morph {
 
             // Now find a hex in hg that a) has this coordinate on it as a vertex and b) has the
             // correct ID. This will be the first hex on the boundary.
-            std::list<Hex>::iterator firsthex = hg->hexen.begin();
+            hexlist::iterator firsthex = hg->hexen.begin();
             while (firsthex != hg->hexen.end()) {
                 if (firsthex->contains_vertex (firstborder) && f[firsthex->vi] == this->f) {
                     // This hex is on the border of this domain.
@@ -129,13 +129,13 @@ namespace morph {
             // and HEX_USER_FLAG_0 for every domain hex.
 
             // Boundary hex iterator
-            std::list<Hex>::iterator bhi = firsthex;
+            hexlist::iterator bhi = firsthex;
             // Previous boundary hex iterator
-            std::list<Hex>::iterator bhi_prev = firsthex;
+            hexlist::iterator bhi_prev = firsthex;
             // Neighbour hex iterator
-            std::list<Hex>::iterator nhi = firsthex;
+            hexlist::iterator nhi = firsthex;
             // A vector of Hex iterators to be filled with the hexes on the domain boundary
-            std::vector< std::list<Hex>::iterator > domBoundary;
+            std::vector< hexlist::iterator > domBoundary;
 
             // Set flags on first hex and add it to domBoundary
             firsthex->setUserFlags(HEX_USER_FLAG_0 | HEX_USER_FLAG_1);
@@ -215,7 +215,7 @@ namespace morph {
             // each other which are both on the boundary and a third hex protruding out - a sort of
             // boundary pimple. So, run through domBoundary to catch these cases and ensure that the
             // area measurement is accurate.
-            for (std::list<Hex>::iterator hi : domBoundary) {
+            for (hexlist::iterator hi : domBoundary) {
                 for (unsigned int i = 0; i<6; ++i) {
                     if (hi->has_neighbour(i)) {
                         nhi = hi->get_neighbour(i);
@@ -229,8 +229,8 @@ namespace morph {
 
             if constexpr (dbg) { std::cout << "foreach hex in domBoundary\n"; }
             // Now the domain boundary should have been found.
-            std::list<Hex>::iterator innerhex = hg->hexen.end();
-            for (std::list<Hex>::iterator hi : domBoundary) {
+            hexlist::iterator innerhex = hg->hexen.end();
+            for (hexlist::iterator hi : domBoundary) {
 
                 if constexpr (dbg) { std::cout << "boundary hex " << hi->outputRG(); }
                 // Mark inwards in all possible directions from nh.
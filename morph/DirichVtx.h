@@ -82,7 +82,7 @@ namespace morph {
          * DirichVtx. Important so that from one DirichVtx, we can find our way along an edge to
          * the next vertex.
          */
-        std::list<Hex>::iterator hi;
+        hexlist::iterator hi;
 
         /*!
          * P_i is a point on the line. In this code, I project A_i+1 onto the line to find the
@@ -145,7 +145,7 @@ namespace morph {
          * (with @oth) and finally, set the list<Hex> iterator @hex.
          */
         DirichVtx (const morph::vec<Flt, 2>& p, const Flt& d, const Flt& id,
-                   const morph::vec<Flt, 2>& oth, const std::list<Hex>::iterator hex)
+                   const morph::vec<Flt, 2>& oth, const hexlist::iterator hex)
             : v(p), f(id), neighb(oth), hi(hex) {
             this->threshold = d/(4.0f*morph::mathconst<float>::sqrt_of_3);
         }
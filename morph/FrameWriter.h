@@ -0,0 +1,260 @@
+/*!
+ * \file
+ *
+ * A small pool of worker threads that writes captured frames (RGBA images) to disk, either as PNG
+ * files or as frames appended to a single raw frame file. This lets a render loop save a movie's
+ * frames without waiting for PNG compression or for the disk. See
+ * VisualOwnable::saveImageAsync.
+ *
+ * A raw frame file is a sequence of frames. Each frame is a 16 byte header (the characters
+ * "MRGB", then the width, the height and the number of bytes per pixel as little endian 32 bit
+ * unsigned integers) followed by the RGBA pixels, top row first.
+ *
+ * \author Seb James
+ * \date 2025
+ */
+#pragma once
+
+#include <morph/lodepng.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+
+namespace morph {
+
+    class FrameWriter
+    {
+    public:
+        /*!
+         * Start \a nthreads worker threads. At most \a max_queued frames wait to be written; push()
+         * waits for a space if the workers fall that far behind, which bounds the memory use.
+         */
+        FrameWriter (unsigned int nthreads = 2, std::size_t max_queued = 8)
+            : max_queue (max_queued > 0 ? max_queued : 1)
+        {
+            if (nthreads == 0) { nthreads = 1; }
+            for (unsigned int i = 0; i < nthreads; ++i) {
+                this->workers.emplace_back (&FrameWriter::work, this);
+            }
+        }
+        FrameWriter (const FrameWriter&) = delete;
+        FrameWriter& operator= (const FrameWriter&) = delete;
+
+        //! Write any frames still in the queue, then stop the workers
+        ~FrameWriter()
+        {
+            {
+                std::lock_guard<std::mutex> lk (this->m);
+                this->stopping = true;
+            }
+            this->cv_work.notify_all();
+            for (auto& w : this->workers) { w.join(); }
+        }
+
+        /*!
+         * Queue the \a w by \a h RGBA frame \a pixels (top row first) to be written to \a
+         * filename. A filename ending in .png is written as a PNG file; any other filename is
+         * treated as a raw frame file and the frame is appended to it. Unless \a transparent_bg,
+         * the frame is made opaque before it is written. Throws if a frame of a different size
+         * is appended to a raw frame file, or if an existing file with that name does not begin
+         * with a raw frame header for a frame of this size.
+         */
+        void push (std::vector<unsigned char>&& pixels, int w, int h, const std::string& filename,
+                   const bool transparent_bg = false)
+        {
+            if (w <= 0 || h <= 0 || pixels.size() != static_cast<std::size_t>(w) * h * 4) {
+                throw std::runtime_error ("FrameWriter::push: pixel data does not match the frame size");
+            }
+            frame f;
+            f.pixels = std::move (pixels);
+            f.w = w;
+            f.h = h;
+            f.filename = filename;
+            f.opaque = !transparent_bg;
+            f.raw = !FrameWriter::is_png (filename);
+
+            std::unique_lock<std::mutex> lk (this->m);
+            if (f.raw) {
+                // Frames are placed in the raw file in the order in which they were pushed
+                auto& rf = this->raw_files[filename];
+                if (rf == nullptr) { rf = std::make_unique<raw_file> (filename, w, h); }
+                if (rf->w != w || rf->h != h) {
+                    throw std::runtime_error ("FrameWriter::push: frame size differs from the frames in " + filename);
+                }
+                f.index = rf->nframes++;
+                f.rf = rf.get();
+            }
+            this->cv_space.wait (lk, [this]{ return this->queue.size() < this->max_queue; });
+            this->queue.push_back (std::move (f));
+            lk.unlock();
+            this->cv_work.notify_one();
+        }
+
+        //! Wait until every frame that has been pushed is written
+        void wait()
+        {
+            std::unique_lock<std::mutex> lk (this->m);
+            this->cv_idle.wait (lk, [this]{ return this->queue.empty() && this->busy == 0; });
+        }
+
+        //! The number of frames written so far
+        std::size_t written() const
+        {
+            std::lock_guard<std::mutex> lk (this->m);
+            return this->n_written;
+        }
+
+        //! The number of frames that could not be written
+        std::size_t errors() const
+        {
+            std::lock_guard<std::mutex> lk (this->m);
+            return this->n_errors;
+        }
+
+        //! True if \a filename has a .png suffix (of any case)
+        static bool is_png (const std::string& filename)
+        {
+            std::string ext = std::filesystem::path (filename).extension().string();
+            for (auto& c : ext) { c = static_cast<char>(std::tolower (static_cast<unsigned char>(c))); }
+            return ext == ".png";
+        }
+
+        //! The number of bytes in the header of each frame in a raw frame file
+        static constexpr std::size_t raw_header_bytes = 16;
+
+    private:
+        //! An open raw frame file. Frames are written at their own offsets, in any order.
+        struct raw_file
+        {
+            raw_file (const std::string& path, int _w, int _h) : w(_w), h(_h)
+            {
+                const std::size_t fbytes = raw_header_bytes + static_cast<std::size_t>(_w) * _h * 4;
+                std::error_code ec;
+                const auto sz = std::filesystem::file_size (path, ec);
+                if (!ec && sz > 0) {
+                    // Append to an existing file (dropping any partly written last frame), but
+                    // only if it holds raw frames of the same size
+                    std::uint32_t hdr[4] = { 0, 0, 0, 0 };
+                    std::ifstream fin (path, std::ios::binary);
+                    fin.read (reinterpret_cast<char*>(hdr), raw_header_bytes);
+                    if (!fin || std::memcmp (hdr, "MRGB", 4) != 0) {
+                        throw std::runtime_error ("FrameWriter: " + path + " exists but is not a raw frame file");
+                    }
+                    if (hdr[1] != static_cast<std::uint32_t>(_w) || hdr[2] != static_cast<std::uint32_t>(_h) || hdr[3] != 4) {
+                        throw std::runtime_error ("FrameWriter: " + path + " holds frames of " + std::to_string (hdr[1])
+                                                  + "x" + std::to_string (hdr[2]) + ", not " + std::to_string (_w)
+                                                  + "x" + std::to_string (_h));
+                    }
+                    this->nframes = sz / fbytes;
+                }
+                this->f.open (path, std::ios::in | std::ios::out | std::ios::binary);
+                if (!this->f.is_open()) { this->f.open (path, std::ios::out | std::ios::binary | std::ios::trunc); }
+                if (!this->f.is_open()) { throw std::runtime_error ("FrameWriter: Failed to open " + path); }
+            }
+            int w = 0;
+            int h = 0;
+            std::uint64_t nframes = 0;
+            std::fstream f;
+            std::mutex fm;
+        };
+
+        struct frame
+        {
+            std::vector<unsigned char> pixels;
+            int w = 0;
+            int h = 0;
+            std::string filename;
+            bool opaque = true;
+            bool raw = false;
+            std::uint64_t index = 0;
+            raw_file* rf = nullptr;
+        };
+
+        //! The worker thread function
+        void work()
+        {
+            for (;;) {
+                frame f;
+                {
+                    std::unique_lock<std::mutex> lk (this->m);
+                    this->cv_work.wait (lk, [this]{ return this->stopping || !this->queue.empty(); });
+                    if (this->queue.empty()) { return; } // stopping, and nothing left to write
+                    f = std::move (this->queue.front());
+                    this->queue.pop_front();
+                    ++this->busy;
+                }
+                this->cv_space.notify_one();
+
+                const bool ok = f.raw ? this->write_raw (f) : this->write_png (f);
+
+                {
+                    std::lock_guard<std::mutex> lk (this->m);
+                    --this->busy;
+                    if (ok) { ++this->n_written; } else { ++this->n_errors; }
+                }
+                this->cv_idle.notify_all();
+            }
+        }
+
+        static void make_opaque (frame& f)
+        {
+            for (std::size_t i = 3; i < f.pixels.size(); i += 4) { f.pixels[i] = 255; }
+        }
+
+        bool write_png (frame& f)
+        {
+            if (f.opaque) { FrameWriter::make_opaque (f); }
+            unsigned int error = lodepng::encode (f.filename, f.pixels.data(), f.w, f.h);
+            if (error) {
+                std::cerr << "encoder error " << error << ": " << lodepng_error_text (error) << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        bool write_raw (frame& f)
+        {
+            if (f.opaque) { FrameWriter::make_opaque (f); }
+            std::uint32_t hdr[4] = { 0, static_cast<std::uint32_t>(f.w), static_cast<std::uint32_t>(f.h), 4 };
+            std::memcpy (hdr, "MRGB", 4);
+            const std::size_t fbytes = raw_header_bytes + f.pixels.size();
+            std::lock_guard<std::mutex> lk (f.rf->fm);
+            f.rf->f.seekp (static_cast<std::streamoff>(f.index * fbytes));
+            f.rf->f.write (reinterpret_cast<const char*>(hdr), raw_header_bytes);
+            f.rf->f.write (reinterpret_cast<const char*>(f.pixels.data()), f.pixels.size());
+            f.rf->f.flush();
+            if (!f.rf->f.good()) {
+                std::cerr << "FrameWriter: Failed to write frame " << f.index << " to " << f.filename << std::endl;
+                f.rf->f.clear();
+                return false;
+            }
+            return true;
+        }
+
+        std::size_t max_queue = 8;
+        std::deque<frame> queue;
+        std::map<std::string, std::unique_ptr<raw_file>> raw_files;
+        std::vector<std::thread> workers;
+        mutable std::mutex m;
+        std::condition_variable cv_work;
+        std::condition_variable cv_space;
+        std::condition_variable cv_idle;
+        unsigned int busy = 0;
+        bool stopping = false;
+        std::size_t n_written = 0;
+        std::size_t n_errors = 0;
+    };
+
+} // namespace morph
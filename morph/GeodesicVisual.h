@@ -6,6 +6,10 @@
 #include <morph/scale.h>
 #include <morph/ColourMap.h>
 #include <array>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <limits>
 
 namespace morph {
 
@@ -48,6 +52,7 @@ namespace morph {
             this->vertexNormals.clear();
             this->vertexColors.clear();
             this->indices.clear();
+            this->lod_faces.clear();
 
             morph::geometry::icosahedral_geodesic_info gi(this->iterations);
             this->n_faces = gi.n_faces;
@@ -64,6 +69,7 @@ namespace morph {
                     this->n_verts = this->computeSphereGeoFaces (morph::vec<float, 3>({0,0,0}),
                                                                  this->cm.convert(0.0f), this->radius, this->iterations);
                 }
+                this->computeFaceLevels();
 
             } else { // colour vertices
 
@@ -71,10 +77,13 @@ namespace morph {
                     // Note odd necessity to stick in the 'template' keyword after this->
                     this->n_verts = this->template computeSphereGeo<double> (morph::vec<float, 3>({0,0,0}),
                                                                              this->cm.convert(0.0f), this->radius, this->iterations);
+                    this->template computeSphereGeoLevels<double> (morph::vec<float, 3>({0,0,0}), this->radius,
+                                                                   this->iterations, 0u, this->detail_levels);
                 } else {
                     // computeSphereGeo F defaults to float
                     this->n_verts = this->computeSphereGeo (morph::vec<float, 3>({0,0,0}),
                                                             this->cm.convert(0.0f), this->radius, this->iterations);
+                    this->computeSphereGeoLevels (morph::vec<float, 3>({0,0,0}), this->radius, this->iterations, 0u, this->detail_levels);
                 }
                 // Resize our data.
                 this->data.resize (n_verts, T{0});
@@ -92,7 +101,8 @@ namespace morph {
             // (r, theta, phi).
             this->cart_centres.resize (this->n_faces);
             this->sph_centres.resize (this->n_faces);
-            for (size_t i = 0; i < this->indices.size(); i+=3) {
+            // The full detail faces come first in indices
+            for (size_t i = 0; i < 3u * static_cast<size_t>(this->n_faces); i+=3) {
                 int _vtx1 = this->indices[i];
                 int _vtx2 = this->indices[i+1];
                 int _vtx3 = this->indices[i+2];
@@ -130,9 +140,9 @@ namespace morph {
                 this->vertexColors.clear(); // could potentially just replace values
                 size_t n_data = this->cdata.size();
 
-                // there are n_vertex colours, and n_data data points.
+                // there are n_vertex colours, and n_data data points (and the faces of any coarser levels of detail)
                 if (this->colourFaces == true) {
-                    if (n_cvals != 3 * 3 * n_data) { throw std::runtime_error ("data is not right size");  }
+                    if (n_cvals != 3 * 3 * (n_data + this->lod_faces.size())) { throw std::runtime_error ("data is not right size");  }
                 } else {
                     if (n_cvals != 3 * n_data) { throw std::runtime_error ("data is not right size");  }
                 }
@@ -150,9 +160,9 @@ namespace morph {
                 this->vertexColors.clear(); // could potentially just replace values
                 size_t n_data = this->data.size();
 
-                // there are n_vertex colours, and n_data data points.
+                // there are n_vertex colours, and n_data data points (and the faces of any coarser levels of detail)
                 if (this->colourFaces == true) {
-                    if (n_cvals != 3 * 3 * n_data) { throw std::runtime_error ("data is not right size");  }
+                    if (n_cvals != 3 * 3 * (n_data + this->lod_faces.size())) { throw std::runtime_error ("data is not right size");  }
                 } else {
                     if (n_cvals != 3 * n_data) { throw std::runtime_error ("data is not right size");  }
                 }
@@ -172,10 +182,68 @@ namespace morph {
                     }
                 }
             }
+            // Faces of the coarser levels of detail take the colour of their full detail face
+            for (auto f : this->lod_faces) {
+                for (int ci = 0; ci < 9; ++ci) { this->vertexColors.push_back (this->vertexColors[9 * f + (ci % 3)]); }
+            }
             // Lastly, this call copies vertexColors (etc) into the OpenGL memory space
             this->reinit_colour_buffer();
         }
 
+        /*!
+         * Add coarser levels of detail to a model with coloured faces. Each level is a geodesic of
+         * one fewer iteration, with faces coloured like the full detail face that is nearest to
+         * their centre.
+         */
+        void computeFaceLevels()
+        {
+            if (this->detail_levels < 1 || this->iterations < 1) { return; }
+            // The centres of the full detail faces, in order of z
+            const std::size_t n_f = static_cast<std::size_t>(this->n_faces);
+            std::vector<morph::vec<float>> centres (n_f);
+            std::vector<std::pair<float, std::size_t>> by_z (n_f);
+            for (std::size_t i = 0; i < n_f; ++i) {
+                const float* p = this->vertexPositions.data() + 9 * i;
+                centres[i] = morph::vec<float>{ p[0] + p[3] + p[6], p[1] + p[4] + p[7], p[2] + p[5] + p[8] } / 3.0f;
+                by_z[i] = { centres[i][2], i };
+            }
+            std::sort (by_z.begin(), by_z.end());
+            this->lod_detail = { 0u, this->indices.size(), 0.0f };
+
+            // An icosahedron's edges subtend 1.107 radians, and each iteration halves them
+            constexpr float edge0 = 1.107f;
+            const float fine_edge = this->radius * edge0 / static_cast<float>(1 << this->iterations);
+            for (int it = this->iterations - 1; it >= 0 && it >= this->iterations - this->detail_levels; --it) {
+                morph::geometry::icosahedral_geodesic<double> geo = morph::geometry::make_icosahedral_geodesic<double> (it);
+                const std::size_t first = this->indices.size();
+                for (auto f : geo.poly.faces) {
+                    morph::vec<double> norm = geo.poly.vertices[f[0]] + geo.poly.vertices[f[1]] + geo.poly.vertices[f[2]];
+                    const morph::vec<float> centre = (norm * (this->radius / 3.0)).as_float();
+                    // Search the faces within a band of z about the centre for the nearest
+                    std::size_t nearest = 0;
+                    float d_nearest = std::numeric_limits<float>::max();
+                    for (float band = fine_edge; d_nearest == std::numeric_limits<float>::max(); band *= 2.0f) {
+                        auto fi = std::lower_bound (by_z.begin(), by_z.end(), std::make_pair (centre[2] - band, std::size_t{0}));
+                        for (; fi != by_z.end() && fi->first <= centre[2] + band; ++fi) {
+                            const float d = (centres[fi->second] - centre).length();
+                            if (d < d_nearest) { d_nearest = d; nearest = fi->second; }
+                        }
+                    }
+                    this->lod_faces.push_back (nearest);
+                    const morph::vec<float> nf = (norm / 3.0).as_float();
+                    std::array<float, 3> clr = { this->vertexColors[9 * nearest], this->vertexColors[9 * nearest + 1],
+                                                 this->vertexColors[9 * nearest + 2] };
+                    for (int j = 0; j < 3; ++j) {
+                        this->vertex_push ((geo.poly.vertices[f[j]] * this->radius).as_float(), this->vertexPositions);
+                        this->vertex_push (nf, this->vertexNormals);
+                        this->vertex_push (clr, this->vertexColors);
+                        this->indices.push_back (this->idx++);
+                    }
+                }
+                this->add_lod_level (first, this->lod_facet_size * static_cast<float>(1 << it) / (edge0 / 2.0f));
+            }
+        }
+
         //! The radius of the geodesic
         float radius = 1.0f;
         //! The colour of the object. Can be resized to n_faces to colour each face
@@ -196,6 +264,13 @@ namespace morph {
         int n_verts = 0;
         //! This may be filled with the number of faces in the geodesic
         int n_faces = 0;
+        /*!
+         * The number of coarser levels of detail (each with one fewer iteration) to draw when the
+         * geodesic is small on screen. Set before finalize().
+         */
+        int detail_levels = 0;
+        //! For each face of the coarser levels of detail, the full detail face whose colour it takes
+        std::vector<std::size_t> lod_faces;
     };
 
 } // namespace morph
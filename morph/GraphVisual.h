@@ -10,6 +10,7 @@
 #include <array>
 #include <vector>
 #include <deque>
+#include <map>
 #include <cmath>
 #include <sstream>
 #include <memory>
@@ -31,6 +32,7 @@
 #include <morph/Grid.h>
 #include <morph/DatasetStyle.h>
 #include <morph/VisualTextModel.h>
+#include <morph/streamseries.h>
 
 namespace morph {
 
@@ -62,6 +64,12 @@ namespace morph {
         //! copy of the data to be able to rescale.
         void append (const Flt& _abscissa, const Flt& _ordinate, const unsigned int didx)
         {
+            if (auto si = this->streams.find (didx); si != this->streams.end()) {
+                // A streaming dataset is redrawn from its decimated points in prepare_draw()
+                si->second.push (_abscissa, _ordinate);
+                this->pendingStream = true;
+                return;
+            }
             this->pendingAppended = true;
             // Transfor the data into temporary containers sd and ad
             Flt o = Flt{0};
@@ -157,18 +165,59 @@ namespace morph {
             this->initializeVertices(); // Re-build
         }
 
-        //! Before calling the base class's render method, check if we have any pending data
-        void render()
+        /*!
+         * Make dataset didx (already set up with prepdata) a streaming dataset.
+         *
+         * Points passed to append() for a streaming dataset go into a ring buffer which holds the
+         * latest capacity points. If xwindow > 0, only the points with abscissae within xwindow
+         * of the newest one are shown. Before each frame, the points are decimated to at most four
+         * per column (the first, min, max and last) and the streams' lines are redrawn from these,
+         * so the cost of drawing is O(columns), however many points have been appended. Set
+         * columns to about the width of the graph in pixels.
+         *
+         * The axes follow the streamed data, unless manual limits were set with setlimits().
+         * Autoscaled axes are given some headroom, so that the axes and their labels are only
+         * redrawn when the data outgrow them. If a graph mixes streaming and ordinary datasets,
+         * set manual limits. Abscissae must not decrease. Streaming datasets are best drawn with
+         * stylepolicy::lines.
+         */
+        void setstreaming (const unsigned int didx, const std::size_t capacity,
+                           const Flt xwindow = Flt{0}, const unsigned int columns = 1024)
+        {
+            if (didx >= this->datastyles.size()) {
+                throw std::runtime_error ("GraphVisual::setstreaming: prepare the dataset with prepdata first");
+            }
+            this->streams.erase (didx);
+            this->streams.emplace (didx, morph::streamseries<Flt>(capacity, xwindow, columns));
+            // Fit the axes afresh to the streamed data
+            this->stream_xr.search_init();
+            this->stream_yr.search_init();
+            this->stream_yr2.search_init();
+        }
+
+        //! Before the graph is drawn, check if we have any pending data
+        void prepare_draw() override
         {
+            if (this->pendingStream == true) {
+                this->redraw_streams();
+                this->pendingStream = false;
+            }
             if (this->pendingAppended == true) {
                 // After adding to graphDataCoords, we have to create the new OpenGL
-                // vertices (CPU side) and update the OpenGL buffers.
+                // vertices (CPU side) and update the OpenGL buffers. The new vertices are
+                // appended, so only the tails of the buffers need to be uploaded.
+                const std::size_t n_posn = this->vertexPositions.size();
+                const std::size_t n_norm = this->vertexNormals.size();
+                const std::size_t n_col = this->vertexColors.size();
+                const std::size_t n_idx = this->indices.size();
                 this->drawAppendedData();
+                this->mark_dirty (this->posnVBO, n_posn, this->vertexPositions.size() - n_posn);
+                this->mark_dirty (this->normVBO, n_norm, this->vertexNormals.size() - n_norm);
+                this->mark_dirty (this->colVBO, n_col, this->vertexColors.size() - n_col);
+                this->mark_dirty (this->idxVBO, n_idx, this->indices.size() - n_idx);
                 this->reinit_buffers();
                 this->pendingAppended = false;
             }
-            // Now do the usual drawing stuff from VisualModel:
-            VisualModel<glver>::render();
         }
 
         //! Clear all the coordinate data for the graph, but leave the containers in place.
@@ -1017,6 +1066,184 @@ namespace morph {
         //! Is there pending appended data that needs to be converted into OpenGL shapes?
         bool pendingAppended = false;
 
+        //! Streaming datasets, by data index
+        std::map<unsigned int, morph::streamseries<Flt>> streams;
+
+        //! Have points been appended to a streaming dataset since it was last drawn?
+        bool pendingStream = false;
+
+        //! The axis ranges that the streaming datasets were last drawn with (see fit_stream_axis)
+        morph::range<Flt> stream_xr = morph::range<Flt>(morph::range_init::for_search);
+        morph::range<Flt> stream_yr = morph::range<Flt>(morph::range_init::for_search);
+        morph::range<Flt> stream_yr2 = morph::range<Flt>(morph::range_init::for_search);
+
+        //! The fraction of the data range that is added to an autoscaled axis of a streaming graph
+        static constexpr Flt stream_headroom = Flt{0.2};
+
+        //! Where the geometry of the streaming datasets starts and ends in the vertex data
+        struct stream_geometry
+        {
+            std::size_t posn = 0;
+            std::size_t norm = 0;
+            std::size_t col = 0;
+            std::size_t ind = 0;
+            GLuint idx = 0u;
+            std::size_t posn_end = 0;
+        };
+        stream_geometry stream_geom;
+
+        //! The range to scale an axis to under policy, given manual limits and the range of the data
+        static morph::range<Flt> policy_range (const morph::scalingpolicy policy,
+                                               const morph::range<Flt>& manual, morph::range<Flt> data)
+        {
+            if (data.span() == Flt{0}) {
+                // Avoid a degenerate scaling
+                const Flt pad = data.min == Flt{0} ? Flt{1} : std::abs (data.min) * Flt{0.1};
+                data.min -= pad;
+                data.max += pad;
+            }
+            switch (policy) {
+            case morph::scalingpolicy::manual: return manual;
+            case morph::scalingpolicy::manual_min: return { manual.min, data.max };
+            case morph::scalingpolicy::manual_max: return { data.min, manual.max };
+            case morph::scalingpolicy::autoscale:
+            default: return data;
+            }
+        }
+
+        /*!
+         * Fit the range \a drawn of an axis of a streaming graph to \a need (the range that
+         * policy_range() gives). So that the axes and their tick labels are not redrawn on every
+         * frame, the autoscaled ends of the axis get stream_headroom of extra room (the low end
+         * only if \a pad_min), and the axis only changes when the data leave it or fill less than
+         * half of it. Returns true if \a drawn changed.
+         */
+        static bool fit_stream_axis (morph::range<Flt>& drawn, const morph::range<Flt>& need,
+                                     const morph::scalingpolicy policy, const bool pad_min = true)
+        {
+            const bool auto_min = policy == morph::scalingpolicy::autoscale || policy == morph::scalingpolicy::manual_max;
+            const bool auto_max = policy == morph::scalingpolicy::autoscale || policy == morph::scalingpolicy::manual_min;
+            if (drawn.min <= drawn.max && drawn.min <= need.min && need.max <= drawn.max
+                && (!(auto_min || auto_max) || drawn.span() <= Flt{2} * need.span())) {
+                return false;
+            }
+            const Flt pad = need.span() * stream_headroom;
+            drawn = need;
+            if (auto_min && pad_min) { drawn.min -= pad; }
+            if (auto_max) { drawn.max += pad; }
+            return true;
+        }
+
+        //! Draw the lines and markers of the streaming datasets, after the rest of the graph
+        void drawStreams()
+        {
+            this->stream_geom.posn = this->vertexPositions.size();
+            this->stream_geom.norm = this->vertexNormals.size();
+            this->stream_geom.col = this->vertexColors.size();
+            this->stream_geom.ind = this->indices.size();
+            this->stream_geom.idx = this->idx;
+            for (const auto& [didx, s] : this->streams) {
+                if (didx < this->graphDataCoords.size()) {
+                    this->drawDataCommon (didx, 0, this->graphDataCoords[didx]->size());
+                }
+            }
+            this->stream_geom.posn_end = this->vertexPositions.size();
+        }
+
+        /*!
+         * Redraw the graph from the decimated points of the streaming datasets. Only the
+         * geometry of the streaming datasets is re-made and uploaded, unless the axes have to
+         * change to fit the data (or ordinary data has been appended since the streams were last
+         * drawn), in which case the whole graph is rebuilt.
+         */
+        void redraw_streams()
+        {
+            morph::range<Flt> xr (morph::range_init::for_search);
+            morph::range<Flt> yr (morph::range_init::for_search);
+            morph::range<Flt> yr2 (morph::range_init::for_search);
+            for (auto& [didx, s] : this->streams) {
+                if (s.size() == 0) { continue; }
+                const morph::range<Flt> sx = s.xrange();
+                xr.update (sx.min);
+                xr.update (sx.max);
+                const morph::range<Flt> sy = s.yrange();
+                morph::range<Flt>& r = this->datastyles[didx].axisside == morph::axisside::left ? yr : yr2;
+                r.update (sy.min);
+                r.update (sy.max);
+            }
+            if (xr.min > xr.max) { return; } // no streamed points yet
+
+            // Abscissae don't decrease, so the x axis needs no headroom at its low end
+            bool rescale = fit_stream_axis (this->stream_xr, policy_range (this->scalingpolicy_x, this->datarange_x, xr),
+                                            this->scalingpolicy_x, false);
+            if (yr.min <= yr.max) {
+                rescale |= fit_stream_axis (this->stream_yr, policy_range (this->scalingpolicy_y, this->datarange_y, yr),
+                                            this->scalingpolicy_y);
+            }
+            if (yr2.min <= yr2.max) {
+                rescale |= fit_stream_axis (this->stream_yr2, policy_range (this->scalingpolicy_y, this->datarange_y2, yr2),
+                                            this->scalingpolicy_y);
+            }
+            // Ordinary data appended after the streams' geometry would be lost when it is replaced
+            rescale |= this->vertexPositions.size() != this->stream_geom.posn_end;
+
+            if (rescale) {
+                this->abscissa_scale.reset();
+                this->abscissa_scale.compute_scaling (this->stream_xr);
+                if (yr.min <= yr.max) {
+                    this->ord1_scale.reset();
+                    this->ord1_scale.compute_scaling (this->stream_yr);
+                }
+                if (yr2.min <= yr2.max) {
+                    this->ord2_scale.reset();
+                    this->ord2_scale.compute_scaling (this->stream_yr2);
+                }
+            }
+
+            std::vector<morph::vec<Flt, 2>> pts;
+            for (auto& [didx, s] : this->streams) {
+                while (this->graphDataCoords.size() < didx + 1) {
+                    this->graphDataCoords.push_back (std::make_unique<std::vector<morph::vec<float>>>());
+                }
+                s.decimate (pts);
+                const bool left = this->datastyles[didx].axisside == morph::axisside::left;
+                std::vector<morph::vec<float>>& gdc = *this->graphDataCoords[didx];
+                gdc.resize (pts.size());
+                for (std::size_t i = 0; i < pts.size(); ++i) {
+                    const Flt a = this->abscissa_scale.transform_one (pts[i][0]);
+                    const Flt o = left ? this->ord1_scale.transform_one (pts[i][1]) : this->ord2_scale.transform_one (pts[i][1]);
+                    gdc[i] = { static_cast<float>(a), static_cast<float>(o), 0.0f };
+                }
+            }
+
+            if (rescale) {
+                // Rebuild the whole graph (uploading it once, below)
+                this->vertexPositions.clear();
+                this->vertexNormals.clear();
+                this->vertexColors.clear();
+                this->indices.clear();
+                this->clearTexts();
+                this->idx = 0u;
+                this->initializeVertices(); // adds text labels, which releases the context...
+                if (this->setContext != nullptr) { this->setContext (this->parentVis); } // ...so re-acquire it
+                // The new labels are made after the Visual set this model's scene matrix
+                this->setSceneMatrixTexts (this->scenematrix);
+            } else {
+                // Replace only the streams' geometry, at the end of the vertex data, and upload just that
+                this->vertexPositions.resize (this->stream_geom.posn);
+                this->vertexNormals.resize (this->stream_geom.norm);
+                this->vertexColors.resize (this->stream_geom.col);
+                this->indices.resize (this->stream_geom.ind);
+                this->idx = this->stream_geom.idx;
+                this->drawStreams();
+                this->mark_dirty (this->posnVBO, this->stream_geom.posn, this->vertexPositions.size() - this->stream_geom.posn);
+                this->mark_dirty (this->normVBO, this->stream_geom.norm, this->vertexNormals.size() - this->stream_geom.norm);
+                this->mark_dirty (this->colVBO, this->stream_geom.col, this->vertexColors.size() - this->stream_geom.col);
+                this->mark_dirty (this->idxVBO, this->stream_geom.ind, this->indices.size() - this->stream_geom.ind);
+            }
+            this->reinit_buffers();
+        }
+
         //! Compute stuff for a graph
         void initializeVertices()
         {
@@ -1027,6 +1254,8 @@ namespace morph {
             if (this->legend == true) { this->drawLegend(); }
             this->drawTickLabels(); // from which we can store the tick label widths
             this->drawAxisLabels();
+            // Last, so that redraw_streams() can replace the streams' geometry on its own
+            if (!this->streams.empty()) { this->drawStreams(); }
         }
 
         //! Is the passed in coordinate within the graph axes (in the x/y sense, ignoring z)?
@@ -1200,6 +1429,7 @@ namespace morph {
         void drawAppendedData()
         {
             for (unsigned int dsi = 0; dsi < this->graphDataCoords.size(); ++dsi) {
+                if (this->streams.count (dsi) > 0) { continue; } // see redraw_streams
                 // Start is old end:
                 unsigned int coords_start = this->coords_lengths[dsi];
                 unsigned int coords_end = static_cast<unsigned int>(this->graphDataCoords[dsi]->size());
@@ -1217,6 +1447,8 @@ namespace morph {
                 unsigned int coords_end = this->graphDataCoords[dsi]->size();
                 // Record coords length for future appending:
                 this->coords_lengths[dsi] = coords_end;
+                // Streaming datasets are drawn after the rest of the graph (see drawStreams)
+                if (this->streams.count (dsi) > 0) { continue; }
                 this->drawDataCommon (dsi, coords_start, coords_end);
             }
         }
@@ -9,6 +9,7 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <span>
 #include <unordered_map>
 
 namespace morph {
@@ -73,6 +74,18 @@ namespace morph {
                 throw std::runtime_error ("grid is nullptr in reinitColours()");
             }
 
+            // Data coloured in the shader needs only its vertex scalars to be re-uploaded
+            if (!this->vertexScalars.empty() && this->scalarData != nullptr) {
+                if (this->scalarData->size() != static_cast<std::size_t>(this->grid->n())) {
+                    throw std::runtime_error ("GridVisual error: grid size does not match scalarData size");
+                }
+                if (this->colourScale.do_autoscale == true) { this->colourScale.reset(); }
+                this->copyScalarData();
+                this->setScalarScalingFromCScale();
+                this->reinit_scalar_buffer();
+                return;
+            }
+
             std::size_t n_data = static_cast<std::size_t>(this->grid->n());
             std::size_t n_cvertices_per_datum = 0;
             // Different gridVisModes will have generated different numbers of OpenGL colour vertices
@@ -99,6 +112,9 @@ namespace morph {
                 throw std::runtime_error ("vertexColors is not big enough to reinitColours()");
             }
 
+            // Keep the old colours, so that only the range that changes is uploaded
+            this->prev_colours = this->vertexColors;
+
             // now sub-call the scalar or vector reinit colours function
             if (this->scalarData != nullptr) {
                 this->reinitColoursScalar (n_data, n_cvertices_per_datum);
@@ -107,6 +123,10 @@ namespace morph {
             } else {
                 throw std::runtime_error ("No data to reinitColours()");
             }
+
+            // Lastly, copy the changed range of vertexColors into the OpenGL memory space
+            this->mark_changed (this->colVBO, this->prev_colours, this->vertexColors);
+            this->reinit_colour_buffer();
         }
 
     public:
@@ -354,9 +374,9 @@ namespace morph {
                 }
 
                 this->dcopy.resize (this->scalarData->size());
-                this->zScale.transform (*(this->scalarData), dcopy);
+                this->zScale.transform (std::span<const T>{ *this->scalarData }, std::span<float>{ this->dcopy });
                 this->dcolour.resize (this->scalarData->size());
-                this->colourScale.transform (*(this->scalarData), dcolour);
+                this->colourScale.transform (std::span<const T>{ *this->scalarData }, std::span<float>{ this->dcolour });
 
             } else if (this->vectorData != nullptr) {
 
@@ -450,6 +470,16 @@ namespace morph {
             if (this->options.test (gridvisual_flags::showorigin) == true) {
                 this->computeSphere (morph::vec<float>{0, 0, 0}, morph::colour::crimson, 0.25f * this->grid->get_dx()[0]);
             }
+
+            // If gpuColourMap is set, colour the pixels in the shader. The sides of Columns take
+            // colours from neighbouring pixels, so Columns are always coloured on the CPU.
+            std::size_t n_svertices_per_datum = 5; // Pixels and RectInterp
+            if (this->gridVisMode == GridVisMode::Triangles) {
+                n_svertices_per_datum = 1;
+            } else if (this->gridVisMode == GridVisMode::Columns) {
+                n_svertices_per_datum = 0;
+            }
+            this->setupScalarColouring (n_svertices_per_datum);
         }
 
         //! Initialize as a minimal, triangled surface
@@ -1155,21 +1185,25 @@ namespace morph {
         {
             if (this->colourScale.do_autoscale == true) { this->colourScale.reset(); }
             this->dcolour.resize (this->scalarData->size());
-            this->colourScale.transform (*(this->scalarData), dcolour);
+            this->colourScale.transform (std::span<const T>{ *this->scalarData }, std::span<float>{ this->dcolour });
+            const std::span<const float> dc = std::span<const float>{ this->dcolour }.first (n_data);
 
-            // Replace elements of vertexColors
-            for (std::size_t i = 0u; i < n_data; ++i) {
-                auto c = this->cm.convert (this->dcolour[i]);
-                std::size_t d_idx = 3 * i * n_cvertices_per_datum;
-                for (std::size_t j = 0; j < n_cvertices_per_datum; ++j) {
-                    this->vertexColors[d_idx + 3 * j] = c[0];
-                    this->vertexColors[d_idx + 3 * j + 1] = c[1];
-                    this->vertexColors[d_idx + 3 * j + 2] = c[2];
+            if (n_cvertices_per_datum == 1) {
+                // One colour vertex per datum, so convert straight into vertexColors
+                this->cm.convert (dc, std::span<float>{ this->vertexColors }.first (3 * n_data));
+            } else {
+                // Convert in one batch, then copy each colour to all the datum's vertices
+                this->rgbcolour.resize (3 * n_data);
+                this->cm.convert (dc, this->rgbcolour);
+                for (std::size_t i = 0u; i < n_data; ++i) {
+                    std::size_t d_idx = 3 * i * n_cvertices_per_datum;
+                    for (std::size_t j = 0; j < n_cvertices_per_datum; ++j) {
+                        this->vertexColors[d_idx + 3 * j] = this->rgbcolour[3 * i];
+                        this->vertexColors[d_idx + 3 * j + 1] = this->rgbcolour[3 * i + 1];
+                        this->vertexColors[d_idx + 3 * j + 2] = this->rgbcolour[3 * i + 2];
+                    }
                 }
             }
-
-            // Lastly, this call copies vertexColors (etc) into the OpenGL memory space
-            this->reinit_colour_buffer();
         }
 
         //! Called by reinitColours when vectorData is not null (vectors are probably RGB colour)
@@ -1198,9 +1232,6 @@ namespace morph {
                     this->vertexColors[d_idx + 3 * j + 2] = c[2];
                 }
             }
-
-            // Lastly, this call copies vertexColors (etc) into the OpenGL memory space
-            this->reinit_colour_buffer();
         }
 
         //! An overridable function to set the colour of rect ri
@@ -1232,6 +1263,8 @@ namespace morph {
         std::vector<float> dcolour;
         std::vector<float> dcolour2;
         std::vector<float> dcolour3;
+        //! The colours converted from dcolour in reinitColoursScalar (3 floats per datum)
+        std::vector<float> rgbcolour;
 
         // A centering offset to make sure that the grid is centred on
         // this->mv_offset. This is computed so that you *add* centering_offset to each
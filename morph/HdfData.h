@@ -15,9 +15,12 @@
 #include <vector>
 #include <array>
 #include <list>
+#include <map>
 #include <string>
 #include <utility>
 #include <bitset>
+#include <span>
+#include <algorithm>
 #include <cstddef>
 #include <sstream>
 #include <stdexcept>
@@ -70,6 +73,13 @@ namespace morph {
         //! The file access mode chosen by the user at construction time.
         FileAccess file_access = FileAccess::TruncateWrite;
 
+        /*!
+         * Extendable datasets (see create_series) that are held open for appending, keyed by
+         * path. Keeping them open keeps the partly filled chunk in HDF5's chunk cache, so that
+         * it is compressed and written once, when it is full or the file is closed.
+         */
+        std::map<std::string, hid_t> series;
+
         /*!
          * If there's an error in status, output a context (given by emsg) sensible
          * message and throw an exception.
@@ -289,6 +299,7 @@ namespace morph {
         //! Deconstruct, closing the file_id
         ~HdfData()
         {
+            for (auto& ds : this->series) { H5Dclose (ds.second); }
             herr_t status = H5Fclose (this->file_id);
             if (status) { std::cerr << "Error closing HDF5 file; status: " << status << std::endl; }
         }
@@ -330,9 +341,13 @@ namespace morph {
                 throw std::runtime_error (ee.str());
             }
 
-            // Read the data from HDF5 into a vector. Thereafter, copy it into the
-            // Container vals. This ensures vals can be std::list.
+            // Read the data from HDF5 directly into vals if it is contiguous (std::vector,
+            // morph::vvec). Otherwise read into a vector, then copy it into the Container
+            // vals. This ensures vals can be std::list.
+            constexpr bool contiguous = std::is_base_of<std::vector<T, Allocator>, Container<T, Allocator>>::value
+                                        && !std::is_same<T, bool>::value;
             std::vector<T> invals;
+            T* inptr = nullptr;
 
             // If cv::Point like. Could add pair<float, float> and pair<double, double>,
             // also container of array<T, 2> also.
@@ -375,8 +390,8 @@ namespace morph {
                        << ":\nError: Expected 2 coordinates to be stored in each cv::Point/array<*,2>/pair<> of " << path;
                     throw std::runtime_error (ee.str());
                 }
-                invals.resize (dims[0]);
                 vals.resize (dims[0]);
+                if constexpr (!contiguous) { invals.resize (dims[0]); }
 
             } else {
                 // If standard thing like double, float, int etc:
@@ -389,8 +404,13 @@ namespace morph {
                        << ":\nError: Expected 1D data to be stored in " << path << ". ndims=" << ndims;
                     throw std::runtime_error (ee.str());
                 }
-                invals.resize (dims[0], T{0});
                 vals.resize (dims[0], T{0});
+                if constexpr (!contiguous) { invals.resize (dims[0], T{0}); }
+            }
+            if constexpr (contiguous) {
+                inptr = vals.data();
+            } else {
+                inptr = invals.data();
             }
 
             herr_t status = 0;
@@ -399,66 +419,66 @@ namespace morph {
                           || std::is_same<typename std::decay<T>::type, std::array<float,2>>::value == true
                           || std::is_same<typename std::decay<T>::type, morph::vec<float,2>>::value == true
                           || std::is_same<typename std::decay<T>::type, std::pair<float, float>>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, double>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::array<double,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, morph::vec<double,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::pair<double, double>>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, int>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::array<int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, morph::vec<int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::pair<int, int>>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, short int>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::array<short int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, morph::vec<short int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::pair<short int, short int>>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, unsigned int>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::array<unsigned int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, morph::vec<unsigned int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::pair<unsigned int, unsigned int>>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_UINT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_UINT, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, unsigned short int>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::array<unsigned short int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, morph::vec<unsigned short int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::pair<unsigned short int, unsigned short int>>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_USHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_USHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, unsigned long long int>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::array<unsigned long long int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, morph::vec<unsigned long long int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::pair<unsigned long long int, unsigned long long int>>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_ULLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_ULLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, long long int>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::array<long long int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, morph::vec<long long int,2>>::value == true
                                  || std::is_same<typename std::decay<T>::type, std::pair<long long int, long long int>>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_LLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_LLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 
 #ifdef BUILD_HDFDATA_WITH_OPENCV
             } else if constexpr (std::is_same<typename std::decay<T>::type, cv::Point2i>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, cv::Point2d>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, cv::Point2f>::value == true) {
-                status = H5Dread (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(invals[0]));
+                status = H5Dread (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, inptr);
 #endif
             } else {
                 throw std::runtime_error ("HdfData::read_contained_vals<T>: Don't know how to read that type");
             }
 
             // Copy invals into vals
-            std::copy (invals.begin(), invals.end(), vals.begin());
+            if constexpr (!contiguous) { std::copy (invals.begin(), invals.end(), vals.begin()); }
 
             this->handle_error (status, "Error. status after H5Dread: ");
             status = H5Dclose (dataset_id);
@@ -1025,108 +1045,115 @@ namespace morph {
                 dataspace_id = H5Screate_simple (1, dim_singleparam, NULL);
             }
 
-            // A container suitable for holding the values to be written to the HDF5.
-            // vals is copied into outvals, because if vals is an std::list, it has no
-            // [] operator.
-            std::vector<T> outvals(vals.size());
-            std::copy (vals.begin(), vals.end(), outvals.begin());
+            // The values to be written to the HDF5. A contiguous vals (std::vector,
+            // morph::vvec) is written directly. Otherwise vals is copied into outvals,
+            // because if vals is an std::list, it has no [] operator.
+            std::vector<T> outvals;
+            const T* outptr = nullptr;
+            if constexpr (std::is_base_of<std::vector<T, Allocator>, Container<T, Allocator>>::value
+                          && !std::is_same<T, bool>::value) {
+                outptr = vals.data();
+            } else {
+                outvals.assign (vals.begin(), vals.end());
+                outptr = outvals.data();
+            }
 
             hid_t dataset_id = 0;
             herr_t status = 0;
             if constexpr (std::is_same<std::decay_t<T>, double>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_IEEE_F64LE, dataspace_id);
                 this->check_dataset_space_1_dim (dataset_id, vals.size());
-                status = H5Dwrite (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, float>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_IEEE_F64LE, dataspace_id);
                 this->check_dataset_space_1_dim (dataset_id, vals.size());
-                status = H5Dwrite (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, char>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_I64LE, dataspace_id);
                 this->check_dataset_space_1_dim (dataset_id, vals.size());
-                status = H5Dwrite (dataset_id, H5T_NATIVE_CHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_CHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, int>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_I64LE, dataspace_id);
                 this->check_dataset_space_1_dim (dataset_id, vals.size());
-                status = H5Dwrite (dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, long long int>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_I64LE, dataspace_id);
                 this->check_dataset_space_1_dim (dataset_id, vals.size());
-                status = H5Dwrite (dataset_id, H5T_NATIVE_LLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_LLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, unsigned int>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_U64LE, dataspace_id);
                 this->check_dataset_space_1_dim (dataset_id, vals.size());
-                status = H5Dwrite (dataset_id, H5T_NATIVE_UINT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_UINT, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<std::decay_t<T>, unsigned char>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_U64LE, dataspace_id);
                 this->check_dataset_space_1_dim (dataset_id, vals.size());
-                status = H5Dwrite (dataset_id, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, unsigned long long int>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_U64LE, dataspace_id);
                 this->check_dataset_space_1_dim (dataset_id, vals.size());
-                status = H5Dwrite (dataset_id, H5T_NATIVE_ULLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_ULLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 #ifdef BUILD_HDFDATA_WITH_OPENCV
             } else if constexpr (std::is_same<typename std::decay<T>::type, cv::Point2i>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_I64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, cv::Point2d>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_IEEE_F64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, cv::Point2f>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_IEEE_F64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 #endif
             } else if constexpr (std::is_same<typename std::decay<T>::type, std::array<float,2>>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_IEEE_F64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, std::array<double,2>>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_IEEE_F64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, std::pair<float, float>>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_IEEE_F64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, std::pair<double, double>>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_IEEE_F64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, std::pair<int, int>>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_I64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, std::pair<unsigned int, unsigned int>>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_U64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_UINT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_UINT, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, std::pair<long long int, long long int>>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_I64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_LLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_LLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else if constexpr (std::is_same<typename std::decay<T>::type, std::pair<unsigned long long int, unsigned long long int>>::value == true) {
                 dataset_id = this->open_dataset (path, H5T_STD_U64LE, dataspace_id);
                 this->check_dataset_space_2_dims (dataset_id, vals.size(), 2);
-                status = H5Dwrite (dataset_id, H5T_NATIVE_ULLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(outvals[0]));
+                status = H5Dwrite (dataset_id, H5T_NATIVE_ULLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, outptr);
 
             } else {
                 throw std::runtime_error ("HdfData::add_contained_vals<Container<T, Allocator>>: Don't know how to store that type");
@@ -1425,6 +1452,448 @@ namespace morph {
             this->handle_error (status, "Error. status after H5Sclose: ");
         }
 
+        /*!
+         * Write the values in \a vals, which may view any contiguous memory (a std::vector,
+         * morph::vvec, C array and so on), straight from that memory into a 1D dataset at \a
+         * path. Values are stored as by add_contained_vals (floats widened to 64 bits).
+         */
+        template <typename T, std::size_t E>
+        void add_contained_vals (const char* path, std::span<T, E> vals)
+        {
+            const hsize_t dims[1] = { vals.size() };
+            this->write_direct (path, vals.data(), 1, dims);
+        }
+
+        /*!
+         * Write \a vals, viewed as a matrix of \a ncols columns in row-major order, straight
+         * from memory into a 2D dataset at \a path.
+         */
+        template <typename T, std::size_t E>
+        void add_contained_vals (const char* path, std::span<T, E> vals, const hsize_t ncols)
+        {
+            if (ncols == 0 || vals.size() % ncols != 0) {
+                std::stringstream ee;
+                ee << "HdfData::add_contained_vals: " << vals.size() << " values do not fill " << ncols << " columns";
+                throw std::runtime_error (ee.str());
+            }
+            const hsize_t dims[2] = { vals.size() / ncols, ncols };
+            this->write_direct (path, vals.data(), 2, dims);
+        }
+
+        //! Write a span of morph::vec<T, N> as an N column 2D dataset, straight from memory
+        template <typename T, std::size_t N, std::size_t E>
+        void add_contained_vals (const char* path, std::span<const morph::vec<T, N>, E> vals)
+        {
+            const hsize_t dims[2] = { vals.size(), N };
+            this->write_direct (path, vals.empty() ? nullptr : vals[0].data(), 2, dims);
+        }
+        //! Write a span of non-const morph::vec<T, N> as an N column 2D dataset
+        template <typename T, std::size_t N, std::size_t E>
+        void add_contained_vals (const char* path, std::span<morph::vec<T, N>, E> vals)
+        {
+            this->add_contained_vals (path, std::span<const morph::vec<T, N>, E>(vals));
+        }
+
+        /*!
+         * Read the dataset at \a path straight into the caller's memory \a buf, with no
+         * intermediate allocation. The dataset must hold exactly buf.size() values (it may
+         * have any number of dimensions; they are read in row-major order).
+         */
+        template <typename T, std::size_t E>
+        void read_into (const char* path, std::span<T, E> buf)
+        {
+            this->read_direct (path, buf.data(), buf.size(), 0);
+        }
+
+        /*!
+         * Read the N column 2D dataset at \a path straight into \a buf, which must have one
+         * element for each row of the dataset.
+         */
+        template <typename T, std::size_t N, std::size_t E>
+        void read_into (const char* path, std::span<morph::vec<T, N>, E> buf)
+        {
+            this->read_direct (path, buf.empty() ? nullptr : buf[0].data(), buf.size() * N, N);
+        }
+
+        /*!
+         * Create an extendable dataset at \a path to hold a series of frames (for example,
+         * one frame of a model variable per output step), each of shape \a frame_shape. Add
+         * frames with append_frame() and read them back with read_frames().
+         *
+         * The dataset is stored in chunks of \a chunk_frames frames. If \a deflate_level is
+         * non-zero (1 to 9) the chunks are compressed with zlib, after a byte shuffle if \a
+         * shuffle is true (which usually improves the compression of floating point data).
+         * If \a store_native is true, values are stored on disk with the precision of T;
+         * otherwise they are widened as they are by add_contained_vals (float to 64 bit
+         * float, integers to 64 bit integers).
+         */
+        template <typename T>
+        void create_series (const char* path, const std::vector<hsize_t>& frame_shape,
+                            const hsize_t chunk_frames = 1, const unsigned int deflate_level = 0,
+                            const bool shuffle = false, const bool store_native = true)
+        {
+            if (chunk_frames == 0) { throw std::runtime_error ("HdfData::create_series: chunk_frames must be > 0"); }
+            if (deflate_level > 0 && H5Zfilter_avail (H5Z_FILTER_DEFLATE) <= 0) {
+                throw std::runtime_error ("HdfData::create_series: The HDF5 library has no deflate filter");
+            }
+            this->process_groups (path);
+
+            const int rank = static_cast<int>(frame_shape.size()) + 1;
+            std::vector<hsize_t> dims (rank, 0);
+            std::vector<hsize_t> maxdims (rank, H5S_UNLIMITED);
+            std::vector<hsize_t> chunk (rank, chunk_frames);
+            for (int i = 1; i < rank; ++i) { dims[i] = maxdims[i] = chunk[i] = frame_shape[i - 1]; }
+            hid_t dataspace_id = H5Screate_simple (rank, dims.data(), maxdims.data());
+
+            hid_t dcpl = H5Pcreate (H5P_DATASET_CREATE);
+            herr_t status = H5Pset_chunk (dcpl, rank, chunk.data());
+            this->handle_error (status, "Error. status after H5Pset_chunk: ");
+            if (deflate_level > 0) {
+                if (shuffle) {
+                    status = H5Pset_shuffle (dcpl);
+                    this->handle_error (status, "Error. status after H5Pset_shuffle: ");
+                }
+                status = H5Pset_deflate (dcpl, deflate_level);
+                this->handle_error (status, "Error. status after H5Pset_deflate: ");
+            }
+
+            const hid_t ftype = HdfData::file_type<T> (store_native);
+            hid_t dapl = HdfData::series_access (chunk, H5Tget_size (ftype));
+            hid_t dataset_id = H5Dcreate2 (this->file_id, path, ftype, dataspace_id, H5P_DEFAULT, dcpl, dapl);
+            H5Pclose (dapl);
+            if (dataset_id < 0) {
+                H5Pclose (dcpl);
+                H5Sclose (dataspace_id);
+                std::stringstream ee;
+                ee << "HdfData::create_series: Failed to create the dataset " << path;
+                throw std::runtime_error (ee.str());
+            }
+            this->close_series (path);
+            this->series[path] = dataset_id;
+
+            status = H5Pclose (dcpl);
+            this->handle_error (status, "Error. status after H5Pclose: ");
+            status = H5Sclose (dataspace_id);
+            this->handle_error (status, "Error. status after H5Sclose: ");
+        }
+
+        /*!
+         * Append one frame to the series at \a path (which must have been made with
+         * create_series, in this or an earlier session). \a frame holds the values of the
+         * frame in row-major order.
+         */
+        template <typename T>
+        void append_frame (const char* path, const std::vector<T>& frame)
+        {
+            this->append_frames (path, frame.data(), frame.size());
+        }
+
+        /*!
+         * Append \a nvals values, which must make up a whole number of frames, to the series at
+         * \a path.
+         */
+        template <typename T>
+        void append_frames (const char* path, const T* vals, const hsize_t nvals)
+        {
+            hid_t dataset_id = this->open_series (path);
+            hid_t space_id = H5Dget_space (dataset_id);
+            const int rank = H5Sget_simple_extent_ndims (space_id);
+            std::vector<hsize_t> dims (rank, 0);
+            H5Sget_simple_extent_dims (space_id, dims.data(), NULL);
+            H5Sclose (space_id);
+
+            hsize_t framesize = 1;
+            for (int i = 1; i < rank; ++i) { framesize *= dims[i]; }
+            if (framesize == 0 || nvals % framesize != 0) {
+                std::stringstream ee;
+                ee << "HdfData::append_frames: " << nvals << " values is not a whole number of frames of "
+                   << framesize << " values in " << path;
+                throw std::runtime_error (ee.str());
+            }
+            const hsize_t nframes = nvals / framesize;
+            if (nframes == 0) { return; }
+
+            // Extend the dataset and write into the new frames
+            std::vector<hsize_t> newdims = dims;
+            newdims[0] += nframes;
+            herr_t status = H5Dset_extent (dataset_id, newdims.data());
+            this->handle_error (status, "Error. status after H5Dset_extent: ");
+
+            std::vector<hsize_t> start (rank, 0);
+            start[0] = dims[0];
+            std::vector<hsize_t> count = newdims;
+            count[0] = nframes;
+            hid_t filespace_id = H5Dget_space (dataset_id);
+            status = H5Sselect_hyperslab (filespace_id, H5S_SELECT_SET, start.data(), NULL, count.data(), NULL);
+            this->handle_error (status, "Error. status after H5Sselect_hyperslab: ");
+            hid_t memspace_id = H5Screate_simple (rank, count.data(), NULL);
+            status = H5Dwrite (dataset_id, HdfData::mem_type<T>(), memspace_id, filespace_id, H5P_DEFAULT, vals);
+            this->handle_error (status, "Error. status after H5Dwrite (series): ");
+            status = H5Sclose (memspace_id);
+            this->handle_error (status, "Error. status after H5Sclose: ");
+            status = H5Sclose (filespace_id);
+            this->handle_error (status, "Error. status after H5Sclose: ");
+        }
+
+        //! The number of frames in the series at \a path, or 0 if there is no such dataset
+        hsize_t series_length (const char* path)
+        {
+            std::vector<hsize_t> dims = this->series_dims (path);
+            return dims.empty() ? 0 : dims[0];
+        }
+
+        /*!
+         * Read \a count frames of the series at \a path, starting from frame \a first, into \a
+         * vals (which is resized to hold them) as a hyperslab. Only the selected frames are
+         * read (and decompressed) from the file.
+         */
+        template <typename T>
+        void read_frames (const char* path, const hsize_t first, const hsize_t count, std::vector<T>& vals)
+        {
+            hid_t dataset_id = -1;
+            bool close_after = false;
+            auto si = this->series.find (path);
+            if (si != this->series.end()) {
+                dataset_id = si->second;
+            } else {
+                dataset_id = H5Dopen2 (this->file_id, path, H5P_DEFAULT);
+                if (this->check_dataset_id (dataset_id, path) == -1) { return; }
+                close_after = true;
+            }
+
+            hid_t filespace_id = H5Dget_space (dataset_id);
+            const int rank = H5Sget_simple_extent_ndims (filespace_id);
+            std::vector<hsize_t> dims (rank, 0);
+            H5Sget_simple_extent_dims (filespace_id, dims.data(), NULL);
+            if (rank < 1 || first + count > dims[0]) {
+                H5Sclose (filespace_id);
+                if (close_after) { H5Dclose (dataset_id); }
+                std::stringstream ee;
+                ee << "HdfData::read_frames: Frames " << first << " to " << (first + count)
+                   << " are out of range for " << path << " (" << (rank < 1 ? 0 : dims[0]) << " frames)";
+                throw std::runtime_error (ee.str());
+            }
+
+            std::vector<hsize_t> start (rank, 0);
+            start[0] = first;
+            std::vector<hsize_t> cnt = dims;
+            cnt[0] = count;
+            hsize_t nvals = 1;
+            for (int i = 0; i < rank; ++i) { nvals *= cnt[i]; }
+            vals.resize (nvals);
+
+            herr_t status = 0;
+            if (nvals > 0) {
+                status = H5Sselect_hyperslab (filespace_id, H5S_SELECT_SET, start.data(), NULL, cnt.data(), NULL);
+                this->handle_error (status, "Error. status after H5Sselect_hyperslab: ");
+                hid_t memspace_id = H5Screate_simple (rank, cnt.data(), NULL);
+                status = H5Dread (dataset_id, HdfData::mem_type<T>(), memspace_id, filespace_id, H5P_DEFAULT, vals.data());
+                this->handle_error (status, "Error. status after H5Dread (series): ");
+                status = H5Sclose (memspace_id);
+                this->handle_error (status, "Error. status after H5Sclose: ");
+            }
+            status = H5Sclose (filespace_id);
+            this->handle_error (status, "Error. status after H5Sclose: ");
+            if (close_after) {
+                status = H5Dclose (dataset_id);
+                this->handle_error (status, "Error. status after H5Dclose: ");
+            }
+        }
+
+        /*!
+         * Close the series at \a path, if it is held open for appending. Series are closed
+         * when the HdfData is destroyed, so this need only be called to release the memory
+         * used for the series' chunk cache early.
+         */
+        void close_series (const char* path)
+        {
+            auto si = this->series.find (path);
+            if (si != this->series.end()) {
+                herr_t status = H5Dclose (si->second);
+                this->series.erase (si);
+                this->handle_error (status, "Error. status after H5Dclose: ");
+            }
+        }
+
+    private:
+        //! Write n-dimensional data straight from \a data into the dataset at \a path
+        template <typename T>
+        void write_direct (const char* path, const T* data, const int rank, const hsize_t* dims)
+        {
+            hsize_t n = 1;
+            for (int i = 0; i < rank; ++i) { n *= dims[i]; }
+            if (n == 0) { return; }
+            this->process_groups (path);
+            hid_t dataspace_id = H5Screate_simple (rank, dims, NULL);
+            hid_t dataset_id = this->open_dataset (path, HdfData::file_type<T> (false), dataspace_id);
+            if (rank == 1) {
+                this->check_dataset_space_1_dim (dataset_id, dims[0]);
+            } else if (rank == 2) {
+                this->check_dataset_space_2_dims (dataset_id, dims[0], dims[1]);
+            }
+            herr_t status = H5Dwrite (dataset_id, HdfData::mem_type<T>(), H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+            this->handle_error (status, "Error. status after H5Dwrite (direct): ");
+            status = H5Dclose (dataset_id);
+            this->handle_error (status, "Error. status after H5Dclose: ");
+            status = H5Sclose (dataspace_id);
+            this->handle_error (status, "Error. status after H5Sclose: ");
+        }
+
+        /*!
+         * Read the dataset at \a path, which must have \a n values, straight into \a data. If
+         * \a ncols is non-zero, the dataset must be 2D with ncols columns.
+         */
+        template <typename T>
+        void read_direct (const char* path, T* data, const hsize_t n, const hsize_t ncols)
+        {
+            hid_t dataset_id = H5Dopen2 (this->file_id, path, H5P_DEFAULT);
+            if (this->check_dataset_id (dataset_id, path) == -1) { return; }
+            hid_t space_id = H5Dget_space (dataset_id);
+            const int rank = H5Sget_simple_extent_ndims (space_id);
+            std::vector<hsize_t> dims (rank > 0 ? rank : 0, 0);
+            H5Sget_simple_extent_dims (space_id, dims.data(), NULL);
+            H5Sclose (space_id);
+            hsize_t nstored = 1;
+            for (hsize_t d : dims) { nstored *= d; }
+            if (nstored != n || (ncols > 0 && (rank != 2 || dims[1] != ncols))) {
+                H5Dclose (dataset_id);
+                std::stringstream ee;
+                ee << "HdfData::read_into: " << path << " holds " << nstored << " values in " << rank
+                   << " dimension(s); the buffer has space for " << n << " values";
+                if (ncols > 0) { ee << " in " << ncols << " columns"; }
+                throw std::runtime_error (ee.str());
+            }
+            herr_t status = 0;
+            if (n > 0) {
+                status = H5Dread (dataset_id, HdfData::mem_type<T>(), H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+                this->handle_error (status, "Error. status after H5Dread (direct): ");
+            }
+            status = H5Dclose (dataset_id);
+            this->handle_error (status, "Error. status after H5Dclose: ");
+        }
+
+        //! The HDF5 memory type for T
+        template <typename T>
+        static hid_t mem_type()
+        {
+            if constexpr (std::is_same<std::decay_t<T>, float>::value == true) {
+                return H5T_NATIVE_FLOAT;
+            } else if constexpr (std::is_same<std::decay_t<T>, double>::value == true) {
+                return H5T_NATIVE_DOUBLE;
+            } else if constexpr (std::is_same<std::decay_t<T>, char>::value == true) {
+                return H5T_NATIVE_CHAR;
+            } else if constexpr (std::is_same<std::decay_t<T>, unsigned char>::value == true) {
+                return H5T_NATIVE_UCHAR;
+            } else if constexpr (std::is_same<std::decay_t<T>, short int>::value == true) {
+                return H5T_NATIVE_SHORT;
+            } else if constexpr (std::is_same<std::decay_t<T>, unsigned short int>::value == true) {
+                return H5T_NATIVE_USHORT;
+            } else if constexpr (std::is_same<std::decay_t<T>, int>::value == true) {
+                return H5T_NATIVE_INT;
+            } else if constexpr (std::is_same<std::decay_t<T>, unsigned int>::value == true) {
+                return H5T_NATIVE_UINT;
+            } else if constexpr (std::is_same<std::decay_t<T>, long long int>::value == true) {
+                return H5T_NATIVE_LLONG;
+            } else if constexpr (std::is_same<std::decay_t<T>, unsigned long long int>::value == true) {
+                return H5T_NATIVE_ULLONG;
+            } else {
+                []<bool flag = false>() { static_assert(flag, "HdfData: Don't know how to store that type"); }();
+                return -1;
+            }
+        }
+
+        //! The HDF5 file type for T, optionally widened as add_contained_vals does
+        template <typename T>
+        static hid_t file_type (const bool store_native)
+        {
+            if constexpr (std::is_floating_point<std::decay_t<T>>::value == true) {
+                return (store_native && sizeof(T) == 4) ? H5T_IEEE_F32LE : H5T_IEEE_F64LE;
+            } else if constexpr (std::is_signed<std::decay_t<T>>::value == true) {
+                if (!store_native) { return H5T_STD_I64LE; }
+                if constexpr (sizeof(T) == 1) { return H5T_STD_I8LE; }
+                else if constexpr (sizeof(T) == 2) { return H5T_STD_I16LE; }
+                else if constexpr (sizeof(T) == 4) { return H5T_STD_I32LE; }
+                else { return H5T_STD_I64LE; }
+            } else {
+                if (!store_native) { return H5T_STD_U64LE; }
+                if constexpr (sizeof(T) == 1) { return H5T_STD_U8LE; }
+                else if constexpr (sizeof(T) == 2) { return H5T_STD_U16LE; }
+                else if constexpr (sizeof(T) == 4) { return H5T_STD_U32LE; }
+                else { return H5T_STD_U64LE; }
+            }
+        }
+
+        /*!
+         * Make a dataset access property list with a chunk cache that can hold a couple of
+         * chunks of dimensions \a chunk, of elements of \a elemsize bytes. The default cache
+         * is 1 MB, which is less than a chunk of a few frames of a large grid. The caller
+         * closes the list.
+         */
+        static hid_t series_access (const std::vector<hsize_t>& chunk, size_t elemsize)
+        {
+            size_t chunkbytes = elemsize;
+            for (hsize_t c : chunk) { chunkbytes *= c; }
+            hid_t dapl = H5Pcreate (H5P_DATASET_ACCESS);
+            H5Pset_chunk_cache (dapl, 521, std::max (size_t{1} << 20, 2 * chunkbytes), 1.0);
+            return dapl;
+        }
+
+        //! Get the open dataset for the series at path, opening it if necessary
+        hid_t open_series (const char* path)
+        {
+            auto si = this->series.find (path);
+            if (si != this->series.end()) { return si->second; }
+
+            hid_t dataset_id = H5Dopen2 (this->file_id, path, H5P_DEFAULT);
+            if (dataset_id < 0) {
+                std::stringstream ee;
+                ee << "HdfData::append_frames: There is no series " << path << " (see HdfData::create_series)";
+                throw std::runtime_error (ee.str());
+            }
+            // Re-open with a chunk cache sized for the dataset's chunks
+            hid_t dcpl = H5Dget_create_plist (dataset_id);
+            if (H5Pget_layout (dcpl) != H5D_CHUNKED) {
+                H5Pclose (dcpl);
+                H5Dclose (dataset_id);
+                std::stringstream ee;
+                ee << "HdfData::append_frames: " << path << " is not an extendable (chunked) dataset";
+                throw std::runtime_error (ee.str());
+            }
+            std::vector<hsize_t> chunk (H5Pget_chunk (dcpl, 0, NULL), 0);
+            H5Pget_chunk (dcpl, static_cast<int>(chunk.size()), chunk.data());
+            H5Pclose (dcpl);
+            hid_t dtype = H5Dget_type (dataset_id);
+            hid_t dapl = HdfData::series_access (chunk, H5Tget_size (dtype));
+            H5Tclose (dtype);
+            H5Dclose (dataset_id);
+            dataset_id = H5Dopen2 (this->file_id, path, dapl);
+            H5Pclose (dapl);
+            this->series[path] = dataset_id;
+            return dataset_id;
+        }
+
+        //! The dimensions of the dataset at path (empty if there is no such dataset)
+        std::vector<hsize_t> series_dims (const char* path)
+        {
+            std::vector<hsize_t> dims;
+            hid_t dataset_id = -1;
+            auto si = this->series.find (path);
+            if (si != this->series.end()) {
+                dataset_id = si->second;
+            } else {
+                if (H5Lexists (this->file_id, path, H5P_DEFAULT) <= 0) { return dims; }
+                dataset_id = H5Dopen2 (this->file_id, path, H5P_DEFAULT);
+                if (dataset_id < 0) { return dims; }
+            }
+            hid_t space_id = H5Dget_space (dataset_id);
+            dims.resize (H5Sget_simple_extent_ndims (space_id));
+            H5Sget_simple_extent_dims (space_id, dims.data(), NULL);
+            H5Sclose (space_id);
+            if (si == this->series.end()) { H5Dclose (dataset_id); }
+            return dims;
+        }
+
+    public:
 #ifdef BUILD_HDFDATA_WITH_OPENCV
         /*!
          * Read an OpenCV Matrix that was stored with the sister add_contained_vals
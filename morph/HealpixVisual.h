@@ -191,45 +191,55 @@ namespace morph {
                                                             {10, {7 | 4<<8,  11 | 4<<8 }},
                                                             {11, {4 | 4<<8,  8  | 4<<8 }}  };
 
+        /*
+         * The vertex for the pixel with NEST index p. When making a coarser level of detail,
+         * nside is temporarily lowered and p is a coarse pixel, which is drawn with the vertex of
+         * its first full detail sub-pixel (whose NEST index is p * 4^lod_order_drop).
+         */
+        GLuint vertex_of (const int64_t p) const
+        {
+            return this->pixel_vertex0 + static_cast<GLuint>(p << (2 * this->lod_order_drop));
+        }
+
         // corners to be in rotated order
         void fill_square (const std::array<hp::t_hpd, 4>& corners)
         {
             int64_t c0 = hp::hpd2nest (this->nside, corners[0]);
             int64_t c2 = hp::hpd2nest (this->nside, corners[2]);
-            this->indices.push_back (this->idx + c0);
-            this->indices.push_back (this->idx + hp::hpd2nest (this->nside, corners[1]));
-            this->indices.push_back (this->idx + c2);
-            this->indices.push_back (this->idx + c0);
-            this->indices.push_back (this->idx + c2);
-            this->indices.push_back (this->idx + hp::hpd2nest (this->nside, corners[3]));
+            this->indices.push_back (this->vertex_of (c0));
+            this->indices.push_back (this->vertex_of (hp::hpd2nest (this->nside, corners[1])));
+            this->indices.push_back (this->vertex_of (c2));
+            this->indices.push_back (this->vertex_of (c0));
+            this->indices.push_back (this->vertex_of (c2));
+            this->indices.push_back (this->vertex_of (hp::hpd2nest (this->nside, corners[3])));
         }
 
         void fill_triangle (const std::array<hp::t_hpd, 3>& corners)
         {
-            this->indices.push_back (this->idx + hp::hpd2nest (this->nside, corners[0]));
-            this->indices.push_back (this->idx + hp::hpd2nest (this->nside, corners[1]));
-            this->indices.push_back (this->idx + hp::hpd2nest (this->nside, corners[2]));
+            this->indices.push_back (this->vertex_of (hp::hpd2nest (this->nside, corners[0])));
+            this->indices.push_back (this->vertex_of (hp::hpd2nest (this->nside, corners[1])));
+            this->indices.push_back (this->vertex_of (hp::hpd2nest (this->nside, corners[2])));
         }
 
         // corners to be in raster order
         void fill_square (const morph::vec<int64_t, 4>& corners_nest)
         {
-            this->indices.push_back (this->idx + corners_nest[0]);
-            this->indices.push_back (this->idx + corners_nest[1]);
-            this->indices.push_back (this->idx + corners_nest[2]);
-            this->indices.push_back (this->idx + corners_nest[1]);
-            this->indices.push_back (this->idx + corners_nest[3]);
-            this->indices.push_back (this->idx + corners_nest[2]);
+            this->indices.push_back (this->vertex_of (corners_nest[0]));
+            this->indices.push_back (this->vertex_of (corners_nest[1]));
+            this->indices.push_back (this->vertex_of (corners_nest[2]));
+            this->indices.push_back (this->vertex_of (corners_nest[1]));
+            this->indices.push_back (this->vertex_of (corners_nest[3]));
+            this->indices.push_back (this->vertex_of (corners_nest[2]));
         }
         // corners to be in raster order
         void fill_square (const int64_t c0, const int64_t c1, const int64_t c2, const int64_t c3)
         {
-            this->indices.push_back (this->idx + c0);
-            this->indices.push_back (this->idx + c1);
-            this->indices.push_back (this->idx + c2);
-            this->indices.push_back (this->idx + c1);
-            this->indices.push_back (this->idx + c3);
-            this->indices.push_back (this->idx + c2);
+            this->indices.push_back (this->vertex_of (c0));
+            this->indices.push_back (this->vertex_of (c1));
+            this->indices.push_back (this->vertex_of (c2));
+            this->indices.push_back (this->vertex_of (c1));
+            this->indices.push_back (this->vertex_of (c3));
+            this->indices.push_back (this->vertex_of (c2));
         }
 
         // Fill the channel between faces and their neighbour to the NE.
@@ -403,7 +413,42 @@ namespace morph {
                 this->vertex_push (vpf, this->vertexNormals);
             }
 
-            // Now draw indices
+            // Now draw indices. Any coarser levels of detail will replace these.
+            this->pixel_vertex0 = this->idx;
+            const std::size_t first_index = this->indices.size();
+            this->healpix_indices();
+            this->lod_detail = { first_index, this->indices.size() - first_index, 0.0f };
+
+            this->idx += n_p;
+        }
+
+        /*
+         * Add coarser levels of detail for the HEALPix made by healpix_triangles_by_nest(). These
+         * go after all of the other indices in the model. Each has one order fewer than the last
+         * and re-uses the full detail vertices (so each coarse pixel shows the colour of one of
+         * its sub-pixels).
+         */
+        void healpix_lod_levels()
+        {
+            const int64_t full_k = this->k;
+            const int64_t full_nside = this->nside;
+            for (int64_t lk = full_k - 1; lk >= 1 && lk >= full_k - this->detail_levels; --lk) {
+                this->k = lk;
+                this->nside = 1LL << lk;
+                this->lod_order_drop = full_k - lk;
+                const std::size_t first = this->indices.size();
+                this->healpix_indices();
+                // A pixel subtends about 1.02 / nside radians
+                this->add_lod_level (first, this->lod_facet_size * static_cast<float>(this->nside) / (1.02f / 2.0f));
+            }
+            this->k = full_k;
+            this->nside = full_nside;
+            this->lod_order_drop = 0;
+        }
+
+        // Add the triangle indices for the HEALPix of order k (or a coarser level; see vertex_of)
+        void healpix_indices()
+        {
             int64_t k_down = this->k - 1;
             int64_t nside_down = 1LL << k_down;
             for (int32_t f = 0; f < 12; ++f) { // 12 'faces' of the HEALPix
@@ -447,8 +492,6 @@ namespace morph {
 
             // Last job is to fill in the channels. Maybe use xy indexing for this task.
             this->fill_channels();
-
-            this->idx += n_p;
         }
 
         void initializeVertices()
@@ -461,6 +504,7 @@ namespace morph {
             this->healpix_triangles_by_nest();
             if (this->show_spheres == true) { this->vertex_spheres(); }
             if (this->indicate_axes == true) { this->draw_coordaxes(); }
+            this->healpix_lod_levels();
 
             // If required, populated the angles lookup map
             if (this->enable_angles_map && this->angles.empty()) { this->populate_angles(); }
@@ -583,10 +627,18 @@ namespace morph {
         // Show a little coordinate axes set indicating directions?
         bool indicate_axes = false;
 
+        // The number of coarser levels of detail (each of one lower order) to draw when the
+        // HEALPix is small on screen. Set before finalize().
+        int64_t detail_levels = 0;
+
     private:
         // How many sides for the healpix? This is a choice of the user. Default to 3.
         int64_t k = 3; // k is the 'order'
         int64_t nside = 1 << k;
+        // The vertex of pixel 0
+        GLuint pixel_vertex0 = 0;
+        // While making a coarser level of detail, the number of orders below k
+        int64_t lod_order_drop = 0;
     };
 
 } // namespace morph
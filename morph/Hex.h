@@ -12,6 +12,9 @@
 #include <list>
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
 #include <morph/BezCoord.h>
 // If the HexGrid::save and HexGrid::load methods are required, define
 // HEXGRID_COMPILE_LOAD_AND_SAVE. A link to libhdf5 will be required in your program.
@@ -20,6 +23,12 @@
 #endif
 #include <morph/mathconst.h>
 #include <morph/vec.h>
+// If HEXGRID_CONTIGUOUS_STORAGE is defined, the Hexes of a HexGrid are held in a
+// morph::hexarena rather than a std::list. This must be defined (or not) consistently across
+// all translation units of a program.
+#ifdef HEXGRID_CONTIGUOUS_STORAGE
+# include <morph/hexarena.h>
+#endif
 //#define DEBUG_WITH_COUT 1
 #ifdef DEBUG_WITH_COUT
 #include <iostream>
@@ -88,6 +97,73 @@
 
 namespace morph {
 
+    class Hex;
+
+    //! The container that holds the Hexes in a HexGrid (see HEXGRID_CONTIGUOUS_STORAGE)
+#ifdef HEXGRID_CONTIGUOUS_STORAGE
+    using hexlist = morph::hexarena<Hex>;
+#else
+    using hexlist = std::list<Hex>;
+#endif
+
+#ifdef HEXGRID_CONTIGUOUS_STORAGE
+    struct HexLinks;
+
+    /*!
+     * One neighbour link of a Hex held in a hexarena: the 32-bit index of the neighbour in the
+     * arena's storage. It converts to and from hexlist::iterator and dereferences like one, so
+     * that code written for iterator links (hi->ne->vi, hi2 = hi->nse, h.ne = it) compiles
+     * unchanged. D is the position of the link in HexLinks.
+     */
+    template <unsigned int D>
+    class HexLink
+    {
+    public:
+        HexLink& operator= (hexlist::iterator it);
+        operator hexlist::iterator() const;
+        Hex* operator->() const;
+        Hex& operator*() const;
+        //! The index of the neighbour in the arena's storage
+        uint32_t index() const { return this->idx; }
+
+    private:
+        //! The HexLinks of which this link is a member
+        const HexLinks& links() const;
+        uint32_t idx = 0;
+    };
+
+    /*!
+     * The neighbour links of a Hex when HEXGRID_CONTIGUOUS_STORAGE is defined. The six links
+     * are 32-bit indices into the storage of the hexarena that holds the Hex, and are resolved
+     * against the storage base held here. That is 32 bytes per Hex rather than 48 for six
+     * iterators. As for an iterator, a copy of a Hex still links into the original arena.
+     */
+    struct HexLinks
+    {
+        //! hexarena passes the base of its storage whenever this Hex is stored or moved
+        void attach_arena (const void* storage) { this->arena = storage; }
+        //! The byte offset of link \a d within HexLinks
+        static constexpr std::size_t offset (unsigned int d) { return sizeof (const void*) + d * sizeof (uint32_t); }
+
+        //! The base of the storage of the hexarena that holds this Hex
+        const void* arena = nullptr;
+        //! Nearest neighbour to the East; in the plus r direction.
+        HexLink<0> ne;
+        //! Nearest neighbour to the NorthEast; in the plus g direction.
+        HexLink<1> nne;
+        //! Nearest neighbour to the NorthWest; in the plus b direction.
+        HexLink<2> nnw;
+        //! Nearest neighbour to the West; in the minus r direction.
+        HexLink<3> nw;
+        //! Nearest neighbour to the SouthWest; in the minus g direction.
+        HexLink<4> nsw;
+        //! Nearest neighbour to the SouthEast; in the minus b direction.
+        HexLink<5> nse;
+    };
+    static_assert (std::is_standard_layout_v<HexLinks>);
+    static_assert (offsetof (HexLinks, ne) == HexLinks::offset (0) && offsetof (HexLinks, nse) == HexLinks::offset (5));
+#endif
+
     /*!
      * Describes a regular hexagon arranged with vertices pointing vertically and two flat sides
      * perpendicular to the horizontal axis:
@@ -121,6 +197,9 @@ namespace morph {
      * Edges/Sides: East: 0, North-East: 1, North-West: 2 West: 3, South-West: 4, South-East: 5
      */
     class Hex
+#ifdef HEXGRID_CONTIGUOUS_STORAGE
+        : public HexLinks
+#endif
     {
     public:
         /*!
@@ -591,37 +670,37 @@ namespace morph {
         }
 
         //! Set that \a it is the Neighbour to the East
-        void set_ne (std::list<Hex>::iterator it)
+        void set_ne (hexlist::iterator it)
         {
             this->ne = it;
             this->flags |= HEX_HAS_NE;
         }
         //! Set that \a it is the Neighbour to the North East
-        void set_nne (std::list<Hex>::iterator it)
+        void set_nne (hexlist::iterator it)
         {
             this->nne = it;
             this->flags |= HEX_HAS_NNE;
         }
         //! Set that \a it is the Neighbour to the North West
-        void set_nnw (std::list<Hex>::iterator it)
+        void set_nnw (hexlist::iterator it)
         {
             this->nnw = it;
             this->flags |= HEX_HAS_NNW;
         }
         //! Set that \a it is the Neighbour to the West
-        void set_nw (std::list<Hex>::iterator it)
+        void set_nw (hexlist::iterator it)
         {
             this->nw = it;
             this->flags |= HEX_HAS_NW;
         }
         //! Set that \a it is the Neighbour to the South West
-        void set_nsw (std::list<Hex>::iterator it)
+        void set_nsw (hexlist::iterator it)
         {
             this->nsw = it;
             this->flags |= HEX_HAS_NSW;
         }
         //! Set that \a it is the Neighbour to the South East
-        void set_nse (std::list<Hex>::iterator it)
+        void set_nse (hexlist::iterator it)
         {
             this->nse = it;
             this->flags |= HEX_HAS_NSE;
@@ -698,13 +777,30 @@ namespace morph {
             return false;
         }
 
+        /*!
+         * Set that \a it is the neighbour at position \a ni.
+         * East: 0, North-East: 1, North-West: 2, West: 3, South-West: 4, South-East: 5
+         */
+        void set_neighbour (unsigned short ni, hexlist::iterator it)
+        {
+            switch (ni) {
+            case HEX_NEIGHBOUR_POS_E: { this->set_ne (it); break; }
+            case HEX_NEIGHBOUR_POS_NE: { this->set_nne (it); break; }
+            case HEX_NEIGHBOUR_POS_NW: { this->set_nnw (it); break; }
+            case HEX_NEIGHBOUR_POS_W: { this->set_nw (it); break; }
+            case HEX_NEIGHBOUR_POS_SW: { this->set_nsw (it); break; }
+            case HEX_NEIGHBOUR_POS_SE: { this->set_nse (it); break; }
+            default: { break; }
+            }
+        }
+
         /*!
          * Get a list<Hex>::iterator to the neighbour at position \a ni.
          * East: 0, North-East: 1, North-West: 2, West: 3, South-West: 4, South-East: 5
          */
-        std::list<Hex>::iterator get_neighbour (unsigned short ni) const
+        hexlist::iterator get_neighbour (unsigned short ni) const
         {
-            std::list<Hex>::iterator hi;
+            hexlist::iterator hi;
             switch (ni) {
             case HEX_NEIGHBOUR_POS_E:
             {
@@ -963,26 +1059,52 @@ namespace morph {
             }
         }
 
+#ifndef HEXGRID_CONTIGUOUS_STORAGE
         /*
-         * Nearest neighbours
+         * Nearest neighbours (with HEXGRID_CONTIGUOUS_STORAGE, these are in HexLinks)
          */
 
         //! Nearest neighbour to the East; in the plus r direction.
-        std::list<Hex>::iterator ne;
+        hexlist::iterator ne;
         //! Nearest neighbour to the NorthEast; in the plus g direction.
-        std::list<Hex>::iterator nne;
+        hexlist::iterator nne;
         //! Nearest neighbour to the NorthWest; in the plus b direction.
-        std::list<Hex>::iterator nnw;
+        hexlist::iterator nnw;
         //! Nearest neighbour to the West; in the minus r direction.
-        std::list<Hex>::iterator nw;
+        hexlist::iterator nw;
         //! Nearest neighbour to the SouthWest; in the minus g direction.
-        std::list<Hex>::iterator nsw;
+        hexlist::iterator nsw;
         //! Nearest neighbour to the SouthEast; in the minus b direction.
-        std::list<Hex>::iterator nse;
+        hexlist::iterator nse;
+#endif
 
     private:
         //! The flags for this Hex.
         unsigned int flags = 0x0;
     };
 
+#ifdef HEXGRID_CONTIGUOUS_STORAGE
+    template <unsigned int D>
+    const HexLinks& HexLink<D>::links() const
+    {
+        return *reinterpret_cast<const HexLinks*>(reinterpret_cast<const char*>(this) - HexLinks::offset (D));
+    }
+
+    template <unsigned int D>
+    HexLink<D>& HexLink<D>::operator= (hexlist::iterator it)
+    {
+        this->idx = hexlist::index_of (this->links().arena, it);
+        return *this;
+    }
+
+    template <unsigned int D>
+    HexLink<D>::operator hexlist::iterator() const { return hexlist::at (this->links().arena, this->idx); }
+
+    template <unsigned int D>
+    Hex* HexLink<D>::operator->() const { return &*hexlist::at (this->links().arena, this->idx); }
+
+    template <unsigned int D>
+    Hex& HexLink<D>::operator*() const { return *hexlist::at (this->links().arena, this->idx); }
+#endif
+
 } // namespace morph
@@ -17,6 +17,9 @@
 #include <morph/MathAlgo.h>
 #include <morph/debug.h>
 #include <morph/mat22.h>
+#include <morph/resample.h>
+#include <morph/lattice_index.h>
+#include <morph/gridcache.h>
 
 // If the HexGrid::save and HexGrid::load methods are required, define
 // HEXGRID_COMPILE_LOAD_AND_SAVE. A link to libhdf5 will be required in your program.
@@ -36,6 +39,12 @@
 #include <vector>
 #include <stdexcept>
 #include <limits>
+#include <algorithm>
+#include <unordered_map>
+#include <iterator>
+#include <cstdint>
+#include <cstring>
+#include <utility>
 
 namespace morph {
 
@@ -96,6 +105,20 @@ namespace morph {
         alignas(8) std::vector<int> d_nsw;
         alignas(8) std::vector<int> d_nse;
 
+        /*!
+         * A flat, padded neighbour table with the six neighbour directions stored one after the
+         * other (structure of arrays). The index of the neighbour of hex hi in direction dir is
+         * d_nbr[dir * d_size_nbr + hi], where dir is one of HEX_NEIGHBOUR_POS_E,
+         * HEX_NEIGHBOUR_POS_NE, ... HEX_NEIGHBOUR_POS_SE. Where a hex has no neighbour, the
+         * entry points at the hex itself, so that stencils reading from d_nbr see a 'ghost'
+         * neighbour with the same value as the hex (a no-flux boundary) without having to test
+         * for the neighbour's existence.
+         */
+        alignas(8) std::vector<unsigned int> d_nbr;
+
+        //! The stride between the directions in d_nbr (the number of hexes when d_nbr was built)
+        unsigned int d_size_nbr = 0;
+
         /*!
          * Flags, such as "on boundary", "inside boundary", "outside boundary", "has
          * neighbour east", etc.
@@ -134,7 +157,7 @@ namespace morph {
         unsigned int d_growthbuffer_vert = 0;
 
         //! Add entries to all the d_ vectors for the Hex pointed to by hi.
-        void d_push_back (std::list<Hex>::iterator hi)
+        void d_push_back (hexlist::iterator hi)
         {
             d_x.push_back (hi->x);
             d_y.push_back (hi->y);
@@ -159,7 +182,7 @@ namespace morph {
             this->d_nsw.resize (this->d_x.size(), 0);
             this->d_nse.resize (this->d_x.size(), 0);
 
-            std::list<morph::Hex>::iterator hi = this->hexen.begin();
+            morph::hexlist::iterator hi = this->hexen.begin();
             while (hi != this->hexen.end()) {
 
                 if (hi->has_ne() == true) {
@@ -200,6 +223,26 @@ namespace morph {
 
                 ++hi;
             }
+
+            this->populate_d_nbr();
+        }
+
+        //! Build d_nbr from d_ne, d_nne and friends.
+        void populate_d_nbr()
+        {
+            const unsigned int n = this->d_ne.size();
+            this->d_size_nbr = n;
+            this->d_nbr.resize (6 * n);
+            const std::array<const std::vector<int>*, 6> dirs = {
+                &this->d_ne, &this->d_nne, &this->d_nnw, &this->d_nw, &this->d_nsw, &this->d_nse
+            };
+            for (unsigned int dir = 0; dir < 6; ++dir) {
+                unsigned int* nb = this->d_nbr.data() + dir * n;
+                const int* dn = dirs[dir]->data();
+                for (unsigned int hi = 0; hi < n; ++hi) {
+                    nb[hi] = dn[hi] < 0 ? hi : static_cast<unsigned int>(dn[hi]);
+                }
+            }
         }
 
         //! Clear out all the d_ vectors
@@ -261,7 +304,7 @@ namespace morph {
 
             // list<Hex> hexen
             // for i in list, save Hex
-            std::list<morph::Hex>::const_iterator h = this->hexen.begin();
+            morph::hexlist::const_iterator h = this->hexen.begin();
             unsigned int hcount = 0;
             while (h != this->hexen.end()) {
                 // Make up a path
@@ -309,6 +352,7 @@ namespace morph {
             hgdata.read_contained_vals ("/d_nsw", this->d_nsw);
             hgdata.read_contained_vals ("/d_nse", this->d_nse);
             hgdata.read_contained_vals ("/d_flags", this->d_flags);
+            this->populate_d_nbr();
 
             // Assume a boundary has been applied so set this true. Also, the HexGrid::save method doesn't
             // save HexGrid::vertexE, etc
@@ -316,6 +360,10 @@ namespace morph {
 
             unsigned int hcount = 0;
             hgdata.read_val ("/hcount", hcount);
+#ifdef HEXGRID_CONTIGUOUS_STORAGE
+            // Neighbour iterators must not be invalidated by the hexen storage growing
+            this->hexen.reserve (hcount);
+#endif
             for (unsigned int i = 0; i < hcount; ++i) {
                 std::string h5path = "/hexen/" + std::to_string(i);
                 morph::Hex h (hgdata, h5path);
@@ -330,7 +378,7 @@ namespace morph {
                 if (_h.has_ne() == true) {
                     bool matched = false;
                     unsigned int neighb_it = (unsigned int) this->d_ne[_h.vi];
-                    std::list<morph::Hex>::iterator hi = this->hexen.begin();
+                    morph::hexlist::iterator hi = this->hexen.begin();
                     while (hi != this->hexen.end()) {
                         if (hi->vi == neighb_it) {
                             matched = true;
@@ -347,7 +395,7 @@ namespace morph {
                 if (_h.has_nne() == true) {
                     bool matched = false;
                     unsigned int neighb_it = (unsigned int) this->d_nne[_h.vi];
-                    std::list<morph::Hex>::iterator hi = this->hexen.begin();
+                    morph::hexlist::iterator hi = this->hexen.begin();
                     while (hi != this->hexen.end()) {
                         if (hi->vi == neighb_it) {
                             matched = true;
@@ -364,7 +412,7 @@ namespace morph {
                 if (_h.has_nnw() == true) {
                     bool matched = false;
                     unsigned int neighb_it = (unsigned int) this->d_nnw[_h.vi];
-                    std::list<morph::Hex>::iterator hi = this->hexen.begin();
+                    morph::hexlist::iterator hi = this->hexen.begin();
                     while (hi != this->hexen.end()) {
                         if (hi->vi == neighb_it) {
                             matched = true;
@@ -381,7 +429,7 @@ namespace morph {
                 if (_h.has_nw() == true) {
                     bool matched = false;
                     unsigned int neighb_it = (unsigned int) this->d_nw[_h.vi];
-                    std::list<morph::Hex>::iterator hi = this->hexen.begin();
+                    morph::hexlist::iterator hi = this->hexen.begin();
                     while (hi != this->hexen.end()) {
                         if (hi->vi == neighb_it) {
                             matched = true;
@@ -398,7 +446,7 @@ namespace morph {
                 if (_h.has_nsw() == true) {
                     bool matched = false;
                     unsigned int neighb_it = (unsigned int) this->d_nsw[_h.vi];
-                    std::list<morph::Hex>::iterator hi = this->hexen.begin();
+                    morph::hexlist::iterator hi = this->hexen.begin();
                     while (hi != this->hexen.end()) {
                         if (hi->vi == neighb_it) {
                             matched = true;
@@ -415,7 +463,7 @@ namespace morph {
                 if (_h.has_nse() == true) {
                     bool matched = false;
                     unsigned int neighb_it = (unsigned int) this->d_nse[_h.vi];
-                    std::list<morph::Hex>::iterator hi = this->hexen.begin();
+                    morph::hexlist::iterator hi = this->hexen.begin();
                     while (hi != this->hexen.end()) {
                         if (hi->vi == neighb_it) {
                             matched = true;
@@ -432,6 +480,171 @@ namespace morph {
         }
 #endif // HEXGRID_COMPILE_LOAD_AND_SAVE
 
+        /*!
+         * Write the geometry of this HexGrid (the d_ vectors, and the position, flags,
+         * distance to boundary and neighbours of each Hex) to a binary cache file at \a path.
+         * \a key identifies the construction parameters of the grid; make it with
+         * morph::gridcache::key(). Unlike save(), this does not require HDF5. The boundary
+         * hexes are saved in the order that getBoundary() returns them. The BezCurvePath from
+         * which the boundary was set is not saved.
+         */
+        void save_geometry (const std::string& path, std::uint64_t key) const
+        {
+            geometry_cache_header hdr;
+            hdr.key = key;
+            hdr.nhex = static_cast<std::uint32_t>(this->hexen.size());
+            hdr.nd = static_cast<std::uint32_t>(this->d_x.size());
+            hdr.nd_nbr = static_cast<std::uint32_t>(this->d_ne.size());
+            hdr.nd_dist = static_cast<std::uint32_t>(this->d_distToBoundary.size());
+            hdr.d = this->d;
+            hdr.v = this->v;
+            hdr.x_span = this->x_span;
+            hdr.z = this->z;
+            hdr.boundaryCentroid = this->boundaryCentroid;
+            hdr.originalBoundaryCentroid = this->originalBoundaryCentroid;
+            hdr.d_rowlen = this->d_rowlen;
+            hdr.d_numrows = this->d_numrows;
+            hdr.d_size = this->d_size;
+            hdr.d_growthbuffer_horz = this->d_growthbuffer_horz;
+            hdr.d_growthbuffer_vert = this->d_growthbuffer_vert;
+            hdr.gridReduced = this->gridReduced ? 1 : 0;
+            hdr.nbhex = static_cast<std::uint32_t>(this->bhexen.size());
+
+            // Per-Hex data, in hexen order. Neighbours are given by position in hexen.
+            std::unordered_map<const Hex*, int> pos;
+            pos.reserve (this->hexen.size());
+            int k = 0;
+            for (const Hex& h : this->hexen) { pos[&h] = k++; }
+            std::vector<int> h_rgb (3 * hdr.nhex);
+            std::vector<float> h_xyd (3 * hdr.nhex);
+            std::vector<unsigned int> h_vi_di_flags (3 * hdr.nhex);
+            std::vector<int> h_nbr (6 * hdr.nhex, -1);
+            k = 0;
+            for (const Hex& h : this->hexen) {
+                h_rgb[3 * k] = h.ri;
+                h_rgb[3 * k + 1] = h.gi;
+                h_rgb[3 * k + 2] = h.bi;
+                h_xyd[3 * k] = h.x;
+                h_xyd[3 * k + 1] = h.y;
+                h_xyd[3 * k + 2] = h.distToBoundary;
+                h_vi_di_flags[3 * k] = h.vi;
+                h_vi_di_flags[3 * k + 1] = h.di;
+                h_vi_di_flags[3 * k + 2] = h.getFlags();
+                for (unsigned short n = 0; n < 6; ++n) {
+                    if (h.has_neighbour (n)) { h_nbr[6 * k + n] = pos[&(*h.get_neighbour (n))]; }
+                }
+                ++k;
+            }
+            std::vector<int> h_bhex;
+            h_bhex.reserve (hdr.nbhex);
+            for (const Hex* bh : this->bhexen) { h_bhex.push_back (pos[bh]); }
+
+            morph::gridcache::writer w (path);
+            w.header (hdr);
+            w.section (this->d_x);
+            w.section (this->d_y);
+            w.section (this->d_ri);
+            w.section (this->d_gi);
+            w.section (this->d_bi);
+            w.section (this->d_flags);
+            w.section (this->d_distToBoundary);
+            w.section (this->d_ne);
+            w.section (this->d_nne);
+            w.section (this->d_nnw);
+            w.section (this->d_nw);
+            w.section (this->d_nsw);
+            w.section (this->d_nse);
+            w.section (h_rgb);
+            w.section (h_xyd);
+            w.section (h_vi_di_flags);
+            w.section (h_nbr);
+            w.section (h_bhex);
+            w.commit();
+        }
+
+        /*!
+         * Populate this HexGrid from the geometry cache file at \a path, written by
+         * save_geometry() with the same \a key. The file is memory mapped and copied directly
+         * into the d_ vectors. The boundary hexes (see getBoundary) are restored. Returns
+         * false, leaving this HexGrid unchanged, if the file does not exist, was written with a
+         * different key or is not a valid cache file.
+         */
+        bool load_geometry (const std::string& path, std::uint64_t key)
+        {
+            morph::gridcache::reader r (path);
+            geometry_cache_header hdr;
+            if (!r.header (hdr)) { return false; }
+            const geometry_cache_header expect;
+            if (std::memcmp (hdr.magic, expect.magic, sizeof(hdr.magic)) != 0
+                || hdr.version != expect.version || hdr.key != key) {
+                return false;
+            }
+
+            HexGrid g;
+            bool ok = r.section (g.d_x, hdr.nd) && r.section (g.d_y, hdr.nd)
+            && r.section (g.d_ri, hdr.nd) && r.section (g.d_gi, hdr.nd) && r.section (g.d_bi, hdr.nd)
+            && r.section (g.d_flags, hdr.nd) && r.section (g.d_distToBoundary, hdr.nd_dist)
+            && r.section (g.d_ne, hdr.nd_nbr) && r.section (g.d_nne, hdr.nd_nbr) && r.section (g.d_nnw, hdr.nd_nbr)
+            && r.section (g.d_nw, hdr.nd_nbr) && r.section (g.d_nsw, hdr.nd_nbr) && r.section (g.d_nse, hdr.nd_nbr);
+            std::vector<int> h_rgb;
+            std::vector<float> h_xyd;
+            std::vector<unsigned int> h_vi_di_flags;
+            std::vector<int> h_nbr;
+            std::vector<int> h_bhex;
+            ok = ok && r.section (h_rgb, 3 * std::uint64_t{hdr.nhex}) && r.section (h_xyd, 3 * std::uint64_t{hdr.nhex})
+            && r.section (h_vi_di_flags, 3 * std::uint64_t{hdr.nhex}) && r.section (h_nbr, 6 * std::uint64_t{hdr.nhex})
+            && r.section (h_bhex, hdr.nbhex);
+            if (!ok) { return false; }
+            for (int nb : h_nbr) {
+                if (nb < -1 || nb >= static_cast<int>(hdr.nhex)) { return false; }
+            }
+            for (int bh : h_bhex) {
+                if (bh < 0 || bh >= static_cast<int>(hdr.nhex)) { return false; }
+            }
+
+            // Re-create the Hexes and their neighbour relations
+#ifdef HEXGRID_CONTIGUOUS_STORAGE
+            g.hexen.reserve (hdr.nhex);
+#endif
+            std::vector<hexlist::iterator> its (hdr.nhex);
+            for (unsigned int k = 0; k < hdr.nhex; ++k) {
+                Hex& h = g.hexen.emplace_back (h_vi_di_flags[3 * k], hdr.d, h_rgb[3 * k], h_rgb[3 * k + 1]);
+                h.bi = h_rgb[3 * k + 2];
+                h.x = h_xyd[3 * k];
+                h.y = h_xyd[3 * k + 1];
+                h.distToBoundary = h_xyd[3 * k + 2];
+                h.di = h_vi_di_flags[3 * k + 1];
+                h.setFlags (h_vi_di_flags[3 * k + 2]);
+                its[k] = std::prev (g.hexen.end());
+            }
+            for (unsigned int k = 0; k < hdr.nhex; ++k) {
+                for (unsigned short n = 0; n < 6; ++n) {
+                    const int nb = h_nbr[6 * k + n];
+                    if (nb >= 0) { its[k]->set_neighbour (n, its[nb]); }
+                }
+            }
+            for (hexlist::iterator hi : its) { g.vhexen.push_back (&(*hi)); }
+            for (int bh : h_bhex) { g.bhexen.push_back (&(*its[bh])); }
+
+            g.d = hdr.d;
+            g.v = hdr.v;
+            g.x_span = hdr.x_span;
+            g.z = hdr.z;
+            g.boundaryCentroid = hdr.boundaryCentroid;
+            g.originalBoundaryCentroid = hdr.originalBoundaryCentroid;
+            g.d_rowlen = hdr.d_rowlen;
+            g.d_numrows = hdr.d_numrows;
+            g.d_size = hdr.d_size;
+            g.d_growthbuffer_horz = hdr.d_growthbuffer_horz;
+            g.d_growthbuffer_vert = hdr.d_growthbuffer_vert;
+            // The vertex iterators are not saved, so the grid is always 'reduced' after loading
+            g.gridReduced = true;
+            g.populate_d_nbr();
+
+            *this = std::move (g);
+            return true;
+        }
+
         /*!
          * Default constructor
          */
@@ -470,6 +683,37 @@ namespace morph {
             this->init();
         }
 
+        /*!
+         * Construct a HexGrid with hex to hex distance \a d_ containing only the hexes on or
+         * inside the boundary \a p. Equivalent to constructing with (d_, x_span_, z_) and then
+         * calling setBoundary (p, loffset), but faster (see init_from_boundary).
+         */
+        HexGrid (float d_, float x_span_, float z_, const BezCurvePath<float>& p, bool loffset = true)
+            : d(d_), x_span(x_span_), z(z_)
+        {
+            this->v = this->d * morph::mathconst<float>::root_3_over_2;
+            this->boundary = p;
+            this->boundary.computePoints (this->d/2.0f, true);
+            std::vector<morph::BezCoord<float>> bpoints = this->boundary.getPoints();
+            this->init_from_boundary (bpoints, loffset);
+        }
+
+        /*!
+         * Initialise with hex to hex distance \a d_ and a grid of approximate diameter
+         * \a x_span_, retaining only the hexes on or inside the boundary \a bpoints (which
+         * is translated so that its centroid is (0,0) if \a loffset is true). This gives the
+         * same hexes as init (d_, x_span_, z_) followed by setBoundary (bpoints, loffset), but
+         * the hexes are built directly in raster order, from the bottom left to the top right.
+         */
+        void init (float d_, float x_span_, float z_, std::vector<BezCoord<float>>& bpoints, bool loffset = true)
+        {
+            this->d = d_;
+            this->v = this->d * morph::mathconst<float>::root_3_over_2;
+            this->x_span = x_span_;
+            this->z = z_;
+            this->init_from_boundary (bpoints, loffset);
+        }
+
         /*!
          * Compute the centroid of the passed in list of Hexes.
          */
@@ -488,10 +732,10 @@ namespace morph {
          * Find the Hex in the Hex grid which is closest to the x,y position given by
          * pos.
          */
-        std::list<Hex>::iterator findHexNearest (const morph::vec<float, 2>& pos)
+        hexlist::iterator findHexNearest (const morph::vec<float, 2>& pos)
         {
-            std::list<morph::Hex>::iterator nearest = this->hexen.end();
-            std::list<morph::Hex>::iterator hi = this->hexen.begin();
+            morph::hexlist::iterator nearest = this->hexen.end();
+            morph::hexlist::iterator hi = this->hexen.begin();
             float dist = std::numeric_limits<float>::max();
             while (hi != this->hexen.end()) {
                 float dx = pos[0] - hi->x;
@@ -506,10 +750,20 @@ namespace morph {
             return nearest;
         }
 
+        /*!
+         * Build a lattice_index over the hexes of this HexGrid. Its nearest() method returns the
+         * d_ index of the Hex nearest to a position in O(1) time, rather than the O(N) of
+         * findHexNearest. The index must be re-made if the HexGrid is changed.
+         */
+        morph::lattice_index spatial_index() const
+        {
+            return morph::lattice_index (this->d_x, this->d_y, { this->d, 0.0f }, { this->d / 2.0f, this->v });
+        }
+
         // If possible, get the hex at the given rgb position
-        std::list<Hex>::iterator findHexAt (const morph::vec<int, 3>& rgbpos)
+        hexlist::iterator findHexAt (const morph::vec<int, 3>& rgbpos)
         {
-            std::list<morph::Hex>::iterator hi = this->hexen.begin(); // First hex in hexen is always 0,0,0
+            morph::hexlist::iterator hi = this->origin_hex();
 
             // +ri is East
             int inc = rgbpos[0] > 0 ? 1 : -1;
@@ -553,8 +807,8 @@ namespace morph {
         {
             this->boundaryCentroid = this->computeCentroid (pHexes);
 
-            std::list<morph::Hex>::iterator bpoint = this->hexen.begin();
-            std::list<morph::Hex>::iterator bpi = this->hexen.begin();
+            morph::hexlist::iterator bpoint = this->hexen.begin();
+            morph::hexlist::iterator bpi = this->hexen.begin();
             while (bpi != this->hexen.end()) {
                 std::list<morph::Hex>::const_iterator ppi = pHexes.begin();
                 while (ppi != pHexes.end()) {
@@ -573,7 +827,7 @@ namespace morph {
 
             // Check that the boundary is contiguous.
             std::set<unsigned int> seen;
-            std::list<morph::Hex>::iterator hi = bpoint;
+            morph::hexlist::iterator hi = bpoint;
             if (this->boundaryContiguous (bpoint, hi, seen) == false) {
                 std::stringstream ee;
                 ee << "The boundary is not a contiguous sequence of hexes.";
@@ -649,7 +903,7 @@ namespace morph {
             }
 
             // now proceed with centroid changed or unchanged
-            std::list<morph::Hex>::iterator nearbyBoundaryPoint = this->hexen.begin(); // i.e the Hex at 0,0
+            morph::hexlist::iterator nearbyBoundaryPoint = this->origin_hex();
             bpi = bpoints.begin();
             while (bpi != bpoints.end()) {
                 nearbyBoundaryPoint = this->setBoundary (*bpi++, nearbyBoundaryPoint);
@@ -658,7 +912,7 @@ namespace morph {
             // Check that the boundary is contiguous.
             {
                 std::set<unsigned int> seen;
-                std::list<morph::Hex>::iterator hi = nearbyBoundaryPoint;
+                morph::hexlist::iterator hi = nearbyBoundaryPoint;
                 if (this->boundaryContiguous (nearbyBoundaryPoint, hi, seen) == false) {
                     std::stringstream ee;
                     ee << "The constructed boundary is not a contiguous sequence of hexes.";
@@ -700,7 +954,7 @@ namespace morph {
             // now proceed with centroid changed or unchanged. First: clear all boundary flags
             for (auto h : this->hexen) { h.unsetUserFlag (HEX_IS_BOUNDARY); }
 
-            std::list<morph::Hex>::iterator nearbyBoundaryPoint = this->hexen.begin(); // i.e the Hex at 0,0
+            morph::hexlist::iterator nearbyBoundaryPoint = this->origin_hex();
             bpi = bpoints.begin();
             while (bpi != bpoints.end()) {
                 nearbyBoundaryPoint = this->setBoundary (*bpi++, nearbyBoundaryPoint);
@@ -709,7 +963,7 @@ namespace morph {
             // Check that the boundary is contiguous.
             {
                 std::set<unsigned int> seen;
-                std::list<morph::Hex>::iterator hi = nearbyBoundaryPoint;
+                morph::hexlist::iterator hi = nearbyBoundaryPoint;
                 if (this->boundaryContiguous (nearbyBoundaryPoint, hi, seen) == false) {
                     std::stringstream ee;
                     ee << "The constructed boundary is not a contiguous sequence of hexes.";
@@ -729,7 +983,7 @@ namespace morph {
         {
             // From centre head to boundary, then mark boundary and walk
             // around the edge.
-            std::list<morph::Hex>::iterator bpi = this->hexen.begin();
+            morph::hexlist::iterator bpi = this->hexen.begin();
             while (bpi->has_nne()) { bpi = bpi->nne; }
             bpi->setFlag (HEX_IS_BOUNDARY | HEX_INSIDE_BOUNDARY);
             while (bpi->has_ne()) {
@@ -762,7 +1016,7 @@ namespace morph {
             }
             // Check that the boundary is contiguous.
             std::set<unsigned int> seen;
-            std::list<morph::Hex>::iterator hi = bpi;
+            morph::hexlist::iterator hi = bpi;
             if (this->boundaryContiguous (bpi, hi, seen) == false) {
                 std::stringstream ee;
                 ee << "The boundary is not a contiguous sequence of hexes.";
@@ -1154,8 +1408,19 @@ namespace morph {
          */
         void computeDistanceToBoundary()
         {
-            std::list<morph::Hex>::iterator h = this->hexen.begin();
-            while (h != this->hexen.end()) {
+            // Gather the boundary hexes once, rather than scanning all hexes for each hex
+            std::vector<const morph::Hex*> bhexes;
+            std::vector<morph::Hex*> allhexes;
+            allhexes.reserve (this->hexen.size());
+            for (morph::Hex& h : this->hexen) {
+                allhexes.push_back (&h);
+                if (h.testFlags(HEX_IS_BOUNDARY) == true) { bhexes.push_back (&h); }
+            }
+
+            const unsigned int nh = allhexes.size();
+#pragma omp parallel for schedule(dynamic, 256)
+            for (unsigned int i = 0; i < nh; ++i) {
+                morph::Hex* h = allhexes[i];
                 if (h->testFlags(HEX_IS_BOUNDARY) == true) {
                     h->distToBoundary = 0.0f;
                 } else {
@@ -1164,19 +1429,14 @@ namespace morph {
                         h->distToBoundary = -100.0;
                     } else {
                         // Not a boundary hex, but inside boundary
-                        std::list<morph::Hex>::iterator bh = this->hexen.begin();
-                        while (bh != this->hexen.end()) {
-                            if (bh->testFlags(HEX_IS_BOUNDARY) == true) {
-                                float delta = h->distanceFrom (*bh);
-                                if (delta < h->distToBoundary || h->distToBoundary < 0.0f) {
-                                    h->distToBoundary = delta;
-                                }
+                        for (const morph::Hex* bh : bhexes) {
+                            float delta = h->distanceFrom (*bh);
+                            if (delta < h->distToBoundary || h->distToBoundary < 0.0f) {
+                                h->distToBoundary = delta;
                             }
-                            ++bh;
                         }
                     }
                 }
-                ++h;
             }
         }
 
@@ -1186,7 +1446,7 @@ namespace morph {
         void populate_d_vectors()
         {
             // The starting hex is always the centre one.
-            std::list<morph::Hex>::iterator hi = this->hexen.begin();
+            morph::hexlist::iterator hi = this->hexen.begin();
             // Clear the d_ vectors.
             this->d_clear();
             // Now raster through the hexes, building the d_ vectors.
@@ -1216,7 +1476,7 @@ namespace morph {
          *
          * \return a vector of iterators to the Hexes that make up the region.
          */
-        std::vector<std::list<Hex>::iterator> getRegion (BezCurvePath<float>& p, morph::vec<float, 2>& regionCentroid,
+        std::vector<hexlist::iterator> getRegion (BezCurvePath<float>& p, morph::vec<float, 2>& regionCentroid,
                                                          bool applyOriginalBoundaryCentroid = true)
         {
             p.computePoints (this->d/2.0f, true);
@@ -1227,7 +1487,7 @@ namespace morph {
         /*!
          * The overload of getRegion that does all the work on a vector of coordinates
          */
-        std::vector<std::list<Hex>::iterator> getRegion (std::vector<BezCoord<float>>& bpoints, morph::vec<float, 2>& regionCentroid,
+        std::vector<hexlist::iterator> getRegion (std::vector<BezCoord<float>>& bpoints, morph::vec<float, 2>& regionCentroid,
                                                          bool applyOriginalBoundaryCentroid = true)
         {
             // First clear all region boundary flags, as we'll be defining a new region boundary
@@ -1237,7 +1497,7 @@ namespace morph {
             regionCentroid = morph::BezCurvePath<float>::getCentroid (bpoints);
 
             // A return object
-            std::vector<std::list<morph::Hex>::iterator> theRegion;
+            std::vector<morph::hexlist::iterator> theRegion;
 
             if (applyOriginalBoundaryCentroid) {
                 auto bpi = bpoints.begin();
@@ -1251,7 +1511,7 @@ namespace morph {
             }
 
             // Now find the hexes on the boundary of the region
-            std::list<morph::Hex>::iterator nearbyRegionBoundaryPoint = this->hexen.begin(); // i.e the Hex at 0,0
+            morph::hexlist::iterator nearbyRegionBoundaryPoint = this->origin_hex();
             typename std::vector<morph::BezCoord<float>>::iterator bpi = bpoints.begin();
             while (bpi != bpoints.end()) {
                 nearbyRegionBoundaryPoint = this->setRegionBoundary (*bpi++, nearbyRegionBoundaryPoint);
@@ -1260,7 +1520,7 @@ namespace morph {
             // Check that the region boundary is contiguous.
             {
                 std::set<unsigned int> seen;
-                std::list<morph::Hex>::iterator hi = nearbyRegionBoundaryPoint;
+                morph::hexlist::iterator hi = nearbyRegionBoundaryPoint;
                 if (this->regionBoundaryContiguous (nearbyRegionBoundaryPoint, hi, seen) == false) {
                     std::stringstream ee;
                     ee << "The constructed region boundary is not a contiguous sequence of hexes.";
@@ -1269,11 +1529,11 @@ namespace morph {
             }
 
             // Mark hexes inside region. Use centroid of the region.
-            std::list<morph::Hex>::iterator insideRegionHex = this->findHexNearest (regionCentroid);
+            morph::hexlist::iterator insideRegionHex = this->findHexNearest (regionCentroid);
             this->markHexesInside (insideRegionHex, HEX_IS_REGION_BOUNDARY, HEX_INSIDE_REGION);
 
             // Populate theRegion, then return it
-            std::list<morph::Hex>::iterator hi = this->hexen.begin();
+            morph::hexlist::iterator hi = this->hexen.begin();
             while (hi != this->hexen.end()) {
                 if (hi->testFlags (HEX_INSIDE_REGION) == true) {
                     theRegion.push_back (hi);
@@ -1286,12 +1546,12 @@ namespace morph {
 
         //! Obtain a hexagonal region of hexes around a given central hex, marked by its
         //! d_ index. This is easier than getting a properly circular region of hexes.
-        std::vector<std::list<Hex>::iterator> getHexagonalRegion (unsigned int centreindex, float radius)
+        std::vector<hexlist::iterator> getHexagonalRegion (unsigned int centreindex, float radius)
         {
-            std::vector<std::list<morph::Hex>::iterator> theRegion;
+            std::vector<morph::hexlist::iterator> theRegion;
 
             // Find the hex with index centreindex
-            std::list<Hex>::iterator sh = this->hexen.begin(); // start hex
+            hexlist::iterator sh = this->hexen.begin(); // start hex
             while (sh != this->hexen.end()) {
                 if (sh->vi == centreindex) { break; }
                 sh++;
@@ -1304,8 +1564,8 @@ namespace morph {
             // For each of 6 directions, step out to collect up the hexes on the disc
             // ring by ring. For rings 2 and above, also need to fill in hexes
             // (otherwise you end up with a snowflake shaped disc)
-            std::list<Hex>::iterator h;
-            std::list<Hex>::iterator h2; // for the tangent direction
+            hexlist::iterator h;
+            hexlist::iterator h2; // for the tangent direction
             for (unsigned short i = 0; i < 6; ++i) {
                 h = sh;
                 if (h->has_neighbour(i)) {
@@ -1346,6 +1606,52 @@ namespace morph {
             }
         }
 
+        /*!
+         * Starting from the hex \a hi, step \a rr hexes in the r direction and \a gg
+         * hexes in the g direction via neighbour relations. Return an iterator to the
+         * hex that is reached, or hexen.end() if the walk gets stuck at a boundary.
+         */
+        hexlist::iterator walk_rg (hexlist::iterator hi, int rr, int gg)
+        {
+            // The path may vary, because going directly in r direction then directly in
+            // g direction could take us temporarily outside the boundary of the HexGrid.
+            hexlist::iterator dhi = hi;
+            while (rr != 0 || gg != 0) {
+                bool moved = false;
+                // Try to move in r direction
+                if (rr > 0) {
+                    if (dhi->has_ne()) {
+                        dhi = dhi->ne;
+                        --rr;
+                        moved = true;
+                    } // Didn't move in +r direction
+                } else if (rr < 0) {
+                    if (dhi->has_nw()) {
+                        dhi = dhi->nw;
+                        ++rr;
+                        moved = true;
+                    } // Didn't move in -r direction
+                }
+                // Try to move in g direction
+                if (gg > 0) {
+                    if (dhi->has_nne()) {
+                        dhi = dhi->nne;
+                        --gg;
+                        moved = true;
+                    } // Didn't move in +g direction
+                } else if (gg < 0) {
+                    if (dhi->has_nsw()) {
+                        dhi = dhi->nsw;
+                        ++gg;
+                        moved = true;
+                    } // Didn't move in -g direction
+                }
+                // We're stuck; Can't move in r or g direction, so can't add a contribution
+                if (!moved && (rr != 0 || gg != 0)) { return this->hexen.end(); }
+            }
+            return dhi;
+        }
+
         /*!
          * Using this HexGrid as the domain, convolve the domain data \a data with the
          * kernel data \a kerneldata, which exists on another HexGrid, \a
@@ -1368,76 +1674,123 @@ namespace morph {
             }
 
             // For each hex in this HexGrid, compute the convolution kernel
-            std::list<Hex>::iterator hi = this->hexen.begin();
+            hexlist::iterator hi = this->hexen.begin();
             for (; hi != this->hexen.end(); ++hi) {
                 T sum = T{0};
                 // For each kernel hex, sum up.
                 for (auto kh : kernelgrid.hexen) {
-                    std::list<Hex>::iterator dhi = hi;
-                    // Kernel hex coords r,g are: kh.ri, kh.gi, which may be (are EXPECTED to be) +ve or -ve
-                    //
-                    // Origin hex coords are h.ri, h.gi
-                    //
-                    // To get the hex whose data we want to multiply with kh's value,
-                    // can go via neighbour relations, but must be prepared to take a
-                    // variable path because going directly in r direction then directly
-                    // in g direction could take us temporarily outside the boundary of
-                    // the HexGrid.
-                    int rr = kh.ri;
-                    int gg = kh.gi;
-                    bool failed = false;
-                    bool finished = false;
-                    //while (gg != 0 && rr != 0) {
-                    while (!finished) {
-                        bool moved = false;
-                        // Try to move in r direction
-                        if (rr > 0) {
-                            if (dhi->has_ne()) {
-                                dhi = dhi->ne;
-                                --rr;
-                                moved = true;
-                            } // Didn't move in +r direction
-                        } else if (rr < 0) {
-                            if (dhi->has_nw()) {
-                                dhi = dhi->nw;
-                                ++rr;
-                                moved = true;
-                            } // Didn't move in -r direction
-                        }
-                        // Try to move in g direction
-                        if (gg > 0) {
-                            if (dhi->has_nne()) {
-                                dhi = dhi->nne;
-                                --gg;
-                                moved = true;
-                            } // Didn't move in +g direction
-                        } else if (gg < 0) {
-                            if (dhi->has_nsw()) {
-                                dhi = dhi->nsw;
-                                ++gg;
-                                moved = true;
-                            } // Didn't move in -g direction
-                        }
+                    hexlist::iterator dhi = this->walk_rg (hi, kh.ri, kh.gi);
+                    if (dhi != this->hexen.end()) {
+                        // Can do the sum
+                        sum +=  data[dhi->vi] * kerneldata[kh.vi];
+                    }
+                }
+                result[hi->vi] = sum;
+            }
+        }
 
-                        if (rr == 0 && gg == 0) {
-                            finished = true;
-                            break;
-                        }
+        /*!
+         * A convolution of this HexGrid with a kernel, precompiled into a flat table in
+         * compressed sparse row (CSR) form. For the hex with vector index i, the
+         * contributing data indices are idx[start[i]] to idx[start[i+1]-1] and the
+         * matching kernel weights are in w at the same locations. Obtain one from
+         * compile_convolution() and apply it with convolve (plan, data, result). The
+         * plan remains valid for as long as the HexGrid and the kernel are unchanged.
+         */
+        template <typename T>
+        struct convolution_plan
+        {
+            //! Offsets into idx and w for each hex. Has size n + 1.
+            std::vector<unsigned int> start;
+            //! The data index (into d_ vectors) of each contributing hex
+            std::vector<unsigned int> idx;
+            //! The kernel weight for each contributing hex
+            std::vector<T> w;
+            //! The number of hexes in the domain HexGrid for which the plan was compiled
+            unsigned int n = 0;
+        };
 
-                        if (!moved) {
-                            // We're stuck; Can't move in r or g direction, so can't add a contribution
-                            failed = true;
-                            break;
-                        }
-                    }
+        /*!
+         * Resolve each (hex, kernel hex) pair of a convolution of data on this HexGrid
+         * with \a kerneldata (on \a kernelgrid) once, returning a convolution_plan
+         * which can be applied to any number of data vectors without walking the
+         * hexen list again.
+         */
+        template<typename T>
+        convolution_plan<T> compile_convolution (const HexGrid& kernelgrid, const std::vector<T>& kerneldata)
+        {
+            if (kernelgrid.getd() != this->d) {
+                throw std::runtime_error ("The kernel HexGrid must have same d as this HexGrid to carry out convolution.");
+            }
+            if (kerneldata.size() != kernelgrid.hexen.size()) {
+                throw std::runtime_error ("The kernel data vector is not the same size as the kernel HexGrid.");
+            }
 
-                    if (!failed) {
-                        // Can do the sum
-                        sum +=  data[dhi->vi] * kerneldata[kh.vi];
+            convolution_plan<T> plan;
+            plan.n = static_cast<unsigned int>(this->hexen.size());
+            plan.start.assign (plan.n + 1, 0u);
+            plan.idx.reserve (this->hexen.size() * kernelgrid.hexen.size());
+            plan.w.reserve (this->hexen.size() * kernelgrid.hexen.size());
+
+            // Walk the neighbour relations once for each hex/kernel hex pair (the same
+            // walk that convolve (kernelgrid, kerneldata, data, result) carries out)
+            std::vector<hexlist::iterator> byindex (plan.n, this->hexen.end());
+            for (hexlist::iterator hi = this->hexen.begin(); hi != this->hexen.end(); ++hi) {
+                byindex[hi->vi] = hi;
+            }
+            unsigned int nnz = 0;
+            for (unsigned int i = 0; i < plan.n; ++i) {
+                plan.start[i] = nnz;
+                if (byindex[i] == this->hexen.end()) { continue; }
+                for (auto kh : kernelgrid.hexen) {
+                    hexlist::iterator dhi = this->walk_rg (byindex[i], kh.ri, kh.gi);
+                    if (dhi != this->hexen.end()) {
+                        plan.idx.push_back (dhi->vi);
+                        plan.w.push_back (kerneldata[kh.vi]);
+                        ++nnz;
                     }
                 }
+            }
+            plan.start[plan.n] = nnz;
+            plan.idx.shrink_to_fit();
+            plan.w.shrink_to_fit();
 
-                result[hi->vi] = sum;
+            return plan;
+        }
+
+        /*!
+         * Apply a precompiled convolution_plan to the domain data \a data, writing the
+         * result into \a result. This is a gather-multiply-add over flat arrays, run
+         * in parallel over hexes and allocating no memory.
+         */
+        template<typename T>
+        void convolve (const convolution_plan<T>& plan, const std::vector<T>& data, std::vector<T>& result) const
+        {
+            if (plan.n != data.size()) {
+                throw std::runtime_error ("The data vector is not the same size as the convolution plan's HexGrid.");
+            }
+            if (result.size() != data.size()) {
+                throw std::runtime_error ("The result vector is not the same size as the data vector.");
+            }
+            if (&data == &result) {
+                throw std::runtime_error ("Pass in separate memory for the result.");
+            }
+
+            const unsigned int* start = plan.start.data();
+            const unsigned int* idx = plan.idx.data();
+            const T* w = plan.w.data();
+            const T* dp = data.data();
+            T* rp = result.data();
+            const int n = static_cast<int>(plan.n);
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; ++i) {
+                T sum = T{0};
+                const unsigned int k1 = start[i + 1];
+#pragma omp simd reduction(+:sum)
+                for (unsigned int k = start[i]; k < k1; ++k) {
+                    sum += dp[idx[k]] * w[k];
+                }
+                rp[i] = sum;
             }
         }
 
@@ -1491,21 +1844,22 @@ namespace morph {
             morph::vec<float, 2> params = 1.0f / (2.0f * dist_per_pix * dist_per_pix);
             morph::vec<float, 2> threesig = 3.0f * dist_per_pix;
 
-#pragma omp parallel for // parallel on this outer loop gives best result (5.8 s vs 7 s)
+            // The Gaussian is separable, so for each hex compute x and y weights for the small
+            // window of pixels that can contribute and sum over only that window.
+#pragma omp parallel for
             for (typename std::vector<float>::size_type xi = 0u; xi < this->d_x.size(); ++xi) {
+                std::array<float, morph::resample::taps> wx;
+                std::array<float, morph::resample::taps> wy;
+                morph::resample::window winx = morph::resample::axis_weights (this->d_x[xi], dist_per_pix[0], input_centering_offset[0],
+                                                                              image_offset[0], image_pixelsz[0], threesig[0], params[0], wx.data());
+                morph::resample::window winy = morph::resample::axis_weights (this->d_y[xi], dist_per_pix[1], input_centering_offset[1],
+                                                                              image_offset[1], image_pixelsz[1], threesig[1], params[1], wy.data());
                 float expr = 0.0f;
-                for (unsigned int i = 0; i < csz; ++i) {
-                    // Get x/y pixel coords:
-                    morph::vec<unsigned int, 2> idx = {(i % image_pixelsz[0]), (i / image_pixelsz[0])};
-                    // Get the coordinates of the pixel at index i (in HexGrid units):
-                    morph::vec<float, 2> posn = (dist_per_pix * idx) - input_centering_offset + image_offset;
-                    // Distance from input pixel to output hex:
-                    float _d_x = this->d_x[xi] - posn[0];
-                    float _d_y = this->d_y[xi] - posn[1];
-                    // Compute contributions to each hex pixel, using 2D (elliptical) Gaussian
-                    if (_d_x < threesig[0] && _d_y < threesig[1]) { // Testing for distance gives slight speedup
-                        expr += std::exp ( - ( (params[0] * _d_x * _d_x) + (params[1] * _d_y * _d_y) ) ) * image_data[i];
-                    }
+                for (unsigned int ky = 0; ky < winy.n; ++ky) {
+                    const float* row = image_data.data() + (winy.first + ky) * image_pixelsz[0] + winx.first;
+                    float rowsum = 0.0f;
+                    for (unsigned int kx = 0; kx < winx.n; ++kx) { rowsum += wx[kx] * row[kx]; }
+                    expr += wy[ky] * rowsum;
                 }
                 expr_resampled[xi] = expr;
             }
@@ -1652,14 +2006,14 @@ namespace morph {
 
             static constexpr bool debugdata = false;
 
-            std::list<Hex>::iterator h = this->hexen.begin();
+            hexlist::iterator h = this->hexen.begin();
             while (h != this->hexen.end()) {
                 // image_data[i] is the data to shift.
                 bool datatocopy = false;
                 if constexpr (debugdata) {
                     datatocopy = image_data[h->vi] > T{0} ? true : false;
                 }
-                std::list<Hex>::iterator dest_hex = h;
+                hexlist::iterator dest_hex = h;
                 if (datatocopy) std::cout << "Copying hex data at " << h->outputRG() << "...";
                 if (int_rg[1] > 0) {
                     for (int j = 0; j < int_rg[1] && dest_hex->has_nne(); ++j) {
@@ -2747,7 +3101,7 @@ namespace morph {
             bool first = true;
             std::array<float, 4> limits = {{0,0,0,0}};
             auto h = this->hexen.begin();
-            std::list<Hex>::iterator bl_hex = this->hexen.begin();
+            hexlist::iterator bl_hex = this->hexen.begin();
             while (h != this->hexen.end()) {
                 if (h->testFlags(HEX_IS_BOUNDARY) == true) {
                     if (first) {
@@ -2765,12 +3119,12 @@ namespace morph {
             //std::cout << "Bottom left hex is " << bl_hex->outputCart() << std::endl;
 
             int count = 0;
-            std::list<Hex>::iterator row_start = bl_hex;
+            hexlist::iterator row_start = bl_hex;
             if (onR) {
                 // go to end of each row and wrap back to the start. This may only work
                 // for parallelograms, at least in an initial implementation.
                 // First row
-                std::list<Hex>::iterator cur_hex = row_start;
+                hexlist::iterator cur_hex = row_start;
                 while (cur_hex->has_ne()) { cur_hex = cur_hex->ne; }
                 cur_hex->set_ne(bl_hex);
                 bl_hex->set_nw(cur_hex);
@@ -2791,11 +3145,11 @@ namespace morph {
                 }
             }
 
-            std::list<Hex>::iterator col_start = bl_hex;
+            hexlist::iterator col_start = bl_hex;
             int vcount = 0;
             if (onG) { // scan up columns in the 'G' direction
                 // First col
-                std::list<Hex>::iterator cur_hex = col_start;
+                hexlist::iterator cur_hex = col_start;
                 while (cur_hex->has_nne()) { cur_hex = cur_hex->nne; ++vcount; }
                 cur_hex->set_nne (bl_hex);
                 bl_hex->set_nsw (cur_hex);
@@ -2829,7 +3183,7 @@ namespace morph {
             // Final scan across to set se neighbours of end rows and nw neighbours of start rows.
             row_start = bl_hex;
             if (onR && onG) {
-                std::list<Hex>::iterator cur_hex = row_start;
+                hexlist::iterator cur_hex = row_start;
                 // First row
                 for (int i = 0; i < count; ++i) { cur_hex = cur_hex->ne; }
                 row_start->set_nnw(cur_hex->nne);
@@ -2848,7 +3202,7 @@ namespace morph {
         /*!
          * The list of hexes that make up this HexGrid.
          */
-        std::list<Hex> hexen;
+        hexlist hexen;
 
         /*!
          * Once boundary secured, fill this vector. Experimental - can I do parallel
@@ -2878,6 +3232,248 @@ namespace morph {
         morph::vec<float, 2> originalBoundaryCentroid = {0.0f, 0.0f};
 
     private:
+        //! The fixed size header of a geometry cache file (see save_geometry)
+        struct geometry_cache_header
+        {
+            char magic[8] = { 'M', 'H', 'G', 'R', 'I', 'D', 'G', 'C' };
+            std::uint32_t version = 2;
+            std::uint32_t nhex = 0;
+            std::uint64_t key = 0;
+            //! The lengths of d_x (and d_y, etc), d_ne (and d_nne, etc) and d_distToBoundary
+            std::uint32_t nd = 0;
+            std::uint32_t nd_nbr = 0;
+            std::uint32_t nd_dist = 0;
+            std::uint32_t gridReduced = 0;
+            float d = 0.0f;
+            float v = 0.0f;
+            float x_span = 0.0f;
+            float z = 0.0f;
+            morph::vec<float, 2> boundaryCentroid = { 0.0f, 0.0f };
+            morph::vec<float, 2> originalBoundaryCentroid = { 0.0f, 0.0f };
+            std::uint32_t d_rowlen = 0;
+            std::uint32_t d_numrows = 0;
+            std::uint32_t d_size = 0;
+            std::uint32_t d_growthbuffer_horz = 0;
+            std::uint32_t d_growthbuffer_vert = 0;
+            //! The number of boundary hexes
+            std::uint32_t nbhex = 0;
+        };
+
+        /*!
+         * The hex at lattice position (0,0,0), from which the neighbour walks in findHexAt,
+         * setBoundary and getRegion start. init() creates it first, but init_from_boundary
+         * creates hexes in raster order, so search for it if it is not at hexen.begin(). If
+         * there is no hex at the origin, return hexen.begin().
+         */
+        morph::hexlist::iterator origin_hex()
+        {
+            morph::hexlist::iterator hi = this->hexen.begin();
+            if (hi == this->hexen.end() || (hi->ri == 0 && hi->gi == 0 && hi->bi == 0)) { return hi; }
+            for (morph::hexlist::iterator h = this->hexen.begin(); h != this->hexen.end(); ++h) {
+                if (h->ri == 0 && h->gi == 0 && h->bi == 0) { return h; }
+            }
+            return hi;
+        }
+
+        //! The (ri, gi) lattice indices (with bi = 0) of the hex whose centre is nearest to (x, y)
+        morph::vec<int, 2> nearest_lattice_hex (const float x, const float y) const
+        {
+            // Fractional axial coordinates, then cube rounding
+            const float gf = y / this->v;
+            const float rf = x / this->d - gf / 2.0f;
+            const float bf = -rf - gf;
+            float rr = std::round (rf);
+            float rg = std::round (gf);
+            float rb = std::round (bf);
+            const float dr = std::abs (rr - rf);
+            const float dg = std::abs (rg - gf);
+            const float db = std::abs (rb - bf);
+            if (dr > dg && dr > db) {
+                rr = -rg - rb;
+            } else if (dg > db) {
+                rg = -rr - rb;
+            }
+            return morph::vec<int, 2>{ static_cast<int>(rr), static_cast<int>(rg) };
+        }
+
+        /*!
+         * Build hexen from a boundary, without first building the whole hexagonal grid.
+         *
+         * The boundary hexes are those nearest to each point in \a bpoints, as for
+         * setBoundary. The hexes inside the boundary are then found row by row (in parallel)
+         * with a scanline test of each hex centre against the closed polygon formed by \a
+         * bpoints. Only the retained hexes are created, in raster order from the bottom left,
+         * and their neighbour relations are set from the row structure. As for setBoundary, a
+         * boundary that is not a contiguous sequence of hexes throws std::runtime_error.
+         */
+        void init_from_boundary (std::vector<BezCoord<float>>& bpoints, bool loffset)
+        {
+            if (bpoints.empty()) { throw std::runtime_error ("HexGrid: The boundary contains no points"); }
+
+            this->hexen.clear();
+            this->vhexen.clear();
+            this->bhexen.clear();
+            this->d_clear();
+
+            this->boundaryCentroid = morph::BezCurvePath<float>::getCentroid (bpoints);
+            if (loffset) {
+                for (auto& bp : bpoints) { bp.subtract (this->boundaryCentroid); }
+                this->originalBoundaryCentroid = this->boundaryCentroid;
+                this->boundaryCentroid = {0.0f, 0.0f};
+            }
+
+            // The hexes retained must lie within the hexagonal grid that init() would make
+            const int maxRing = static_cast<int>(std::abs (std::ceil (this->x_span / 2.0f / this->d)));
+            auto ringof = [](int _r, int _g) { return (std::abs (_r) + std::abs (_g) + std::abs (_r + _g)) / 2; };
+
+            // 1. The boundary hexes
+            const unsigned int nb = bpoints.size();
+            std::vector<morph::vec<int, 2>> bhex (nb);
+#pragma omp parallel for schedule(static)
+            for (unsigned int i = 0; i < nb; ++i) {
+                bhex[i] = this->nearest_lattice_hex (bpoints[i].x(), bpoints[i].y());
+            }
+            int gmin = std::numeric_limits<int>::max();
+            int gmax = std::numeric_limits<int>::min();
+            for (const auto& b : bhex) {
+                if (ringof (b[0], b[1]) > maxRing) {
+                    throw std::runtime_error ("HexGrid: The boundary extends beyond the grid's x_span");
+                }
+                gmin = std::min (gmin, b[1]);
+                gmax = std::max (gmax, b[1]);
+            }
+            const int nrows = gmax - gmin + 1;
+
+            // 2. Bucket the boundary hexes and the crossings of the boundary polygon by row. A
+            // crossing is counted for rows with ylo <= y < yhi so that a polygon vertex lying
+            // exactly on a row is counted once.
+            std::vector<std::vector<int>> rowbhex (nrows);
+            for (const auto& b : bhex) { rowbhex[b[1] - gmin].push_back (b[0]); }
+            std::vector<std::vector<float>> crossings (nrows);
+            for (unsigned int i = 0; i < nb; ++i) {
+                const float x0 = bpoints[i].x();
+                const float y0 = bpoints[i].y();
+                const float x1 = bpoints[(i + 1) % nb].x();
+                const float y1 = bpoints[(i + 1) % nb].y();
+                if (y0 == y1) { continue; }
+                const float ylo = std::min (y0, y1);
+                const float yhi = std::max (y0, y1);
+                const int g0 = std::max (gmin, static_cast<int>(std::floor (ylo / this->v)));
+                const int g1 = std::min (gmax, static_cast<int>(std::ceil (yhi / this->v)));
+                for (int g = g0; g <= g1; ++g) {
+                    const float y = this->v * g;
+                    if (y >= ylo && y < yhi) {
+                        crossings[g - gmin].push_back (x0 + (y - y0) * (x1 - x0) / (y1 - y0));
+                    }
+                }
+            }
+
+            // 3. For each row, find the sorted ri of the retained hexes and whether each is a boundary hex
+            std::vector<std::vector<int>> rows (nrows);
+            std::vector<std::vector<unsigned char>> isbnd (nrows);
+#pragma omp parallel for schedule(dynamic, 8)
+            for (int k = 0; k < nrows; ++k) {
+                const int g = gmin + k;
+                std::vector<int>& rb = rowbhex[k];
+                std::sort (rb.begin(), rb.end());
+                rb.erase (std::unique (rb.begin(), rb.end()), rb.end());
+                std::vector<float>& cr = crossings[k];
+                std::sort (cr.begin(), cr.end());
+
+                // The interior hexes, whose centres lie between pairs of crossings
+                std::vector<int> inner;
+                const float xoff = (this->d / 2.0f) * g;
+                for (unsigned int c = 0; c + 1 < cr.size(); c += 2) {
+                    int r0 = static_cast<int>(std::floor ((cr[c] - xoff) / this->d));
+                    int r1 = static_cast<int>(std::ceil ((cr[c + 1] - xoff) / this->d));
+                    for (int _r = r0; _r <= r1; ++_r) {
+                        const float x = this->d * _r + xoff;
+                        if (x >= cr[c] && x <= cr[c + 1] && ringof (_r, g) <= maxRing) { inner.push_back (_r); }
+                    }
+                }
+
+                // Merge with the boundary hexes
+                std::vector<int>& row = rows[k];
+                std::vector<unsigned char>& ib = isbnd[k];
+                row.reserve (inner.size() + rb.size());
+                unsigned int a = 0, b = 0;
+                while (a < inner.size() || b < rb.size()) {
+                    if (b < rb.size() && (a >= inner.size() || rb[b] <= inner[a])) {
+                        if (a < inner.size() && inner[a] == rb[b]) { ++a; }
+                        row.push_back (rb[b++]);
+                        ib.push_back (1);
+                    } else {
+                        row.push_back (inner[a++]);
+                        ib.push_back (0);
+                    }
+                }
+            }
+
+            // 4. Create the hexes, row by row from the bottom
+            std::vector<unsigned int> rowstart (nrows + 1, 0);
+            for (int k = 0; k < nrows; ++k) { rowstart[k + 1] = rowstart[k] + rows[k].size(); }
+#ifdef HEXGRID_CONTIGUOUS_STORAGE
+            this->hexen.reserve (rowstart[nrows]);
+#endif
+            std::vector<morph::hexlist::iterator> its (rowstart[nrows]);
+            unsigned int vi = 0;
+            for (int k = 0; k < nrows; ++k) {
+                for (unsigned int j = 0; j < rows[k].size(); ++j) {
+                    this->hexen.emplace_back (vi, this->d, rows[k][j], gmin + k);
+                    its[vi] = --this->hexen.end();
+                    its[vi]->setFlag (isbnd[k][j] ? (HEX_IS_BOUNDARY | HEX_INSIDE_BOUNDARY) : HEX_INSIDE_BOUNDARY);
+                    ++vi;
+                }
+            }
+
+            // 5. Set the neighbour relations. Each hex sets only its own neighbours.
+#pragma omp parallel for schedule(dynamic, 8)
+            for (int k = 0; k < nrows; ++k) {
+                const std::vector<int>& row = rows[k];
+                // Find the iterator for ri in row kk, or hexen.end()
+                auto find = [&](int kk, int _r) {
+                    if (kk < 0 || kk >= nrows) { return this->hexen.end(); }
+                    auto ri_it = std::lower_bound (rows[kk].begin(), rows[kk].end(), _r);
+                    if (ri_it == rows[kk].end() || *ri_it != _r) { return this->hexen.end(); }
+                    return its[rowstart[kk] + (ri_it - rows[kk].begin())];
+                };
+                for (unsigned int j = 0; j < row.size(); ++j) {
+                    morph::hexlist::iterator hi = its[rowstart[k] + j];
+                    const int _r = row[j];
+                    if (j + 1 < row.size() && row[j + 1] == _r + 1) { hi->set_ne (its[rowstart[k] + j + 1]); }
+                    if (j > 0 && row[j - 1] == _r - 1) { hi->set_nw (its[rowstart[k] + j - 1]); }
+                    morph::hexlist::iterator n = find (k + 1, _r);
+                    if (n != this->hexen.end()) { hi->set_nne (n); }
+                    n = find (k + 1, _r - 1);
+                    if (n != this->hexen.end()) { hi->set_nnw (n); }
+                    n = find (k - 1, _r);
+                    if (n != this->hexen.end()) { hi->set_nsw (n); }
+                    n = find (k - 1, _r + 1);
+                    if (n != this->hexen.end()) { hi->set_nse (n); }
+                }
+            }
+
+            // 6. Check that the boundary is contiguous, starting from the hex of the last
+            // boundary point, as setBoundary does. This also populates bhexen.
+            {
+                const int k = bhex.back()[1] - gmin;
+                auto ri_it = std::lower_bound (rows[k].begin(), rows[k].end(), bhex.back()[0]);
+                morph::hexlist::iterator bstart = its[rowstart[k] + (ri_it - rows[k].begin())];
+                std::set<unsigned int> seen;
+                morph::hexlist::iterator hi = bstart;
+                if (this->boundaryContiguous (bstart, hi, seen) == false) {
+                    std::stringstream ee;
+                    ee << "The constructed boundary is not a contiguous sequence of hexes.";
+                    throw std::runtime_error (ee.str());
+                }
+            }
+
+            this->renumberVectorIndices();
+            // There are no outer hexagonal grid vertices
+            this->gridReduced = true;
+            this->populate_d_vectors();
+        }
+
         /*!
          * Initialise a grid of hexes in a hex spiral, setting neighbours as the grid
          * spirals out. This method populates hexen based on the grid parameters set
@@ -2897,23 +3493,27 @@ namespace morph {
             // Vectors of list-iterators to hexes in this->hexen. Used to keep a track of nearest
             // neighbours. I'm using vector, rather than a list as this allows fast random access of
             // elements and I'll not be inserting or erasing in the middle of the arrays.
-            std::vector<std::list<morph::Hex>::iterator> prevRingEven;
-            std::vector<std::list<morph::Hex>::iterator> prevRingOdd;
+            std::vector<morph::hexlist::iterator> prevRingEven;
+            std::vector<morph::hexlist::iterator> prevRingOdd;
 
             // Swap pointers between rings.
-            std::vector<std::list<morph::Hex>::iterator>* prevRing = &prevRingEven;
-            std::vector<std::list<morph::Hex>::iterator>* nextPrevRing = &prevRingOdd;
+            std::vector<morph::hexlist::iterator>* prevRing = &prevRingEven;
+            std::vector<morph::hexlist::iterator>* nextPrevRing = &prevRingOdd;
 
             // Direction iterators used in the loop for creating hexes
             int ri = 0;
             int gi = 0;
 
+#ifdef HEXGRID_CONTIGUOUS_STORAGE
+            // 1 + 6 + 12 + ... hexes, in maxRing rings around the central hex
+            this->hexen.reserve (1 + 3 * maxRing * (maxRing + 1));
+#endif
             // Create central "ring" first (the single hex)
             this->hexen.emplace_back (vi++, this->d, ri, gi);
 
             // Put central ring in the prevRing vector:
             {
-                std::list<morph::Hex>::iterator h = this->hexen.end(); --h;
+                morph::hexlist::iterator h = this->hexen.end(); --h;
                 prevRing->push_back (h);
             }
 
@@ -3242,7 +3842,7 @@ namespace morph {
                 ringSideLen++;
 
                 // Swap prevRing and nextPrevRing.
-                std::vector<std::list<morph::Hex>::iterator>* tmp = prevRing;
+                std::vector<morph::hexlist::iterator>* tmp = prevRing;
                 prevRing = nextPrevRing;
                 nextPrevRing = tmp;
             }
@@ -3256,10 +3856,10 @@ namespace morph {
          *
          * \return An iterator into HexGrid::hexen which refers to the closest Hex to \a point.
          */
-        std::list<morph::Hex>::iterator setBoundary (const morph::BezCoord<float>& point,
-                                                     std::list<morph::Hex>::iterator startFrom)
+        morph::hexlist::iterator setBoundary (const morph::BezCoord<float>& point,
+                                                     morph::hexlist::iterator startFrom)
         {
-            std::list<morph::Hex>::iterator h = this->findHexNearPoint (point, startFrom);
+            morph::hexlist::iterator h = this->findHexNearPoint (point, startFrom);
             h->setFlag (HEX_IS_BOUNDARY | HEX_INSIDE_BOUNDARY);
             return h;
         }
@@ -3271,13 +3871,13 @@ namespace morph {
         bool boundaryContiguous()
         {
             this->bhexen.clear();
-            std::list<morph::Hex>::const_iterator bhi = this->hexen.begin();
+            morph::hexlist::const_iterator bhi = this->hexen.begin();
             if (this->findBoundaryHex (bhi) == false) {
                 // Found no boundary hex
                 return false;
             }
             std::set<unsigned int> seen;
-            std::list<morph::Hex>::const_iterator hi = bhi;
+            morph::hexlist::const_iterator hi = bhi;
             return this->boundaryContiguous (bhi, hi, seen);
         }
 
@@ -3285,52 +3885,41 @@ namespace morph {
          * Determine whether the boundary is contiguous, starting from the boundary
          * Hex iterator \a bhi.
          *
-         * The overload with bhexes takes a list of Hex pointers and populates it with
-         * pointers to the hexes on the boundary.
+         * This walks the boundary depth first, pushing each boundary Hex that it reaches onto
+         * bhexen. The walk is iterative, with an explicit stack in place of recursion, so that a
+         * long boundary can't overflow the call stack. Neighbours are tried in the order E, NE,
+         * NW, W, SW, SE, and bhexen is filled in the order a recursive walk would fill it.
          */
-        bool boundaryContiguous (std::list<Hex>::const_iterator bhi,
-                                 std::list<Hex>::const_iterator hi, std::set<unsigned int>& seen)
+        bool boundaryContiguous (hexlist::const_iterator bhi,
+                                 hexlist::const_iterator hi, std::set<unsigned int>& seen)
         {
-            bool rtn = false;
-            std::list<morph::Hex>::const_iterator hi_next;
+            // Each entry is a Hex on the current path and the next neighbour direction to try
+            std::vector<std::pair<hexlist::const_iterator, unsigned short>> path;
             seen.insert (hi->vi);
-            // Insert into the std::list of Hex pointers, too
             this->bhexen.push_back (&(*hi));
-
-            if (rtn == false && hi->has_ne() && hi->ne->testFlags(HEX_IS_BOUNDARY) == true && seen.find(hi->ne->vi) == seen.end()) {
-                hi_next = hi->ne;
-                rtn = (this->boundaryContiguous (bhi, hi_next, seen));
-            }
-            if (rtn == false && hi->has_nne() && hi->nne->testFlags(HEX_IS_BOUNDARY) == true && seen.find(hi->nne->vi) == seen.end()) {
-                hi_next = hi->nne;
-                rtn = (this->boundaryContiguous (bhi, hi_next, seen));
-            }
-            if (rtn == false && hi->has_nnw() && hi->nnw->testFlags(HEX_IS_BOUNDARY) == true && seen.find(hi->nnw->vi) == seen.end()) {
-                hi_next = hi->nnw;
-                rtn =  (this->boundaryContiguous (bhi, hi_next, seen));
-            }
-            if (rtn == false && hi->has_nw() && hi->nw->testFlags(HEX_IS_BOUNDARY) == true && seen.find(hi->nw->vi) == seen.end()) {
-                hi_next = hi->nw;
-                rtn =  (this->boundaryContiguous (bhi, hi_next, seen));
-            }
-            if (rtn == false && hi->has_nsw() && hi->nsw->testFlags(HEX_IS_BOUNDARY) == true && seen.find(hi->nsw->vi) == seen.end()) {
-                hi_next = hi->nsw;
-                rtn =  (this->boundaryContiguous (bhi, hi_next, seen));
-            }
-            if (rtn == false && hi->has_nse() && hi->nse->testFlags(HEX_IS_BOUNDARY) == true && seen.find(hi->nse->vi) == seen.end()) {
-                hi_next = hi->nse;
-                rtn =  (this->boundaryContiguous (bhi, hi_next, seen));
-            }
-
-            if (rtn == false) {
-                // Checked all neighbours
-                if (hi == bhi) {
-                    // Back at start, nowhere left to go! return true.
-                    rtn = true;
+            path.push_back ({ hi, HEX_NEIGHBOUR_POS_E });
+
+            while (!path.empty()) {
+                hexlist::const_iterator h = path.back().first;
+                const unsigned short ni = path.back().second;
+                if (ni > HEX_NEIGHBOUR_POS_SE) {
+                    // Checked all neighbours. Back at start, nowhere left to go! return true.
+                    if (h == bhi) { return true; }
+                    path.pop_back();
+                    continue;
+                }
+                ++path.back().second;
+                if (h->has_neighbour (ni)) {
+                    hexlist::const_iterator hn = h->get_neighbour (ni);
+                    if (hn->testFlags (HEX_IS_BOUNDARY) == true && seen.find (hn->vi) == seen.end()) {
+                        seen.insert (hn->vi);
+                        this->bhexen.push_back (&(*hn));
+                        path.push_back ({ hn, HEX_NEIGHBOUR_POS_E });
+                    }
                 }
             }
 
-            return rtn;
+            return false;
         }
 
         /*!
@@ -3339,9 +3928,9 @@ namespace morph {
          * region, extract the pointers to all the Hexes in that region and store that
          * information for later use.
          */
-        std::list<Hex>::iterator setRegionBoundary (const BezCoord<float>& point, std::list<Hex>::iterator startFrom)
+        hexlist::iterator setRegionBoundary (const BezCoord<float>& point, hexlist::iterator startFrom)
         {
-            std::list<morph::Hex>::iterator h = this->findHexNearPoint (point, startFrom);
+            morph::hexlist::iterator h = this->findHexNearPoint (point, startFrom);
             h->setFlag (HEX_IS_REGION_BOUNDARY | HEX_INSIDE_REGION);
             return h;
         }
@@ -3350,11 +3939,11 @@ namespace morph {
          * Determine whether the region boundary is contiguous, starting from the
          * boundary Hex iterator #bhi.
          */
-        bool regionBoundaryContiguous (std::list<Hex>::const_iterator bhi,
-                                       std::list<Hex>::const_iterator hi, std::set<unsigned int>& seen)
+        bool regionBoundaryContiguous (hexlist::const_iterator bhi,
+                                       hexlist::const_iterator hi, std::set<unsigned int>& seen)
         {
             bool rtn = false;
-            std::list<morph::Hex>::const_iterator hi_next;
+            morph::hexlist::const_iterator hi_next;
             seen.insert (hi->vi);
             // Insert into the list of Hex pointers, too
             this->bhexen.push_back (&(*hi));
@@ -3397,7 +3986,7 @@ namespace morph {
          * assumes that setBoundary (const BezCurvePath&) has been called to mark the
          * Hexes that lie on the boundary.
          */
-        bool findBoundaryHex (std::list<Hex>::const_iterator& hi) const
+        bool findBoundaryHex (hexlist::const_iterator& hi) const
         {
             if (hi->testFlags(HEX_IS_BOUNDARY) == true) {
                 // No need to change the Hex iterator
@@ -3405,42 +3994,42 @@ namespace morph {
             }
 
             if (hi->has_ne()) {
-                std::list<morph::Hex>::const_iterator ci(hi->ne);
+                morph::hexlist::const_iterator ci(hi->ne);
                 if (this->findBoundaryHex (ci) == true) {
                     hi = ci;
                     return true;
                 }
             }
             if (hi->has_nne()) {
-                std::list<morph::Hex>::const_iterator ci(hi->nne);
+                morph::hexlist::const_iterator ci(hi->nne);
                 if (this->findBoundaryHex (ci) == true) {
                     hi = ci;
                     return true;
                 }
             }
             if (hi->has_nnw()) {
-                std::list<morph::Hex>::const_iterator ci(hi->nnw);
+                morph::hexlist::const_iterator ci(hi->nnw);
                 if (this->findBoundaryHex (ci) == true) {
                     hi = ci;
                     return true;
                 }
             }
             if (hi->has_nw()) {
-                std::list<morph::Hex>::const_iterator ci(hi->nw);
+                morph::hexlist::const_iterator ci(hi->nw);
                 if (this->findBoundaryHex (ci) == true) {
                     hi = ci;
                     return true;
                 }
             }
             if (hi->has_nsw()) {
-                std::list<morph::Hex>::const_iterator ci(hi->nsw);
+                morph::hexlist::const_iterator ci(hi->nsw);
                 if (this->findBoundaryHex (ci) == true) {
                     hi = ci;
                     return true;
                 }
             }
             if (hi->has_nse()) {
-                std::list<morph::Hex>::const_iterator ci(hi->nse);
+                morph::hexlist::const_iterator ci(hi->nse);
                 if (this->findBoundaryHex (ci) == true) {
                     hi = ci;
                     return true;
@@ -3454,11 +4043,11 @@ namespace morph {
          * Find the hex near @point, starting from startFrom, which should be as close
          * as possible to point in order to reduce computation time.
          */
-        std::list<Hex>::iterator findHexNearPoint (const BezCoord<float>& point, std::list<Hex>::iterator startFrom)
+        hexlist::iterator findHexNearPoint (const BezCoord<float>& point, hexlist::iterator startFrom)
         {
             bool neighbourNearer = true;
 
-            std::list<morph::Hex>::iterator h = startFrom;
+            morph::hexlist::iterator h = startFrom;
             float dmin = h->distanceFrom (point);
             float dcur = 0.0f;
 
@@ -3511,7 +4100,7 @@ namespace morph {
          * By changing \a bdryFlag and \a insideFlag, it's possible to use this method
          * with region boundaries.
          */
-        void markFromBoundary (std::list<Hex>::iterator hi,
+        void markFromBoundary (hexlist::iterator hi,
                                unsigned int bdryFlag = HEX_IS_BOUNDARY,
                                unsigned int insideFlag = HEX_INSIDE_BOUNDARY)
         {
@@ -3553,7 +4142,7 @@ namespace morph {
         {
             // Find a marked-inside Hex next to this boundary hex. This will be the first direction to mark
             // a line of inside hexes in.
-            std::list<morph::Hex>::iterator first_inside = this->hexen.begin();
+            morph::hexlist::iterator first_inside = this->hexen.begin();
             unsigned short firsti = 0;
             for (unsigned short i = 0; i < 6; ++i) {
                 if (hi->has_neighbour(i)
@@ -3592,13 +4181,13 @@ namespace morph {
         /*!
          * Common code used by markFromBoundary()
          */
-        void markFromBoundaryCommon (std::list<Hex>::iterator first_inside, unsigned short firsti,
+        void markFromBoundaryCommon (hexlist::iterator first_inside, unsigned short firsti,
                                      unsigned int bdryFlag = HEX_IS_BOUNDARY,
                                      unsigned int insideFlag = HEX_INSIDE_BOUNDARY)
         {
             // From the "first inside the boundary hex" head in the direction specified by firsti until a
             // boundary hex is reached.
-            std::list<morph::Hex>::iterator straight = first_inside;
+            morph::hexlist::iterator straight = first_inside;
 
 #ifdef DO_WARNINGS
             bool warning_given = false;
@@ -3662,8 +4251,8 @@ namespace morph {
          *
          * \return true if a next boundary neighbour was found, false otherwise.
          */
-        bool findNextBoundaryNeighbour (std::list<Hex>::iterator& bhi,
-                                        std::deque<std::list<Hex>::iterator>& recently_seen,
+        bool findNextBoundaryNeighbour (hexlist::iterator& bhi,
+                                        std::deque<hexlist::iterator>& recently_seen,
                                         unsigned int n_recents = 2U,
                                         unsigned int bdryFlag = HEX_IS_BOUNDARY,
                                         unsigned int insideFlag = HEX_INSIDE_BOUNDARY) const
@@ -3677,7 +4266,7 @@ namespace morph {
                 if (bhi->has_neighbour(i) && bhi->get_neighbour(i)->testFlags(bdryFlag)) {
 
                     // cbhi is "candidate boundary hex iterator", now guaranteed to be a boundary hex
-                    std::list<morph::Hex>::iterator cbhi = bhi->get_neighbour(i);
+                    morph::hexlist::iterator cbhi = bhi->get_neighbour(i);
 
                     // Test if the candidate boundary hex is in the 'recently seen' deque
                     bool hex_already_seen = false;
@@ -3724,23 +4313,23 @@ namespace morph {
          * \a hi which is assumed to already be known to refer to a hex lying inside the
          * boundary.
          */
-        void markHexesInside (std::list<Hex>::iterator hi,
+        void markHexesInside (hexlist::iterator hi,
                               unsigned int bdryFlag = HEX_IS_BOUNDARY,
                               unsigned int insideFlag = HEX_INSIDE_BOUNDARY)
         {
             // Run to boundary, marking as we go
-            std::list<morph::Hex>::iterator bhi(hi);
+            morph::hexlist::iterator bhi(hi);
             while (bhi->testFlags (bdryFlag) == false && bhi->has_nne()) {
                 bhi->setFlag (insideFlag);
                 bhi = bhi->nne;
             }
-            std::list<morph::Hex>::iterator bhi_start = bhi;
+            morph::hexlist::iterator bhi_start = bhi;
 
             // Mark from first boundary hex and across the region
             this->markFromBoundary (bhi, bdryFlag, insideFlag);
 
             // a deque to hold the 'n_recents' most recently seen boundary hexes.
-            std::deque<std::list<morph::Hex>::iterator> recently_seen;
+            std::deque<morph::hexlist::iterator> recently_seen;
             unsigned int n_recents = 16U; // 2 should be sufficient for boundaries with double thickness
             // sections. If problems occur, trying increasing this.
             bool gotnext = this->findNextBoundaryNeighbour (bhi, recently_seen, n_recents, bdryFlag, insideFlag);
@@ -3843,7 +4432,7 @@ namespace morph {
          */
         void markAllHexesInsideDomain()
         {
-            std::list<morph::Hex>::iterator hi = this->hexen.begin();
+            morph::hexlist::iterator hi = this->hexen.begin();
             while (hi != this->hexen.end()) {
                 hi->setInsideDomain();
                 hi++;
@@ -3856,7 +4445,7 @@ namespace morph {
         void discardOutsideBoundary()
         {
             // Mark those hexes inside the boundary
-            std::list<morph::Hex>::iterator centroidHex = this->findHexNearest (this->boundaryCentroid);
+            morph::hexlist::iterator centroidHex = this->findHexNearest (this->boundaryCentroid);
             this->markHexesInside (centroidHex);
             // Run through and discard those hexes outside the boundary:
             auto hi = this->hexen.begin();
@@ -4017,12 +4606,12 @@ namespace morph {
          * boundary is applied to the original hexagonal grid. When this occurs,
          * gridReduced should be set false.
          */
-        std::list<Hex>::iterator vertexE;
-        std::list<Hex>::iterator vertexNE;
-        std::list<Hex>::iterator vertexNW;
-        std::list<Hex>::iterator vertexW;
-        std::list<Hex>::iterator vertexSW;
-        std::list<Hex>::iterator vertexSE;
+        hexlist::iterator vertexE;
+        hexlist::iterator vertexNE;
+        hexlist::iterator vertexNW;
+        hexlist::iterator vertexW;
+        hexlist::iterator vertexSW;
+        hexlist::iterator vertexSE;
 
         /*!
          * Set true when a new boundary has been applied. This means that
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <span>
 
 /*
  * Macros for testing neighbours. The step along for neighbours on the
@@ -106,9 +107,9 @@ namespace morph {
             if (this->scalarData != nullptr) {
                 // What do these scaling operations do to any NaNs in scalarData? They should remain
                 // NaN. Then in dcopy, might want to make them 0.
-                this->zScale.transform (*(this->scalarData), this->dcopy);
+                this->zScale.transform (std::span<const T>{ *this->scalarData }, std::span<float>{ this->dcopy });
                 dcopy.replace_nan_with (this->zScale.transform_one(0.0f));
-                this->colourScale.transform (*(this->scalarData), this->dcolour);
+                this->colourScale.transform (std::span<const T>{ *this->scalarData }, std::span<float>{ this->dcolour });
 
             } else if (this->vectorData != nullptr) {
 
@@ -156,6 +157,13 @@ namespace morph {
         //! Set false to omit the hexes (to show just the geometry of showoverlap==true)
         bool showhexes = true;
 
+        /*!
+         * Set true to colour scalar data with one batch call to ColourMap::convert, which is
+         * faster for large grids. Leave this false in a subclass that overrides setColour(), as
+         * the batch path does not call setColour().
+         */
+        bool batchcolours = false;
+
         void initializeVertices() { this->initializeVertices (false); }
         //! Do the computations to initialize the vertices that will represent the
         //! HexGrid.
@@ -178,21 +186,45 @@ namespace morph {
                 break;
             }
             }
+
+            // If gpuColourMap is set, colour the hexes in the shader (but keep the marked hexes'
+            // black vertices black). In HexInterp mode, a hex with NaN data is given the NaN
+            // colour all over, rather than just at its centre.
+            const bool tris = this->hexVisMode == HexVisMode::Triangles;
+            const std::size_t n_svertices_per_datum = tris ? 1u : (this->showhexes ? 7u : 0u);
+            if (this->setupScalarColouring (n_svertices_per_datum)) {
+                for (unsigned int hi : this->markedHexes) {
+                    if (tris) {
+                        this->vertexColors[3u * hi] = 0.0f;
+                    } else {
+                        for (unsigned int k : { 1u, 3u, 5u }) { this->vertexColors[3u * (7u * hi + k)] = 0.0f; }
+                    }
+                }
+            }
         }
 
         // This locally defined reinit function knows that we don't want to clear vertexPositions/vertexNormals
         void reinit_on_update()
         {
             if (this->setContext != nullptr) { this->setContext (this->parentVis); }
+            // Keep the old positions and colours, so that only the ranges that change are uploaded
+            this->prev_positions = this->vertexPositions;
+            this->prev_colours = this->vertexColors;
             // No need to set idx to 0 on an update, or clear/empty vertex/indices containers
             this->initializeVertices (true); // true for 'update' not 'initial build'
-            this->reinit_buffers(); // could potentially be 'reinit_position_color_buffers_only()'
+            this->mark_changed (this->posnVBO, this->prev_positions, this->vertexPositions);
+            this->mark_changed (this->colVBO, this->prev_colours, this->vertexColors);
+            // The normals and indices are not changed on an update
+            this->mark_unchanged (this->normVBO);
+            this->mark_unchanged (this->idxVBO);
+            this->reinit_buffers();
         }
 
         // Override the updateData method
         void updateData (const std::vector<T>* _data)
         {
             this->scalarData = _data;
+            if (this->updateVertexScalars()) { return; }
             switch (this->hexVisMode) {
             case HexVisMode::Triangles:
             {
@@ -201,7 +233,8 @@ namespace morph {
             }
             default:
             {
-                VisualDataModel<T,glver>::reinit();
+                // Rebuilds the hexes, but uploads only the ranges of vertex data that change
+                this->reinit_changed();
                 break;
             }
             }
@@ -231,8 +264,10 @@ namespace morph {
                 this->indices.reserve (6u * nhex);
             }
 
+            // Write the colours straight into vertexColors; marked hexes are blacked out below
+            this->setColours (std::span<float>{ this->vertexColors }.first (3u * nhex));
+
             for (unsigned int hi = 0; hi < nhex; ++hi) {
-                std::array<float, 3> clr = this->setColour (hi);
                 // If dataCoords has been populated, use these for hex positions, allowing for
                 // mapping of the 2D HexGrid onto a 3D manifold.
                 if (this->dataCoords == nullptr) {
@@ -253,10 +288,6 @@ namespace morph {
                     this->vertexColors[hi * 3] = blkclr[0];
                     this->vertexColors[hi * 3 + 1] = blkclr[1];
                     this->vertexColors[hi * 3 + 2] = blkclr[2];
-                } else {
-                    this->vertexColors[hi * 3] = clr[0];
-                    this->vertexColors[hi * 3 + 1] = clr[1];
-                    this->vertexColors[hi * 3 + 2] = clr[2];
                 }
                 if (update == false) {
                     this->vertexNormals[hi * 3] = 0.0f;
@@ -323,6 +354,8 @@ namespace morph {
             unsigned int nhex = this->hg->num();
 
             this->setupScaling();
+            this->hexcolours.resize (3u * nhex);
+            this->setColours (this->hexcolours);
 
             // x and y coords on the HexGrid. May be replaced if dataCoords has been set.
             float _x = 0.0f;
@@ -385,8 +418,8 @@ namespace morph {
                 }
 
                 // Use a single colour for each hex, even though hex z positions are
-                // interpolated. Do the _colour_ scaling:
-                std::array<float, 3> clr = this->setColour (hi);
+                // interpolated.
+                std::array<float, 3> clr = { this->hexcolours[3 * hi], this->hexcolours[3 * hi + 1], this->hexcolours[3 * hi + 2] };
                 if (this->showboundary && (this->hg->vhexen[hi])->boundaryHex() == true) {
                     this->markHex (hi);
                 }
@@ -1126,6 +1159,27 @@ namespace morph {
         HexVisMode hexVisMode = HexVisMode::HexInterp;
 
     protected:
+        /*!
+         * Set the colours of all the hexes into rgb (3 floats per hex). setColour() is called for
+         * each hex unless batchcolours is true, in which case scalar data with a single-datum
+         * colour map is converted in one call to the ColourMap.
+         */
+        virtual void setColours (std::span<float> rgb)
+        {
+            const std::size_t nhex = rgb.size() / 3u;
+            if (this->batchcolours && this->scalarData != nullptr
+                && this->cm.numDatums() == 1 && this->dcolour.size() >= nhex) {
+                this->cm.convert (std::span<const float>{ this->dcolour }.first (nhex), rgb);
+                return;
+            }
+            for (unsigned int hi = 0; hi < nhex; ++hi) {
+                const std::array<float, 3> clr = this->setColour (hi);
+                rgb[3 * hi] = clr[0];
+                rgb[3 * hi + 1] = clr[1];
+                rgb[3 * hi + 2] = clr[2];
+            }
+        }
+
         //! An overridable function to set the colour of hex hi
         virtual std::array<float, 3> setColour (unsigned int hi)
         {
@@ -1157,6 +1211,8 @@ namespace morph {
         std::vector<float> dcolour;
         std::vector<float> dcolour2;
         std::vector<float> dcolour3;
+        //! The colour of each hex (3 floats per hex), used by initializeVerticesHexesInterpolated
+        std::vector<float> hexcolours;
     };
 
 } // namespace morph
@@ -14,6 +14,7 @@
 #include <morph/vec.h>
 #include <morph/vvec.h>
 #include <morph/range.h>
+#include <morph/sorting.h>
 #include <morph/mathconst.h>
 #include <morph/trait_tests.h>
 #include <morph/MathImpl.h>
@@ -431,104 +432,46 @@ namespace morph {
             }
         }
 
-        //! The bubble sort algorithm, high to low. T could be floating point or
-        //! integer types.
+        /*!
+         * Sort values from high to low. T could be floating point or integer types. Despite the
+         * name, this is no longer a bubble sort; it is a thin wrapper around
+         * morph::sorting::sort (see morph/sorting.h).
+         */
         template<typename T>
-        static void bubble_sort_hi_to_lo (std::vector<T>& values) {
-            T value;
-            unsigned int jplus;
-            for (unsigned int i = 0; i < values.size(); ++i) {
-                for (unsigned int j = 0; j < values.size()-1; ++j) {
-                    jplus = j+1;
-                    if (values[j] < values[jplus]) {
-                        value = values[j];
-                        values[j] = values[jplus];
-                        values[jplus] = value;
-                    }
-                }
-            }
+        static void bubble_sort_hi_to_lo (std::vector<T>& values)
+        {
+            morph::sorting::sort (values, morph::sorting::order::descending);
         }
 
-        //! The bubble sort algorithm, low to high. T could be floating point or
-        //! integer types.
+        //! Sort values from low to high (a wrapper around morph::sorting::sort)
         template<typename T>
-        static void bubble_sort_lo_to_hi (std::vector<T>& values) {
-            T value;
-            unsigned int jplus;
-            for (unsigned int i = 0; i < values.size(); ++i) {
-                for (unsigned int j = 0; j < values.size()-1; ++j) {
-                    jplus = j+1;
-                    if (values[j] > values[jplus]) {
-                        value = values[j];
-                        values[j] = values[jplus];
-                        values[jplus] = value;
-                    }
-                }
-            }
+        static void bubble_sort_lo_to_hi (std::vector<T>& values)
+        {
+            morph::sorting::sort (values, morph::sorting::order::ascending);
         }
 
-        //! Bubble sort, high to low, order is returned in indices, values are left
-        //! unchanged
+        /*!
+         * Stable sort, high to low, order is returned in indices (which is resized to
+         * values.size()), values are left unchanged. A wrapper around morph::sorting::argsort.
+         */
         template<typename T>
-        static void bubble_sort_hi_to_lo (const std::vector<T>& values, std::vector<unsigned int>& indices) {
-
-            std::vector<T> vcopy = values;
-
-            // Init indices to be a sequence
-            for (unsigned int i = 0; i < indices.size(); ++i) {
-                indices[i] = i;
-            }
-
-            T value;
-            unsigned int index;
-            unsigned int jplus;
-            for (unsigned int i = 0; i < vcopy.size(); ++i) {
-                for (unsigned int j = 0; j < vcopy.size()-1; ++j) {
-                    jplus = j+1;
-                    if (vcopy[j] < vcopy[jplus]) {
-                        // Swap value in the copy
-                        value = vcopy[j];
-                        vcopy[j] = vcopy[jplus];
-                        vcopy[jplus] = value;
-                        // Swap index too
-                        index = indices[j];
-                        indices[j] = indices[jplus];
-                        indices[jplus] = index;
-                    }
-                }
-            }
+        static void bubble_sort_hi_to_lo (const std::vector<T>& values, std::vector<unsigned int>& indices)
+        {
+            const morph::vvec<std::size_t> order = morph::sorting::argsort (values, morph::sorting::order::descending);
+            indices.resize (order.size());
+            std::transform (order.begin(), order.end(), indices.begin(), [](std::size_t i) { return static_cast<unsigned int>(i); });
         }
 
-        //! Bubble sort, low to high, order is returned in indices, values are left
-        //! unchanged
+        /*!
+         * Stable sort, low to high, order is returned in indices (which is resized to
+         * values.size()), values are left unchanged. A wrapper around morph::sorting::argsort.
+         */
         template<typename T>
-        static void bubble_sort_lo_to_hi (const std::vector<T>& values, std::vector<unsigned int>& indices) {
-
-            std::vector<T> vcopy = values;
-
-            // Init indices to be a sequence
-            for (unsigned int i = 0; i < indices.size(); ++i) {
-                indices[i] = i;
-            }
-
-            T value;
-            unsigned int index;
-            unsigned int jplus;
-            for (unsigned int i = 0; i < vcopy.size(); ++i) {
-                for (unsigned int j = 0; j < vcopy.size()-1; ++j) {
-                    jplus = j+1;
-                    if (vcopy[j] > vcopy[jplus]) {
-                        // Swap value in the copy
-                        value = vcopy[j];
-                        vcopy[j] = vcopy[jplus];
-                        vcopy[jplus] = value;
-                        // Swap index too
-                        index = indices[j];
-                        indices[j] = indices[jplus];
-                        indices[jplus] = index;
-                    }
-                }
-            }
+        static void bubble_sort_lo_to_hi (const std::vector<T>& values, std::vector<unsigned int>& indices)
+        {
+            const morph::vvec<std::size_t> order = morph::sorting::argsort (values, morph::sorting::order::ascending);
+            indices.resize (order.size());
+            std::transform (order.begin(), order.end(), indices.begin(), [](std::size_t i) { return static_cast<unsigned int>(i); });
         }
 
         /*!
@@ -178,6 +178,15 @@ namespace morph {
         float ellipse_a = 1.0f;
         float ellipse_b = 1.0f;
 
+        /*!
+         * If set, allocate() keeps the HexGrid geometry (with the distances to the boundary)
+         * in a binary cache file in this directory, keyed on hextohex_d, hexspan and the
+         * boundary (the contents of the file at svgpath, or ellipse_a and ellipse_b). Later
+         * runs with the same parameters load the grid from the cache instead of building it. The
+         * loaded grid has the same hexes, boundary hexes and boundary centroid as a built one.
+         */
+        std::string geometry_cache_dir = "";
+
         /*!
          * Simple constructor; no arguments.
          */
@@ -366,31 +375,75 @@ namespace morph {
             }
         }
 
+        /*!
+         * As noiseify_vector_variable, but take the noise from the counter-based generator \a
+         * rng, so that a simulation can be re-run with the same noise (and each of several
+         * simulations can take its own rng.stream(id)).
+         */
+        void noiseify_vector_variable (std::vector<Flt>& v, Flt offset, Flt gain, morph::RandPhilox& rng)
+        {
+            std::vector<Flt> noise (this->hg->num());
+            rng.fill_uniform (std::span<Flt>{noise});
+            for (auto h : this->hg->hexen) {
+                v[h.vi] = noise[h.vi] * gain + offset;
+                if (h.distToBoundary > -0.5) {
+                    Flt bSig = Flt{1} / ( Flt{1} + std::exp (-Flt{100}*(h.distToBoundary-this->boundaryFalloffDist)) );
+                    v[h.vi] = v[h.vi] * bSig;
+                }
+            }
+        }
+
         /*!
          * Perform memory allocations, vector resizes and so on.
          */
         virtual void allocate()
         {
-            // Create a HexGrid. 3 is the 'x span' which determines how
-            // many hexes are initially created. 0 is the z co-ordinate for the HexGrid.
-            this->hg = std::make_unique<HexGrid>(this->hextohex_d, this->hexspan, 0);
-
-            // Either set a boundary using the svgpath, or set it as an ellipse
-            if (this->svgpath != "") {
-                // Read the curves which make a boundary
-                this->r.init (this->svgpath);
-                // Set the boundary in the HexGrid
-                this->hg->setBoundary (this->r.getCorticalPath());
-            } else {
-                this->hg->setEllipticalBoundary (this->ellipse_a, this->ellipse_b);
+            // Read the curves which make a boundary
+            if (this->svgpath != "") { this->r.init (this->svgpath); }
+
+            // Find the geometry cache file for this grid
+            std::string cachefile = "";
+            std::uint64_t cachekey = 0;
+            if (!this->geometry_cache_dir.empty()) {
+                std::uint64_t bhash = 0;
+                if (this->svgpath != "") {
+                    bhash = morph::gridcache::hash_file (this->svgpath);
+                } else {
+                    const float ab[2] = { this->ellipse_a, this->ellipse_b };
+                    bhash = morph::gridcache::fnv1a (ab, sizeof(ab));
+                }
+                cachekey = morph::gridcache::key (this->hextohex_d, this->hexspan, bhash);
+                cachefile = morph::gridcache::filename (this->geometry_cache_dir, "hexgrid", cachekey);
+            }
+
+            this->hg = std::make_unique<HexGrid>();
+            if (cachefile.empty() || !this->hg->load_geometry (cachefile, cachekey)) {
+                // Create a HexGrid. 3 is the 'x span' which determines how
+                // many hexes are initially created. 0 is the z co-ordinate for the HexGrid.
+                this->hg->init (this->hextohex_d, this->hexspan, 0);
+
+                // Either set a boundary using the svgpath, or set it as an ellipse
+                if (this->svgpath != "") {
+                    // Set the boundary in the HexGrid
+                    this->hg->setBoundary (this->r.getCorticalPath());
+                } else {
+                    this->hg->setEllipticalBoundary (this->ellipse_a, this->ellipse_b);
+                }
+                // Compute the distances from the boundary
+                this->hg->computeDistanceToBoundary();
+
+                if (!cachefile.empty()) {
+                    morph::tools::createDir (this->geometry_cache_dir);
+                    this->hg->save_geometry (cachefile, cachekey);
+                }
             }
-            // Compute the distances from the boundary
-            this->hg->computeDistanceToBoundary();
             // Vector size comes from number of Hexes in the HexGrid
             this->nhex = this->hg->num();
             // Spatial d comes from the HexGrid, too.
             this->set_d(this->hg->getd());
             this->set_v(this->hg->getv());
+            // Resolve the gradient stencil for the boundary once
+            this->build_grad_stencil();
         }
 
         /*!
@@ -586,97 +639,189 @@ namespace morph {
          */
         virtual void step() = 0;
 
+    protected:
+        /*!
+         * The gradient stencil. For each hex, the x gradient is
+         *
+         *   grad_wx[hi] * (f[grad_nbr[0][hi]] - f[grad_nbr[1][hi]])
+         *
+         * and the y gradient is
+         *
+         *   grad_wy[hi] * ((f[grad_nbr[2][hi]] - f[grad_nbr[3][hi]]) + (f[grad_nbr[4][hi]] - f[grad_nbr[5][hi]]))
+         *
+         * The choice of neighbours and weights depends on which neighbours each hex has (see
+         * build_grad_stencil), but is made once, so that spacegrad2D and compute_divergence need
+         * not branch. Unused stencil entries point at the hex itself and so contribute 0.
+         */
+        std::array<std::vector<unsigned int>, 6> grad_nbr;
+        std::vector<Flt> grad_wx;
+        std::vector<Flt> grad_wy;
+        //! The hex spacings d and v that grad_wx and grad_wy were built with
+        Flt grad_d = Flt{0};
+        Flt grad_v = Flt{0};
+
+        /*!
+         * Resolve the gradient stencil from the HexGrid's neighbour relations. Hexes with both
+         * east and west neighbours use a central difference in x; those with only one use a one
+         * sided difference. In y, the mean of the nse->nne and nsw->nnw differences is used if
+         * all four neighbours exist, then one-sided differences to the mean of the north (or
+         * south) pair, then the nnw->nsw or nne->nse difference alone.
+         */
+        void build_grad_stencil()
+        {
+            const unsigned int n = this->nhex;
+            for (auto& g : this->grad_nbr) { g.resize (n); }
+            this->grad_wx.resize (n);
+            this->grad_wy.resize (n);
+            this->grad_d = this->d;
+            this->grad_v = this->v;
+
+            for (unsigned int hi = 0; hi < n; ++hi) {
+                // Resolve the neighbours, with missing neighbours pointing at hi
+                auto nb = [hi](const std::vector<int>& dn) {
+                    return dn[hi] < 0 ? hi : static_cast<unsigned int>(dn[hi]);
+                };
+                const bool ne = HAS_NE(hi), nw = HAS_NW(hi);
+                const bool nne = HAS_NNE(hi), nnw = HAS_NNW(hi), nsw = HAS_NSW(hi), nse = HAS_NSE(hi);
+
+                // x: missing neighbours resolve to hi, so only the weight depends on the case
+                this->grad_nbr[0][hi] = nb (this->hg->d_ne);
+                this->grad_nbr[1][hi] = nb (this->hg->d_nw);
+                this->grad_wx[hi] = (ne && nw) ? this->oneover2d : ((ne || nw) ? this->oneoverd : Flt{0});
+
+                // y
+                for (unsigned int k = 2; k < 6; ++k) { this->grad_nbr[k][hi] = hi; }
+                this->grad_wy[hi] = Flt{0};
+                if (nnw && nne && nsw && nse) {
+                    this->grad_nbr[2][hi] = nb (this->hg->d_nne);
+                    this->grad_nbr[3][hi] = nb (this->hg->d_nse);
+                    this->grad_nbr[4][hi] = nb (this->hg->d_nnw);
+                    this->grad_nbr[5][hi] = nb (this->hg->d_nsw);
+                    this->grad_wy[hi] = this->oneover4v;
+                } else if (nnw && nne) {
+                    // ((f_nne + f_nnw)/2 - f) / v
+                    this->grad_nbr[2][hi] = nb (this->hg->d_nne);
+                    this->grad_nbr[4][hi] = nb (this->hg->d_nnw);
+                    this->grad_wy[hi] = this->oneover2v;
+                } else if (nsw && nse) {
+                    // (f - (f_nse + f_nsw)/2) / v
+                    this->grad_nbr[3][hi] = nb (this->hg->d_nse);
+                    this->grad_nbr[5][hi] = nb (this->hg->d_nsw);
+                    this->grad_wy[hi] = this->oneover2v;
+                } else if (nnw && nsw) {
+                    this->grad_nbr[2][hi] = nb (this->hg->d_nnw);
+                    this->grad_nbr[3][hi] = nb (this->hg->d_nsw);
+                    this->grad_wy[hi] = this->oneover2v;
+                } else if (nne && nse) {
+                    this->grad_nbr[2][hi] = nb (this->hg->d_nne);
+                    this->grad_nbr[3][hi] = nb (this->hg->d_nse);
+                    this->grad_wy[hi] = this->oneover2v;
+                }
+            }
+        }
+
+        /*!
+         * Build the gradient stencil if it is out of date: if it was never built (for models
+         * that don't call allocate()), if the number of hexes changed or if d or v changed
+         * since it was built.
+         */
+        void check_grad_stencil()
+        {
+            if (this->grad_wx.size() != this->nhex || this->grad_d != this->d || this->grad_v != this->v) {
+                this->build_grad_stencil();
+            }
+        }
+
+    public:
         /*!
          * 2D spatial integration of the function f. Result placed in gradf.
          *
          * For each Hex, work out the gradient in x and y directions
-         * using whatever neighbours can contribute to an estimate.
+         * using whatever neighbours can contribute to an estimate (see
+         * build_grad_stencil).
          */
-        void spacegrad2D (std::vector<Flt>& f, std::array<std::vector<Flt>, 2>& gradf) {
+        void spacegrad2D (const std::vector<Flt>& f, std::array<std::vector<Flt>, 2>& gradf)
+        {
+            this->check_grad_stencil();
+            const Flt* F = f.data();
+            Flt* gx = gradf[0].data();
+            Flt* gy = gradf[1].data();
+            const unsigned int* n0 = this->grad_nbr[0].data();
+            const unsigned int* n1 = this->grad_nbr[1].data();
+            const unsigned int* n2 = this->grad_nbr[2].data();
+            const unsigned int* n3 = this->grad_nbr[3].data();
+            const unsigned int* n4 = this->grad_nbr[4].data();
+            const unsigned int* n5 = this->grad_nbr[5].data();
+            const Flt* wx = this->grad_wx.data();
+            const Flt* wy = this->grad_wy.data();
 
             // Note - East is positive x; North is positive y.
-#pragma omp parallel for schedule(static)
+#pragma omp parallel for simd schedule(static)
             for (unsigned int hi=0; hi<this->nhex; ++hi) {
+                gx[hi] = (F[n0[hi]] - F[n1[hi]]) * wx[hi];
+                gy[hi] = ((F[n2[hi]] - F[n3[hi]]) + (F[n4[hi]] - F[n5[hi]])) * wy[hi];
+            }
+        }
 
-                // Find x gradient
-                if (HAS_NE(hi) && HAS_NW(hi)) {
-                    gradf[0][hi] = (f[NE(hi)] - f[NW(hi)]) * oneover2d;
-                } else if (HAS_NE(hi)) {
-                    gradf[0][hi] = (f[NE(hi)] - f[hi]) * oneoverd;
-                } else if (HAS_NW(hi)) {
-                    gradf[0][hi] = (f[hi] - f[NW(hi)]) * oneoverd;
-                } else {
-                    // zero gradient in x direction as no neighbours in
-                    // those directions? Or possibly use the average of
-                    // the gradient between the nw,ne and sw,se neighbours
-                    gradf[0][hi] = Flt{0};
-                }
-
-                // Find y gradient
-                if (HAS_NNW(hi) && HAS_NNE(hi) && HAS_NSW(hi) && HAS_NSE(hi)) {
-                    // Full complement. Compute the mean of the nse->nne and nsw->nnw gradients
-                    gradf[1][hi] = ( (f[NNE(hi)] - f[NSE(hi)]) + (f[NNW(hi)] - f[NSW(hi)]) ) * oneover4v;
-                } else if (HAS_NNW(hi) && HAS_NNE(hi)) {
-                    gradf[1][hi] = ( (f[NNE(hi)] + f[NNW(hi)]) * Flt{0.5} - f[hi]) * oneoverv;
-                } else if (HAS_NSW(hi) && HAS_NSE(hi)) {
-                    gradf[1][hi] = (f[hi] - (f[NSE(hi)] + f[NSW(hi)]) * Flt{0.5}) * oneoverv;
-                } else if (HAS_NNW(hi) && HAS_NSW(hi)) {
-                    gradf[1][hi] = (f[NNW(hi)] - f[NSW(hi)]) * oneover2v;
-                } else if (HAS_NNE(hi) && HAS_NSE(hi)) {
-                    gradf[1][hi] = (f[NNE(hi)] - f[NSE(hi)]) * oneover2v;
-                } else {
-                    // Leave grady at 0
-                    gradf[1][hi] = Flt{0};
-                }
+        /*!
+         * Compute the divergence of the vector field with x and y components V[0] and V[1],
+         * placing the result in divV. Uses the same finite differences as spacegrad2D.
+         */
+        void compute_divergence (const std::array<std::vector<Flt>, 2>& V, std::vector<Flt>& divV)
+        {
+            this->check_grad_stencil();
+            const Flt* Vx = V[0].data();
+            const Flt* Vy = V[1].data();
+            Flt* dv = divV.data();
+            const unsigned int* n0 = this->grad_nbr[0].data();
+            const unsigned int* n1 = this->grad_nbr[1].data();
+            const unsigned int* n2 = this->grad_nbr[2].data();
+            const unsigned int* n3 = this->grad_nbr[3].data();
+            const unsigned int* n4 = this->grad_nbr[4].data();
+            const unsigned int* n5 = this->grad_nbr[5].data();
+            const Flt* wx = this->grad_wx.data();
+            const Flt* wy = this->grad_wy.data();
+
+#pragma omp parallel for simd schedule(static)
+            for (unsigned int hi=0; hi<this->nhex; ++hi) {
+                dv[hi] = (Vx[n0[hi]] - Vx[n1[hi]]) * wx[hi]
+                + ((Vy[n2[hi]] - Vy[n3[hi]]) + (Vy[n4[hi]] - Vy[n5[hi]])) * wy[hi];
             }
         }
 
         /*!
          * Compute laplacian of scalar field F, with result placed in lapF.
+         *
+         * This reads the neighbours from HexGrid::d_nbr, in which missing neighbours point
+         * back to the hex itself. That gives a ghost neighbour with the same value as the hex
+         * (a no-flux boundary) without any branching in the loop.
          */
-        virtual void compute_laplace (const std::vector<Flt>& F, std::vector<Flt>& lapF) {
-
-            Flt norm  = Flt{2} / (Flt{3.0} * this->d * this->d);
-
-#pragma omp parallel for schedule(static)
+        virtual void compute_laplace (const std::vector<Flt>& F, std::vector<Flt>& lapF)
+        {
+            const Flt norm  = Flt{2} / (Flt{3.0} * this->d * this->d);
+
+            const unsigned int n = this->hg->d_size_nbr;
+            const unsigned int* nb = this->hg->d_nbr.data();
+            const unsigned int* n_e = nb;
+            const unsigned int* n_ne = nb + n;
+            const unsigned int* n_nw = nb + 2 * n;
+            const unsigned int* n_w = nb + 3 * n;
+            const unsigned int* n_sw = nb + 4 * n;
+            const unsigned int* n_se = nb + 5 * n;
+            const Flt* f = F.data();
+            Flt* lap = lapF.data();
+
+#pragma omp parallel for simd schedule(static)
             for (unsigned int hi=0; hi<this->nhex; ++hi) {
-
-                // 1. The D Del^2 term
-
-                // Compute the sum around the neighbours
-                Flt thesum = Flt{-6} * F[hi];
-                if (HAS_NE(hi)) {
-                    thesum += F[NE(hi)];
-                } else {
-                    thesum += F[hi]; // A ghost neighbour-east with same value as Hex_0
-                }
-                if (HAS_NNE(hi)) {
-                    thesum += F[NNE(hi)];
-                } else {
-                    thesum += F[hi];
-                }
-                if (HAS_NNW(hi)) {
-                    thesum += F[NNW(hi)];
-                } else {
-                    thesum += F[hi];
-                }
-                if (HAS_NW(hi)) {
-                    thesum += F[NW(hi)];
-                } else {
-                    thesum += F[hi];
-                }
-                if (HAS_NSW(hi)) {
-                    thesum += F[NSW(hi)];
-                } else {
-                    thesum += F[hi];
-                }
-                if (HAS_NSE(hi)) {
-                    thesum += F[NSE(hi)];
-                } else {
-                    thesum += F[hi];
-                }
-
-                lapF[hi] = norm * thesum;
+                // The sum around the neighbours, less 6 times the central value
+                Flt thesum = Flt{-6} * f[hi];
+                thesum += f[n_e[hi]];
+                thesum += f[n_ne[hi]];
+                thesum += f[n_nw[hi]];
+                thesum += f[n_w[hi]];
+                thesum += f[n_sw[hi]];
+                thesum += f[n_se[hi]];
+                lap[hi] = norm * thesum;
             }
         }
 
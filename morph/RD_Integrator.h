@@ -0,0 +1,220 @@
+/*!
+ * \file
+ *
+ * A base class for hex-grid reaction-diffusion models of the form
+ *
+ *   du_n/dt = R_n(u) + D_n lap(u_n)   for n = 0..N-1
+ *
+ * that carries out the time integration (Euler, RK2 or RK4) on behalf of the model. The model
+ * supplies the reaction terms as a per-hex functor.
+ *
+ * Each stage of the integration is one pass over the hexes in which the Laplacians, the
+ * reaction terms and the stage update are all computed together, tile by tile. All the stages
+ * of a step run within a single OpenMP parallel region and the stage buffers are held in one
+ * preallocated arena.
+ */
+#pragma once
+
+#include <morph/RD_Base.h>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+namespace morph {
+
+    //! The time integration schemes offered by RD_Integrator
+    enum class IntegrationMethod
+    {
+        euler,
+        rk2,
+        rk4
+    };
+
+    /*!
+     * Reaction-diffusion base class with a fused integrator for N diffusing variables.
+     *
+     * A derived model should, in allocate(), call RD_Integrator::allocate(), size its variables
+     * and point vars at them. It sets the diffusion coefficients D and then, in step(), calls
+     * integrate() with its reaction functor:
+     *
+     * \code
+     * void step()
+     * {
+     *     this->stepCount++;
+     *     this->integrate ([this](const std::array<Flt, 2>& u, unsigned int h) {
+     *         std::array<Flt, 2> r = { this->k1 - this->k2 * u[0] + this->k3 * u[0] * u[0] * u[1],
+     *                                  this->k4 - this->k3 * u[0] * u[0] * u[1] };
+     *         return r;
+     *     });
+     * }
+     * \endcode
+     *
+     * \tparam Flt The floating point type
+     * \tparam N The number of diffusing variables
+     */
+    template <typename Flt, unsigned int N>
+    class RD_Integrator : public RD_Base<Flt>
+    {
+    public:
+        //! The number of hexes processed together in a stage. The Laplacians for a tile are held on the stack.
+        static constexpr unsigned int tile = 256;
+
+        //! The integration scheme
+        IntegrationMethod method = IntegrationMethod::rk4;
+
+        //! Pointers to the model's variables, each of which has nhex elements
+        std::array<std::vector<Flt>*, N> vars = {};
+
+        //! The diffusion coefficient for each variable
+        std::array<Flt, N> D = {};
+
+        /*!
+         * Carry out one timestep of length dt with the reaction terms given by \a reaction. This
+         * must be callable as
+         *
+         *   std::array<Flt, N> reaction (const std::array<Flt, N>& u, unsigned int h)
+         *
+         * returning the reaction terms for the values u of the variables at hex h. It is called
+         * concurrently from several threads.
+         */
+        template <typename R>
+        void integrate (R&& reaction)
+        {
+            const unsigned int n = this->nhex;
+            const unsigned int nn = N * n;
+            if (this->arena.size() != 3 * nn) { this->arena.assign (3 * nn, Flt{0}); }
+            Flt* acc = this->arena.data();
+            Flt* tstA = acc + nn;
+            Flt* tstB = tstA + nn;
+
+            std::array<Flt*, N> u;
+            std::array<const Flt*, N> u_in;
+            std::array<const Flt*, N> a_in;
+            std::array<const Flt*, N> b_in;
+            for (unsigned int f = 0; f < N; ++f) {
+                u[f] = this->vars[f]->data();
+                u_in[f] = u[f];
+                a_in[f] = tstA + f * n;
+                b_in[f] = tstB + f * n;
+            }
+
+            const Flt half = Flt{0.5};
+            const Flt third = Flt{1} / Flt{3};
+            const Flt sixth = Flt{1} / Flt{6};
+
+            switch (this->method) {
+            case IntegrationMethod::euler:
+            {
+#pragma omp parallel
+                {
+                    this->stage (reaction, u_in, [&](unsigned int f, unsigned int h, Flt k) {
+                        tstA[f * n + h] = u[f][h] + k;
+                    });
+                    // u can only be updated once all of its neighbour values have been read
+                    for (unsigned int f = 0; f < N; ++f) {
+#pragma omp for schedule(static)
+                        for (unsigned int h = 0; h < n; ++h) { u[f][h] = tstA[f * n + h]; }
+                    }
+                }
+                break;
+            }
+            case IntegrationMethod::rk2:
+            {
+                // The midpoint method
+#pragma omp parallel
+                {
+                    this->stage (reaction, u_in, [&](unsigned int f, unsigned int h, Flt k) {
+                        tstA[f * n + h] = u[f][h] + k * half;
+                    });
+                    this->stage (reaction, a_in, [&](unsigned int f, unsigned int h, Flt k) {
+                        u[f][h] += k;
+                    });
+                }
+                break;
+            }
+            case IntegrationMethod::rk4:
+            default:
+            {
+#pragma omp parallel
+                {
+                    this->stage (reaction, u_in, [&](unsigned int f, unsigned int h, Flt k) {
+                        acc[f * n + h] = k * sixth;
+                        tstB[f * n + h] = u[f][h] + k * half;
+                    });
+                    this->stage (reaction, b_in, [&](unsigned int f, unsigned int h, Flt k) {
+                        acc[f * n + h] += k * third;
+                        tstA[f * n + h] = u[f][h] + k * half;
+                    });
+                    this->stage (reaction, a_in, [&](unsigned int f, unsigned int h, Flt k) {
+                        acc[f * n + h] += k * third;
+                        tstB[f * n + h] = u[f][h] + k;
+                    });
+                    // Stage 4 reads only tstB from the neighbours, so u can be updated in place
+                    this->stage (reaction, b_in, [&](unsigned int f, unsigned int h, Flt k) {
+                        u[f][h] += acc[f * n + h] + k * sixth;
+                    });
+                }
+                break;
+            }
+            }
+        }
+
+    protected:
+        //! The stage buffers: an accumulator for the RK4 sum and two test point buffers, each N * nhex long
+        std::vector<Flt> arena;
+
+        /*!
+         * One integration stage, to be called from within a parallel region. For each hex h and
+         * variable f, computes k = dt * (R_f(in) + D_f lap(in_f)) at h and passes it to
+         * write (f, h, k). There is an implied barrier at the end of the stage.
+         */
+        template <typename R, typename W>
+        void stage (R& reaction, const std::array<const Flt*, N>& in, W&& write)
+        {
+            const unsigned int n = this->nhex;
+            const unsigned int ntiles = (n + tile - 1) / tile;
+            const unsigned int stride = this->hg->d_size_nbr;
+            const unsigned int* n_e = this->hg->d_nbr.data();
+            const unsigned int* n_ne = n_e + stride;
+            const unsigned int* n_nw = n_e + 2 * stride;
+            const unsigned int* n_w = n_e + 3 * stride;
+            const unsigned int* n_sw = n_e + 4 * stride;
+            const unsigned int* n_se = n_e + 5 * stride;
+            const Flt _dt = this->dt;
+
+#pragma omp for schedule(static)
+            for (unsigned int t = 0; t < ntiles; ++t) {
+                const unsigned int h0 = t * tile;
+                const unsigned int h1 = std::min (h0 + tile, n);
+
+                // The diffusion terms for the tile (see RD_Base::compute_laplace)
+                Flt diff[N][tile];
+                for (unsigned int f = 0; f < N; ++f) {
+                    const Flt* uf = in[f];
+                    const Flt dnorm = this->D[f] * this->twoover3dd;
+                    Flt* df = diff[f];
+#pragma omp simd
+                    for (unsigned int h = h0; h < h1; ++h) {
+                        Flt thesum = Flt{-6} * uf[h];
+                        thesum += uf[n_e[h]];
+                        thesum += uf[n_ne[h]];
+                        thesum += uf[n_nw[h]];
+                        thesum += uf[n_w[h]];
+                        thesum += uf[n_sw[h]];
+                        thesum += uf[n_se[h]];
+                        df[h - h0] = dnorm * thesum;
+                    }
+                }
+
+                // The reaction terms and the stage update
+                std::array<Flt, N> uh;
+                for (unsigned int h = h0; h < h1; ++h) {
+                    for (unsigned int f = 0; f < N; ++f) { uh[f] = in[f][h]; }
+                    const std::array<Flt, N> r = reaction (uh, h);
+                    for (unsigned int f = 0; f < N; ++f) { write (f, h, _dt * (r[f] + diff[f][h - h0])); }
+                }
+            }
+        }
+    };
+
+} // namespace morph
@@ -75,20 +75,148 @@ namespace morph {
         void add (morph::vec<float> coord, Flt value)
         {
             std::array<float, 3> clr = this->cm.convert (this->colourScale.transform_one (value));
-            this->marker (coord, clr, this->radiusFixed);
-            this->reinit_buffers();
+            this->add_marker (coord, clr, this->radiusFixed);
         }
 
         //! Additional point with variable size
         void add (morph::vec<float> coord, Flt value, Flt size)
         {
             std::array<float, 3> clr = this->cm.convert (this->colourScale.transform_one (value));
-            this->marker (coord, clr, size);
-            this->reinit_buffers();
+            this->add_marker (coord, clr, size);
+        }
+
+        //! Add one marker, as an instance if the model is already instanced
+        void add_marker (const morph::vec<float> coord, const std::array<float, 3>& clr, const Flt size)
+        {
+            if (!this->instanceData.empty()) {
+                this->instance_push (coord, static_cast<float>(size), clr);
+                this->reinit_instance_buffer();
+            } else {
+                this->marker (coord, clr, size);
+                this->reinit_buffers();
+            }
         }
 
         //! Compute spheres for a scatter plot
         void initializeVertices()
+        {
+            this->computeMarkers (false);
+        }
+
+        /*!
+         * Update the scalar data. For an instanced ScatterVisual, only the per-instance buffer is
+         * re-computed and re-uploaded.
+         */
+        void updateData (const std::vector<Flt>* _data) override
+        {
+            this->scalarData = _data;
+            this->reinitMarkers();
+        }
+
+        //! Update coordinate and scalar data (only the instance buffer, if instanced)
+        void updateData (std::vector<vec<float>>* _coords, const std::vector<Flt>* _data,
+                         const scale<Flt, float>& zscale) override
+        {
+            this->dataCoords = _coords;
+            this->scalarData = _data;
+            this->zScale = zscale;
+            this->reinitMarkers();
+        }
+
+        //! Update coordinate and scalar data (only the instance buffer, if instanced)
+        void updateData (std::vector<vec<float>>* _coords, const std::vector<Flt>* _data,
+                         const scale<Flt, float>& zscale, const scale<Flt, float>& cscale) override
+        {
+            this->dataCoords = _coords;
+            this->scalarData = _data;
+            this->zScale = zscale;
+            this->colourScale = cscale;
+            this->reinitMarkers();
+        }
+
+        //! Update just the coordinate data (only the instance buffer, if instanced)
+        void updateCoords (std::vector<vec<float>>* _coords) override
+        {
+            this->dataCoords = _coords;
+            this->reinitMarkers();
+        }
+
+        // Bring in the VisualDataModel::updateData overloads that are not overridden here
+        using VisualDataModel<Flt, glver>::updateData;
+
+        // The constexpr, unordered geodesic code is no slower than the regular
+        // VisualModel::computeSphere(), but leave this off for now (if true, C++-20 is
+        // required)
+        static constexpr bool draw_spheres_as_geodesics = false;
+
+        //! Set this->radiusFixed, then re-compute vertices.
+        void setRadius (float fr)
+        {
+            this->radiusFixed = fr;
+            this->reinitMarkers();
+        }
+
+        // How to show the scatter points?
+        markerstyle markers = morph::markerstyle::sphere;
+
+        // Marker direction, if relevant. Used for length of rod markers
+        morph::vec<float, 3> markerdirn = this->uz;
+
+        //! Change this to get larger or smaller spheres.
+        Flt radiusFixed = Flt{0.05};
+        Flt sizeFactor = Flt{0};
+
+        // Hues for colour control with vectorData
+        float hue1 = 0.1f;
+        float hue2 = 0.5f;
+        float hue3 = -1.0f;
+
+        // Do we add index labels?
+        bool labelIndices = false;
+
+        morph::vec<float, 3> labelOffset = { 0.04f, 0.0f, 0.0f };
+        float labelSize = 0.03f;
+
+        /*!
+         * If true, draw the markers with GPU instancing: one template mesh for the marker
+         * shape, drawn once per data point from a buffer of per-point position, size and
+         * colour. This uses a fraction of the memory of the full per-marker geometry and an
+         * update of the data only rewrites the instance buffer. Rod markers are not instanced.
+         * Visual::savegltf will only see the template mesh of an instanced model.
+         */
+        bool instancing = false;
+
+    protected:
+        //! True if the markers should be (and can be) drawn by instancing
+        bool instanced_markers() const { return this->instancing && this->markers != morph::markerstyle::rod; }
+
+        //! The marker style of the current template mesh
+        markerstyle template_markers = morph::markerstyle::sphere;
+
+        /*!
+         * Re-compute after a change of data. If the model is already instanced with the right
+         * template mesh, then only the instance buffer needs to be re-computed. Otherwise,
+         * reinit() the whole model.
+         */
+        void reinitMarkers()
+        {
+            if (this->instanced_markers() && !this->instanceData.empty() && !this->indices.empty()
+                && this->template_markers == this->markers && !this->labelIndices) {
+                this->instanceData.clear();
+                this->computeMarkers (true);
+                // Instance data may have been rejected (a size mismatch); reinit will report that
+                if (this->instanceData.empty()) { this->reinit(); } else { this->reinit_instance_buffer(); }
+            } else {
+                this->reinit();
+            }
+        }
+
+        /*!
+         * Compute the markers. Either compute a full mesh for each marker, or, if instanced, a
+         * single template mesh plus the per-instance data. If \a instances_only, then leave
+         * the template mesh (and the labels) alone and re-compute only the instance data.
+         */
+        void computeMarkers (const bool instances_only)
         {
             unsigned int ncoords = this->dataCoords == nullptr ? 0 : this->dataCoords->size();
             if (ncoords == 0) { return; }
@@ -142,6 +270,16 @@ namespace morph {
 
             } // else no scaling required - spheres will be one colour
 
+            const bool inst = this->instanced_markers();
+            if (inst) {
+                if (!instances_only) {
+                    // The template mesh: a marker of unit size at the origin
+                    this->marker ({ 0.0f, 0.0f, 0.0f }, this->cm.getHueRGB(), Flt{1});
+                    this->template_markers = this->markers;
+                }
+                this->instanceData.reserve (this->instance_stride * ncoords);
+            }
+
             for (unsigned int i = 0; i < ncoords; ++i) {
                 // Scale colour (or use single colour)
                 std::array<float, 3> clr = this->cm.getHueRGB();
@@ -154,51 +292,19 @@ namespace morph {
                     clr = this->cm.convert (vdcopy1[i], vdcopy2[i]);
                 }
 
-                if (this->sizeFactor == Flt{0}) {
-                    this->marker ((*this->dataCoords)[i], clr, this->radiusFixed);
+                const Flt size = this->sizeFactor == Flt{0} ? this->radiusFixed : dcopy[i] * this->sizeFactor;
+                if (inst) {
+                    this->instance_push ((*this->dataCoords)[i], static_cast<float>(size), clr);
                 } else {
-                    this->marker ((*this->dataCoords)[i], clr, dcopy[i] * this->sizeFactor);
+                    this->marker ((*this->dataCoords)[i], clr, size);
                 }
 
-                if (this->labelIndices == true) {
+                if (this->labelIndices == true && !instances_only) {
                     // Draw an index label...
                     this->addLabel (std::to_string (i), (*this->dataCoords)[i] + labelOffset, morph::TextFeatures(labelSize) );
                 }
             }
         }
-
-        // The constexpr, unordered geodesic code is no slower than the regular
-        // VisualModel::computeSphere(), but leave this off for now (if true, C++-20 is
-        // required)
-        static constexpr bool draw_spheres_as_geodesics = false;
-
-        //! Set this->radiusFixed, then re-compute vertices.
-        void setRadius (float fr)
-        {
-            this->radiusFixed = fr;
-            this->reinit();
-        }
-
-        // How to show the scatter points?
-        markerstyle markers = morph::markerstyle::sphere;
-
-        // Marker direction, if relevant. Used for length of rod markers
-        morph::vec<float, 3> markerdirn = this->uz;
-
-        //! Change this to get larger or smaller spheres.
-        Flt radiusFixed = Flt{0.05};
-        Flt sizeFactor = Flt{0};
-
-        // Hues for colour control with vectorData
-        float hue1 = 0.1f;
-        float hue2 = 0.5f;
-        float hue3 = -1.0f;
-
-        // Do we add index labels?
-        bool labelIndices = false;
-
-        morph::vec<float, 3> labelOffset = { 0.04f, 0.0f, 0.0f };
-        float labelSize = 0.03f;
     };
 
 } // namespace morph
@@ -310,7 +310,7 @@ namespace morph {
          */
         static void
         vertex_test (HexGrid* hg, std::vector<Flt>& f,
-                     std::list<Hex>::iterator h, std::list<DirichVtx<Flt> >& vertices) {
+                     hexlist::iterator h, std::list<DirichVtx<Flt> >& vertices) {
 
             // For each hex, examine its neighbours, counting number of different neighbours.
             std::set<Flt> n_ids;
@@ -451,14 +451,14 @@ namespace morph {
             // side. _Initially_, point hexit at the hex that's on the inside of the domain for
             // which v is a Dirichlet vertex - v.hi. At least, this is what you do when walking OUT
             // to a neighbour vertex that's part of another domain.
-            std::list<Hex>::iterator hexit = v.hi;
+            hexlist::iterator hexit = v.hi;
             // point hexit_neighb to the hexes on the edgedoms[1] side
-            std::list<Hex>::iterator hexit_neighb = v.hi;
+            hexlist::iterator hexit_neighb = v.hi;
             // The first hex, inside the domain.
-            std::list<Hex>::iterator hexit_first = v.hi;
+            hexlist::iterator hexit_first = v.hi;
             // Temporary hex pointers
-            std::list<Hex>::iterator hexit_next = v.hi;
-            std::list<Hex>::iterator hexit_last = v.hi;
+            hexlist::iterator hexit_next = v.hi;
+            hexlist::iterator hexit_last = v.hi;
 
             // Set true when we find the partner vertex.
             bool partner_found = false;
@@ -947,7 +947,7 @@ namespace morph {
             // simulations. From this list, I can find vertex sets, whilst deleting from the list
             // until it is empty, and know that I will have discovered all the domain vertex sets.
             // list<DirichVtx<Flt> > vertices;
-            std::list<Hex>::iterator h = hg->hexen.begin();
+            hexlist::iterator h = hg->hexen.begin();
             while (h != hg->hexen.end()) {
                 vertex_test (hg, f, h, vertices);
                 // Move on to the next Hex in hexen
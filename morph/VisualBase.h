@@ -72,7 +72,16 @@ namespace morph {
         //! Set true to output some user information to stdout (e.g. user requested quit)
         userInfoStdout,
         //! If true, output morph version to stdout
-        versionStdout
+        versionStdout,
+        //! If true, draw every VisualModel, even those that lie outside the view frustum
+        disableFrustumCulling,
+        /*!
+         * If true, draw the texts of all the VisualModels after all of their triangles, so that
+         * the shader program is switched once per frame rather than twice for each model that
+         * has texts. This changes how texts are composed (and alpha blended) with the models
+         * drawn after them.
+         */
+        deferTexts
     };
 
     //! Whether to render with perspective or orthographic (or even a cylindrical projection)
@@ -381,6 +390,9 @@ namespace morph {
         //! Set true to output some user information to stdout (e.g. user requested quit)
         void userInfoStdout (const bool val) { this->options.set (visual_options::userInfoStdout, val); }
 
+        //! Set false to draw every VisualModel, rather than skipping those that are out of view
+        void frustumCulling (const bool val) { this->options.set (visual_options::disableFrustumCulling, !val); }
+
         //! How big should the steps in scene translation be when scrolling?
         float scenetrans_stepsize = 0.1f;
 
@@ -16,6 +16,40 @@ namespace morph {
 
     namespace visgl {
 
+        // The locations of the per-model uniforms in a shader program. These are looked up once,
+        // when the program is linked, rather than by name for every model on every frame. A
+        // location of -1 means the program has no such uniform.
+        struct model_uniforms
+        {
+            int /*GLint*/ alpha = -1;
+            int /*GLint*/ v_matrix = -1;
+            int /*GLint*/ m_matrix = -1;
+            //! Only in the graphics shader programs
+            int /*GLint*/ instanced = -1;
+            int /*GLint*/ scalar_colour = -1;
+            int /*GLint*/ scalar_params = -1;
+            int /*GLint*/ scalar_nan = -1;
+            int /*GLint*/ scalar_cmap = -1;
+            //! Only in the text shader program
+            int /*GLint*/ text_colour = -1;
+        };
+
+        // The locations of the per-frame uniforms in a shader program, which morph::Visual sets
+        // once per frame. Looked up along with the model_uniforms when the program is linked.
+        struct scene_uniforms
+        {
+            int /*GLint*/ p_matrix = -1;
+            //! Only in the graphics shader programs
+            int /*GLint*/ light_colour = -1;
+            int /*GLint*/ ambient_intensity = -1;
+            int /*GLint*/ diffuse_position = -1;
+            int /*GLint*/ diffuse_intensity = -1;
+            //! Only in the cylindrical graphics shader program
+            int /*GLint*/ cyl_cam_pos = -1;
+            int /*GLint*/ cyl_radius = -1;
+            int /*GLint*/ cyl_height = -1;
+        };
+
         // A container struct for the shader program identifiers used in a morph::Visual. Separate
         // from morph::Visual so that it can be used in morph::VisualModel as well, which does not
         // #include morph/Visual.h.
@@ -25,6 +59,14 @@ namespace morph {
             unsigned int /*GLuint*/ gprog = 0;
             //! A text shader program, which uses textures to draw text on quads.
             unsigned int /*GLuint*/ tprog = 0;
+            //! The uniform locations in gprog
+            model_uniforms gprog_uniforms;
+            //! The uniform locations in tprog
+            model_uniforms tprog_uniforms;
+            //! The per-frame uniform locations in gprog
+            scene_uniforms gprog_scene;
+            //! The per-frame uniform locations in tprog
+            scene_uniforms tprog_scene;
         };
 
         // This defines different graphics shader types, as used in morph::Visual. The essential
@@ -38,14 +80,18 @@ namespace morph {
         };
 
         //! The locations for the position, normal and colour vertex attributes in the
-        //! morph::Visual GLSL programs
-        enum AttribLocn { posnLoc = 0, normLoc = 1, colLoc = 2, textureLoc = 3 };
+        //! morph::Visual GLSL programs. instPosnLoc (position and scale) and instColLoc are the
+        //! per-instance attributes of instanced models. scalarLoc is the per-vertex scalar of a
+        //! model that is coloured with a colour map in the shader.
+        enum AttribLocn { posnLoc = 0, normLoc = 1, colLoc = 2, textureLoc = 3, instPosnLoc = 4, instColLoc = 5, scalarLoc = 6 };
 
         //! A struct to hold information about font glyph properties
         struct CharInfo
         {
-            //! ID handle of the glyph texture
-            unsigned int textureID;
+            //! The layer (page) of the face's glyph atlas texture that holds the glyph
+            unsigned int layer;
+            //! The glyph's texture coordinates in its atlas layer: left, top, right, bottom
+            morph::vec<float, 4> uv;
             //! Size of glyph
             morph::vec<int,2>  size;
             //! Offset from baseline to left/top of glyph
@@ -4,7 +4,10 @@
 #pragma once
 
 #include <vector>
+#include <stdexcept>
+#include <cmath>
 #include <morph/vec.h>
+#include <morph/range.h>
 #include <morph/VisualModel.h>
 #include <morph/ColourMap.h>
 #include <morph/scale.h>
@@ -62,6 +65,11 @@ namespace morph {
         void updateCScale (const scale<T, float>& cscale)
         {
             this->colourScale = cscale;
+            // When the data are coloured in the shader, only the shader's scaling has to change
+            if (!this->vertexScalars.empty()) {
+                this->setScalarScalingFromCScale();
+                return;
+            }
             this->reinit();
         }
 
@@ -77,10 +85,26 @@ namespace morph {
             this->cm.setType (_cmt);
         }
 
-        //! Update the scalar data
+        /*!
+         * Change the colour map and recolour the model. When the data are coloured in the shader
+         * (see gpuColourMap) this only replaces the colour map texture; otherwise the model is
+         * rebuilt.
+         */
+        void updateColourMap (ColourMapType _cmt, const float _hue = 0.0f)
+        {
+            this->setColourMap (_cmt, _hue);
+            if (!this->vertexScalars.empty() && this->cm.numDatums() == 1) {
+                this->setScalarColourMap (this->cm.rgb_table(), ColourMap<float>::nanColour (this->cm.getType()));
+                return;
+            }
+            this->reinit();
+        }
+
+        //! Update the scalar data. Data that is coloured in the shader may need only the vertex scalars to be updated.
         virtual void updateData (const std::vector<T>* _data)
         {
             this->scalarData = _data;
+            if (this->updateVertexScalars()) { return; }
             this->reinit();
         }
 
@@ -148,6 +172,16 @@ namespace morph {
         //! object to generate different types of map.
         ColourMap<float> cm;
 
+        /*!
+         * If true, colour scalarData in the shader rather than on the CPU, in the models that
+         * support it (GridVisual, HexGridVisual and CartGridVisual). The vertices then carry the
+         * data as one float each, which the shader scales with colourScale and looks up in a
+         * texture made from cm. updateColourMap() and updateCScale() become texture and
+         * uniform updates, and updateData() uploads only the data if it does not also set the
+         * vertex positions (that is, if zScale is a null scaling). Set before finalize().
+         */
+        bool gpuColourMap = false;
+
         //! A Scaling function for the colour map. Perhaps a scale class contains a
         //! colour map? If not, then this scale might well be autoscaled. Applied to scalarData.
         scale<T, float> colourScale;
@@ -178,6 +212,91 @@ namespace morph {
         //! graph, quiver plot). Note fixed type of float, which is suitable for
         //! OpenGL coordinates. Not const as child code may resize or update content.
         std::vector<vec<float>>* dataCoords = nullptr;
+
+    protected:
+        //! The number of vertices per datum that are coloured from vertexScalars (0 if none)
+        std::size_t scalar_vertices_per_datum = 0;
+        //! True if vertexScalars contains NaNs. NaN data gives NaN positions, even with a null zScale.
+        bool scalar_data_has_nan = false;
+
+        /*!
+         * Called by a derived model at the end of initializeVertices(), if it has made \a nv
+         * vertices for each datum, in order, starting from the first vertex. If gpuColourMap is
+         * set (and there is scalar data for a one dimensional colour map) the data is written into
+         * vertexScalars and these vertices are flagged to be coloured from it in the shader.
+         * Returns true if the data is coloured in the shader.
+         */
+        bool setupScalarColouring (const std::size_t nv)
+        {
+            this->vertexScalars.clear();
+            this->scalar_vertices_per_datum = 0;
+            if (this->gpuColourMap == false || this->scalarData == nullptr || nv == 0 || this->cm.numDatums() != 1) {
+                return false;
+            }
+            const std::size_t n_scalars = this->scalarData->size() * nv;
+            if (n_scalars > this->vertexColors.size() / 3u) {
+                throw std::runtime_error ("VisualDataModel::setupScalarColouring: fewer vertices than expected");
+            }
+            // Set the colour map first; if it can't be set, the vertices keep their CPU colours
+            this->setScalarColourMap (this->cm.rgb_table(), ColourMap<float>::nanColour (this->cm.getType()));
+            this->setScalarScalingFromCScale();
+            this->scalar_vertices_per_datum = nv;
+            this->vertexScalars.assign (this->vertexColors.size() / 3u, 0.0f);
+            for (std::size_t v = 0; v < n_scalars; ++v) {
+                this->vertexColors[3 * v] = this->scalar_colour_flag;
+            }
+            this->scalar_data_has_nan = this->copyScalarData();
+            return true;
+        }
+
+        /*!
+         * If the data are coloured in the shader and do not set the vertex positions (zScale is a
+         * null scaling and neither the old nor the new data contain NaNs), copy scalarData into
+         * vertexScalars and upload only these. Returns false if the model has to be rebuilt.
+         */
+        bool updateVertexScalars()
+        {
+            if (this->vertexScalars.empty() || this->scalarData == nullptr || this->scalar_data_has_nan) { return false; }
+            if (this->zScale.do_autoscale == true || !this->zScale.ready()
+                || this->zScale.getParams (0) != 0.0f || this->zScale.getParams (1) != 0.0f) {
+                return false;
+            }
+            if (this->scalarData->size() * this->scalar_vertices_per_datum > this->vertexScalars.size()) { return false; }
+            this->scalar_data_has_nan = this->copyScalarData();
+            if (this->scalar_data_has_nan) { return false; }
+            this->setScalarScalingFromCScale();
+            this->reinit_scalar_buffer();
+            return true;
+        }
+
+        //! Write each datum of scalarData into the vertexScalars of its vertices. Returns true if there are NaNs.
+        bool copyScalarData()
+        {
+            const std::size_t nv = this->scalar_vertices_per_datum;
+            float* vs = this->vertexScalars.data();
+            bool has_nan = false;
+            for (const T& d : *this->scalarData) {
+                const float f = static_cast<float>(d);
+                has_nan = has_nan || std::isnan (f);
+                for (std::size_t j = 0; j < nv; ++j) { *vs++ = f; }
+            }
+            return has_nan;
+        }
+
+        //! Copy colourScale into the shader's scaling of the vertex scalars, autoscaling it first if necessary
+        void setScalarScalingFromCScale()
+        {
+            if (this->colourScale.do_autoscale == true && !this->colourScale.ready()) {
+                morph::range<T> r (morph::range_init::for_search);
+                for (const T& d : *this->scalarData) { r.update (d); }
+                this->colourScale.compute_scaling (r);
+            }
+            if (!this->colourScale.ready()) {
+                throw std::runtime_error ("VisualDataModel: colourScale params are not set and do_autoscale is set false");
+            }
+            this->setScalarScaling (this->colourScale.getParams (0), this->colourScale.getParams (1),
+                                    this->colourScale.getType() == scaling_function::Logarithmic);
+        }
     };
 
 } // namespace morph
@@ -105,20 +105,40 @@ namespace morph {
     "uniform mat4 v_matrix;\n"
     "uniform mat4 p_matrix;\n"
     "uniform float alpha;\n"
+    "uniform bool instanced;\n"
+    "uniform bool scalar_colour;\n"
+    "uniform vec3 scalar_params;\n"
+    "uniform vec3 scalar_nan;\n"
+    "uniform sampler2D scalar_cmap;\n"
     "layout(location = 0) in vec4 position;\n"
     "layout(location = 1) in vec4 normalin;\n"
     "layout(location = 2) in vec3 color;\n"
+    "layout(location = 4) in vec4 instposn;\n"
+    "layout(location = 5) in vec3 instcolor;\n"
+    "layout(location = 6) in float scalar;\n"
     "out VERTEX\n"
     "{\n"
     "    vec4 normal;\n"
     "    vec4 color;\n"
     "    vec3 fragpos;\n"
     "} vertex;\n"
+    "vec3 scalar_to_colour (float s)\n"
+    "{\n"
+    "    float u = (scalar_params.z > 0.5 ? log (s) : s) * scalar_params.x + scalar_params.y;\n"
+    "    if (isnan (u)) { return scalar_nan; }\n"
+    "    float r = clamp (u, 0.0, 1.0) * float(textureSize (scalar_cmap, 0).x - 1);\n"
+    "    int i = int(r);\n"
+    "    if (r - float(i) >= 0.5) { ++i; }\n"
+    "    return texelFetch (scalar_cmap, ivec2(i, 0), 0).rgb;\n"
+    "}\n"
     "void main()\n"
     "{\n"
-    "    gl_Position = (p_matrix * v_matrix * m_matrix * position);\n"
-    "    vertex.color = vec4(color, alpha);\n"
-    "    vertex.fragpos = vec3(m_matrix * position);\n"
+    "    vec4 pos = instanced ? vec4(position.xyz * instposn.w + instposn.xyz, 1.0) : position;\n"
+    "    vec3 col = instanced ? instcolor : color;\n"
+    "    if (scalar_colour && col.r < 0.0) { col = scalar_to_colour (scalar); }\n"
+    "    gl_Position = (p_matrix * v_matrix * m_matrix * pos);\n"
+    "    vertex.color = vec4(col, alpha);\n"
+    "    vertex.fragpos = vec3(m_matrix * pos);\n"
     "    vertex.normal = normalin;\n"
     "}\n";
 
@@ -169,11 +189,11 @@ namespace morph {
     "layout(location = 1) in vec4 vnormal;\n"
     "layout(location = 2) in vec4 vcolor;\n"
     "layout(location = 3) in vec4 texture;\n"
-    "out vec2 TexCoords;\n"
+    "out vec3 TexCoords;\n"
     "void main()\n"
     "{\n"
     "    gl_Position = p_matrix * v_matrix * m_matrix * position;\n"
-    "    TexCoords = texture.xy;\n"
+    "    TexCoords = texture.xyz;\n"
     "}";
 
     std::string getDefaultTextVtxShader (const int glver)
@@ -185,9 +205,9 @@ namespace morph {
     }
 
     // Default text fragment shader. See VisText.frag.glsl
-    const char* defaultTextFragShader = "in vec2 TexCoords;\n"
+    const char* defaultTextFragShader = "in vec3 TexCoords;\n"
     "out vec4 color;\n"
-    "uniform sampler2D text;\n"
+    "uniform mediump sampler2DArray text;\n"
     "uniform vec3 textColor;\n"
     "void main()\n"
     "{\n"
@@ -212,21 +232,41 @@ namespace morph {
     "uniform float cyl_radius = 0.005;\n"
     "uniform float cyl_height = 0.01;\n"
     "uniform vec4 cyl_cam_pos = vec4(0);\n"
+    "uniform bool instanced;\n"
+    "uniform bool scalar_colour;\n"
+    "uniform vec3 scalar_params;\n"
+    "uniform vec3 scalar_nan;\n"
+    "uniform sampler2D scalar_cmap;\n"
     "layout(location = 0) in vec4 position;\n"
     "layout(location = 1) in vec4 normalin;\n"
     "layout(location = 2) in vec3 color;\n"
+    "layout(location = 4) in vec4 instposn;\n"
+    "layout(location = 5) in vec3 instcolor;\n"
+    "layout(location = 6) in float scalar;\n"
     "out VERTEX\n"
     "{\n"
     "    vec4 normal;\n"
     "    vec4 color;\n"
     "    vec3 fragpos;\n"
     "} vertex;\n"
+    "vec3 scalar_to_colour (float s)\n"
+    "{\n"
+    "    float u = (scalar_params.z > 0.5 ? log (s) : s) * scalar_params.x + scalar_params.y;\n"
+    "    if (isnan (u)) { return scalar_nan; }\n"
+    "    float r = clamp (u, 0.0, 1.0) * float(textureSize (scalar_cmap, 0).x - 1);\n"
+    "    int i = int(r);\n"
+    "    if (r - float(i) >= 0.5) { ++i; }\n"
+    "    return texelFetch (scalar_cmap, ivec2(i, 0), 0).rgb;\n"
+    "}\n"
     "void main()\n"
     "{\n"
     "    const float pi = 3.1415927;\n"
     "    const float two_pi = 6.283185307;\n"
     "    const float heading_offset = 1.570796327;\n"
-    "    vec4 pv = (v_matrix * m_matrix * position);\n"
+    "    vec4 pos = instanced ? vec4(position.xyz * instposn.w + instposn.xyz, 1.0) : position;\n"
+    "    vec3 col = instanced ? instcolor : color;\n"
+    "    if (scalar_colour && col.r < 0.0) { col = scalar_to_colour (scalar); }\n"
+    "    vec4 pv = (v_matrix * m_matrix * pos);\n"
     "    vec4 ray = pv - (v_matrix * cyl_cam_pos);\n"
     "    vec3 rho_phi_z;\n"
     "    rho_phi_z[0] = sqrt (ray.x * ray.x + ray.y * ray.y);\n"
@@ -241,13 +281,13 @@ namespace morph {
     "        y_s = (cyl_radius * tan (theta)) / cyl_height;\n"
     "        gl_PointSize = 1;\n"
     "        gl_Position = vec4(x_s, y_s, -1.0, 1.0);\n"
-    "        vertex.color = vec4(color, alpha);\n"
-    "        vertex.fragpos = vec3(m_matrix * position);\n"
+    "        vertex.color = vec4(col, alpha);\n"
+    "        vertex.fragpos = vec3(m_matrix * pos);\n"
     "        vertex.normal = normalin;\n"
     "    } else {\n"
     "        gl_Position = vec4(0.0, 0.0, -100.0, 1.0);\n"
-    "        vertex.color = vec4(color, 0.0);\n"
-    "        vertex.fragpos = vec3(m_matrix * position);\n"
+    "        vertex.color = vec4(col, 0.0);\n"
+    "        vertex.fragpos = vec3(m_matrix * pos);\n"
     "        vertex.normal = normalin;\n"
     "    }\n"
     "}\n";
@@ -13,6 +13,8 @@
 #pragma once
 
 #include <map>
+#include <vector>
+#include <cstring>
 #include <iostream>
 #include <utility>
 #include <fstream>
@@ -179,7 +181,98 @@ namespace morph {
             //! The OpenGL character info stuff
             std::map<char32_t, morph::visgl::CharInfo> glchars;
 
+            //! The glyph atlas. An OpenGL 2D texture array with one square layer per atlas page
+            unsigned int atlas = 0;
+            //! The width (and height) of each atlas page, in pixels
+            unsigned int atlas_size = 0;
+            //! The number of pages (texture array layers) in the atlas
+            unsigned int atlas_pages = 0;
+            //! The largest atlas page that will be used. Fonts with large fontpixels use many pages.
+            static constexpr unsigned int atlas_max_size = 2048;
+
         protected:
+            /*!
+             * Render every glyph in the face and pack the bitmaps into the pages of a glyph
+             * atlas of atlas_size square pixels per page. Glyphs are placed in rows ('shelves'),
+             * in order of code point, so the common characters all share the first page. A
+             * blank pixel separates neighbouring glyphs so that linear texture filtering does
+             * not pick up the neighbours. Fills glchars and atlas_pages and returns the atlas
+             * pixels, page after page, ready to upload as a texture array.
+             */
+            std::vector<unsigned char> pack_glyphs()
+            {
+                constexpr unsigned int pad = 1;
+                const unsigned int asz = this->atlas_size;
+                std::vector<unsigned char> pixels (asz * asz, 0);
+                this->atlas_pages = 1;
+                unsigned int x = pad;      // Where the next glyph goes on the current shelf
+                unsigned int y = pad;      // The top of the current shelf
+                unsigned int shelf_h = 0;  // The height of the current shelf
+
+                // How far to loop. In principle, up to 21 bits worth - that's 2097151 possible characters!
+                for (char32_t c = 0; c < 2097151; c++) {
+                    // Check glyph index first, if it's 0 it's a blank so skip.
+                    if (FT_Get_Char_Index (this->face, c) == 0) { continue; }
+
+                    // load character glyph
+                    if (FT_Load_Char (this->face, c, FT_LOAD_RENDER)) {
+                        std::cout << "ERROR::FREETYPE: Failed to load Glyph for Unicode 0x"
+                                  << std::hex << static_cast<unsigned int>(c) << std::dec << std::endl;
+                        continue;
+                    }
+
+                    const FT_Bitmap& bm = this->face->glyph->bitmap;
+                    const unsigned int w = bm.width;
+                    const unsigned int h = bm.rows;
+                    if (w + 2 * pad > asz || h + 2 * pad > asz) {
+                        std::cout << "ERROR::FREETYPE: Glyph for Unicode 0x" << std::hex << static_cast<unsigned int>(c)
+                                  << std::dec << " is too large for the glyph atlas" << std::endl;
+                        continue;
+                    }
+
+                    morph::visgl::CharInfo glchar = {
+                        0, {0.0f, 0.0f, 0.0f, 0.0f}, // layer and uv (blank glyphs, such as space, have none)
+                        {static_cast<int>(w), static_cast<int>(h)},                      // size
+                        {this->face->glyph->bitmap_left, this->face->glyph->bitmap_top}, // bearing
+                        static_cast<unsigned int>(this->face->glyph->advance.x)          // advance
+                    };
+
+                    if (w > 0 && h > 0) {
+                        // Start a new shelf, or a new page, if the glyph doesn't fit
+                        if (x + w + pad > asz) {
+                            x = pad;
+                            y += shelf_h + pad;
+                            shelf_h = 0;
+                        }
+                        if (y + h + pad > asz) {
+                            x = pad;
+                            y = pad;
+                            shelf_h = 0;
+                            ++this->atlas_pages;
+                            pixels.resize (pixels.size() + asz * asz, 0);
+                        }
+                        // Copy the glyph, row by row, into its place in the current page
+                        unsigned char* page = pixels.data() + (this->atlas_pages - 1) * asz * asz;
+                        for (unsigned int r = 0; r < h; ++r) {
+                            std::memcpy (page + (y + r) * asz + x, bm.buffer + r * bm.pitch, w);
+                        }
+                        const float fasz = static_cast<float>(asz);
+                        glchar.layer = this->atlas_pages - 1;
+                        glchar.uv = { x / fasz, y / fasz, (x + w) / fasz, (y + h) / fasz };
+                        x += w + pad;
+                        shelf_h = h > shelf_h ? h : shelf_h;
+                    }
+
+                    if constexpr (debug_visualface == true) {
+                        std::cout << "Inserting character into this->glchars with info: layer:" << glchar.layer
+                                  << ", uv:" << glchar.uv << ", Size:" << glchar.size << ", Bearing:" << glchar.bearing
+                                  << ", Advance:" << glchar.advance << std::endl;
+                    }
+                    this->glchars.insert (std::pair<char32_t, morph::visgl::CharInfo>(c, glchar));
+                }
+                return pixels;
+            }
+
 
             void init_common (const morph::VisualFont _font, unsigned int fontpixels, FT_Library& ft_freetype)
             {
@@ -14,6 +14,9 @@
 #pragma once
 
 #include <morph/VisualFaceBase.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 
 #if defined __gl3_h_ || defined __gl_h_
 // GL headers have been externally included
@@ -44,64 +47,44 @@ namespace morph {
                           GladGLContext* glfn = nullptr)
             {
                 this->init_common (_font, fontpixels, ft_freetype);
+                if (glfn == nullptr) { throw std::runtime_error ("glfn problem"); }
+                this->glfn = glfn;
 
-                // How far to loop. In principle, up to 21 bits worth - that's 2097151 possible characters!
-                for (char32_t c = 0; c < 2097151; c++) {
-                    // Check glyph index first, if it's 0 it's a blank so skip.
-                    if (FT_Get_Char_Index (this->face, c) == 0) { continue; }
-
-                    // load character glyph
-                    if (FT_Load_Char (this->face, c, FT_LOAD_RENDER)) {
-                        std::cout << "ERROR::FREETYPE: Failed to load Glyph for Unicode 0x"
-                                  << std::hex << static_cast<unsigned int>(c) << std::dec << std::endl;
-                        continue;
-                    }
-
-                    // generate texture
-                    unsigned int texture = 0;
-
-                    if (glfn == nullptr) { throw std::runtime_error ("glfn problem"); }
-                    glfn->GenTextures (1, &texture);
-                    glfn->BindTexture (GL_TEXTURE_2D, texture);
-                    glfn->TexImage2D(
-                        GL_TEXTURE_2D,
-                        0,
-                        GL_RED,
-                        this->face->glyph->bitmap.width,
-                        this->face->glyph->bitmap.rows,
-                        0,
-                        GL_RED,
-                        GL_UNSIGNED_BYTE,
-                        this->face->glyph->bitmap.buffer
-                        );
-                    // set texture options
-                    glfn->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                    glfn->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-                    glfn->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                    glfn->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR); // Could be GL_NEAREST, but doesn't look as good.
-
-                    // now store character for later use
-                    morph::visgl::CharInfo glchar = {
-                        texture,
-                        {static_cast<int>(this->face->glyph->bitmap.width), static_cast<int>(this->face->glyph->bitmap.rows)}, // size
-                        {this->face->glyph->bitmap_left, this->face->glyph->bitmap_top}, // bearing
-                        static_cast<unsigned int>(this->face->glyph->advance.x)          // advance
-                    };
-
-                    if constexpr (debug_visualface == true) {
-                        std::cout << "Inserting character into this->glchars with info: ID:" << glchar.textureID
-                                  << ", Size:" << glchar.size << ", Bearing:" << glchar.bearing
-                                  << ", Advance:" << glchar.advance << std::endl;
-                    }
-                    this->glchars.insert (std::pair<char32_t, morph::visgl::CharInfo>(c, glchar));
+                // Render all the glyphs into one atlas, so that a whole text can be drawn with a
+                // single texture binding (and a single draw call)
+                GLint max_size = 0;
+                GLint max_layers = 0;
+                glfn->GetIntegerv (GL_MAX_TEXTURE_SIZE, &max_size);
+                glfn->GetIntegerv (GL_MAX_ARRAY_TEXTURE_LAYERS, &max_layers);
+                this->atlas_size = std::min (this->atlas_max_size, static_cast<unsigned int>(max_size));
+                std::vector<unsigned char> pixels = this->pack_glyphs();
+                if (this->atlas_pages > static_cast<unsigned int>(max_layers)) {
+                    throw std::runtime_error ("VisualFace: Glyph atlas needs too many texture layers; reduce fontpixels");
                 }
-                glfn->BindTexture(GL_TEXTURE_2D, 0);
+
+                glfn->GenTextures (1, &this->atlas);
+                glfn->BindTexture (GL_TEXTURE_2D_ARRAY, this->atlas);
+                glfn->TexImage3D (GL_TEXTURE_2D_ARRAY, 0, GL_R8, this->atlas_size, this->atlas_size, this->atlas_pages,
+                                  0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+                // set texture options
+                glfn->TexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glfn->TexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glfn->TexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glfn->TexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR); // Could be GL_NEAREST, but doesn't look as good.
+                glfn->BindTexture (GL_TEXTURE_2D_ARRAY, 0);
 
                 // At this point could FT_Done_Face() etc, I think. as we no longer do anything Freetypey with it.
                 FT_Done_Face (this->face);
             }
 
-            ~VisualFaceMX() {}
+            //! Free the glyph atlas. The Visual's OpenGL context must be current.
+            ~VisualFaceMX()
+            {
+                if (this->atlas != 0 && this->glfn != nullptr) { this->glfn->DeleteTextures (1, &this->atlas); }
+            }
+
+            //! The GL function pointers of the Visual that owns the atlas
+            GladGLContext* glfn = nullptr;
         };
     } // namespace gl
 } // namespace morph
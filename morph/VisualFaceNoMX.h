@@ -13,6 +13,9 @@
 #pragma once
 
 #include <morph/VisualFaceBase.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 
 #if defined __gl3_h_ || defined __gl_h_
 // GL headers have been externally included
@@ -43,63 +46,35 @@ namespace morph {
             {
                 this->init_common (_font, fontpixels, ft_freetype);
 
-                // How far to loop. In principle, up to 21 bits worth - that's 2097151 possible characters!
-                for (char32_t c = 0; c < 2097151; c++) {
-                    // Check glyph index first, if it's 0 it's a blank so skip.
-                    if (FT_Get_Char_Index (this->face, c) == 0) { continue; }
-
-                    // load character glyph
-                    if (FT_Load_Char (this->face, c, FT_LOAD_RENDER)) {
-                        std::cout << "ERROR::FREETYPE: Failed to load Glyph for Unicode 0x"
-                                  << std::hex << static_cast<unsigned int>(c) << std::dec << std::endl;
-                        continue;
-                    }
-
-                    // generate texture
-                    unsigned int texture = 0;
-
-                    glGenTextures (1, &texture);
-                    glBindTexture (GL_TEXTURE_2D, texture);
-                    glTexImage2D(
-                        GL_TEXTURE_2D,
-                        0,
-                        GL_RED,
-                        this->face->glyph->bitmap.width,
-                        this->face->glyph->bitmap.rows,
-                        0,
-                        GL_RED,
-                        GL_UNSIGNED_BYTE,
-                        this->face->glyph->bitmap.buffer
-                        );
-                    // set texture options
-                    glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                    glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-                    glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                    glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR); // Could be GL_NEAREST, but doesn't look as good.
-
-                    // now store character for later use
-                    morph::visgl::CharInfo glchar = {
-                        texture,
-                        {static_cast<int>(this->face->glyph->bitmap.width), static_cast<int>(this->face->glyph->bitmap.rows)}, // size
-                        {this->face->glyph->bitmap_left, this->face->glyph->bitmap_top}, // bearing
-                        static_cast<unsigned int>(this->face->glyph->advance.x)          // advance
-                    };
-
-                    if constexpr (debug_visualface == true) {
-                        std::cout << "Inserting character into this->glchars with info: ID:" << glchar.textureID
-                                  << ", Size:" << glchar.size << ", Bearing:" << glchar.bearing
-                                  << ", Advance:" << glchar.advance << std::endl;
-                    }
-                    this->glchars.insert (std::pair<char32_t, morph::visgl::CharInfo>(c, glchar));
+                // Render all the glyphs into one atlas, so that a whole text can be drawn with a
+                // single texture binding (and a single draw call)
+                GLint max_size = 0;
+                GLint max_layers = 0;
+                glGetIntegerv (GL_MAX_TEXTURE_SIZE, &max_size);
+                glGetIntegerv (GL_MAX_ARRAY_TEXTURE_LAYERS, &max_layers);
+                this->atlas_size = std::min (this->atlas_max_size, static_cast<unsigned int>(max_size));
+                std::vector<unsigned char> pixels = this->pack_glyphs();
+                if (this->atlas_pages > static_cast<unsigned int>(max_layers)) {
+                    throw std::runtime_error ("VisualFace: Glyph atlas needs too many texture layers; reduce fontpixels");
                 }
 
-                glBindTexture(GL_TEXTURE_2D, 0);
+                glGenTextures (1, &this->atlas);
+                glBindTexture (GL_TEXTURE_2D_ARRAY, this->atlas);
+                glTexImage3D (GL_TEXTURE_2D_ARRAY, 0, GL_R8, this->atlas_size, this->atlas_size, this->atlas_pages,
+                              0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+                // set texture options
+                glTexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glTexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR); // Could be GL_NEAREST, but doesn't look as good.
+                glBindTexture (GL_TEXTURE_2D_ARRAY, 0);
 
                 // At this point could FT_Done_Face() etc, I think. as we no longer do anything Freetypey with it.
                 FT_Done_Face (this->face);
             }
 
-            ~VisualFaceNoMX() {}
+            //! Free the glyph atlas. The Visual's OpenGL context must be current.
+            ~VisualFaceNoMX() { if (this->atlas != 0) { glDeleteTextures (1, &this->atlas); } }
         };
     } // namespace gl
 } // namespace morph
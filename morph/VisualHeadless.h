@@ -0,0 +1,38 @@
+/*!
+ * \file
+ *
+ * Awesome graphics code for high performance graphing and visualisation.
+ *
+ * morph::VisualHeadless is the windowless counterpart of morph::Visual. It renders into a
+ * framebuffer object in a surfaceless EGL context, so it needs no display.
+ *
+ * \author Seb James
+ * \date 2025
+ */
+#pragma once
+
+#include <morph/VisualHeadlessMX.h>
+
+namespace morph {
+
+    /*!
+     * Windowless Visual 'scene' class
+     *
+     * Use this to render figures (with saveImage) on a machine with no display, such as a cluster
+     * node, or to run rendering tests in CI with Mesa's llvmpipe driver. The images are _width *
+     * _height pixels. The scene can be supersampled by a factor of 2, 4 or 8 to smooth its edges.
+     *
+     * The implementation code is provided by the multi-context aware morph::VisualHeadlessMX
+     * class. If you want global GL function aliases, use morph::VisualHeadlessNoMX<>.
+     *
+     * \tparam glver The OpenGL version, encoded as a single int (see morph::gl::version)
+     */
+    template <int glver = morph::gl::version_4_1>
+    struct VisualHeadless : public morph::VisualHeadlessMX<glver>
+    {
+        VisualHeadless (const int _width, const int _height, const std::string& _title = "",
+                        const unsigned int _supersample = 1, const bool _version_stdout = false)
+            : morph::VisualHeadlessMX<glver> (_width, _height, _title, _supersample, _version_stdout) {}
+    };
+
+} // namespace morph
@@ -0,0 +1,216 @@
+/*!
+ * \file
+ *
+ * Awesome graphics code for high performance graphing and visualisation.
+ *
+ * This is a windowless morph::VisualOwnableMX. It needs no display; it creates a surfaceless
+ * EGL context and renders into a framebuffer object of any size. Use it to make figures on a
+ * cluster node or to run rendering tests in CI.
+ *
+ * This one is multi-context aware; GL functions are called through a GladGLContext (glfn)
+ *
+ * \author Seb James
+ * \date 2025
+ */
+#pragma once
+
+#include <morph/gl/egl_context.h>
+
+// VisualOwnable needs a window type, although there is no window here. Using GLFW's type means
+// this header can be used alongside morph/VisualMX.h
+struct GLFWwindow;
+namespace morph { using win_t = GLFWwindow; }
+
+#include <morph/gl/version.h>
+#include <morph/VisualOwnableMX.h>
+#include <vector>
+#include <stdexcept>
+
+namespace morph {
+
+    /*!
+     * A Visual 'scene' with no window.
+     *
+     * The scene is rendered into a framebuffer object of width * height pixels. With a
+     * supersample factor of 2 (or 4 or 8), the scene is rendered at 2 (4 or 8) times the width
+     * and height and then filtered down to width * height, which gives smooth edges. Call
+     * render(), then saveImage() or saveImageAsync() to write out the frame.
+     *
+     * Each VisualHeadlessMX has its own EGL context, so several can be used in one program, and
+     * many programs can render at once on a CPU-only node.
+     *
+     * \tparam glver The OpenGL version, encoded as a single int (see morph::gl::version)
+     */
+    template <int glver = morph::gl::version_4_1>
+    class VisualHeadlessMX : public morph::VisualOwnableMX<glver>
+    {
+    public:
+        /*!
+         * Construct a windowless visualiser which renders images of _width * _height pixels,
+         * supersampled by _supersample (1, 2, 4 or 8). Throws if no EGL context can be created.
+         */
+        VisualHeadlessMX (const int _width, const int _height, const std::string& _title = "",
+                            const unsigned int _supersample = 1, const bool _version_stdout = false)
+        {
+            if (_width < 1 || _height < 1) { throw std::runtime_error ("VisualHeadless: bad image size"); }
+            if (_supersample < 1 || _supersample > 8 || (_supersample & (_supersample - 1)) != 0) {
+                throw std::runtime_error ("VisualHeadless: supersample must be 1, 2, 4 or 8");
+            }
+            this->image_w = _width;
+            this->image_h = _height;
+            this->supersample = _supersample;
+            // The scene is rendered at the supersampled size
+            this->window_w = _width * _supersample;
+            this->window_h = _height * _supersample;
+            this->title = _title;
+            this->options.set (visual_options::versionStdout, _version_stdout);
+
+            try {
+                this->init_resources();
+            } catch (const std::exception&) {
+                this->egl.deinit();
+                throw;
+            }
+            this->init_gl();
+
+            // Special tasks: re-bind coordArrows and title text
+            this->bindextra (this->coordArrows);
+            this->bindextra (this->textModel);
+        }
+
+        //! Free the framebuffers, deregister from VisualResources and destroy the EGL context
+        ~VisualHeadlessMX()
+        {
+            this->setContext();
+            this->free_framebuffers();
+            this->deconstructCommon();
+            this->egl.deinit();
+        }
+
+        // Create the EGL context and framebuffers, load GL and set up fonts
+        void init_resources()
+        {
+            this->egl.init (glver);
+            this->init_glad (reinterpret_cast<GLADloadfunc>(eglGetProcAddress));
+            if (!this->glfn) { throw std::runtime_error ("VisualHeadless: Failed to load OpenGL"); }
+            this->init_framebuffers();
+            // VisualResources provides font management. Ensure it exists in memory.
+            morph::VisualResourcesMX<glver>::i().create();
+            this->freetype_init();
+            this->releaseContext();
+        }
+
+        //! Make this Visual's context current
+        void setContext() final { this->egl.make_current(); }
+
+        //! Release the OpenGL context
+        void releaseContext() final { this->egl.release(); }
+
+        //! True if this Visual's context is current
+        bool checkContext() { return this->egl.is_current(); }
+
+        /*!
+         * Called at the end of render(). If supersampling, filter the frame down to image_w *
+         * image_h, leaving the result bound for reading (by saveImage) and the viewport set to
+         * its size.
+         */
+        void swapBuffers() final
+        {
+            if (this->fbo.size() < 2) { return; }
+            for (std::size_t i = 1; i < this->fbo.size(); ++i) {
+                // Each step halves the size, so linear filtering averages each 2x2 block of pixels
+                const GLint sw = this->image_w << (this->fbo.size() - i);
+                const GLint sh = this->image_h << (this->fbo.size() - i);
+                this->glfn->BindFramebuffer (GL_READ_FRAMEBUFFER, this->fbo[i - 1]);
+                this->glfn->BindFramebuffer (GL_DRAW_FRAMEBUFFER, this->fbo[i]);
+                this->glfn->BlitFramebuffer (0, 0, sw, sh, 0, 0, sw / 2, sh / 2, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            }
+            this->glfn->BindFramebuffer (GL_READ_FRAMEBUFFER, this->fbo.back());
+            this->glfn->BindFramebuffer (GL_DRAW_FRAMEBUFFER, this->fbo[0]);
+            this->glfn->Viewport (0, 0, this->image_w, this->image_h);
+            morph::gl::Util::checkError (__FILE__, __LINE__, this->glfn);
+        }
+
+        //! The size of the images that are saved
+        morph::vec<int, 2> image_size() const { return { this->image_w, this->image_h }; }
+
+        /*!
+         * Set up the passed-in VisualModel (or indeed, VisualTextModel) with functions that need access to Visual attributes.
+         */
+        template <typename T>
+        void bindmodel (std::unique_ptr<T>& model)
+        {
+            morph::VisualBase<glver>::template bindmodel<T> (model);
+            model->setContext = &morph::VisualBase<glver>::set_context;
+            model->releaseContext = &morph::VisualBase<glver>::release_context;
+            model->get_glfn = &morph::VisualOwnableMX<glver>::get_glfn;
+        }
+
+        template <typename T>
+        void bindextra (std::unique_ptr<T>& model)
+        {
+            model->setContext = &morph::VisualBase<glver>::set_context;
+            model->releaseContext = &morph::VisualBase<glver>::release_context;
+            model->get_glfn = &morph::VisualOwnableMX<glver>::get_glfn;
+        }
+
+    private:
+        /*
+         * Create the framebuffer objects. fbo[0] has colour and depth buffers at the rendered
+         * size. When supersampling, each further fbo has a colour buffer of half the size of the
+         * one before, down to image_w * image_h.
+         */
+        void init_framebuffers()
+        {
+            unsigned int levels = 1;
+            for (unsigned int s = this->supersample; s > 1; s >>= 1) { ++levels; }
+            this->fbo.resize (levels, 0);
+            this->rbo.resize (levels + 1, 0);
+            this->glfn->GenFramebuffers (levels, this->fbo.data());
+            this->glfn->GenRenderbuffers (levels + 1, this->rbo.data());
+            for (unsigned int i = 0; i < levels; ++i) {
+                const GLsizei w = this->image_w << (levels - 1 - i);
+                const GLsizei h = this->image_h << (levels - 1 - i);
+                this->glfn->BindFramebuffer (GL_FRAMEBUFFER, this->fbo[i]);
+                this->glfn->BindRenderbuffer (GL_RENDERBUFFER, this->rbo[i]);
+                this->glfn->RenderbufferStorage (GL_RENDERBUFFER, GL_RGBA8, w, h);
+                this->glfn->FramebufferRenderbuffer (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->rbo[i]);
+                if (i == 0) {
+                    this->glfn->BindRenderbuffer (GL_RENDERBUFFER, this->rbo[levels]);
+                    this->glfn->RenderbufferStorage (GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, w, h);
+                    this->glfn->FramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, this->rbo[levels]);
+                }
+                if (this->glfn->CheckFramebufferStatus (GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                    throw std::runtime_error ("VisualHeadless: framebuffer is incomplete (image too large?)");
+                }
+            }
+            this->glfn->BindRenderbuffer (GL_RENDERBUFFER, 0);
+            // Render into fbo[0]
+            this->glfn->BindFramebuffer (GL_FRAMEBUFFER, this->fbo[0]);
+            morph::gl::Util::checkError (__FILE__, __LINE__, this->glfn);
+        }
+
+        void free_framebuffers()
+        {
+            if (this->fbo.empty()) { return; }
+            this->glfn->BindFramebuffer (GL_FRAMEBUFFER, 0);
+            this->glfn->DeleteFramebuffers (this->fbo.size(), this->fbo.data());
+            this->glfn->DeleteRenderbuffers (this->rbo.size(), this->rbo.data());
+            this->fbo.clear();
+            this->rbo.clear();
+        }
+
+        //! The EGL display and context
+        morph::gl::egl_context egl;
+        //! The size of the saved images
+        int image_w = 0;
+        int image_h = 0;
+        //! The scene is rendered at supersample times the image size
+        unsigned int supersample = 1;
+        //! Framebuffer objects, from the rendered size down to the image size
+        std::vector<GLuint> fbo;
+        //! A colour renderbuffer for each fbo, then the depth buffer of fbo[0]
+        std::vector<GLuint> rbo;
+    };
+
+} // namespace morph
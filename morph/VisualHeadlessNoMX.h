@@ -0,0 +1,213 @@
+/*!
+ * \file
+ *
+ * Awesome graphics code for high performance graphing and visualisation.
+ *
+ * This is a windowless morph::VisualOwnableNoMX. It needs no display; it creates a surfaceless
+ * EGL context and renders into a framebuffer object of any size. Use it to make figures on a
+ * cluster node or to run rendering tests in CI.
+ *
+ * This one assumes GL has been loaded with global function aliases (glCear, glEnable, etc)
+ *
+ * \author Seb James
+ * \date 2025
+ */
+#pragma once
+
+#include <morph/gl/egl_context.h>
+
+// VisualOwnable needs a window type, although there is no window here. Using GLFW's type means
+// this header can be used alongside morph/VisualNoMX.h
+struct GLFWwindow;
+namespace morph { using win_t = GLFWwindow; }
+
+#include <morph/gl/version.h>
+#include <morph/VisualOwnableNoMX.h>
+#include <vector>
+#include <stdexcept>
+
+namespace morph {
+
+    /*!
+     * A Visual 'scene' with no window.
+     *
+     * The scene is rendered into a framebuffer object of width * height pixels. With a
+     * supersample factor of 2 (or 4 or 8), the scene is rendered at 2 (4 or 8) times the width
+     * and height and then filtered down to width * height, which gives smooth edges. Call
+     * render(), then saveImage() or saveImageAsync() to write out the frame.
+     *
+     * Each VisualHeadlessNoMX has its own EGL context, so several can be used in one program, and
+     * many programs can render at once on a CPU-only node.
+     *
+     * \tparam glver The OpenGL version, encoded as a single int (see morph::gl::version)
+     */
+    template <int glver = morph::gl::version_4_1>
+    class VisualHeadlessNoMX : public morph::VisualOwnableNoMX<glver>
+    {
+    public:
+        /*!
+         * Construct a windowless visualiser which renders images of _width * _height pixels,
+         * supersampled by _supersample (1, 2, 4 or 8). Throws if no EGL context can be created.
+         */
+        VisualHeadlessNoMX (const int _width, const int _height, const std::string& _title = "",
+                            const unsigned int _supersample = 1, const bool _version_stdout = false)
+        {
+            if (_width < 1 || _height < 1) { throw std::runtime_error ("VisualHeadless: bad image size"); }
+            if (_supersample < 1 || _supersample > 8 || (_supersample & (_supersample - 1)) != 0) {
+                throw std::runtime_error ("VisualHeadless: supersample must be 1, 2, 4 or 8");
+            }
+            this->image_w = _width;
+            this->image_h = _height;
+            this->supersample = _supersample;
+            // The scene is rendered at the supersampled size
+            this->window_w = _width * _supersample;
+            this->window_h = _height * _supersample;
+            this->title = _title;
+            this->options.set (visual_options::versionStdout, _version_stdout);
+
+            try {
+                this->init_resources();
+            } catch (const std::exception&) {
+                this->egl.deinit();
+                throw;
+            }
+            this->init_gl();
+
+            // Special tasks: re-bind coordArrows and title text
+            this->bindextra (this->coordArrows);
+            this->bindextra (this->textModel);
+        }
+
+        //! Free the framebuffers, deregister from VisualResources and destroy the EGL context
+        ~VisualHeadlessNoMX()
+        {
+            this->setContext();
+            this->free_framebuffers();
+            this->deconstructCommon();
+            this->egl.deinit();
+        }
+
+        // Create the EGL context and framebuffers, load GL and set up fonts
+        void init_resources()
+        {
+            this->egl.init (glver);
+            this->init_glad (reinterpret_cast<GLADloadfunc>(eglGetProcAddress));
+            this->init_framebuffers();
+            // VisualResources provides font management. Ensure it exists in memory.
+            morph::VisualResourcesNoMX<glver>::i().create();
+            this->freetype_init();
+            this->releaseContext();
+        }
+
+        //! Make this Visual's context current
+        void setContext() final { this->egl.make_current(); }
+
+        //! Release the OpenGL context
+        void releaseContext() final { this->egl.release(); }
+
+        //! True if this Visual's context is current
+        bool checkContext() { return this->egl.is_current(); }
+
+        /*!
+         * Called at the end of render(). If supersampling, filter the frame down to image_w *
+         * image_h, leaving the result bound for reading (by saveImage) and the viewport set to
+         * its size.
+         */
+        void swapBuffers() final
+        {
+            if (this->fbo.size() < 2) { return; }
+            for (std::size_t i = 1; i < this->fbo.size(); ++i) {
+                // Each step halves the size, so linear filtering averages each 2x2 block of pixels
+                const GLint sw = this->image_w << (this->fbo.size() - i);
+                const GLint sh = this->image_h << (this->fbo.size() - i);
+                glBindFramebuffer (GL_READ_FRAMEBUFFER, this->fbo[i - 1]);
+                glBindFramebuffer (GL_DRAW_FRAMEBUFFER, this->fbo[i]);
+                glBlitFramebuffer (0, 0, sw, sh, 0, 0, sw / 2, sh / 2, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            }
+            glBindFramebuffer (GL_READ_FRAMEBUFFER, this->fbo.back());
+            glBindFramebuffer (GL_DRAW_FRAMEBUFFER, this->fbo[0]);
+            glViewport (0, 0, this->image_w, this->image_h);
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
+
+        //! The size of the images that are saved
+        morph::vec<int, 2> image_size() const { return { this->image_w, this->image_h }; }
+
+        /*!
+         * Set up the passed-in VisualModel (or indeed, VisualTextModel) with functions that need access to Visual attributes.
+         */
+        template <typename T>
+        void bindmodel (std::unique_ptr<T>& model)
+        {
+            morph::VisualBase<glver>::template bindmodel<T> (model);
+            model->setContext = &morph::VisualBase<glver>::set_context;
+            model->releaseContext = &morph::VisualBase<glver>::release_context;
+        }
+
+        template <typename T>
+        void bindextra (std::unique_ptr<T>& model)
+        {
+            model->setContext = &morph::VisualBase<glver>::set_context;
+            model->releaseContext = &morph::VisualBase<glver>::release_context;
+        }
+
+    private:
+        /*
+         * Create the framebuffer objects. fbo[0] has colour and depth buffers at the rendered
+         * size. When supersampling, each further fbo has a colour buffer of half the size of the
+         * one before, down to image_w * image_h.
+         */
+        void init_framebuffers()
+        {
+            unsigned int levels = 1;
+            for (unsigned int s = this->supersample; s > 1; s >>= 1) { ++levels; }
+            this->fbo.resize (levels, 0);
+            this->rbo.resize (levels + 1, 0);
+            glGenFramebuffers (levels, this->fbo.data());
+            glGenRenderbuffers (levels + 1, this->rbo.data());
+            for (unsigned int i = 0; i < levels; ++i) {
+                const GLsizei w = this->image_w << (levels - 1 - i);
+                const GLsizei h = this->image_h << (levels - 1 - i);
+                glBindFramebuffer (GL_FRAMEBUFFER, this->fbo[i]);
+                glBindRenderbuffer (GL_RENDERBUFFER, this->rbo[i]);
+                glRenderbufferStorage (GL_RENDERBUFFER, GL_RGBA8, w, h);
+                glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->rbo[i]);
+                if (i == 0) {
+                    glBindRenderbuffer (GL_RENDERBUFFER, this->rbo[levels]);
+                    glRenderbufferStorage (GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, w, h);
+                    glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, this->rbo[levels]);
+                }
+                if (glCheckFramebufferStatus (GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                    throw std::runtime_error ("VisualHeadless: framebuffer is incomplete (image too large?)");
+                }
+            }
+            glBindRenderbuffer (GL_RENDERBUFFER, 0);
+            // Render into fbo[0]
+            glBindFramebuffer (GL_FRAMEBUFFER, this->fbo[0]);
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
+
+        void free_framebuffers()
+        {
+            if (this->fbo.empty()) { return; }
+            glBindFramebuffer (GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers (this->fbo.size(), this->fbo.data());
+            glDeleteRenderbuffers (this->rbo.size(), this->rbo.data());
+            this->fbo.clear();
+            this->rbo.clear();
+        }
+
+        //! The EGL display and context
+        morph::gl::egl_context egl;
+        //! The size of the saved images
+        int image_w = 0;
+        int image_h = 0;
+        //! The scene is rendered at supersample times the image size
+        unsigned int supersample = 1;
+        //! Framebuffer objects, from the rendered size down to the image size
+        std::vector<GLuint> fbo;
+        //! A colour renderbuffer for each fbo, then the depth buffer of fbo[0]
+        std::vector<GLuint> rbo;
+    };
+
+} // namespace morph
@@ -32,6 +32,7 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <map>
 #include <cstddef>
 #include <cmath>
 
@@ -107,6 +108,12 @@ namespace morph {
         //! reinit ONLY vertexColors buffer
         virtual void reinit_colour_buffer() = 0;
 
+        //! reinit ONLY the per-instance buffer (instanceData) of an instanced model
+        virtual void reinit_instance_buffer() = 0;
+
+        //! reinit ONLY the vertexScalars buffer. Enough to recolour a model that is coloured from vertex scalars.
+        virtual void reinit_scalar_buffer() = 0;
+
         virtual void clearTexts() = 0;
 
         //! Clear out the model, *including text models*
@@ -115,7 +122,11 @@ namespace morph {
             this->vertexPositions.clear();
             this->vertexNormals.clear();
             this->vertexColors.clear();
+            this->vertexScalars.clear();
             this->indices.clear();
+            this->instanceData.clear();
+            this->lod_levels.clear();
+            this->lod_detail = {};
             this->clearTexts();
             this->idx = 0u;
             this->reinit_buffers();
@@ -125,14 +136,29 @@ namespace morph {
         void reinit()
         {
             if (this->setContext != nullptr) { this->setContext (this->parentVis); }
-            // Fixme: Better not to clear, then repeatedly pushback here:
-            this->vertexPositions.clear();
-            this->vertexNormals.clear();
-            this->vertexColors.clear();
-            this->indices.clear();
-            // NB: Do NOT call clearTexts() here! We're only updating the model itself.
-            this->idx = 0u;
-            this->initializeVertices();
+            this->rebuild_vertices();
+            this->reinit_buffers();
+        }
+
+        /*!
+         * Re-create the model like reinit(), but upload only the ranges of vertexPositions,
+         * vertexNormals, vertexColors and indices that differ from the previous build. This
+         * suits a model that is rebuilt on every data update with the same number of vertices.
+         * The previous build is kept (by swapping, not copying) in the prev_ vectors, so the
+         * model holds two copies of its vertex data.
+         */
+        void reinit_changed()
+        {
+            if (this->setContext != nullptr) { this->setContext (this->parentVis); }
+            this->prev_positions.swap (this->vertexPositions);
+            this->prev_normals.swap (this->vertexNormals);
+            this->prev_colours.swap (this->vertexColors);
+            this->prev_indices.swap (this->indices);
+            this->rebuild_vertices();
+            this->mark_changed (posnVBO, this->prev_positions, this->vertexPositions);
+            this->mark_changed (normVBO, this->prev_normals, this->vertexNormals);
+            this->mark_changed (colVBO, this->prev_colours, this->vertexColors);
+            this->mark_changed (idxVBO, this->prev_indices, this->indices);
             this->reinit_buffers();
         }
 
@@ -147,7 +173,11 @@ namespace morph {
             this->vertexPositions.clear();
             this->vertexNormals.clear();
             this->vertexColors.clear();
+            this->vertexScalars.clear();
             this->indices.clear();
+            this->instanceData.clear();
+            this->lod_levels.clear();
+            this->lod_detail = {};
             this->clearTexts();
             this->idx = 0u;
             this->initializeVertices();
@@ -170,6 +200,12 @@ namespace morph {
         {
             if (this->setContext != nullptr) { this->setContext (this->parentVis); }
             this->initializeVertices();
+            // Check here, as draw() must not throw (it skips the shader colouring if there is no map)
+            if (!this->vertexScalars.empty() && this->scalar_cmap.empty()) {
+                if (this->releaseContext != nullptr) { this->releaseContext (this->parentVis); }
+                throw std::runtime_error ("VisualModel::finalize: vertexScalars is set, but there is no colour map (see setScalarColourMap)");
+            }
+            this->computeBoundingBox();
             this->postVertexInitRequired = true;
             // Release context after creating and finalizing this VisualModel. On Visual::render(),
             // context will be re-acquired.
@@ -180,6 +216,32 @@ namespace morph {
         //! obtained by the parent Visual::render call.
         virtual void render() = 0;
 
+        /*!
+         * Called by VisualOwnable::render() for each model, with the graphics shader program in
+         * use. This calls render(). The default render() then draws the triangles with the
+         * program in use, and the texts (if any) with the text program, returning to the
+         * graphics program after. If \a defer_texts is true, it leaves the texts for
+         * draw_deferred_texts() instead (see visual_options::deferTexts). Returns false if
+         * render() is overridden and drew the model without calling the default render(); the
+         * override may then have changed the shader program.
+         */
+        bool render_in_scene (const bool defer_texts)
+        {
+            this->scene_pass = true;
+            this->scene_pass_defer_texts = defer_texts;
+            this->scene_pass_rendered = false;
+            this->texts_deferred = false;
+            this->render();
+            this->scene_pass = false;
+            return this->scene_pass_rendered;
+        }
+
+        /*!
+         * Called at the start of each draw, with the OpenGL context current. Models that defer
+         * changes to their vertex buffers until render time (see GraphVisual) override this.
+         */
+        virtual void prepare_draw() {}
+
         //! Setter for the viewmatrix
         void setViewMatrix (const mat44<float>& mv) { this->viewmatrix = mv; }
 
@@ -292,6 +354,106 @@ namespace morph {
         void toggleHide() { this->hide = this->hide ? false : true; }
         float hidden() const { return this->hide; }
 
+        /*!
+         * Decide whether the model is in view and, if it is, which level of detail to draw. Called
+         * by VisualOwnable::render() for each model, after setSceneMatrix() and before draw().
+         *
+         * The model is culled if its bounding box lies wholly outside one of the planes of the
+         * view frustum. The level of detail is the coarsest one whose max_size is no smaller than
+         * the projected diameter of the model's bounding sphere.
+         *
+         * \param projection The projection matrix of the scene
+         *
+         * \param viewport_h The height of the viewport in pixels
+         */
+        void computeVisibility (const mat44<float>& projection, const float viewport_h)
+        {
+            this->resetVisibility();
+            if (this->bb[0].span() < 0.0f) { return; } // no vertices
+            const mat44<float> mv = this->scenematrix * this->model_scaling * this->viewmatrix;
+            const mat44<float> mvp = projection * mv;
+
+            // Count the corners of the bounding box outside each clip plane
+            std::array<unsigned int, 6> n_out = {};
+            for (unsigned int c = 0; c < 8; ++c) {
+                const vec<float, 4> corner = { (c & 1) ? this->bb[0].max : this->bb[0].min,
+                                               (c & 2) ? this->bb[1].max : this->bb[1].min,
+                                               (c & 4) ? this->bb[2].max : this->bb[2].min, 1.0f };
+                const vec<float, 4> cc = mvp * corner;
+                for (unsigned int i = 0; i < 3; ++i) {
+                    if (cc[i] < -cc[3]) { ++n_out[2 * i]; }
+                    if (cc[i] > cc[3]) { ++n_out[2 * i + 1]; }
+                }
+            }
+            for (auto n : n_out) { if (n == 8u) { this->culled = true; return; } }
+
+            if (this->lod_levels.empty()) { return; }
+
+            // Project the bounding sphere
+            const vec<float, 4> centre = { (this->bb[0].min + this->bb[0].max) / 2.0f,
+                                           (this->bb[1].min + this->bb[1].max) / 2.0f,
+                                           (this->bb[2].min + this->bb[2].max) / 2.0f, 1.0f };
+            const float r = vec<float, 3>{ this->bb[0].span(), this->bb[1].span(), this->bb[2].span() }.length() / 2.0f;
+            float scl = 0.0f;
+            for (unsigned int i = 0; i < 3; ++i) {
+                scl = std::max (scl, vec<float, 3>{ mv.mat[4 * i], mv.mat[4 * i + 1], mv.mat[4 * i + 2] }.length());
+            }
+            const float w = (mvp * centre)[3];
+            if (w <= r * scl) { return; } // The camera is within the bounding sphere
+            const float size = r * scl * projection.mat[5] * viewport_h / w;
+
+            for (std::size_t l = 0; l < this->lod_levels.size(); ++l) {
+                if (this->lod_levels[l].max_size >= size
+                    && (this->lod_current < 0 || this->lod_levels[l].max_size < this->lod_levels[this->lod_current].max_size)) {
+                    this->lod_current = static_cast<int>(l);
+                }
+            }
+        }
+
+        //! Mark the model to be drawn, at full detail, without testing it against the view
+        void resetVisibility()
+        {
+            this->culled = false;
+            this->lod_current = -1;
+        }
+
+        //! True if computeVisibility() found the model to be out of view
+        bool isCulled() const { return this->culled; }
+
+        //! The level of detail chosen by computeVisibility(); -1 for full detail
+        int levelOfDetail() const { return this->lod_current; }
+
+        /*!
+         * Streaming mode is for models whose vertex data is re-written every frame. The
+         * position, normal and colour buffers are then persistently mapped and triple
+         * buffered, if the OpenGL version supports it (4.4 and up); otherwise their storage is
+         * orphaned on each update. Set before the model is first rendered.
+         */
+        void setStreaming (const bool _s = true) { this->streaming = _s; }
+        bool getStreaming() const { return this->streaming; }
+
+        /*!
+         * Set the colour map for the vertices that are coloured from their scalars (see
+         * vertexScalars). \a rgb holds RGB triplets for scalars evenly spaced from 0 to 1 (as
+         * given by ColourMap::rgb_table) and \a nan_colour is the colour for a NaN. The map is
+         * copied into a texture when the model is next drawn.
+         */
+        void setScalarColourMap (const std::vector<float>& rgb, const std::array<float, 3>& nan_colour)
+        {
+            if (rgb.size() < 3u || rgb.size() % 3u != 0u) {
+                throw std::runtime_error ("VisualModel::setScalarColourMap: rgb must hold one or more RGB triplets");
+            }
+            this->scalar_cmap = rgb;
+            this->scalar_nan = nan_colour;
+            this->scalar_cmap_changed = true;
+        }
+
+        //! Set the scaling m x + c (or m ln(x) + c) that takes a vertex scalar x into [0, 1] for the colour map
+        void setScalarScaling (const float m, const float c, const bool logarithmic = false)
+        {
+            this->scalar_params = { m, c, logarithmic ? 1.0f : 0.0f };
+        }
+
         /*
          * Methods used by Visual::savegltf()
          */
@@ -301,17 +463,18 @@ namespace morph {
         //! And a simple getter for mv_offset
         vec<float> get_mv_offset() { return this->mv_offset; }
 
-        //! Return the number of elements in this->indices
-        std::size_t indices_size() { return this->indices.size(); }
+        //! Return the number of elements in this->indices (at full detail; gltf files don't hold coarser levels)
+        std::size_t indices_size() { return this->full_detail_end(); }
         float indices_max() { return this->idx_max; }
         float indices_min() { return this->idx_min; }
-        std::size_t indices_bytes() { return this->indices.size() * sizeof (GLuint); }
+        std::size_t indices_bytes() { return this->full_detail_end() * sizeof (GLuint); }
         //! Return base64 encoded version of indices
         std::string indices_base64()
         {
-            std::vector<std::uint8_t> idx_bytes (this->indices.size() << 2, 0);
+            std::vector<std::uint8_t> idx_bytes (this->full_detail_end() << 2, 0);
             std::size_t b = 0u;
-            for (auto i : this->indices) {
+            for (std::size_t j = 0; j < this->full_detail_end(); ++j) {
+                const GLuint i = this->indices[j];
                 idx_bytes[b++] = i & 0xff;
                 idx_bytes[b++] = i >> 8 & 0xff;
                 idx_bytes[b++] = i >> 16 & 0xff;
@@ -327,12 +490,52 @@ namespace morph {
         {
             morph::vec<morph::range<float>, 3> axis_extents;
             for (unsigned int i = 0; i < 3; ++i) { axis_extents[i].search_init(); }
-            for (unsigned int j = 0; j < static_cast<unsigned int>(this->vertexPositions.size() - 2); j += 3) {
+            for (std::size_t j = 0; j + 2 < this->vertexPositions.size(); j += 3) {
                 for (unsigned int i = 0; i < 3; ++i) { axis_extents[i].update (this->vertexPositions[j+i]); }
             }
             return axis_extents;
         }
 
+        /*!
+         * Compute bb, the bounding box of the model (including all of its instances, if it is
+         * instanced). Called whenever the vertex or instance buffers are set up. If only the
+         * instances have changed, pass false to skip recomputing the extents of the vertices.
+         */
+        void computeBoundingBox (const bool vertices_changed = true)
+        {
+            if (vertices_changed) { this->bb_mesh = this->extents(); }
+            if (this->instanceData.empty()) { this->bb = this->bb_mesh; return; }
+            for (unsigned int i = 0; i < 3; ++i) { this->bb[i].search_init(); }
+            if (this->bb_mesh[0].span() < 0.0f) { return; }
+            for (std::size_t j = 0; j + instance_stride <= this->instanceData.size(); j += instance_stride) {
+                const float sz = this->instanceData[j + 3];
+                for (unsigned int i = 0; i < 3; ++i) {
+                    this->bb[i].update (this->instanceData[j + i] + sz * this->bb_mesh[i].min);
+                    this->bb[i].update (this->instanceData[j + i] + sz * this->bb_mesh[i].max);
+                }
+            }
+        }
+
+        /*!
+         * Update bb after vertexPositions have changed, before they are uploaded. If only a range
+         * of vertexPositions was marked with mark_dirty(), bb is extended over that range rather
+         * than recomputed over every vertex. The box then never shrinks, which is safe for
+         * culling (see computeVisibility).
+         */
+        void updateBoundingBox()
+        {
+            const std::size_t first = this->dirty_first[posnVBO];
+            const std::size_t end = std::min (this->dirty_end[posnVBO], this->vertexPositions.size());
+            if (!this->dirty_marked[posnVBO] || this->bb_mesh[0].span() < 0.0f) {
+                this->computeBoundingBox();
+                return;
+            }
+            for (std::size_t j = first - first % 3; j + 2 < end; j += 3) {
+                for (unsigned int i = 0; i < 3; ++i) { this->bb_mesh[i].update (this->vertexPositions[j+i]); }
+            }
+            this->computeBoundingBox (false);
+        }
+
         /*!
          * Compute the max and min values of indices and vertexPositions/Colors/Normals for use
          * when saving gltf files
@@ -340,7 +543,7 @@ namespace morph {
         void computeVertexMaxMins()
         {
             // Compute index maxmins
-            for (std::size_t i = 0u; i < this->indices.size(); ++i) {
+            for (std::size_t i = 0u; i < this->full_detail_end(); ++i) {
                 idx_max = this->indices[i] > idx_max ? this->indices[i] : idx_max;
                 idx_min = this->indices[i] < idx_min ? this->indices[i] : idx_min;
             }
@@ -351,13 +554,14 @@ namespace morph {
                 throw std::runtime_error ("Expect vertexPositions, Colors and Normals vectors all to have same size");
             }
 
+            const std::vector<float> cols = this->export_colours();
             for (std::size_t i = 0u; i < this->vertexPositions.size(); i+=3u) {
                 vpos_maxes[0] =  (vertexPositions[i] > vpos_maxes[0]) ? vertexPositions[i] : vpos_maxes[0];
                 vpos_maxes[1] =  (vertexPositions[i+1] > vpos_maxes[1]) ? vertexPositions[i+1] : vpos_maxes[1];
                 vpos_maxes[2] =  (vertexPositions[i+2] > vpos_maxes[2]) ? vertexPositions[i+2] : vpos_maxes[2];
-                vcol_maxes[0] =  (vertexColors[i] > vcol_maxes[0]) ? vertexColors[i] : vcol_maxes[0];
-                vcol_maxes[1] =  (vertexColors[i+1] > vcol_maxes[1]) ? vertexColors[i+1] : vcol_maxes[1];
-                vcol_maxes[2] =  (vertexColors[i+2] > vcol_maxes[2]) ? vertexColors[i+2] : vcol_maxes[2];
+                vcol_maxes[0] =  (cols[i] > vcol_maxes[0]) ? cols[i] : vcol_maxes[0];
+                vcol_maxes[1] =  (cols[i+1] > vcol_maxes[1]) ? cols[i+1] : vcol_maxes[1];
+                vcol_maxes[2] =  (cols[i+2] > vcol_maxes[2]) ? cols[i+2] : vcol_maxes[2];
                 vnorm_maxes[0] =  (vertexNormals[i] > vnorm_maxes[0]) ? vertexNormals[i] : vnorm_maxes[0];
                 vnorm_maxes[1] =  (vertexNormals[i+1] > vnorm_maxes[1]) ? vertexNormals[i+1] : vnorm_maxes[1];
                 vnorm_maxes[2] =  (vertexNormals[i+2] > vnorm_maxes[2]) ? vertexNormals[i+2] : vnorm_maxes[2];
@@ -365,9 +569,9 @@ namespace morph {
                 vpos_mins[0] =  (vertexPositions[i] < vpos_mins[0]) ? vertexPositions[i] : vpos_mins[0];
                 vpos_mins[1] =  (vertexPositions[i+1] < vpos_mins[1]) ? vertexPositions[i+1] : vpos_mins[1];
                 vpos_mins[2] =  (vertexPositions[i+2] < vpos_mins[2]) ? vertexPositions[i+2] : vpos_mins[2];
-                vcol_mins[0] =  (vertexColors[i] < vcol_mins[0]) ? vertexColors[i] : vcol_mins[0];
-                vcol_mins[1] =  (vertexColors[i+1] < vcol_mins[1]) ? vertexColors[i+1] : vcol_mins[1];
-                vcol_mins[2] =  (vertexColors[i+2] < vcol_mins[2]) ? vertexColors[i+2] : vcol_mins[2];
+                vcol_mins[0] =  (cols[i] < vcol_mins[0]) ? cols[i] : vcol_mins[0];
+                vcol_mins[1] =  (cols[i+1] < vcol_mins[1]) ? cols[i+1] : vcol_mins[1];
+                vcol_mins[2] =  (cols[i+2] < vcol_mins[2]) ? cols[i+2] : vcol_mins[2];
                 vnorm_mins[0] =  (vertexNormals[i] < vnorm_mins[0]) ? vertexNormals[i] : vnorm_mins[0];
                 vnorm_mins[1] =  (vertexNormals[i+1] < vnorm_mins[1]) ? vertexNormals[i+1] : vnorm_mins[1];
                 vnorm_mins[2] =  (vertexNormals[i+2] < vnorm_mins[2]) ? vertexNormals[i+2] : vnorm_mins[2];
@@ -401,7 +605,7 @@ namespace morph {
             std::vector<std::uint8_t> _bytes (this->vertexColors.size() << 2, 0);
             std::size_t b = 0u;
             float_bytes fb;
-            for (auto i : this->vertexColors) {
+            for (auto i : this->export_colours()) {
                 fb.f = i;
                 _bytes[b++] = fb.bytes[0];
                 _bytes[b++] = fb.bytes[1];
@@ -410,6 +614,34 @@ namespace morph {
             }
             return base64::encode (_bytes);
         }
+        /*!
+         * vertexColors as they are drawn: the vertices flagged with scalar_colour_flag are given
+         * the colour of their scalar, as the shader would. Used when saving gltf files.
+         */
+        std::vector<float> export_colours() const
+        {
+            std::vector<float> cols = this->vertexColors;
+            if (this->vertexScalars.empty()) { return cols; }
+            const std::size_t n_cmap = this->scalar_cmap.size() / 3u;
+            for (std::size_t v = 0; v < this->vertexScalars.size() && 3u * v + 2u < cols.size(); ++v) {
+                if (!(cols[3u * v] < 0.0f)) { continue; }
+                const float s = this->vertexScalars[v];
+                const float u = (this->scalar_params[2] > 0.5f ? std::log (s) : s) * this->scalar_params[0] + this->scalar_params[1];
+                std::array<float, 3> c = this->scalar_nan;
+                if (!std::isnan (u) && n_cmap > 0u) {
+                    // Round to the nearest colour map entry, as the shader does
+                    const float r = std::clamp (u, 0.0f, 1.0f) * static_cast<float>(n_cmap - 1u);
+                    std::size_t i = static_cast<std::size_t>(r);
+                    if (r - static_cast<float>(i) >= 0.5f) { ++i; }
+                    c = { this->scalar_cmap[3u * i], this->scalar_cmap[3u * i + 1u], this->scalar_cmap[3u * i + 2u] };
+                }
+                cols[3u * v] = c[0];
+                cols[3u * v + 1u] = c[1];
+                cols[3u * v + 2u] = c[2];
+            }
+            return cols;
+        }
+
         std::size_t vnorm_size() { return this->vertexNormals.size(); }
         std::string vnorm_max() { return this->vnorm_maxes.str_mat(); }
         std::string vnorm_min() { return this->vnorm_mins.str_mat(); }
@@ -433,6 +665,13 @@ namespace morph {
         //! If true, then this VisualModel should always be viewed in a plane - it's a 2D model
         bool twodimensional = false;
 
+        /*!
+         * For models that build coarser levels of detail, the greatest size, in pixels, that
+         * their facets may have on screen. A coarser level is drawn only while its facets are
+         * no larger than this.
+         */
+        float lod_facet_size = 4.0f;
+
         //! The current indices index
         GLuint idx = 0u;
 
@@ -502,7 +741,7 @@ namespace morph {
 
         //! This enum contains the positions within the vbo array of the different
         //! vertex buffer objects
-        enum VBOPos { posnVBO, normVBO, colVBO, idxVBO, numVBO };
+        enum VBOPos { posnVBO, normVBO, colVBO, idxVBO, instVBO, scalVBO, numVBO };
 
         //! A unit vector in the x direction
         morph::vec<float, 3> ux = { 1.0f, 0.0f, 0.0f };
@@ -521,6 +760,115 @@ namespace morph {
         //! Vertex Buffer Objects stored in an array
         std::unique_ptr<GLuint[]> vbos;
 
+        //! The size (in bytes) of the GPU storage allocated for each vertex buffer object
+        std::array<std::size_t, numVBO> vbo_capacity = {};
+
+        /*!
+         * The changed range of elements, [dirty_first, dirty_end), in each of vertexPositions,
+         * vertexNormals, vertexColors and indices since they were last uploaded. Set with
+         * mark_dirty().
+         */
+        std::array<std::size_t, numVBO> dirty_first = {};
+        std::array<std::size_t, numVBO> dirty_end = {};
+        //! True for a buffer whose changes have been marked (possibly as none, with mark_unchanged())
+        std::array<bool, numVBO> dirty_marked = {};
+
+        /*!
+         * Mark \a count elements of the vertex data for the buffer \a vp, starting from
+         * element \a first, as changed. The next reinit_buffers() or reinit_colour_buffer()
+         * then uploads only the changed range of that buffer (unless the buffer has to grow).
+         * Buffers with no marked range are uploaded in full.
+         */
+        void mark_dirty (const VBOPos vp, const std::size_t first, const std::size_t count)
+        {
+            if (count == 0) { return; }
+            if (!this->dirty_marked[vp] || this->dirty_end[vp] <= this->dirty_first[vp]) {
+                this->dirty_first[vp] = first;
+                this->dirty_end[vp] = first + count;
+            } else {
+                this->dirty_first[vp] = std::min (this->dirty_first[vp], first);
+                this->dirty_end[vp] = std::max (this->dirty_end[vp], first + count);
+            }
+            this->dirty_marked[vp] = true;
+        }
+
+        //! Mark the vertex data for buffer \a vp as unchanged, so that it is not uploaded (unless marked by mark_dirty() too)
+        void mark_unchanged (const VBOPos vp) { this->dirty_marked[vp] = true; }
+
+        /*!
+         * Mark the range of \a after, the vertex data for buffer \a vp, that differs from \a
+         * before. If they differ in size, all of \a after is marked.
+         */
+        template <typename V>
+        void mark_changed (const VBOPos vp, const std::vector<V>& before, const std::vector<V>& after)
+        {
+            this->mark_unchanged (vp);
+            if (before.size() != after.size()) {
+                this->mark_dirty (vp, 0u, after.size());
+                return;
+            }
+            std::size_t first = 0u;
+            while (first < after.size() && before[first] == after[first]) { ++first; }
+            if (first == after.size()) { return; }
+            std::size_t end = after.size();
+            while (end > first && before[end - 1] == after[end - 1]) { --end; }
+            this->mark_dirty (vp, first, end - first);
+        }
+
+        //! The byte range [first, end) of \a nbytes of data for buffer \a vp to upload
+        std::array<std::size_t, 2> upload_range (const VBOPos vp, const std::size_t elemsize, const std::size_t nbytes) const
+        {
+            if (!this->dirty_marked[vp]) { return { 0u, nbytes }; }
+            if (this->dirty_end[vp] <= this->dirty_first[vp]) { return { 0u, 0u }; }
+            return { std::min (this->dirty_first[vp] * elemsize, nbytes), std::min (this->dirty_end[vp] * elemsize, nbytes) };
+        }
+
+        void clear_dirty (const VBOPos vp)
+        {
+            this->dirty_first[vp] = 0u;
+            this->dirty_end[vp] = 0u;
+            this->dirty_marked[vp] = false;
+        }
+
+        //! The vertex data of the previous build, kept by reinit_changed() and by models that upload only what changes
+        std::vector<float> prev_positions = {};
+        std::vector<float> prev_normals = {};
+        std::vector<float> prev_colours = {};
+        std::vector<GLuint> prev_indices = {};
+
+        //! Clear the vertex data and build it again with initializeVertices()
+        void rebuild_vertices()
+        {
+            // Fixme: Better not to clear, then repeatedly pushback here:
+            this->vertexPositions.clear();
+            this->vertexNormals.clear();
+            this->vertexColors.clear();
+            this->vertexScalars.clear();
+            this->indices.clear();
+            this->instanceData.clear();
+            this->lod_levels.clear();
+            this->lod_detail = {};
+            // NB: Do NOT call clearTexts() here! We're only updating the model itself.
+            this->idx = 0u;
+            this->initializeVertices();
+        }
+
+        //! If true, the vertex buffers are set up for data that changes every frame. See setStreaming().
+        bool streaming = false;
+        //! Can we persistently map buffers? Requires glBufferStorage (OpenGL 4.4)
+        static constexpr bool persistent_mapping = !morph::gl::version::gles (glver)
+                                                   && (morph::gl::version::major (glver) > 4
+                                                       || (morph::gl::version::major (glver) == 4
+                                                           && morph::gl::version::minor (glver) >= 4));
+        //! The number of regions in each streaming buffer
+        static constexpr unsigned int stream_regions = 3u;
+        //! The region of the streaming buffers that holds the current vertex data
+        unsigned int stream_region = 0u;
+        //! The persistent mappings of the streaming buffers
+        std::array<void*, numVBO> stream_ptr = {};
+        //! A fence for each streaming region, set after the region's data was last drawn
+        std::array<GLsync, stream_regions> stream_fence = {};
+
         //! CPU-side data for indices
         std::vector<GLuint> indices = {};
         //! CPU-side data for vertex positions
@@ -530,6 +878,94 @@ namespace morph {
         //! CPU-side data for vertex colours
         std::vector<float> vertexColors = {};
 
+        /*!
+         * CPU-side data for vertex scalars; empty, or one per vertex. A vertex whose red colour
+         * component in vertexColors is scalar_colour_flag is coloured in the shader: its scalar
+         * is scaled with scalar_params and looked up in the colour map scalar_cmap. Changing
+         * the colour map or its scaling is then a uniform or texture update, and new data needs
+         * only this buffer to be uploaded (see reinit_scalar_buffer()).
+         */
+        std::vector<float> vertexScalars = {};
+        //! The vertex colour (red component) that marks a vertex to be coloured from its scalar
+        static constexpr float scalar_colour_flag = -1.0f;
+        //! The scaling of a vertex scalar x into [0, 1]: m, c and 0 for m x + c, or 1 for m ln(x) + c
+        morph::vec<float, 3> scalar_params = { 1.0f, 0.0f, 0.0f };
+        //! The colour of a NaN vertex scalar
+        std::array<float, 3> scalar_nan = { 1.0f, 0.0f, 0.0f };
+        //! The colour map for vertex scalars; RGB triplets for values evenly spaced from 0 to 1
+        std::vector<float> scalar_cmap = {};
+        //! True if scalar_cmap has changed since it was copied into scalar_cmap_texture
+        bool scalar_cmap_changed = false;
+        //! The one-row texture that holds scalar_cmap for the shader
+        GLuint scalar_cmap_texture = 0;
+
+        /*!
+         * CPU-side per-instance data. If this is non-empty, the model is instanced: the
+         * vertices and indices hold a template mesh (centred on the origin, with unit size)
+         * which is drawn once per instance, translated, scaled and coloured by the
+         * instance_stride floats (x, y, z, scale, r, g, b) of each instance.
+         */
+        std::vector<float> instanceData = {};
+        static constexpr unsigned int instance_stride = 7u;
+
+        //! The number of instances in instanceData
+        std::size_t num_instances() const { return this->instanceData.size() / instance_stride; }
+
+        //! Add an instance of the template mesh at \a posn with scale \a sz and colour \a clr
+        void instance_push (const vec<float>& posn, const float sz, const std::array<float, 3>& clr)
+        {
+            this->instanceData.insert (this->instanceData.end(),
+                                       { posn[0], posn[1], posn[2], sz, clr[0], clr[1], clr[2] });
+        }
+
+        //! The bounding box of the model in model coordinates (see computeBoundingBox()). Empty until computed.
+        morph::vec<morph::range<float>, 3> bb = { morph::range<float>(morph::range_init::for_search),
+                                                  morph::range<float>(morph::range_init::for_search),
+                                                  morph::range<float>(morph::range_init::for_search) };
+        //! The bounding box of the vertices (the template mesh of an instanced model)
+        morph::vec<morph::range<float>, 3> bb_mesh = bb;
+        //! Set by computeVisibility() if the model is out of view. draw() then does nothing.
+        bool culled = false;
+        //! True while render() is called from render_in_scene()
+        bool scene_pass = false;
+        //! True if the texts are to be left for draw_deferred_texts() in this scene pass
+        bool scene_pass_defer_texts = false;
+        //! Set by the default render() in a scene pass
+        bool scene_pass_rendered = false;
+        //! Set by the default render() when it leaves the texts for draw_deferred_texts()
+        bool texts_deferred = false;
+
+        //! A range of indices, and the largest projected size (in pixels) at which to draw them
+        struct lod_level
+        {
+            std::size_t first = 0;
+            std::size_t count = 0;
+            float max_size = 0.0f;
+        };
+        /*!
+         * Coarser levels of detail for part of the model (lod_detail). Their indices follow all
+         * the full detail indices, and each is drawn in place of the indices in lod_detail when
+         * the model is small enough on screen (see computeVisibility()). Their vertices may be
+         * shared with the full detail part.
+         */
+        std::vector<lod_level> lod_levels = {};
+        //! The range of full detail indices that the lod_levels replace
+        lod_level lod_detail = {};
+        //! The element of lod_levels to draw; -1 to draw at full detail
+        int lod_current = -1;
+
+        //! The end of the full detail indices
+        std::size_t full_detail_end() const
+        {
+            return this->lod_levels.empty() ? this->indices.size() : this->lod_levels.front().first;
+        }
+
+        //! Add the indices from \a first to the end of indices as a level of detail to draw up to \a max_size pixels
+        void add_lod_level (const std::size_t first, const float max_size)
+        {
+            this->lod_levels.push_back (lod_level{ first, this->indices.size() - first, max_size });
+        }
+
         static constexpr float _max = std::numeric_limits<float>::max();
         static constexpr float _low = std::numeric_limits<float>::lowest();
 
@@ -574,8 +1010,8 @@ namespace morph {
             std::copy (vec.begin(), vec.end(), std::back_inserter (vp));
         }
 
-        //! Set up a vertex buffer object - bind, buffer and set vertex array object attribute
-        virtual void setupVBO (GLuint& buf, std::vector<float>& dat, unsigned int bufferAttribPosition) = 0;
+        //! Set up the vertex buffer object vbos[vp] - bind, buffer and set vertex array object attribute
+        virtual void setupVBO (const VBOPos vp, std::vector<float>& dat, unsigned int bufferAttribPosition) = 0;
 
         /*!
          * Create a tube from \a start to \a end, with radius \a r and a colour which
@@ -1307,6 +1743,59 @@ namespace morph {
             return n_verts;
         }
 
+        /*!
+         * Add coarser levels of detail for a geodesic sphere that was made with computeSphereGeo
+         * (pass the same F, so, r and iterations). Each level is a geodesic of fewer iterations,
+         * drawn with the vertices of the full detail sphere that it shares (so it shares their
+         * colours, too). Call this straight after computeSphereGeo.
+         *
+         * \param first_index The position in indices of the first index of the full detail sphere
+         *
+         * \param levels The number of coarser levels to add (each with one fewer iteration)
+         *
+         * \return The number of levels added
+         */
+        template<typename F=float>
+        int computeSphereGeoLevels (vec<float> so, float r, int iterations, const std::size_t first_index, const int levels)
+        {
+            // The sphere's vertices are the last added
+            const std::size_t n_verts = 10u * (std::size_t{1} << (2 * iterations)) + 2u;
+            if (3u * n_verts > this->vertexPositions.size() || first_index > this->indices.size()) {
+                throw std::runtime_error ("computeSphereGeoLevels: Call this straight after computeSphereGeo");
+            }
+            const GLuint first_vertex = this->idx - static_cast<GLuint>(n_verts);
+            std::map<std::array<float, 3>, GLuint> vertex_at;
+            for (std::size_t i = 0; i < n_verts; ++i) {
+                const float* p = this->vertexPositions.data() + 3u * (first_vertex + i);
+                vertex_at[{ p[0], p[1], p[2] }] = first_vertex + static_cast<GLuint>(i);
+            }
+            this->lod_detail = { first_index, this->indices.size() - first_index, 0.0f };
+
+            // An icosahedron's edges subtend 1.107 radians, and each iteration halves them
+            constexpr float edge0 = 1.107f;
+            int n_added = 0;
+            for (int it = iterations - 1; it >= 0 && it >= iterations - levels; --it) {
+                morph::geometry::icosahedral_geodesic<F> geo = morph::geometry::make_icosahedral_geodesic<F> (it);
+                // The coarse vertices are the same as the matching full detail ones
+                std::vector<GLuint> fine (geo.poly.vertices.size());
+                for (std::size_t i = 0; i < geo.poly.vertices.size(); ++i) {
+                    const vec<float> p = geo.poly.vertices[i].as_float() * r + so;
+                    auto vi = vertex_at.find ({ p[0], p[1], p[2] });
+                    if (vi == vertex_at.end()) { return n_added; }
+                    fine[i] = vi->second;
+                }
+                const std::size_t first = this->indices.size();
+                for (auto f : geo.poly.faces) {
+                    this->indices.push_back (fine[f[0]]);
+                    this->indices.push_back (fine[f[1]]);
+                    this->indices.push_back (fine[f[2]]);
+                }
+                this->add_lod_level (first, this->lod_facet_size * static_cast<float>(1 << it) / (edge0 / 2.0f));
+                ++n_added;
+            }
+            return n_added;
+        }
+
         /*!
          * Sphere, geodesic polygon version with coloured faces
          *
@@ -1344,7 +1833,7 @@ namespace morph {
             for (int i = 0; i < n_faces; ++i) { // For each face in the geodesic...
                 morph::vec<F, 3> norm = { F{0}, F{0}, F{0} };
                 for (auto vtx : geo.poly.faces[i]) { // For each vertex in face...
-                    norm += vtx; // Add to the face norm
+                    norm += geo.poly.vertices[vtx]; // Add to the face norm
                     this->vertex_push (geo.poly.vertices[vtx].as_float() * r + so, this->vertexPositions);
                 }
                 morph::vec<float, 3> nf = (norm / F{3}).as_float();
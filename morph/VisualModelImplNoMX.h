@@ -43,8 +43,10 @@ namespace morph {
             // Explicitly clear owned VisualTextModels
             this->texts.clear();
             if (this->vbos != nullptr) {
+                for (GLsync& fence : this->stream_fence) { if (fence != nullptr) { glDeleteSync (fence); } }
                 glDeleteBuffers (this->numVBO, this->vbos.get());
                 glDeleteVertexArrays (1, &this->vao);
+                if (this->scalar_cmap_texture != 0) { glDeleteTextures (1, &this->scalar_cmap_texture); }
             }
         }
 
@@ -84,15 +86,18 @@ namespace morph {
             // Set up the indices buffer - bind and buffer the data in this->indices
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vbos[this->idxVBO]);
 
-            std::size_t sz = this->indices.size() * sizeof(GLuint);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sz, this->indices.data(), GL_STATIC_DRAW);
+            this->bufferData (GL_ELEMENT_ARRAY_BUFFER, this->idxVBO, this->indices.data(), sizeof(GLuint), this->indices.size());
 
             // Binds data from the "C++ world" to the OpenGL shader world for
             // "position", "normalin" and "color"
             // (bind, buffer and set vertex array object attribute)
-            this->setupVBO (this->vbos[this->posnVBO], this->vertexPositions, visgl::posnLoc);
-            this->setupVBO (this->vbos[this->normVBO], this->vertexNormals, visgl::normLoc);
-            this->setupVBO (this->vbos[this->colVBO], this->vertexColors, visgl::colLoc);
+            this->streamNextRegion();
+            this->setupVBO (this->posnVBO, this->vertexPositions, visgl::posnLoc);
+            this->setupVBO (this->normVBO, this->vertexNormals, visgl::normLoc);
+            this->setupVBO (this->colVBO, this->vertexColors, visgl::colLoc);
+            this->setupInstanceVBO();
+            this->setupScalarVBO();
+            this->computeBoundingBox();
 
             // Unbind only the vertex array (not the buffers, that causes GL_INVALID_ENUM errors)
             glBindVertexArray(0); // carefully unbind and rebind
@@ -112,15 +117,19 @@ namespace morph {
         {
             if (this->setContext != nullptr) { this->setContext (this->parentVis); }
             if (this->postVertexInitRequired == true) { this->postVertexInit(); }
+            // Before setupVBO uploads the marked range of vertexPositions and clears the mark
+            this->updateBoundingBox();
             // Now re-set up the VBOs
             glBindVertexArray (this->vao);                              // carefully unbind and rebind
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vbos[this->idxVBO]);  // carefully unbind and rebind
 
-            std::size_t sz = this->indices.size() * sizeof(GLuint);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sz, this->indices.data(), GL_STATIC_DRAW);
-            this->setupVBO (this->vbos[this->posnVBO], this->vertexPositions, visgl::posnLoc);
-            this->setupVBO (this->vbos[this->normVBO], this->vertexNormals, visgl::normLoc);
-            this->setupVBO (this->vbos[this->colVBO], this->vertexColors, visgl::colLoc);
+            this->bufferData (GL_ELEMENT_ARRAY_BUFFER, this->idxVBO, this->indices.data(), sizeof(GLuint), this->indices.size());
+            this->streamNextRegion();
+            this->setupVBO (this->posnVBO, this->vertexPositions, visgl::posnLoc);
+            this->setupVBO (this->normVBO, this->vertexNormals, visgl::normLoc);
+            this->setupVBO (this->colVBO, this->vertexColors, visgl::colLoc);
+            this->setupInstanceVBO();
+            this->setupScalarVBO();
 
             glBindVertexArray(0);                               // carefully unbind and rebind
             morph::gl::Util::checkError (__FILE__, __LINE__);   // carefully unbind and rebind
@@ -129,11 +138,39 @@ namespace morph {
         //! reinit ONLY vertexColors buffer
         void reinit_colour_buffer() final
         {
+            // In streaming mode, all the vertex data moves to the next region together
+            if (this->streaming) {
+                this->reinit_buffers();
+                return;
+            }
             if (this->setContext != nullptr) { this->setContext (this->parentVis); }
             if (this->postVertexInitRequired == true) { this->postVertexInit(); }
             // Now re-set up the VBOs
             glBindVertexArray (this->vao);  // carefully unbind and rebind
-            this->setupVBO (this->vbos[this->colVBO], this->vertexColors, visgl::colLoc);
+            this->setupVBO (this->colVBO, this->vertexColors, visgl::colLoc);
+            glBindVertexArray(0);  // carefully unbind and rebind
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
+
+        //! reinit ONLY the per-instance buffer. Much cheaper than reinit() for an instanced model.
+        void reinit_instance_buffer() final
+        {
+            if (this->setContext != nullptr) { this->setContext (this->parentVis); }
+            if (this->postVertexInitRequired == true) { this->postVertexInit(); }
+            glBindVertexArray (this->vao);  // carefully unbind and rebind
+            this->setupInstanceVBO();
+            this->computeBoundingBox (false);
+            glBindVertexArray(0);  // carefully unbind and rebind
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
+
+        //! reinit ONLY the vertex scalar buffer. Enough to recolour a model that is coloured from its vertex scalars.
+        void reinit_scalar_buffer() final
+        {
+            if (this->setContext != nullptr) { this->setContext (this->parentVis); }
+            if (this->postVertexInitRequired == true) { this->postVertexInit(); }
+            glBindVertexArray (this->vao);  // carefully unbind and rebind
+            this->setupScalarVBO();
             glBindVertexArray(0);  // carefully unbind and rebind
             morph::gl::Util::checkError (__FILE__, __LINE__);
         }
@@ -141,56 +178,116 @@ namespace morph {
         void clearTexts() { this->texts.clear(); }
 
         static constexpr bool debug_render = false;
-        //! Render the VisualModel. Note that it is assumed that the OpenGL context has been
-        //! obtained by the parent Visual::render call.
+        /*!
+         * Render the VisualModel on its own: its triangles with the graphics shader program, then
+         * its texts with the text shader program, restoring the previously used program at the
+         * end. Note that it is assumed that the OpenGL context has been obtained by the parent
+         * Visual::render call.
+         *
+         * When called by Visual::render (through render_in_scene) the graphics program is
+         * already in use, so it is not looked up or restored. The texts are drawn straight after
+         * the triangles, or left for the Visual to draw after all the models if it has
+         * visual_options::deferTexts set. A derived model that overrides render() should call
+         * this to draw in this way.
+         */
         void render() // not final
         {
-            if (this->hide == true) { return; }
+            if (this->scene_pass == true) {
+                this->scene_pass_rendered = true;
+                this->draw();
+                if (this->scene_pass_defer_texts == true) {
+                    this->texts_deferred = true;
+                } else if (this->hide == false && !this->texts.empty()) {
+                    glUseProgram (this->get_tprog(this->parentVis));
+                    this->draw_texts();
+                    glUseProgram (this->get_gprog(this->parentVis));
+                }
+                return;
+            }
 
-            // Execute post-vertex init at render, as GL should be available.
-            if (this->postVertexInitRequired == true) { this->postVertexInit(); }
+            if (this->hide == true) { return; }
 
             GLint prev_shader = 0;
-
             glGetIntegerv (GL_CURRENT_PROGRAM, &prev_shader);
-            // Ensure the correct program is in play for this VisualModel
             glUseProgram (this->get_gprog(this->parentVis));
+            this->draw();
+            glUseProgram (this->get_tprog(this->parentVis));
+            this->draw_texts();
+            glUseProgram (prev_shader);
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
+
+        //! Draw the VisualModel's triangles. The graphics shader program must be in use.
+        void draw()
+        {
+            // Give the model a chance to update its buffers, even if it's hidden
+            this->prepare_draw();
+
+            if (this->hide == true) { return; }
+
+            // Execute post-vertex init at render, as GL should be available.
+            if (this->postVertexInitRequired == true) { this->postVertexInit(); }
+
+            // Out of view (see VisualModelBase::computeVisibility)
+            if (this->culled == true) { return; }
 
             if (!this->indices.empty()) {
                 // It is only necessary to bind the vertex array object before rendering
                 // (not the vertex buffer objects)
                 glBindVertexArray (this->vao);
 
-                // Pass this->float to GLSL so the model can have an alpha value.
-                GLint loc_a = glGetUniformLocation (this->get_gprog(this->parentVis), static_cast<const GLchar*>("alpha"));
-                if (loc_a != -1) { glUniform1f (loc_a, this->alpha); }
-
-                GLint loc_v = glGetUniformLocation (this->get_gprog(this->parentVis), static_cast<const GLchar*>("v_matrix"));
-                if (loc_v != -1) { glUniformMatrix4fv (loc_v, 1, GL_FALSE, this->scenematrix.mat.data()); }
+                // Uniform locations were looked up when the program was linked
+                const morph::visgl::model_uniforms u = this->get_shaderprogs(this->parentVis).gprog_uniforms;
 
+                // Pass this->float to GLSL so the model can have an alpha value.
+                if (u.alpha != -1) { glUniform1f (u.alpha, this->alpha); }
+                if (u.v_matrix != -1) { glUniformMatrix4fv (u.v_matrix, 1, GL_FALSE, this->scenematrix.mat.data()); }
                 // Should be able to apply scaling to the model matrix
-                GLint loc_m = glGetUniformLocation (this->get_gprog(this->parentVis), static_cast<const GLchar*>("m_matrix"));
-                if (loc_m != -1) { glUniformMatrix4fv (loc_m, 1, GL_FALSE, (this->model_scaling * this->viewmatrix).mat.data()); }
+                if (u.m_matrix != -1) { glUniformMatrix4fv (u.m_matrix, 1, GL_FALSE, (this->model_scaling * this->viewmatrix).mat.data()); }
+                // Tell the shader whether to apply the per-instance attributes
+                if (u.instanced != -1) { glUniform1i (u.instanced, this->instanceData.empty() ? 0 : 1); }
+                // Colour the vertices that are marked for it from their scalars (if there is a colour map for them)
+                const bool scalar_colour = !this->vertexScalars.empty() && !this->scalar_cmap.empty();
+                if (u.scalar_colour != -1) { glUniform1i (u.scalar_colour, scalar_colour ? 1 : 0); }
+                if (scalar_colour) { this->bindScalarColourMap (u); }
 
                 if constexpr (debug_render) {
                     std::cout << "VisualModelImpl::render: scenematrix:\n" << this->scenematrix << std::endl;
                     std::cout << "VisualModelImpl::render: model viewmatrix:\n" << this->viewmatrix << std::endl;
                 }
 
-                // Draw the triangles
-                glDrawElements (GL_TRIANGLES, static_cast<unsigned int>(this->indices.size()), GL_UNSIGNED_INT, 0);
+                // Draw the triangles, replacing the lod_detail indices with a coarser level of detail if one was chosen
+                if (this->lod_current < 0) {
+                    this->drawElements (0, this->full_detail_end());
+                } else {
+                    const std::size_t detail_end = this->lod_detail.first + this->lod_detail.count;
+                    const typename VisualModelBase<glver>::lod_level& lod = this->lod_levels[this->lod_current];
+                    this->drawElements (0, this->lod_detail.first);
+                    this->drawElements (lod.first, lod.count);
+                    this->drawElements (detail_end, this->full_detail_end() - detail_end);
+                }
+                this->streamFenceRegion();
 
                 // Unbind the VAO
                 glBindVertexArray(0);
             }
             morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
 
-            // Now render any VisualTextModels
+        //! Draw the VisualModel's VisualTextModels. The text shader program must be in use.
+        void draw_texts()
+        {
+            if (this->hide == true) { return; }
             auto ti = this->texts.begin();
-            while (ti != this->texts.end()) { (*ti)->render(); ti++; }
+            while (ti != this->texts.end()) { (*ti)->draw(); ti++; }
+        }
 
-            glUseProgram (prev_shader);
-            morph::gl::Util::checkError (__FILE__, __LINE__);
+        //! Draw the texts left by render() in a scene pass with deferred texts (see render_in_scene). The text shader program must be in use.
+        void draw_deferred_texts()
+        {
+            if (this->texts_deferred == false) { return; }
+            this->texts_deferred = false;
+            this->draw_texts();
         }
 
         /*!
@@ -325,20 +422,208 @@ namespace morph {
         //! A vector of pointers to text models that should be rendered.
         std::vector<std::unique_ptr<morph::VisualTextModel<glver>>> texts;
 
-        //! Set up a vertex buffer object - bind, buffer and set vertex array object attribute
-        void setupVBO (GLuint& buf, std::vector<float>& dat, unsigned int bufferAttribPosition) final
+        //! Set up the vertex buffer object vbos[vp] - bind, buffer and set vertex array object attribute
+        void setupVBO (const typename VisualModelBase<glver>::VBOPos vp, std::vector<float>& dat,
+                       unsigned int bufferAttribPosition) final
         {
-            std::size_t sz = dat.size() * sizeof(float);
-
-            glBindBuffer (GL_ARRAY_BUFFER, buf);
-            morph::gl::Util::checkError (__FILE__, __LINE__);
-            glBufferData (GL_ARRAY_BUFFER, sz, dat.data(), GL_STATIC_DRAW);
+            if (this->streaming) {
+                this->streamVBO (vp, dat, bufferAttribPosition);
+                return;
+            }
+            glBindBuffer (GL_ARRAY_BUFFER, this->vbos[vp]);
             morph::gl::Util::checkError (__FILE__, __LINE__);
+            this->bufferData (GL_ARRAY_BUFFER, vp, dat.data(), sizeof(float), dat.size());
             glVertexAttribPointer (bufferAttribPosition, 3, GL_FLOAT, GL_FALSE, 0, (void*)(0));
             morph::gl::Util::checkError (__FILE__, __LINE__);
             glEnableVertexAttribArray (bufferAttribPosition);
             morph::gl::Util::checkError (__FILE__, __LINE__);
         }
+
+        /*!
+         * Buffer \a n elements of size \a elemsize from \a data into vbos[vp], which is bound to
+         * \a target. GPU storage is only (re)allocated when the data has outgrown it, and then
+         * with double the capacity, so that a growing model (such as a GraphVisual that is
+         * being appended to) rarely reallocates. Otherwise, only the range marked with
+         * mark_dirty() is copied with glBufferSubData (nothing, if the buffer was marked with
+         * mark_unchanged(), and all of the data, if it was not marked at all).
+         */
+        void bufferData (const GLenum target, const typename VisualModelBase<glver>::VBOPos vp,
+                         const void* data, const std::size_t elemsize, const std::size_t n)
+        {
+            // A persistently mapped buffer has immutable storage; replace it with a mutable one
+            if (this->stream_ptr[vp] != nullptr) {
+                this->replaceBuffer (vp);
+                glBindBuffer (target, this->vbos[vp]);
+            }
+            const std::size_t sz = n * elemsize;
+            if (this->vbo_capacity[vp] == 0u) {
+                // First allocation. Exactly sized, as most models are never updated.
+                glBufferData (target, sz, data, GL_STATIC_DRAW);
+                this->vbo_capacity[vp] = sz;
+            } else if (sz > this->vbo_capacity[vp]) {
+                const std::size_t cap = std::max (sz, 2u * this->vbo_capacity[vp]);
+                glBufferData (target, cap, nullptr, GL_DYNAMIC_DRAW);
+                glBufferSubData (target, 0, sz, data);
+                this->vbo_capacity[vp] = cap;
+            } else {
+                const std::array<std::size_t, 2> r = this->upload_range (vp, elemsize, sz);
+                if (r[1] > r[0]) { glBufferSubData (target, r[0], r[1] - r[0], static_cast<const char*>(data) + r[0]); }
+            }
+            this->clear_dirty (vp);
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
+
+        /*!
+         * Write \a dat into the current region of the persistently mapped, triple buffered
+         * streaming buffer vbos[vp] and point the vertex attribute \a bufferAttribPosition at
+         * it. Without persistent mapping (before OpenGL 4.4 and in OpenGL ES), orphan the
+         * buffer's storage and upload \a dat into fresh storage.
+         */
+        void streamVBO (const typename VisualModelBase<glver>::VBOPos vp, std::vector<float>& dat,
+                        unsigned int bufferAttribPosition)
+        {
+            const std::size_t sz = dat.size() * sizeof(float);
+            std::size_t offset = 0u;
+            glBindBuffer (GL_ARRAY_BUFFER, this->vbos[vp]);
+            if constexpr (VisualModelBase<glver>::persistent_mapping) {
+                if (this->stream_ptr[vp] == nullptr || sz > this->vbo_capacity[vp]) {
+                    // Immutable storage can't grow, so start again with a new buffer object
+                    const std::size_t cap = std::max ({ sz, 2u * this->vbo_capacity[vp], std::size_t{4096} });
+                    this->replaceBuffer (vp);
+                    glBindBuffer (GL_ARRAY_BUFFER, this->vbos[vp]);
+                    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                    glBufferStorage (GL_ARRAY_BUFFER, cap * this->stream_regions, nullptr, flags);
+                    this->stream_ptr[vp] = glMapBufferRange (GL_ARRAY_BUFFER, 0, cap * this->stream_regions, flags);
+                    this->vbo_capacity[vp] = cap;
+                    morph::gl::Util::checkError (__FILE__, __LINE__);
+                }
+                offset = this->stream_region * this->vbo_capacity[vp];
+                std::memcpy (static_cast<char*>(this->stream_ptr[vp]) + offset, dat.data(), sz);
+            } else {
+                glBufferData (GL_ARRAY_BUFFER, sz, nullptr, GL_STREAM_DRAW);
+                glBufferSubData (GL_ARRAY_BUFFER, 0, sz, dat.data());
+                this->vbo_capacity[vp] = sz;
+            }
+            glVertexAttribPointer (bufferAttribPosition, 3, GL_FLOAT, GL_FALSE, 0, (void*)(offset));
+            glEnableVertexAttribArray (bufferAttribPosition);
+            this->clear_dirty (vp);
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
+
+        //! Replace vbos[vp] with a new buffer object (needed to change a buffer's storage type)
+        void replaceBuffer (const typename VisualModelBase<glver>::VBOPos vp)
+        {
+            glDeleteBuffers (1, &this->vbos[vp]); // Also unmaps the buffer, if it was mapped
+            glGenBuffers (1, &this->vbos[vp]);
+            this->vbo_capacity[vp] = 0u;
+            this->stream_ptr[vp] = nullptr;
+        }
+
+        //! Draw \a count triangle indices from index \a first; once per instance for an instanced model
+        void drawElements (const std::size_t first, const std::size_t count)
+        {
+            if (count == 0u) { return; }
+            const void* offset = reinterpret_cast<const void*>(first * sizeof (GLuint));
+            if (this->instanceData.empty()) {
+                glDrawElements (GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, offset);
+            } else {
+                glDrawElementsInstanced (GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, offset,
+                                         static_cast<GLsizei>(this->num_instances()));
+            }
+        }
+
+        //! In streaming mode, move on to the next region, waiting until the GPU has finished drawing from it
+        void streamNextRegion()
+        {
+            if constexpr (VisualModelBase<glver>::persistent_mapping) {
+                if (!this->streaming) { return; }
+                this->stream_region = (this->stream_region + 1u) % this->stream_regions;
+                GLsync& fence = this->stream_fence[this->stream_region];
+                if (fence != nullptr) {
+                    while (glClientWaitSync (fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+                    glDeleteSync (fence);
+                    fence = nullptr;
+                }
+            }
+        }
+
+        //! In streaming mode, fence the current region after drawing from it
+        void streamFenceRegion()
+        {
+            if constexpr (VisualModelBase<glver>::persistent_mapping) {
+                if (!this->streaming) { return; }
+                GLsync& fence = this->stream_fence[this->stream_region];
+                if (fence != nullptr) { glDeleteSync (fence); }
+                fence = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            }
+        }
+
+        /*!
+         * Set up the per-instance vertex buffer object from instanceData, with a vertex
+         * attribute divisor of 1 so that its attributes advance once per instance. Disable the
+         * instance attributes for a model that is not instanced.
+         */
+        void setupInstanceVBO()
+        {
+            if (this->instanceData.empty()) {
+                glDisableVertexAttribArray (visgl::instPosnLoc);
+                glDisableVertexAttribArray (visgl::instColLoc);
+                return;
+            }
+            constexpr GLsizei stride = VisualModelBase<glver>::instance_stride * sizeof(float);
+            glBindBuffer (GL_ARRAY_BUFFER, this->vbos[this->instVBO]);
+            this->bufferData (GL_ARRAY_BUFFER, this->instVBO, this->instanceData.data(), sizeof(float), this->instanceData.size());
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+            // x, y, z and scale
+            glVertexAttribPointer (visgl::instPosnLoc, 4, GL_FLOAT, GL_FALSE, stride, (void*)(0));
+            glVertexAttribDivisor (visgl::instPosnLoc, 1);
+            glEnableVertexAttribArray (visgl::instPosnLoc);
+            // r, g, b
+            glVertexAttribPointer (visgl::instColLoc, 3, GL_FLOAT, GL_FALSE, stride, (void*)(4 * sizeof(float)));
+            glVertexAttribDivisor (visgl::instColLoc, 1);
+            glEnableVertexAttribArray (visgl::instColLoc);
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
+
+        //! Set up the vertex scalar buffer object from vertexScalars, or disable the scalar attribute if there are none
+        void setupScalarVBO()
+        {
+            if (this->vertexScalars.empty()) {
+                glDisableVertexAttribArray (visgl::scalarLoc);
+                return;
+            }
+            glBindBuffer (GL_ARRAY_BUFFER, this->vbos[this->scalVBO]);
+            this->bufferData (GL_ARRAY_BUFFER, this->scalVBO, this->vertexScalars.data(), sizeof(float), this->vertexScalars.size());
+            glVertexAttribPointer (visgl::scalarLoc, 1, GL_FLOAT, GL_FALSE, 0, (void*)(0));
+            glEnableVertexAttribArray (visgl::scalarLoc);
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
+
+        /*!
+         * Bind the colour map for the vertex scalars to texture unit 0 (copying scalar_cmap into
+         * the texture first if it has changed) and set its uniforms in the graphics shader program.
+         * Called from draw(), which must not throw, and only if scalar_cmap is not empty.
+         */
+        void bindScalarColourMap (const morph::visgl::model_uniforms& u)
+        {
+            glActiveTexture (GL_TEXTURE0);
+            if (this->scalar_cmap_texture == 0) { glGenTextures (1, &this->scalar_cmap_texture); }
+            glBindTexture (GL_TEXTURE_2D, this->scalar_cmap_texture);
+            if (this->scalar_cmap_changed) {
+                // One row of texels, read with texelFetch (so there is no filtering)
+                glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTexImage2D (GL_TEXTURE_2D, 0, GL_RGB32F, static_cast<GLsizei>(this->scalar_cmap.size() / 3u), 1, 0,
+                              GL_RGB, GL_FLOAT, this->scalar_cmap.data());
+                this->scalar_cmap_changed = false;
+            }
+            if (u.scalar_cmap != -1) { glUniform1i (u.scalar_cmap, 0); }
+            if (u.scalar_params != -1) { glUniform3f (u.scalar_params, this->scalar_params[0], this->scalar_params[1], this->scalar_params[2]); }
+            if (u.scalar_nan != -1) { glUniform3f (u.scalar_nan, this->scalar_nan[0], this->scalar_nan[1], this->scalar_nan[2]); }
+            morph::gl::Util::checkError (__FILE__, __LINE__);
+        }
     };
 
 } // namespace morph
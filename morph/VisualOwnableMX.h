@@ -32,6 +32,8 @@ namespace morph { namespace gl { static constexpr int multicontext = 1; } }
 #include <morph/VisualTextModel.h>
 #include <morph/VisualBase.h>
 #include <morph/gl/loadshaders_mx.h>
+#include <morph/FrameWriter.h>
+#include <cstring>
 
 namespace morph {
 
@@ -88,10 +90,25 @@ namespace morph {
                 this->glfn->DeleteProgram (this->shaders.tprog);
                 this->shaders.tprog = 0;
             }
-            this->free_gladgl_context (this->glfn);
-
-            // Free up the Fonts associated with this morph::Visual
+            // Write out any frames from saveImageAsync and free the capture buffers. This is
+            // reached from the destructor, so report (rather than throw) a frame that can't be written.
+            try {
+                this->finishImageWrites();
+            } catch (const std::exception& e) {
+                std::cerr << "Visual: Failed to write a frame from saveImageAsync: " << e.what() << std::endl;
+            }
+            this->frame_writer.reset();
+            if (this->capture_pbo[0] != 0) {
+                this->glfn->DeleteBuffers (2, this->capture_pbo);
+                this->capture_pbo[0] = 0;
+                this->capture_pbo[1] = 0;
+                this->capture[0].bytes = 0;
+                this->capture[1].bytes = 0;
+            }
+            // Free up the Fonts associated with this morph::Visual (while glfn is still valid)
             morph::VisualResourcesMX<glver>::i().freetype_deinit (this);
+
+            this->free_gladgl_context (this->glfn);
         }
 
     protected:
@@ -162,6 +179,63 @@ namespace morph {
             return dims;
         }
 
+        /*!
+         * Save a screenshot of the window without waiting for the GPU or for the image to be
+         * written. The pixels are read into one of two pixel buffer objects, and the frame that
+         * was read into the other buffer on the previous call is collected and handed to a
+         * FrameWriter, whose worker threads encode and write it. If img_filename ends in .png,
+         * a PNG is written; otherwise the frame is appended to img_filename as a raw frame
+         * file (see FrameWriter). Call finishImageWrites() to write out the final frame and wait
+         * for all the images to be written. Returns the frame's width and height.
+         */
+        morph::vec<int, 2> saveImageAsync (const std::string& img_filename, const bool transparent_bg = false)
+        {
+            this->setContext();
+
+            GLint viewport[4];
+            this->glfn->GetIntegerv (GL_VIEWPORT, viewport);
+            morph::vec<int, 2> dims = { viewport[2], viewport[3] };
+
+            if (this->capture_pbo[0] == 0) { this->glfn->GenBuffers (2, this->capture_pbo); }
+            pending_capture& pc = this->capture[this->capture_cur];
+            const GLsizeiptr nbytes = static_cast<GLsizeiptr>(dims.product()) * 4;
+            this->glfn->BindBuffer (GL_PIXEL_PACK_BUFFER, this->capture_pbo[this->capture_cur]);
+            if (pc.bytes != nbytes) {
+                this->glfn->BufferData (GL_PIXEL_PACK_BUFFER, nbytes, nullptr, GL_STREAM_READ);
+                pc.bytes = nbytes;
+            }
+            this->glfn->PixelStorei (GL_PACK_ALIGNMENT, 1);
+            this->glfn->PixelStorei (GL_PACK_ROW_LENGTH, 0);
+            this->glfn->PixelStorei (GL_PACK_SKIP_ROWS, 0);
+            this->glfn->PixelStorei (GL_PACK_SKIP_PIXELS, 0);
+            // With a pack buffer bound, ReadPixels returns without waiting for the frame
+            this->glfn->ReadPixels (0, 0, dims[0], dims[1], GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            pc.fence = this->glfn->FenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            this->glfn->BindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+            pc.dims = dims;
+            pc.filename = img_filename;
+            pc.transparent_bg = transparent_bg;
+            morph::gl::Util::checkError (__FILE__, __LINE__, this->glfn);
+
+            // Collect the previous frame, which has had a frame's time to be read back
+            this->capture_cur = 1 - this->capture_cur;
+            this->collect_capture (this->capture_cur);
+
+            return dims;
+        }
+
+        //! Collect any frames captured by saveImageAsync and wait until they have all been written
+        void finishImageWrites()
+        {
+            if (this->capture_pbo[0] != 0) {
+                this->setContext();
+                // The older frame is in the current buffer
+                this->collect_capture (this->capture_cur);
+                this->collect_capture (1 - this->capture_cur);
+            }
+            if (this->frame_writer) { this->frame_writer->wait(); }
+        }
+
         //! Render the scene
         void render() noexcept final
         {
@@ -172,12 +246,14 @@ namespace morph {
                     if (this->shaders.gprog) { this->glfn->DeleteProgram (this->shaders.gprog); }
                     this->shaders.gprog = morph::gl::LoadShadersMX (this->proj2d_shader_progs, this->glfn);
                     this->active_gprog = morph::visgl::graphics_shader_type::projection2d;
+                    this->cache_uniform_locations();
                 }
             } else if (this->ptype == perspective_type::cylindrical) {
                 if (this->active_gprog != morph::visgl::graphics_shader_type::cylindrical) {
                     if (this->shaders.gprog) { this->glfn->DeleteProgram (this->shaders.gprog); }
                     this->shaders.gprog = morph::gl::LoadShadersMX (this->cyl_shader_progs, this->glfn);
                     this->active_gprog = morph::visgl::graphics_shader_type::cylindrical;
+                    this->cache_uniform_locations();
                 }
             }
 
@@ -191,12 +267,10 @@ namespace morph {
                 this->setPerspective();
             } else if (this->ptype == perspective_type::cylindrical) {
                 // Set cylindrical-specific uniforms
-                GLint loc_campos = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("cyl_cam_pos"));
-                if (loc_campos != -1) { this->glfn->Uniform4fv (loc_campos, 1, this->cyl_cam_pos.data()); }
-                GLint loc_cyl_radius = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("cyl_radius"));
-                if (loc_cyl_radius != -1) { this->glfn->Uniform1f (loc_cyl_radius, this->cyl_radius); }
-                GLint loc_cyl_height = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("cyl_height"));
-                if (loc_cyl_height != -1) { this->glfn->Uniform1f (loc_cyl_height, this->cyl_height); }
+                const morph::visgl::scene_uniforms& su = this->shaders.gprog_scene;
+                if (su.cyl_cam_pos != -1) { this->glfn->Uniform4fv (su.cyl_cam_pos, 1, this->cyl_cam_pos.data()); }
+                if (su.cyl_radius != -1) { this->glfn->Uniform1f (su.cyl_radius, this->cyl_radius); }
+                if (su.cyl_height != -1) { this->glfn->Uniform1f (su.cyl_height, this->cyl_height); }
             } else {
                 // unknown projection
                 return;
@@ -217,35 +291,36 @@ namespace morph {
             // Set the background colour:
             this->glfn->ClearBufferfv (GL_COLOR, 0, this->bgcolour.data());
 
-            // Lighting shader variables
-            //
+            // Lighting shader variables (the uniform locations were looked up when the program was linked)
+            const morph::visgl::scene_uniforms& gsu = this->shaders.gprog_scene;
             // Ambient light colour
-            GLint loc_lightcol = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("light_colour"));
-            if (loc_lightcol != -1) { this->glfn->Uniform3fv (loc_lightcol, 1, this->light_colour.data()); }
+            if (gsu.light_colour != -1) { this->glfn->Uniform3fv (gsu.light_colour, 1, this->light_colour.data()); }
             // Ambient light intensity
-            GLint loc_ai = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("ambient_intensity"));
-            if (loc_ai != -1) { this->glfn->Uniform1f (loc_ai, this->ambient_intensity); }
+            if (gsu.ambient_intensity != -1) { this->glfn->Uniform1f (gsu.ambient_intensity, this->ambient_intensity); }
             // Diffuse light position
-            GLint loc_dp = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("diffuse_position"));
-            if (loc_dp != -1) { this->glfn->Uniform3fv (loc_dp, 1, this->diffuse_position.data()); }
+            if (gsu.diffuse_position != -1) { this->glfn->Uniform3fv (gsu.diffuse_position, 1, this->diffuse_position.data()); }
             // Diffuse light intensity
-            GLint loc_di = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("diffuse_intensity"));
-            if (loc_di != -1) { this->glfn->Uniform1f (loc_di, this->diffuse_intensity); }
+            if (gsu.diffuse_intensity != -1) { this->glfn->Uniform1f (gsu.diffuse_intensity, this->diffuse_intensity); }
 
             // Switch to text shader program and set the projection matrix
             this->glfn->UseProgram (this->shaders.tprog);
-            GLint loc_p = this->glfn->GetUniformLocation (this->shaders.tprog, static_cast<const GLchar*>("p_matrix"));
-            if (loc_p != -1) { this->glfn->UniformMatrix4fv (loc_p, 1, GL_FALSE, this->projection.mat.data()); }
+            if (this->shaders.tprog_scene.p_matrix != -1) {
+                this->glfn->UniformMatrix4fv (this->shaders.tprog_scene.p_matrix, 1, GL_FALSE, this->projection.mat.data());
+            }
 
             // Switch back to the regular shader prog and render the VisualModels.
             this->glfn->UseProgram (this->shaders.gprog);
 
             // Set the projection matrix just once
-            loc_p = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("p_matrix"));
-            if (loc_p != -1) { this->glfn->UniformMatrix4fv (loc_p, 1, GL_FALSE, this->projection.mat.data()); }
-
-            if ((this->ptype == perspective_type::orthographic || this->ptype == perspective_type::perspective)
-                && this->options.test(visual_options::showCoordArrows)) {
+            if (gsu.p_matrix != -1) { this->glfn->UniformMatrix4fv (gsu.p_matrix, 1, GL_FALSE, this->projection.mat.data()); }
+
+            // Draw the VisualModels in the order in which they were added, which matters for alpha
+            // blending. The graphics shader program stays in use, except that each model with texts
+            // switches to the text program to draw them straight after its triangles. With
+            // visual_options::deferTexts, all the texts are drawn after all the triangles instead.
+            const bool show_arrows = (this->ptype == perspective_type::orthographic || this->ptype == perspective_type::perspective)
+                                     && this->options.test (visual_options::showCoordArrows);
+            if (show_arrows) {
                 // Ensure coordarrows centre sphere will be visible on BG:
                 this->coordArrows->setColourForBackground (this->bgcolour); // releases context...
                 this->setContext(); // ...so re-acquire if we're managing it
@@ -255,12 +330,18 @@ namespace morph {
                 } else {
                     this->positionCoordArrows();
                 }
-                this->coordArrows->render();
+                this->coordArrows->draw();
             }
 
             morph::mat44<float> scenetransonly;
             scenetransonly.translate (this->scenetrans);
 
+            // Models wholly outside the view frustum are not drawn (the cylindrical projection is not a frustum)
+            const bool cull = (this->ptype == perspective_type::orthographic || this->ptype == perspective_type::perspective)
+                              && !this->options.test (visual_options::disableFrustumCulling);
+            const float viewport_h = static_cast<float>(this->window_h * morph::retinaScale);
+            const bool defer_texts = this->options.test (visual_options::deferTexts);
+
             auto vmi = this->vm.begin();
             while (vmi != this->vm.end()) {
                 if ((*vmi)->twodimensional == true) {
@@ -269,25 +350,40 @@ namespace morph {
                 } else {
                     (*vmi)->setSceneMatrix (sceneview);
                 }
-                (*vmi)->render();
+                if (cull) {
+                    (*vmi)->computeVisibility (this->projection, viewport_h);
+                } else {
+                    (*vmi)->resetVisibility();
+                }
+                if ((*vmi)->render_in_scene (defer_texts) == false) {
+                    // An overridden render() drew the model itself and may have changed the program
+                    this->glfn->UseProgram (this->shaders.gprog);
+                }
                 ++vmi;
             }
 
+            this->glfn->UseProgram (this->shaders.tprog);
+            if (show_arrows) { this->coordArrows->draw_texts(); }
+            if (defer_texts) {
+                for (vmi = this->vm.begin(); vmi != this->vm.end(); ++vmi) { (*vmi)->draw_deferred_texts(); }
+            }
+
             morph::vec<float, 3> v0 = this->textPosition ({-0.8f, 0.8f});
             if (this->options.test (visual_options::showTitle) == true) {
                 // Render the title text
                 this->textModel->setSceneTranslation (v0);
                 this->textModel->setVisibleOn (this->bgcolour);
-                this->textModel->render();
+                this->textModel->draw();
             }
 
             auto ti = this->texts.begin();
             while (ti != this->texts.end()) {
                 (*ti)->setSceneTranslation (v0);
                 (*ti)->setVisibleOn (this->bgcolour);
-                (*ti)->render();
+                (*ti)->draw();
                 ++ti;
             }
+            this->glfn->UseProgram (this->shaders.gprog);
 
             this->swapBuffers();
         }
@@ -388,6 +484,90 @@ namespace morph {
         }
 
     protected:
+        //! Look up the locations of the per-model and per-frame uniforms once, after the shaders are (re)linked
+        void cache_uniform_locations()
+        {
+            auto lookup = [this](GLuint prog, morph::visgl::model_uniforms& u)
+            {
+                u.alpha = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("alpha"));
+                u.v_matrix = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("v_matrix"));
+                u.m_matrix = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("m_matrix"));
+                u.instanced = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("instanced"));
+                u.scalar_colour = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("scalar_colour"));
+                u.scalar_params = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("scalar_params"));
+                u.scalar_nan = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("scalar_nan"));
+                u.scalar_cmap = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("scalar_cmap"));
+                u.text_colour = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("textColor"));
+            };
+            auto lookup_scene = [this](GLuint prog, morph::visgl::scene_uniforms& u)
+            {
+                u.p_matrix = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("p_matrix"));
+                u.light_colour = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("light_colour"));
+                u.ambient_intensity = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("ambient_intensity"));
+                u.diffuse_position = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("diffuse_position"));
+                u.diffuse_intensity = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("diffuse_intensity"));
+                u.cyl_cam_pos = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("cyl_cam_pos"));
+                u.cyl_radius = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("cyl_radius"));
+                u.cyl_height = this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>("cyl_height"));
+            };
+            if (this->shaders.gprog) {
+                lookup (this->shaders.gprog, this->shaders.gprog_uniforms);
+                lookup_scene (this->shaders.gprog, this->shaders.gprog_scene);
+            }
+            if (this->shaders.tprog) {
+                lookup (this->shaders.tprog, this->shaders.tprog_uniforms);
+                lookup_scene (this->shaders.tprog, this->shaders.tprog_scene);
+            }
+        }
+
+        //! A frame that saveImageAsync has read into a pixel buffer object
+        struct pending_capture
+        {
+            GLsync fence = nullptr;
+            GLsizeiptr bytes = 0;
+            morph::vec<int, 2> dims = { 0, 0 };
+            std::string filename;
+            bool transparent_bg = false;
+        };
+        //! Two pixel pack buffers, used in turn by saveImageAsync
+        GLuint capture_pbo[2] = { 0, 0 };
+        pending_capture capture[2];
+        //! The index of the buffer that the next saveImageAsync call reads into
+        int capture_cur = 0;
+        //! The worker threads that encode and write the captured frames
+        std::unique_ptr<morph::FrameWriter> frame_writer;
+
+        //! If a frame is waiting in capture_pbo[i], copy it out (flipping it so that the top row
+        //! comes first) and pass it to the frame_writer
+        void collect_capture (const int i)
+        {
+            pending_capture& pc = this->capture[i];
+            if (pc.fence == nullptr) { return; }
+            this->glfn->ClientWaitSync (pc.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            this->glfn->DeleteSync (pc.fence);
+            pc.fence = nullptr;
+
+            const std::size_t rowbytes = static_cast<std::size_t>(pc.dims[0]) * 4;
+            const std::size_t nrows = static_cast<std::size_t>(pc.dims[1]);
+            std::vector<unsigned char> pixels (rowbytes * nrows);
+            this->glfn->BindBuffer (GL_PIXEL_PACK_BUFFER, this->capture_pbo[i]);
+            auto mapped = static_cast<const unsigned char*>(this->glfn->MapBufferRange (GL_PIXEL_PACK_BUFFER, 0, pc.bytes, GL_MAP_READ_BIT));
+            if (mapped != nullptr) {
+                for (std::size_t r = 0; r < nrows; ++r) {
+                    std::memcpy (pixels.data() + (nrows - r - 1) * rowbytes, mapped + r * rowbytes, rowbytes);
+                }
+                this->glfn->UnmapBuffer (GL_PIXEL_PACK_BUFFER);
+            }
+            this->glfn->BindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+            morph::gl::Util::checkError (__FILE__, __LINE__, this->glfn);
+            if (mapped == nullptr) {
+                std::cerr << "saveImageAsync: failed to map the pixel buffer for " << pc.filename << std::endl;
+                return;
+            }
+            if (!this->frame_writer) { this->frame_writer = std::make_unique<morph::FrameWriter>(); }
+            this->frame_writer->push (std::move (pixels), pc.dims[0], pc.dims[1], pc.filename, pc.transparent_bg);
+        }
+
         // Initialize OpenGL shaders, set some flags (Alpha, Anti-aliasing), read in any external
         // state from json, and set up the coordinate arrows and any VisualTextModels that will be
         // required to render the Visual.
@@ -424,6 +604,7 @@ namespace morph {
                 {GL_FRAGMENT_SHADER, "VisText.frag.glsl" , morph::getDefaultTextFragShader(glver), 0 }
             };
             this->shaders.tprog = morph::gl::LoadShadersMX (this->text_shader_progs, this->glfn);
+            this->cache_uniform_locations();
 
             // OpenGL options
             this->glfn->Enable (GL_DEPTH_TEST);
@@ -26,7 +26,13 @@ namespace morph {
     {
     private:
         VisualResourcesMX(){}
-        ~VisualResourcesMX() { this->faces.clear(); }
+        // Any faces left here have outlived their Visual's OpenGL context (see
+        // VisualResourcesNoMX), so don't delete their atlas textures.
+        ~VisualResourcesMX()
+        {
+            for (auto& f : this->faces) { f.second->atlas = 0; }
+            this->faces.clear();
+        }
 
         //! The collection of VisualFaces generated for this instance of the
         //! application. Create one VisualFace for each unique combination of VisualFont
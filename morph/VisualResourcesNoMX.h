@@ -28,8 +28,13 @@ namespace morph {
         VisualResourcesNoMX(){}
         // Normally, when each morph::Visual goes out of scope, the faces associated with that
         // Visual get cleaned up (in VisualResources::freetype_deinit). So at this point, faces
-        // should be empty, and the following clear() should do nothing.
-        ~VisualResourcesNoMX() { this->faces.clear(); }
+        // should be empty, and the following clear() should do nothing. Any faces left have
+        // outlived their Visual's OpenGL context, so don't delete their atlas textures.
+        ~VisualResourcesNoMX()
+        {
+            for (auto& f : this->faces) { f.second->atlas = 0; }
+            this->faces.clear();
+        }
 
         //! The collection of VisualFaces generated for this instance of the
         //! application. Create one VisualFace for each unique combination of VisualFont
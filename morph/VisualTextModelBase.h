@@ -176,6 +176,7 @@ namespace morph {
             for (unsigned int qi = 0; qi < nquads; ++qi) {
 
                 std::array<float, 12> quad = this->quads[qi];
+                const std::array<float, 5>& tc = this->quad_texcoords[qi];
 
                 if constexpr (debug_textquads == true) {
                     std::cout << "Quad box from (" << quad[0] << "," << quad[1] << "," << quad[2]
@@ -189,11 +190,12 @@ namespace morph {
                 this->vertex_push (quad[6], quad[7],  quad[8],  this->vertexPositions); //3
                 this->vertex_push (quad[9], quad[10], quad[11], this->vertexPositions); //4
 
-                // Add the info for drawing the textures on the quads
-                this->vertex_push (0.0f, 1.0f, 0.0f, this->vertexTextures);
-                this->vertex_push (0.0f, 0.0f, 0.0f, this->vertexTextures);
-                this->vertex_push (1.0f, 0.0f, 0.0f, this->vertexTextures);
-                this->vertex_push (1.0f, 1.0f, 0.0f, this->vertexTextures);
+                // Add the info for drawing the textures on the quads: the glyph's corners in the
+                // atlas and the atlas layer
+                this->vertex_push (tc[0], tc[3], tc[4], this->vertexTextures);
+                this->vertex_push (tc[0], tc[1], tc[4], this->vertexTextures);
+                this->vertex_push (tc[2], tc[1], tc[4], this->vertexTextures);
+                this->vertex_push (tc[2], tc[3], tc[4], this->vertexTextures);
 
                 // All same colours
                 this->vertex_push (this->clr_backing, this->vertexColors);
@@ -299,8 +301,9 @@ namespace morph {
         //! VisualTextModel. setupText should modify these as it sets up quads. Order of
         //! numbers is left, right, bottom, top
         vec<float, 4> extents = { 1e7, -1e7, 1e7, -1e7 };
-        //! The texture ID for each quad - so that we draw the right texture image over each quad.
-        std::vector<unsigned int> quad_ids = {};
+        //! The glyph atlas coordinates for each quad (left, top, right, bottom and the atlas
+        //! layer) - so that we draw the right part of the atlas over each quad.
+        std::vector<std::array<float, 5>> quad_texcoords = {};
         //! Position within vertex buffer object (if I use an array of VBO)
         enum VBOPos { posnVBO, normVBO, colVBO, idxVBO, textureVBO, numVBO };
         //! The OpenGL Vertex Array Object
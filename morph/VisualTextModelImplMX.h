@@ -47,50 +47,43 @@ namespace morph {
             }
         }
 
-        //! Render the VisualTextModel
+        //! Render the VisualTextModel on its own, restoring the previously used shader program
         void render() final
         {
             if (this->hide == true) { return; }
 
             GLint prev_shader;
-            GLuint tshaderprog = this->get_tprog (this->parentVis);
-
             auto _glfn = this->get_glfn (this->parentVis);
-
             _glfn->GetIntegerv (GL_CURRENT_PROGRAM, &prev_shader);
-
             // Ensure the correct program is in play for this VisualModel
-            _glfn->UseProgram (tshaderprog);
-
-            // Set uniforms
-            GLint loc_tc = _glfn->GetUniformLocation (tshaderprog, static_cast<const GLchar*>("textColor"));
-            if (loc_tc != -1) { _glfn->Uniform3f (loc_tc, this->clr_text[0], this->clr_text[1], this->clr_text[2]); }
-            GLint loc_a = _glfn->GetUniformLocation (tshaderprog, static_cast<const GLchar*>("alpha"));
-            if (loc_a != -1) { _glfn->Uniform1f (loc_a, this->alpha); }
-            GLint loc_v = _glfn->GetUniformLocation (tshaderprog, static_cast<const GLchar*>("v_matrix"));
-            if (loc_v != -1) { _glfn->UniformMatrix4fv (loc_v, 1, GL_FALSE, this->scenematrix.mat.data()); }
-            GLint loc_m = _glfn->GetUniformLocation (tshaderprog, static_cast<const GLchar*>("m_matrix"));
-            if (loc_m != -1) { _glfn->UniformMatrix4fv (loc_m, 1, GL_FALSE, this->viewmatrix.mat.data()); }
+            _glfn->UseProgram (this->get_tprog (this->parentVis));
+            this->draw();
+            _glfn->UseProgram (prev_shader);
+        }
+
+        //! Draw the VisualTextModel. The text shader program must be in use.
+        void draw()
+        {
+            if (this->hide == true || this->indices.empty()) { return; }
+
+            auto _glfn = this->get_glfn (this->parentVis);
+            // Set uniforms. Their locations were looked up when the program was linked.
+            const morph::visgl::model_uniforms u = this->get_shaderprogs (this->parentVis).tprog_uniforms;
+            if (u.text_colour != -1) { _glfn->Uniform3f (u.text_colour, this->clr_text[0], this->clr_text[1], this->clr_text[2]); }
+            if (u.alpha != -1) { _glfn->Uniform1f (u.alpha, this->alpha); }
+            if (u.v_matrix != -1) { _glfn->UniformMatrix4fv (u.v_matrix, 1, GL_FALSE, this->scenematrix.mat.data()); }
+            if (u.m_matrix != -1) { _glfn->UniformMatrix4fv (u.m_matrix, 1, GL_FALSE, this->viewmatrix.mat.data()); }
 
             _glfn->ActiveTexture (GL_TEXTURE0);
+            _glfn->BindTexture (GL_TEXTURE_2D_ARRAY, this->face->atlas);
 
             // It is only necessary to bind the vertex array object before rendering
             _glfn->BindVertexArray (this->vao);
 
-            // We have a max of (2^32)-1 characters. Should be enough.
-            for (unsigned int i = 0U; i < this->quads.size(); ++i) {
-                // Bind the right texture for the quad.
-                _glfn->BindTexture (GL_TEXTURE_2D, this->quad_ids[i]);
-                // This is 'draw a subset of the elements from the vertex array
-                // object'. You say how many indices to draw and which base *vertex* you
-                // start from. In my scheme, I have 4 vertices for each two triangles
-                // that are constructed. Thus, I draw 6 indices, but increment the base
-                // vertex by 4 for each letter.
-                _glfn->DrawElementsBaseVertex (GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, 4*i);
-            }
+            // All the glyphs are in the face's atlas, so the whole text is one draw call
+            _glfn->DrawElements (GL_TRIANGLES, static_cast<GLsizei>(this->indices.size()), GL_UNSIGNED_INT, 0);
 
             _glfn->BindVertexArray(0);
-            _glfn->UseProgram (prev_shader);
 
             morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);
         }
@@ -186,7 +179,7 @@ namespace morph {
             this->txt = _txt;
             // With glyph information from txt, set up this->quads.
             this->quads.clear();
-            this->quad_ids.clear();
+            this->quad_texcoords.clear();
             // Our string of letters starts at this location
             float letter_pos = 0.0f;
             float letter_y = 0.0f;
@@ -229,10 +222,10 @@ namespace morph {
                               << ") to (" << tbox[6] << "," << tbox[7] << "," << tbox[8]
                               << ") to (" << tbox[9] << "," << tbox[10] << "," << tbox[11]
                               << "). w="<<w<<", h="<<h<<"\n";
-                    std::cout << "Texture ID for that character is: " << ci.textureID << std::endl;
+                    std::cout << "Atlas layer for that character is: " << ci.layer << ", uv: " << ci.uv << std::endl;
                 }
                 this->quads.push_back (tbox);
-                this->quad_ids.push_back (ci.textureID);
+                this->quad_texcoords.push_back ({ ci.uv[0], ci.uv[1], ci.uv[2], ci.uv[3], static_cast<float>(ci.layer) });
 
                 // The value in ci.advance has to be divided by 64 to bring it into the
                 // same units as the ci.size and ci.bearing values.
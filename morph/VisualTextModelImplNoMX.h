@@ -46,48 +46,41 @@ namespace morph {
             }
         }
 
-        //! Render the VisualTextModel
+        //! Render the VisualTextModel on its own, restoring the previously used shader program
         void render() final
         {
             if (this->hide == true) { return; }
 
             GLint prev_shader;
-            GLuint tshaderprog = this->get_tprog (this->parentVis);
-
             glGetIntegerv (GL_CURRENT_PROGRAM, &prev_shader);
-
             // Ensure the correct program is in play for this VisualModel
-            glUseProgram (tshaderprog);
-
-            // Set uniforms
-            GLint loc_tc = glGetUniformLocation (tshaderprog, static_cast<const GLchar*>("textColor"));
-            if (loc_tc != -1) { glUniform3f (loc_tc, this->clr_text[0], this->clr_text[1], this->clr_text[2]); }
-            GLint loc_a = glGetUniformLocation (tshaderprog, static_cast<const GLchar*>("alpha"));
-            if (loc_a != -1) { glUniform1f (loc_a, this->alpha); }
-            GLint loc_v = glGetUniformLocation (tshaderprog, static_cast<const GLchar*>("v_matrix"));
-            if (loc_v != -1) { glUniformMatrix4fv (loc_v, 1, GL_FALSE, this->scenematrix.mat.data()); }
-            GLint loc_m = glGetUniformLocation (tshaderprog, static_cast<const GLchar*>("m_matrix"));
-            if (loc_m != -1) { glUniformMatrix4fv (loc_m, 1, GL_FALSE, this->viewmatrix.mat.data()); }
+            glUseProgram (this->get_tprog (this->parentVis));
+            this->draw();
+            glUseProgram (prev_shader);
+        }
+
+        //! Draw the VisualTextModel. The text shader program must be in use.
+        void draw()
+        {
+            if (this->hide == true || this->indices.empty()) { return; }
+
+            // Set uniforms. Their locations were looked up when the program was linked.
+            const morph::visgl::model_uniforms u = this->get_shaderprogs (this->parentVis).tprog_uniforms;
+            if (u.text_colour != -1) { glUniform3f (u.text_colour, this->clr_text[0], this->clr_text[1], this->clr_text[2]); }
+            if (u.alpha != -1) { glUniform1f (u.alpha, this->alpha); }
+            if (u.v_matrix != -1) { glUniformMatrix4fv (u.v_matrix, 1, GL_FALSE, this->scenematrix.mat.data()); }
+            if (u.m_matrix != -1) { glUniformMatrix4fv (u.m_matrix, 1, GL_FALSE, this->viewmatrix.mat.data()); }
 
             glActiveTexture (GL_TEXTURE0);
+            glBindTexture (GL_TEXTURE_2D_ARRAY, this->face->atlas);
 
             // It is only necessary to bind the vertex array object before rendering
             glBindVertexArray (this->vao);
 
-            // We have a max of (2^32)-1 characters. Should be enough.
-            for (unsigned int i = 0U; i < this->quads.size(); ++i) {
-                // Bind the right texture for the quad.
-                glBindTexture (GL_TEXTURE_2D, this->quad_ids[i]);
-                // This is 'draw a subset of the elements from the vertex array
-                // object'. You say how many indices to draw and which base *vertex* you
-                // start from. In my scheme, I have 4 vertices for each two triangles
-                // that are constructed. Thus, I draw 6 indices, but increment the base
-                // vertex by 4 for each letter.
-                glDrawElementsBaseVertex (GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, 4*i);
-            }
+            // All the glyphs are in the face's atlas, so the whole text is one draw call
+            glDrawElements (GL_TRIANGLES, static_cast<GLsizei>(this->indices.size()), GL_UNSIGNED_INT, 0);
 
             glBindVertexArray(0);
-            glUseProgram (prev_shader);
 
             morph::gl::Util::checkError (__FILE__, __LINE__);
         }
@@ -178,7 +171,7 @@ namespace morph {
             this->txt = _txt;
             // With glyph information from txt, set up this->quads.
             this->quads.clear();
-            this->quad_ids.clear();
+            this->quad_texcoords.clear();
             // Our string of letters starts at this location
             float letter_pos = 0.0f;
             float letter_y = 0.0f;
@@ -221,10 +214,10 @@ namespace morph {
                               << ") to (" << tbox[6] << "," << tbox[7] << "," << tbox[8]
                               << ") to (" << tbox[9] << "," << tbox[10] << "," << tbox[11]
                               << "). w="<<w<<", h="<<h<<"\n";
-                    std::cout << "Texture ID for that character is: " << ci.textureID << std::endl;
+                    std::cout << "Atlas layer for that character is: " << ci.layer << ", uv: " << ci.uv << std::endl;
                 }
                 this->quads.push_back (tbox);
-                this->quad_ids.push_back (ci.textureID);
+                this->quad_texcoords.push_back ({ ci.uv[0], ci.uv[1], ci.uv[2], ci.uv[3], static_cast<float>(ci.layer) });
 
                 // The value in ci.advance has to be divided by 64 to bring it into the
                 // same units as the ci.size and ci.bearing values.
@@ -8,6 +8,10 @@
 #pragma once
 
 #include <vector>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
 #include <morph/vec.h>
 #include <morph/vvec.h>
 
@@ -18,61 +22,113 @@ namespace morph {
 
         static constexpr bool debug_bstrap = false;
 
-        // Resample B sets from data and place them in resamples
-        static void resample_with_replacement (const morph::vvec<T>& data,
-                                               std::vector<morph::vvec<T>>& resamples, const unsigned int B)
+        // A seed for the resample streams from std::random_device. This is the default seed for
+        // the bootstrap functions; pass your own seed for reproducible results.
+        static std::uint64_t random_seed()
         {
-            unsigned int data_n = data.size();
-            resamples.resize (B);
-            for (unsigned int i = 0; i < B; ++i) {
-                morph::vvec<T> resample (data_n);
-                morph::vvec<unsigned int> randindices (data_n);
-                randindices.randomize (0, data_n - 1);
-                for (unsigned int j = 0; j < data_n; ++j) {
-                    resample[j] = data[randindices[j]];
+            std::random_device rd;
+            return (static_cast<std::uint64_t>(rd()) << 32) ^ static_cast<std::uint64_t>(rd());
+        }
+
+        // A seed derived from seed and b (a splitmix64 hash), for a second, independent set of
+        // resamples
+        static std::uint64_t resample_seed (const std::uint64_t seed, const std::uint64_t b)
+        {
+            std::uint64_t z = seed + (b + 1) * 0x9e3779b97f4a7c15ull;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        // Fill resample with data drawn with replacement, from stream b of the counter-based
+        // generator seeded with seed
+        static void draw_resample (const morph::vvec<T>& data, morph::vvec<T>& resample,
+                                   const std::uint64_t seed, const std::uint64_t b)
+        {
+            morph::RandPhilox gen (seed, b);
+            std::uniform_int_distribution<std::size_t> index (0, data.size() - 1);
+            resample.resize (data.size());
+            for (auto& r : resample) { r = data[index (gen)]; }
+        }
+
+        // Compute stat(resample) for each of B resamples of data (drawn with replacement). The
+        // resamples are never stored together; each thread draws into one reused buffer, so the
+        // memory needed is one resample per thread. Resample b takes its random indices from
+        // stream b of a RandPhilox seeded with seed, so the results depend only on seed, not on
+        // the number of threads. stat may return any type; it is called from several threads at once
+        // so it must be thread safe (and must not throw).
+        template <typename F>
+        static auto resample_statistic (const morph::vvec<T>& data, const unsigned int B, F stat,
+                                        const std::uint64_t seed = random_seed())
+        {
+            using R = std::decay_t<std::invoke_result_t<F, const morph::vvec<T>&>>;
+            // std::vector<bool> packs its elements into shared words, so threads writing to
+            // neighbouring elements would race. bool results are stored as bytes.
+            using Rs = std::conditional_t<std::is_same_v<R, bool>, unsigned char, R>;
+            std::vector<Rs> stats (B);
+            if (!data.empty()) {
+#pragma omp parallel
+                {
+                    morph::vvec<T> resample (data.size());
+#pragma omp for schedule(static)
+                    for (unsigned int b = 0; b < B; ++b) {
+                        draw_resample (data, resample, seed, b);
+                        stats[b] = static_cast<Rs>(stat (resample));
+                    }
                 }
-                resamples[i] = resample;
+            }
+            if constexpr (std::is_same_v<R, bool>) {
+                return std::vector<bool> (stats.begin(), stats.end());
+            } else {
+                return stats;
             }
         }
 
+        // Resample B sets from data and place them in resamples. This stores all B resamples;
+        // prefer resample_statistic, which doesn't.
+        static void resample_with_replacement (const morph::vvec<T>& data,
+                                               std::vector<morph::vvec<T>>& resamples, const unsigned int B,
+                                               const std::uint64_t seed = random_seed())
+        {
+            resamples.resize (B);
+            if (data.empty()) { return; }
+            for (unsigned int i = 0; i < B; ++i) { draw_resample (data, resamples[i], seed, i); }
+        }
+
         // Compute a bootstapped standard error of the mean of the data with B resamples
-        static T error_of_mean (const morph::vvec<T>& data, const unsigned int B)
+        static T error_of_mean (const morph::vvec<T>& data, const unsigned int B,
+                                const std::uint64_t seed = random_seed())
         {
-            std::vector<morph::vvec<T>> resamples;
-            morph::bootstrap<T>::resample_with_replacement (data, resamples, B);
-            morph::vvec<T> r_mean (B, T{0});
-            for (unsigned int i = 0; i < B; ++i) {
-                r_mean[i] = resamples[i].mean();
-            }
+            morph::vvec<T> r_mean;
+            r_mean.set_from (resample_statistic (data, B, [](const morph::vvec<T>& r) { return r.mean(); }, seed));
             // Standard error is the standard deviation of the resample means
             return r_mean.std();
         }
         // std::vector version of error_of_mean
-        static T error_of_mean (const std::vector<T>& data, const unsigned int B)
+        static T error_of_mean (const std::vector<T>& data, const unsigned int B,
+                                const std::uint64_t seed = random_seed())
         {
             morph::vvec<T> vdata;
             vdata.set_from (data);
-            return bootstrap<T>::error_of_mean (vdata, B);
+            return bootstrap<T>::error_of_mean (vdata, B, seed);
         }
 
         // Compute a bootstapped standard error of the SD of the data with B resamples
-        static T error_of_std (const morph::vvec<T>& data, const unsigned int B)
+        static T error_of_std (const morph::vvec<T>& data, const unsigned int B,
+                               const std::uint64_t seed = random_seed())
         {
-            std::vector<morph::vvec<T>> resamples;
-            morph::bootstrap<T>::resample_with_replacement (data, resamples, B);
-            morph::vvec<T> r_std (B, T{0});
-            for (unsigned int i = 0; i < B; ++i) {
-                r_std[i] = resamples[i].std();
-            }
+            morph::vvec<T> r_std;
+            r_std.set_from (resample_statistic (data, B, [](const morph::vvec<T>& r) { return r.std(); }, seed));
             // Standard error of the statistic is the standard deviation of the resampled statistic
             return r_std.std();
         }
         // std::vector version of error_of_std
-        static T error_of_std (const std::vector<T>& data, const unsigned int B)
+        static T error_of_std (const std::vector<T>& data, const unsigned int B,
+                               const std::uint64_t seed = random_seed())
         {
             morph::vvec<T> vdata;
             vdata.set_from (data);
-            return bootstrap<T>::error_of_std (vdata, B);
+            return bootstrap<T>::error_of_std (vdata, B, seed);
         }
 
         // Compute a bootstrapped two sample t statistic as per algorithm 16.2
@@ -98,7 +154,8 @@ namespace morph {
         // Cognitive and Developmental Systems, vol. 10, no. 3, pp. 823-836, Sept. 2018, doi:
         // 10.1109/TCDS.2018.2797426.
         static morph::vec<T, 2> ttest_equalityofmeans (const morph::vvec<T>& _zdata,
-                                                       const morph::vvec<T>& _ydata, const unsigned int B)
+                                                       const morph::vvec<T>& _ydata, const unsigned int B,
+                                                       const std::uint64_t seed = random_seed())
         {
             // Ensure that the group which we name zdata is the larger one.
             morph::vvec<T> zdata = _zdata;
@@ -138,36 +195,24 @@ namespace morph {
                 std::cout << "ytilda mean: " << ytilda.mean() << std::endl;
             }
 
-            // Resample from the shifted (tilda) distributions:
-            std::vector<morph::vvec<T>> zstar;
-            bootstrap<T>::resample_with_replacement (ztilda, zstar, B);
-            if constexpr (debug_bstrap) {
-                std::cout << "zstar size after resample: " << zstar.size() << std::endl;
-            }
-            std::vector<morph::vvec<T>> ystar;
-            bootstrap<T>::resample_with_replacement (ytilda, ystar, B);
+            // Resample from the shifted (tilda) distributions, keeping just the mean and variance
+            // of each resample. z and y take their resamples from different streams.
+            auto mean_and_variance = [](const morph::vvec<T>& r) { return morph::vec<T, 2>{ r.mean(), r.variance() }; };
+            std::vector<morph::vec<T, 2>> zstar = resample_statistic (ztilda, B, mean_and_variance, seed);
+            std::vector<morph::vec<T, 2>> ystar = resample_statistic (ytilda, B, mean_and_variance, resample_seed (seed, B));
 
-            // Create vectors of the means of these resamples:
             morph::vvec<T> zstarmeans (B, T{0});
             morph::vvec<T> ystarmeans (B, T{0});
-
-            for (unsigned int i = 0; i < B; ++i) {
-                zstarmeans[i] = zstar[i].mean();
-                ystarmeans[i] = ystar[i].mean();
-            }
-
-            if constexpr (debug_bstrap) {
-                std::cout << "zstarmeans of size " << zstarmeans.size() << " and content: " << zstarmeans << std::endl;
-            }
-
-            // Compute the variances.
             morph::vvec<T> zvariances (B, T{0});
             morph::vvec<T> yvariances (B, T{0});
             for (unsigned int i = 0; i < B; ++i) {
-                zvariances[i] = (zstar[i]-zstarmeans[i]).pow(2).sum() / (n-1);
-                yvariances[i] = (ystar[i]-ystarmeans[i]).pow(2).sum() / (m-1);
+                zstarmeans[i] = zstar[i][0];
+                zvariances[i] = zstar[i][1];
+                ystarmeans[i] = ystar[i][0];
+                yvariances[i] = ystar[i][1];
             }
             if constexpr (debug_bstrap) {
+                std::cout << "zstarmeans of size " << zstarmeans.size() << " and content: " << zstarmeans << std::endl;
                 std::cout << "zvariances: " << zvariances << std::endl;
             }
 
@@ -191,13 +236,14 @@ namespace morph {
         }
         // std::vector version of ttest_equalityofmeans()
         static morph::vec<T, 2> ttest_equalityofmeans (const std::vector<T>& _zdata,
-                                                       const std::vector<T>& _ydata, const unsigned int B)
+                                                       const std::vector<T>& _ydata, const unsigned int B,
+                                                       const std::uint64_t seed = random_seed())
         {
             morph::vvec<T> vzdata;
             vzdata.set_from (_zdata);
             morph::vvec<T> vydata;
             vydata.set_from (_ydata);
-            return bootstrap<T>::ttest_equalityofmeans (vzdata, vydata, B);
+            return bootstrap<T>::ttest_equalityofmeans (vzdata, vydata, B, seed);
         }
     };
 }
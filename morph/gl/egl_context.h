@@ -0,0 +1,135 @@
+#pragma once
+
+/*
+ * A windowless OpenGL context from EGL, for rendering without a display (e.g. on a cluster node
+ * or in CI, using Mesa's llvmpipe or a GPU driver). Used by morph::VisualHeadless.
+ *
+ * The context has no default framebuffer. Render into a framebuffer object.
+ *
+ * Author: Seb James.
+ */
+
+#ifndef EGL_NO_X11
+# define EGL_NO_X11 // We need no X11 types; don't let eglplatform.h pull in Xlib.h
+#endif
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <morph/gl/version.h>
+#include <stdexcept>
+#include <string>
+#include <mutex>
+
+namespace morph {
+    namespace gl {
+
+        //! An EGL context with no surface. Throws from init() if no context can be made.
+        struct egl_context
+        {
+            EGLDisplay display = EGL_NO_DISPLAY;
+            EGLContext context = EGL_NO_CONTEXT;
+
+            /*!
+             * Create a context for the OpenGL (or OpenGL ES) version glver. A Mesa surfaceless
+             * display is preferred; otherwise the default EGL display is used.
+             */
+            void init (const int glver)
+            {
+                this->display = EGL_NO_DISPLAY;
+                std::unique_lock<std::mutex> lk (egl_context::display_mutex());
+                auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress ("eglGetPlatformDisplayEXT"));
+                if (get_platform_display != nullptr) {
+                    this->display = get_platform_display (EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+                }
+                EGLint egl_major = 0, egl_minor = 0;
+                if (this->display == EGL_NO_DISPLAY || !eglInitialize (this->display, &egl_major, &egl_minor)) {
+                    this->display = eglGetDisplay (EGL_DEFAULT_DISPLAY);
+                    if (this->display == EGL_NO_DISPLAY || !eglInitialize (this->display, &egl_major, &egl_minor)) {
+                        // display_users() was not incremented, so deinit() must not see this display
+                        this->display = EGL_NO_DISPLAY;
+                        throw std::runtime_error ("egl_context: Failed to initialize an EGL display");
+                    }
+                }
+                ++egl_context::display_users();
+                lk.unlock();
+
+                const bool gles = morph::gl::version::gles (glver);
+                if (!eglBindAPI (gles ? EGL_OPENGL_ES_API : EGL_OPENGL_API)) {
+                    this->deinit();
+                    throw std::runtime_error ("egl_context: EGL does not provide the OpenGL API");
+                }
+                // Choose a config if we can; a surfaceless context doesn't need one
+                const EGLint cfg_attribs[] = { EGL_RENDERABLE_TYPE, (gles ? EGL_OPENGL_ES3_BIT : EGL_OPENGL_BIT), EGL_NONE };
+                EGLConfig cfg = EGL_NO_CONFIG_KHR;
+                EGLint ncfg = 0;
+                if (!eglChooseConfig (this->display, cfg_attribs, &cfg, 1, &ncfg) || ncfg < 1) { cfg = EGL_NO_CONFIG_KHR; }
+
+                const EGLint profile = morph::gl::version::compat (glver)
+                    ? EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT : EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT;
+                const EGLint ctx_attribs[] = { EGL_CONTEXT_MAJOR_VERSION, morph::gl::version::major (glver),
+                                               EGL_CONTEXT_MINOR_VERSION, morph::gl::version::minor (glver),
+                                               (gles ? EGL_NONE : EGL_CONTEXT_OPENGL_PROFILE_MASK), profile, EGL_NONE };
+                this->context = eglCreateContext (this->display, cfg, EGL_NO_CONTEXT, ctx_attribs);
+                if (this->context == EGL_NO_CONTEXT) {
+                    this->deinit();
+                    throw std::runtime_error ("egl_context: Failed to create an OpenGL "
+                                              + morph::gl::version::vstring (glver) + " context");
+                }
+                if (!this->make_current()) {
+                    this->deinit();
+                    throw std::runtime_error ("egl_context: Failed to make the context current (no surfaceless support?)");
+                }
+            }
+
+            //! Make the context current in this thread
+            bool make_current() const
+            {
+                return eglMakeCurrent (this->display, EGL_NO_SURFACE, EGL_NO_SURFACE, this->context) == EGL_TRUE;
+            }
+
+            //! Make no context current in this thread
+            void release() const
+            {
+                if (this->display != EGL_NO_DISPLAY) {
+                    eglMakeCurrent (this->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+                }
+            }
+
+            //! True if the context is current in this thread
+            bool is_current() const
+            {
+                return this->context != EGL_NO_CONTEXT && eglGetCurrentContext() == this->context;
+            }
+
+            //! Destroy the context. The display is terminated when its last context is destroyed.
+            void deinit()
+            {
+                if (this->display == EGL_NO_DISPLAY) { return; }
+                if (this->context != EGL_NO_CONTEXT) {
+                    if (this->is_current()) { this->release(); }
+                    eglDestroyContext (this->display, this->context);
+                    this->context = EGL_NO_CONTEXT;
+                }
+                std::lock_guard<std::mutex> lk (egl_context::display_mutex());
+                if (--egl_context::display_users() == 0) { eglTerminate (this->display); }
+                this->display = EGL_NO_DISPLAY;
+            }
+
+        private:
+            // eglTerminate affects every context on a display, so count the contexts that use it
+            static int& display_users()
+            {
+                static int users = 0;
+                return users;
+            }
+            // Contexts may be made and destroyed in several threads at once. This guards the count
+            // together with the eglInitialize or eglTerminate call that goes with each change.
+            static std::mutex& display_mutex()
+            {
+                static std::mutex m;
+                return m;
+            }
+        };
+
+    } // namespace gl
+} // namespace morph
@@ -0,0 +1,228 @@
+/*!
+ * \file
+ *
+ * Support for a binary, on-disk cache of grid geometry, used by HexGrid::save_geometry and
+ * HexGrid::load_geometry. A cache file is written once, then memory mapped and copied into
+ * the grid's vectors on load, which is far quicker than re-applying a boundary and
+ * re-computing the distance to the boundary.
+ *
+ * Cache files are identified by a key computed from the grid's construction parameters and a
+ * hash of the boundary that was applied (usually the contents of an SVG file). This is POSIX
+ * code (it uses mmap).
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <type_traits>
+#include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace morph {
+
+    namespace gridcache {
+
+        //! The 64 bit FNV-1a hash of \a n bytes at \a data, continuing from the hash \a h
+        inline std::uint64_t fnv1a (const void* data, std::size_t n, std::uint64_t h = 0xcbf29ce484222325ULL)
+        {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (std::size_t i = 0; i < n; ++i) {
+                h ^= p[i];
+                h *= 0x100000001b3ULL;
+            }
+            return h;
+        }
+
+        //! Hash the contents of the file at \a path. Throws if the file can't be read.
+        inline std::uint64_t hash_file (const std::string& path)
+        {
+            std::ifstream f (path, std::ios::binary);
+            if (!f.is_open()) { throw std::runtime_error ("gridcache::hash_file: Failed to open " + path); }
+            std::uint64_t h = fnv1a (nullptr, 0);
+            std::vector<char> buf (1 << 16);
+            while (f) {
+                f.read (buf.data(), buf.size());
+                h = fnv1a (buf.data(), static_cast<std::size_t>(f.gcount()), h);
+            }
+            return h;
+        }
+
+        /*!
+         * The cache key for a grid with element to element distance \a d and span \a span, to
+         * which the boundary with hash \a boundary_hash has been applied.
+         */
+        inline std::uint64_t key (float d, float span, std::uint64_t boundary_hash)
+        {
+            std::uint64_t h = fnv1a (&d, sizeof(float));
+            h = fnv1a (&span, sizeof(float), h);
+            return fnv1a (&boundary_hash, sizeof(std::uint64_t), h);
+        }
+
+        //! A file name for the cache file with key \a k in the directory \a dir
+        inline std::string filename (const std::string& dir, const std::string& prefix, std::uint64_t k)
+        {
+            std::stringstream ss;
+            ss << dir << "/" << prefix << "_" << std::hex << std::setw(16) << std::setfill('0') << k << ".bin";
+            return ss.str();
+        }
+
+        /*!
+         * Writes a cache file as a fixed size header followed by a sequence of sections. Each
+         * section is an element count followed by the elements, padded to a multiple of 8
+         * bytes. The file is written under a temporary name and renamed into place on
+         * commit(), so that concurrent jobs never see a partly written file.
+         */
+        class writer
+        {
+        public:
+            explicit writer (const std::string& _path)
+                : path(_path), tmppath(_path + ".tmp" + std::to_string (::getpid()))
+            {
+                this->f.open (this->tmppath, std::ios::binary | std::ios::trunc);
+                if (!this->f.is_open()) {
+                    throw std::runtime_error ("gridcache::writer: Failed to open " + this->tmppath);
+                }
+            }
+            ~writer()
+            {
+                if (this->f.is_open()) {
+                    this->f.close();
+                    std::remove (this->tmppath.c_str());
+                }
+            }
+
+            //! Write a trivially copyable header struct
+            template <typename H>
+            void header (const H& h)
+            {
+                static_assert (std::is_trivially_copyable_v<H> && sizeof(H) % 8 == 0);
+                this->f.write (reinterpret_cast<const char*>(&h), sizeof(H));
+            }
+
+            //! Write a section holding the contents of \a v
+            template <typename T>
+            void section (const std::vector<T>& v)
+            {
+                static_assert (std::is_trivially_copyable_v<T>);
+                const std::uint64_t n = v.size();
+                this->f.write (reinterpret_cast<const char*>(&n), sizeof(n));
+                const std::size_t nbytes = n * sizeof(T);
+                this->f.write (reinterpret_cast<const char*>(v.data()), nbytes);
+                const char pad[8] = {};
+                this->f.write (pad, (8 - nbytes % 8) % 8);
+            }
+
+            //! Close the file and move it into place
+            void commit()
+            {
+                this->f.close();
+                if (this->f.fail()) {
+                    std::remove (this->tmppath.c_str());
+                    throw std::runtime_error ("gridcache::writer: Failed to write " + this->tmppath);
+                }
+                std::error_code ec;
+                std::filesystem::rename (this->tmppath, this->path, ec);
+                if (ec) {
+                    std::remove (this->tmppath.c_str());
+                    throw std::runtime_error ("gridcache::writer: Failed to rename " + this->tmppath + " to " + this->path);
+                }
+            }
+
+        private:
+            std::string path;
+            std::string tmppath;
+            std::ofstream f;
+        };
+
+        /*!
+         * Reads a cache file written by gridcache::writer through a read-only memory mapping.
+         * A reader that failed to open its file, or that has run past the end of the data, is
+         * !good(); it does not throw, because a missing or stale cache file is not an error.
+         */
+        class reader
+        {
+        public:
+            explicit reader (const std::string& path)
+            {
+                int fd = ::open (path.c_str(), O_RDONLY);
+                if (fd < 0) { return; }
+                struct stat st;
+                if (::fstat (fd, &st) == 0 && st.st_size > 0) {
+                    void* p = ::mmap (nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (p != MAP_FAILED) {
+                        this->base = static_cast<const char*>(p);
+                        this->len = static_cast<std::size_t>(st.st_size);
+                    }
+                }
+                ::close (fd);
+            }
+            reader (const reader&) = delete;
+            reader& operator= (const reader&) = delete;
+            ~reader() { if (this->base != nullptr) { ::munmap (const_cast<char*>(this->base), this->len); } }
+
+            bool good() const { return this->base != nullptr && this->ok; }
+
+            //! Read the header struct
+            template <typename H>
+            bool header (H& h)
+            {
+                static_assert (std::is_trivially_copyable_v<H> && sizeof(H) % 8 == 0);
+                if (!this->take (sizeof(H))) { return false; }
+                std::memcpy (&h, this->base + this->pos - sizeof(H), sizeof(H));
+                return true;
+            }
+
+            //! Read a section into \a v, which must end up with \a expected elements
+            template <typename T>
+            bool section (std::vector<T>& v, std::uint64_t expected)
+            {
+                static_assert (std::is_trivially_copyable_v<T>);
+                std::uint64_t n = 0;
+                if (!this->take (sizeof(n))) { return false; }
+                std::memcpy (&n, this->base + this->pos - sizeof(n), sizeof(n));
+                if (n != expected) { this->ok = false; return false; }
+                const std::size_t nbytes = n * sizeof(T);
+                const std::size_t start = this->pos;
+                if (!this->take (nbytes + (8 - nbytes % 8) % 8)) { return false; }
+                v.resize (n);
+                std::memcpy (v.data(), this->base + start, nbytes);
+                return true;
+            }
+
+            //! The element count of the next section, without consuming it
+            std::uint64_t peek_count() const
+            {
+                std::uint64_t n = 0;
+                if (this->good() && this->pos + sizeof(n) <= this->len) {
+                    std::memcpy (&n, this->base + this->pos, sizeof(n));
+                }
+                return n;
+            }
+
+        private:
+            bool take (std::size_t n)
+            {
+                if (!this->good() || n > this->len - this->pos) { this->ok = false; return false; }
+                this->pos += n;
+                return true;
+            }
+
+            const char* base = nullptr;
+            std::size_t len = 0;
+            std::size_t pos = 0;
+            bool ok = true;
+        };
+
+    } // namespace gridcache
+} // namespace morph
@@ -0,0 +1,237 @@
+/*!
+ * \file
+ *
+ * A contiguous-storage alternative to std::list for holding the Hexes of a HexGrid. Define
+ * HEXGRID_CONTIGUOUS_STORAGE before including morph/Hex.h or morph/HexGrid.h to use it.
+ */
+#pragma once
+
+#include <vector>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <optional>
+#include <type_traits>
+#include <stdexcept>
+
+namespace morph {
+
+    /*!
+     * A circular doubly linked list whose nodes are held contiguously in a std::vector, and
+     * whose links are 32-bit offsets between nodes in that vector.
+     *
+     * It offers the subset of std::list's interface that HexGrid and its clients use
+     * (begin/end, push_back/emplace_back, erase, front/back, size, clear), so that code written
+     * against std::list<Hex> compiles unchanged. An iterator is a single pointer to a node,
+     * just as for std::list. Like std::list, erase() does not invalidate iterators to other
+     * elements and iteration visits elements in list order. Unlike std::list, all iterators,
+     * pointers and references would be invalidated if an insertion had to grow the storage, as
+     * for std::vector. So call reserve() before building a container whose iterators are kept
+     * (HexGrid does this). After reserve(), an insertion that would grow the storage throws
+     * instead, until the next clear().
+     *
+     * Erased elements are unlinked but their storage is not reclaimed until clear().
+     *
+     * If T has a member function attach_arena (const void*), it is called with the base of the
+     * storage for each element that is inserted, and again for every element whenever the
+     * storage moves (on growth or copy). Together with at() and index_of(), this lets an element
+     * hold 32-bit indices to other elements in place of iterators (see morph::HexLinks).
+     *
+     * \tparam T The element type (morph::Hex). May be incomplete where hexarena<T>::iterator is
+     * named.
+     */
+    template <typename T>
+    class hexarena
+    {
+        //! Element 0 of the storage is a sentinel node with no value; end() points to it.
+        struct node
+        {
+            std::optional<T> val;
+            int32_t prev = 0;
+            int32_t next = 0;
+        };
+
+        template <bool is_const>
+        class iter
+        {
+            template <bool> friend class iter;
+            friend class hexarena<T>;
+
+            node* n = nullptr;
+
+            explicit iter (node* _n) : n(_n) {}
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<is_const, const T*, T*>;
+            using reference = std::conditional_t<is_const, const T&, T&>;
+
+            iter() = default;
+            //! Allow conversion from iterator to const_iterator
+            template <bool c = is_const, std::enable_if_t<c, int> = 0>
+            iter (const iter<false>& o) : n(o.n) {}
+            //! Allow conversion to const_iterator from a type that converts to iterator (a HexLink)
+            template <typename L, bool c = is_const,
+                      std::enable_if_t<c && !std::is_same_v<L, iter<false>> && std::is_convertible_v<const L&, iter<false>>, int> = 0>
+            iter (const L& l) : n(iter<false>(l).n) {}
+
+            reference operator*() const { return *this->n->val; }
+            pointer operator->() const { return &*this->n->val; }
+
+            iter& operator++() { this->n += this->n->next; return *this; }
+            iter operator++ (int) { iter t = *this; ++(*this); return t; }
+            iter& operator--() { this->n += this->n->prev; return *this; }
+            iter operator-- (int) { iter t = *this; --(*this); return t; }
+
+            template <bool c>
+            bool operator== (const iter<c>& o) const { return this->n == o.n; }
+        };
+
+        std::vector<node> nodes;
+        std::size_t count = 0;
+        //! Set by reserve(). While set, the storage must not grow, as iterators may be held.
+        bool fixed = false;
+
+        node* sentinel() { return this->nodes.data(); }
+        const node* sentinel() const { return this->nodes.data(); }
+
+        //! Link node at index i in before the sentinel (i.e. at the back)
+        void link_back (int32_t i)
+        {
+            node* s = this->sentinel();
+            const int32_t tail = static_cast<int32_t>(s->prev); // offset of tail from sentinel (index 0)
+            this->nodes[i].prev = tail - i;
+            this->nodes[i].next = -i;
+            this->nodes[tail].next = i - tail;
+            s->prev = i;
+        }
+
+        //! Pass the storage base to the elements from index \a first on, if T wants it
+        void attach (std::size_t first)
+        {
+            if constexpr (requires (T& t, const void* p) { t.attach_arena (p); }) {
+                for (std::size_t i = first; i < this->nodes.size(); ++i) {
+                    if (this->nodes[i].val) { this->nodes[i].val->attach_arena (this->nodes.data()); }
+                }
+            }
+        }
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = iter<false>;
+        using const_iterator = iter<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        hexarena() { this->nodes.resize (1); }
+        hexarena (const hexarena& o) : nodes(o.nodes), count(o.count), fixed(o.fixed) { this->attach (1); }
+        hexarena (hexarena&& o) noexcept : nodes(std::move (o.nodes)), count(o.count), fixed(o.fixed) { o.clear(); }
+        hexarena& operator= (const hexarena& o)
+        {
+            this->nodes = o.nodes;
+            this->count = o.count;
+            this->fixed = o.fixed;
+            this->attach (1);
+            return *this;
+        }
+        hexarena& operator= (hexarena&& o) noexcept
+        {
+            std::swap (this->nodes, o.nodes);
+            std::swap (this->count, o.count);
+            std::swap (this->fixed, o.fixed);
+            return *this;
+        }
+
+        iterator begin() { return ++this->end(); }
+        iterator end() { return iterator (this->sentinel()); }
+        const_iterator begin() const { return ++this->end(); }
+        const_iterator end() const { return const_iterator (const_cast<node*>(this->sentinel())); }
+        const_iterator cbegin() const { return this->begin(); }
+        const_iterator cend() const { return this->end(); }
+        reverse_iterator rbegin() { return reverse_iterator (this->end()); }
+        reverse_iterator rend() { return reverse_iterator (this->begin()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator (this->end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator (this->begin()); }
+
+        size_type size() const { return this->count; }
+        bool empty() const { return this->count == 0; }
+        //! The number of elements, including erased ones, held in the storage
+        size_type capacity_used() const { return this->nodes.size() - 1; }
+
+        T& front() { return *this->begin(); }
+        const T& front() const { return *this->begin(); }
+        T& back() { return *(--this->end()); }
+        const T& back() const { return *(--this->end()); }
+
+        /*!
+         * Reserve storage for n more elements, in addition to those already stored (erased
+         * elements still occupy storage). From now until clear(), an insertion beyond the
+         * reserved storage throws rather than reallocating under iterators that may be held.
+         */
+        void reserve (size_type n)
+        {
+            this->nodes.reserve (this->nodes.size() + n);
+            this->fixed = true;
+        }
+
+        void clear()
+        {
+            this->nodes.clear();
+            this->nodes.resize (1);
+            this->count = 0;
+            this->fixed = false;
+        }
+
+        template <typename... Args>
+        T& emplace_back (Args&&... args)
+        {
+            if (this->fixed && this->nodes.size() == this->nodes.capacity()) {
+                throw std::runtime_error ("hexarena: insertion beyond the reserved storage would invalidate iterators");
+            }
+            const int32_t i = static_cast<int32_t>(this->nodes.size());
+            const node* base = this->nodes.data();
+            this->nodes.emplace_back();
+            this->nodes.back().val.emplace (std::forward<Args>(args)...);
+            this->link_back (i);
+            ++this->count;
+            this->attach (this->nodes.data() == base ? i : 1);
+            return *this->nodes[i].val;
+        }
+        void push_back (const T& v) { this->emplace_back (v); }
+        void push_back (T&& v) { this->emplace_back (std::move (v)); }
+
+        /*!
+         * The iterator to the element at index \a i of the storage whose base was passed to
+         * attach_arena. Index 0 is the sentinel, so a zero index gives end().
+         */
+        static iterator at (const void* storage, uint32_t i)
+        {
+            return iterator (static_cast<node*>(const_cast<void*>(storage)) + i);
+        }
+
+        //! The index of the element at \a it in the storage whose base was passed to attach_arena
+        static uint32_t index_of (const void* storage, const_iterator it)
+        {
+            return static_cast<uint32_t>(it.n - static_cast<const node*>(storage));
+        }
+
+        //! Unlink the element at \a it, returning an iterator to the following element
+        iterator erase (const_iterator it)
+        {
+            node* n = it.n;
+            node* p = n + n->prev;
+            node* nx = n + n->next;
+            p->next += n->next;
+            nx->prev += n->prev;
+            --this->count;
+            return iterator (nx);
+        }
+    };
+
+} // namespace morph
@@ -6,6 +6,7 @@
 #include <morph/vec.h>
 #include <morph/vvec.h>
 #include <morph/HexGrid.h>
+#include <morph/lattice_index.h>
 #include <utility>
 
 namespace morph {
@@ -22,17 +23,18 @@ namespace morph {
             this->proportions.resize(n, T{0});
 
             // For each coordinate, add it to a hex
+            morph::lattice_index hindex = hg->spatial_index();
             for (const morph::vec<T, 3>& datum : data) {
                 if (datum[2] < 0.0f) { continue; }
-                // if datum is in a hex hi, then counts[hi->vg] += T{1};
-                auto hi = hg->findHexNearest (datum.less_one_dim());
+                // if datum is in a hex hi, then counts[hi] += T{1};
+                unsigned int hi = hindex.nearest (datum.less_one_dim().as_float());
+                if (hi == morph::lattice_index::none) { continue; }
 
                 // dist from hi to datum:
-                morph::vec<T> hipos = { hi->x, hi->y, 0 };
+                morph::vec<T> hipos = { hg->d_x[hi], hg->d_y[hi], 0 };
                 T _d = (hipos - datum).length();
                 if (_d <= hg->getv()) {
-                    counts[hi->vi] += T{1};
-                    //std::cout << "crossing at " << datum << " has nearest hex: " << hi->outputXY() << " for which count = " << counts[hi->vi] << std::endl;
+                    counts[hi] += T{1};
                     this->datacount++;
                 }
             }
@@ -0,0 +1,316 @@
+/*!
+ * \file
+ *
+ * A spatial index for the elements of a HexGrid or CartGrid (or any set of points that lie on a
+ * regular 2D lattice). Obtain one with HexGrid::spatial_index() or CartGrid::spatial_index().
+ */
+#pragma once
+
+#include <morph/vec.h>
+#include <span>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+namespace morph {
+
+    /*!
+     * A lookup from Cartesian position to the d_ index of the nearest element of a grid whose
+     * element centres lie on a lattice. The lattice is defined by two basis vectors a and b so
+     * that each element is at origin + i * a + j * b for integers i and j. For a HexGrid, a =
+     * (d, 0) and b = (d/2, v); for a CartGrid, a = (d, 0) and b = (0, v).
+     *
+     * The index is a dense table over the (i, j) bounding box of the elements, holding the d_
+     * index of the element at each lattice site. Finding the site that contains a position is
+     * O(1). When the sites nearby are empty (e.g. for a position outside the grid's boundary)
+     * the search proceeds outwards, ring by ring, until the nearest element has been found.
+     *
+     * The index is built from the element positions, so it must be re-made if the grid changes.
+     */
+    struct lattice_index
+    {
+        //! The value returned for 'no element'
+        static constexpr unsigned int none = std::numeric_limits<unsigned int>::max();
+
+        lattice_index() {}
+
+        /*!
+         * Build the index for the elements whose centres are (x[k], y[k]) on the lattice with
+         * basis vectors \a _a and \a _b.
+         */
+        lattice_index (const std::vector<float>& x, const std::vector<float>& y,
+                       const morph::vec<float, 2>& _a, const morph::vec<float, 2>& _b)
+        {
+            this->init (x, y, _a, _b);
+        }
+
+        void init (const std::vector<float>& x, const std::vector<float>& y,
+                   const morph::vec<float, 2>& _a, const morph::vec<float, 2>& _b)
+        {
+            if (x.size() != y.size()) { throw std::runtime_error ("lattice_index: x and y differ in size"); }
+            this->a = _a;
+            this->b = _b;
+            float det = this->a[0] * this->b[1] - this->b[0] * this->a[1];
+            if (det == 0.0f) { throw std::runtime_error ("lattice_index: basis vectors are not independent"); }
+            this->inv = { this->b[1] / det, -this->b[0] / det, -this->a[1] / det, this->a[0] / det };
+            this->compute_norm_bound();
+
+            this->px = x;
+            this->py = y;
+            this->table.clear();
+            this->imin = 0; this->jmin = 0; this->ni = 0; this->nj = 0;
+            if (x.empty()) { return; }
+
+            // The lattice origin is the first element; all others are an integer number of
+            // basis vectors away.
+            this->origin = { x[0], y[0] };
+            std::vector<int> li (x.size());
+            std::vector<int> lj (x.size());
+            int imax = std::numeric_limits<int>::min();
+            int jmax = std::numeric_limits<int>::min();
+            this->imin = std::numeric_limits<int>::max();
+            this->jmin = std::numeric_limits<int>::max();
+            for (unsigned int k = 0; k < x.size(); ++k) {
+                morph::vec<float, 2> f = this->lattice_coords ({ x[k], y[k] });
+                li[k] = static_cast<int>(std::round (f[0]));
+                lj[k] = static_cast<int>(std::round (f[1]));
+                this->imin = std::min (this->imin, li[k]);
+                this->jmin = std::min (this->jmin, lj[k]);
+                imax = std::max (imax, li[k]);
+                jmax = std::max (jmax, lj[k]);
+            }
+            this->ni = imax - this->imin + 1;
+            this->nj = jmax - this->jmin + 1;
+            this->table.assign (static_cast<size_t>(this->ni) * this->nj, none);
+            for (unsigned int k = 0; k < x.size(); ++k) {
+                this->table[static_cast<size_t>(lj[k] - this->jmin) * this->ni + (li[k] - this->imin)] = k;
+            }
+            this->compute_empty_steps();
+        }
+
+        //! Return the d_ index of the element nearest to \a pos (or lattice_index::none if empty)
+        unsigned int nearest (const morph::vec<float, 2>& pos) const
+        {
+            if (this->px.empty()) { return none; }
+
+            morph::vec<float, 2> f = this->lattice_coords (pos);
+            const int imax = this->imin + this->ni - 1;
+            const int jmax = this->jmin + this->nj - 1;
+
+            // The nearest lattice site is a corner of the lattice cell that contains pos. If pos
+            // is outside the table, start from the nearest cell that overlaps the table.
+            int i0 = static_cast<int>(std::clamp (std::floor (f[0]), static_cast<float>(this->imin - 1), static_cast<float>(imax)));
+            int j0 = static_cast<int>(std::clamp (std::floor (f[1]), static_cast<float>(this->jmin - 1), static_cast<float>(jmax)));
+            unsigned int best = none;
+            float best_d = std::numeric_limits<float>::max();
+            for (int j = j0; j <= j0 + 1; ++j) {
+                for (int i = i0; i <= i0 + 1; ++i) { this->consider (i, j, pos, best, best_d); }
+            }
+
+            // The distances, in lattice steps, from pos to the table along each axis (zero if pos
+            // is within the table's range on that axis)
+            float gi = std::max (0.0f, std::max (this->imin - f[0], f[0] - imax));
+            float gj = std::max (0.0f, std::max (this->jmin - f[1], f[1] - jmax));
+            float gmin = std::min (gi, gj);
+            float gmax = std::max (gi, gj);
+            // Far outside the table, a ring search visits more sites than a linear scan would
+            if (gmax > 0.25f * std::max (this->ni, this->nj)) { return this->nearest_linear (pos); }
+
+            // Search outwards. A site not yet visited by ring k is more than k lattice steps from
+            // the start cell on some axis, and so at least (k + gap) steps from pos on that axis.
+            // Every site is at least norm_bound per lattice step away from pos.
+            // Rings that lie closer to the start cell than its nearest occupied site are empty.
+            int kmax = std::max (this->ni, this->nj) + 1;
+            int kstart = std::max (1, this->empty_steps[static_cast<size_t>(std::max (j0, this->jmin) - this->jmin) * this->ni
+                                                        + (std::max (i0, this->imin) - this->imin)] - 2);
+            for (int k = kstart; k <= kmax && this->norm_bound * std::max (k + gmin, gmax) < best_d; ++k) {
+                int ilo = i0 - k;
+                int ihi = i0 + 1 + k;
+                int jlo = j0 - k;
+                int jhi = j0 + 1 + k;
+                for (int i = std::max (ilo, this->imin); i <= std::min (ihi, imax); ++i) {
+                    this->consider (i, jlo, pos, best, best_d);
+                    this->consider (i, jhi, pos, best, best_d);
+                }
+                for (int j = std::max (jlo + 1, this->jmin); j <= std::min (jhi - 1, jmax); ++j) {
+                    this->consider (ilo, j, pos, best, best_d);
+                    this->consider (ihi, j, pos, best, best_d);
+                }
+            }
+            return best;
+        }
+
+        //! Find the nearest element for each of \a pos, writing the d_ indices into \a result
+        void nearest (std::span<const morph::vec<float, 2>> pos, std::span<unsigned int> result) const
+        {
+            if (result.size() < pos.size()) { throw std::runtime_error ("lattice_index::nearest: result is too small"); }
+            const int n = static_cast<int>(pos.size());
+#pragma omp parallel for
+            for (int k = 0; k < n; ++k) { result[k] = this->nearest (pos[k]); }
+        }
+
+        //! Find the nearest element for each of \a pos, returning the d_ indices
+        std::vector<unsigned int> nearest (std::span<const morph::vec<float, 2>> pos) const
+        {
+            std::vector<unsigned int> result (pos.size(), none);
+            this->nearest (pos, std::span<unsigned int>(result));
+            return result;
+        }
+
+        //! Append to \a result the d_ indices of all elements within \a radius of \a pos
+        void within_radius (const morph::vec<float, 2>& pos, const float radius, std::vector<unsigned int>& result) const
+        {
+            if (this->px.empty() || radius < 0.0f) { return; }
+            morph::vec<float, 2> f = this->lattice_coords (pos);
+            // Half-extents of the disc in lattice coordinates
+            float ri = radius * std::sqrt (this->inv[0] * this->inv[0] + this->inv[1] * this->inv[1]);
+            float rj = radius * std::sqrt (this->inv[2] * this->inv[2] + this->inv[3] * this->inv[3]);
+            if (f[0] + ri < this->imin || f[0] - ri > this->imin + this->ni
+                || f[1] + rj < this->jmin || f[1] - rj > this->jmin + this->nj) { return; }
+            int ilo = std::max (static_cast<int>(std::floor (f[0] - ri)), this->imin);
+            int ihi = std::min (static_cast<int>(std::ceil (f[0] + ri)), this->imin + this->ni - 1);
+            int jlo = std::max (static_cast<int>(std::floor (f[1] - rj)), this->jmin);
+            int jhi = std::min (static_cast<int>(std::ceil (f[1] + rj)), this->jmin + this->nj - 1);
+            const float r2 = radius * radius;
+            for (int j = jlo; j <= jhi; ++j) {
+                for (int i = ilo; i <= ihi; ++i) {
+                    unsigned int k = this->table[static_cast<size_t>(j - this->jmin) * this->ni + (i - this->imin)];
+                    if (k == none) { continue; }
+                    float dx = this->px[k] - pos[0];
+                    float dy = this->py[k] - pos[1];
+                    if (dx * dx + dy * dy <= r2) { result.push_back (k); }
+                }
+            }
+        }
+
+        //! Return the d_ indices of all elements within \a radius of \a pos
+        std::vector<unsigned int> within_radius (const morph::vec<float, 2>& pos, const float radius) const
+        {
+            std::vector<unsigned int> result;
+            this->within_radius (pos, radius, result);
+            return result;
+        }
+
+        //! The number of elements in the index
+        unsigned int size() const { return static_cast<unsigned int>(this->px.size()); }
+
+    private:
+        //! Convert a Cartesian position into (fractional) lattice coordinates
+        morph::vec<float, 2> lattice_coords (const morph::vec<float, 2>& pos) const
+        {
+            float dx = pos[0] - this->origin[0];
+            float dy = pos[1] - this->origin[1];
+            return { this->inv[0] * dx + this->inv[1] * dy, this->inv[2] * dx + this->inv[3] * dy };
+        }
+
+        //! If there's an element at site (i, j) that is closer to pos than best_d, make it the best
+        void consider (const int i, const int j, const morph::vec<float, 2>& pos, unsigned int& best, float& best_d) const
+        {
+            if (i < this->imin || j < this->jmin || i >= this->imin + this->ni || j >= this->jmin + this->nj) { return; }
+            unsigned int k = this->table[static_cast<size_t>(j - this->jmin) * this->ni + (i - this->imin)];
+            if (k == none) { return; }
+            float dx = this->px[k] - pos[0];
+            float dy = this->py[k] - pos[1];
+            float dl = std::sqrt (dx * dx + dy * dy);
+            if (dl < best_d || (dl == best_d && k < best)) {
+                best_d = dl;
+                best = k;
+            }
+        }
+
+        //! Linear scan for the nearest element. Used for positions far outside the table.
+        unsigned int nearest_linear (const morph::vec<float, 2>& pos) const
+        {
+            unsigned int best = none;
+            float best_d = std::numeric_limits<float>::max();
+            for (unsigned int k = 0; k < this->px.size(); ++k) {
+                float dx = this->px[k] - pos[0];
+                float dy = this->py[k] - pos[1];
+                float dl = std::sqrt (dx * dx + dy * dy);
+                if (dl < best_d) {
+                    best_d = dl;
+                    best = k;
+                }
+            }
+            return best;
+        }
+
+        /*!
+         * For each site in the table, find the number of lattice steps (in the Chebyshev sense,
+         * so that diagonal steps count as one) to the nearest occupied site, using a two pass
+         * distance transform.
+         */
+        void compute_empty_steps()
+        {
+            const int big = this->ni + this->nj;
+            this->empty_steps.assign (this->table.size(), big);
+            auto at = [this](int i, int j) -> int& { return this->empty_steps[static_cast<size_t>(j) * this->ni + i]; };
+            for (size_t k = 0; k < this->table.size(); ++k) { if (this->table[k] != none) { this->empty_steps[k] = 0; } }
+            for (int j = 0; j < this->nj; ++j) {
+                for (int i = 0; i < this->ni; ++i) {
+                    int& e = at (i, j);
+                    if (i > 0) { e = std::min (e, at (i - 1, j) + 1); }
+                    if (j > 0) {
+                        e = std::min (e, at (i, j - 1) + 1);
+                        if (i > 0) { e = std::min (e, at (i - 1, j - 1) + 1); }
+                        if (i < this->ni - 1) { e = std::min (e, at (i + 1, j - 1) + 1); }
+                    }
+                }
+            }
+            for (int j = this->nj - 1; j >= 0; --j) {
+                for (int i = this->ni - 1; i >= 0; --i) {
+                    int& e = at (i, j);
+                    if (i < this->ni - 1) { e = std::min (e, at (i + 1, j) + 1); }
+                    if (j < this->nj - 1) {
+                        e = std::min (e, at (i, j + 1) + 1);
+                        if (i < this->ni - 1) { e = std::min (e, at (i + 1, j + 1) + 1); }
+                        if (i > 0) { e = std::min (e, at (i - 1, j + 1) + 1); }
+                    }
+                }
+            }
+        }
+
+        /*!
+         * Find the smallest Cartesian length of s * a + t * b with max(|s|,|t|) = 1. Any
+         * lattice site that is k or more lattice steps from a position is then at least k *
+         * norm_bound away from it.
+         */
+        void compute_norm_bound()
+        {
+            auto edge_min = [](const morph::vec<float, 2>& u, const morph::vec<float, 2>& w)
+            {
+                // min over t in [-1, 1] of |u + t w|
+                float ww = w[0] * w[0] + w[1] * w[1];
+                float t = ww > 0.0f ? std::clamp (-(u[0] * w[0] + u[1] * w[1]) / ww, -1.0f, 1.0f) : 0.0f;
+                morph::vec<float, 2> p = { u[0] + t * w[0], u[1] + t * w[1] };
+                return std::sqrt (p[0] * p[0] + p[1] * p[1]);
+            };
+            // By symmetry, only the edges s = 1 and t = 1 need checking. Slightly reduce the
+            // bound to guard against rounding.
+            this->norm_bound = 0.999f * std::min (edge_min (this->a, this->b), edge_min (this->b, this->a));
+        }
+
+        //! Lattice basis vectors and the inverse of the matrix [a b] (row-major)
+        morph::vec<float, 2> a = { 1.0f, 0.0f };
+        morph::vec<float, 2> b = { 0.0f, 1.0f };
+        morph::vec<float, 4> inv = { 1.0f, 0.0f, 0.0f, 1.0f };
+        float norm_bound = 1.0f;
+        //! Cartesian position of lattice site (0, 0)
+        morph::vec<float, 2> origin = { 0.0f, 0.0f };
+        //! Extent of the table in lattice coordinates
+        int imin = 0;
+        int jmin = 0;
+        int ni = 0;
+        int nj = 0;
+        //! The d_ index of the element at each lattice site, or none
+        std::vector<unsigned int> table;
+        //! For each lattice site, the number of lattice steps to the nearest occupied site
+        std::vector<int> empty_steps;
+        //! Copies of the element positions
+        std::vector<float> px;
+        std::vector<float> py;
+    };
+
+} // namespace morph
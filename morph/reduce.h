@@ -0,0 +1,260 @@
+/*!
+ * \file
+ *
+ * Blocked reductions (sums, dot products, mean and variance, extrema) over contiguous arrays
+ * of arithmetic values. These are used by morph::vvec's statistics functions.
+ *
+ * The array is cut into blocks of reduce::block_size elements. Within a block, the reduction
+ * runs across reduce::lanes independent accumulators so that the compiler can vectorise it,
+ * and the block results are then combined pairwise in a fixed order. Above
+ * reduce::parallel_threshold elements, the blocks are shared between OpenMP threads. Because
+ * the blocks and the order in which they are combined don't depend on the number of threads,
+ * the result is the same, to the last bit, for any number of threads. The pairwise
+ * combination is also more accurate than a single running sum.
+ *
+ * The sums and moments take a skip_nans template flag (vvec passes its test_for_nans flag). If
+ * it is true, NaN elements are left out of the reduction. The extrema always leave out NaNs, but
+ * report whether there were any.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+namespace morph::reduce {
+
+    //! The number of elements in each block. One thread reduces each block.
+    constexpr std::size_t block_size = 4096;
+    //! Reductions over fewer elements than this run on the calling thread only
+    constexpr std::size_t parallel_threshold = std::size_t{1} << 18;
+    //! The number of independent accumulators used within a block
+    constexpr std::size_t lanes = 8;
+
+    //! Is x a NaN? Always false for integer types.
+    template <typename T>
+    constexpr bool is_nan (const T& x) noexcept
+    {
+        if constexpr (std::is_floating_point_v<T>) { return std::isnan (x); } else { return false; }
+    }
+
+    /*!
+     * Reduce the n elements in blocks. block_fn(i0, i1) reduces the elements [i0, i1) to a
+     * result of type R and combine(a, b) combines the results of two neighbouring ranges.
+     * block_fn(0, 0) must return the result for an empty range.
+     */
+    template <typename R, typename F, typename C>
+    R blocked (const std::size_t n, F block_fn, C combine)
+    {
+        const std::size_t nb = (n + block_size - 1) / block_size;
+        if (nb <= 1) { return block_fn (std::size_t{0}, n); }
+        std::vector<R> part (nb);
+#pragma omp parallel for schedule(static) if (n >= parallel_threshold)
+        for (std::size_t b = 0; b < nb; ++b) {
+            part[b] = block_fn (b * block_size, std::min (n, (b + 1) * block_size));
+        }
+        // Combine neighbouring results pairwise, always in the same order
+        for (std::size_t w = 1; w < nb; w *= 2) {
+            for (std::size_t i = 0; i + w < nb; i += 2 * w) { part[i] = combine (part[i], part[i + w]); }
+        }
+        return part[0];
+    }
+
+    //! Sum f(i) for i in [i0, i1) across reduce::lanes accumulators, then sum the accumulators pairwise
+    template <typename Sy, typename F>
+    Sy lane_sum (const std::size_t i0, const std::size_t i1, F f)
+    {
+        Sy acc[lanes];
+        for (std::size_t j = 0; j < lanes; ++j) { acc[j] = Sy{0}; }
+        std::size_t i = i0;
+        for (; i + lanes <= i1; i += lanes) {
+            for (std::size_t j = 0; j < lanes; ++j) { acc[j] += f (i + j); }
+        }
+        for (std::size_t j = 0; i < i1; ++i, ++j) { acc[j] += f (i); }
+        for (std::size_t w = lanes / 2; w > 0; w /= 2) {
+            for (std::size_t j = 0; j < w; ++j) { acc[j] += acc[j + w]; }
+        }
+        return acc[0];
+    }
+
+    //! The sum of the n elements of p, accumulated in type Sy
+    template <bool skip_nans = false, typename Sy, typename S>
+    Sy sum (const S* p, const std::size_t n)
+    {
+        auto block_fn = [p](std::size_t i0, std::size_t i1) {
+            return lane_sum<Sy> (i0, i1, [p](std::size_t i) {
+                if constexpr (skip_nans) { return is_nan (p[i]) ? Sy{0} : static_cast<Sy>(p[i]); }
+                else { return static_cast<Sy>(p[i]); }
+            });
+        };
+        return blocked<Sy> (n, block_fn, [](Sy a, Sy b) { return a + b; });
+    }
+
+    //! The sum of the squares of the n elements of p, accumulated in type Sy
+    template <bool skip_nans = false, typename Sy, typename S>
+    Sy sos (const S* p, const std::size_t n)
+    {
+        auto block_fn = [p](std::size_t i0, std::size_t i1) {
+            return lane_sum<Sy> (i0, i1, [p](std::size_t i) {
+                const Sy x = static_cast<Sy>(p[i]);
+                if constexpr (skip_nans) { return is_nan (p[i]) ? Sy{0} : x * x; }
+                else { return x * x; }
+            });
+        };
+        return blocked<Sy> (n, block_fn, [](Sy a, Sy b) { return a + b; });
+    }
+
+    //! The scalar product of the n elements of p and q, accumulated in type Sy
+    template <typename Sy, typename S, typename S2>
+    Sy dot (const S* p, const S2* q, const std::size_t n)
+    {
+        auto block_fn = [p, q](std::size_t i0, std::size_t i1) {
+            return lane_sum<Sy> (i0, i1, [p, q](std::size_t i) { return static_cast<Sy>(p[i]) * static_cast<Sy>(q[i]); });
+        };
+        return blocked<Sy> (n, block_fn, [](Sy a, Sy b) { return a + b; });
+    }
+
+    //! The number of elements that are not NaN
+    template <typename S>
+    std::size_t count_numbers (const S* p, const std::size_t n)
+    {
+        if constexpr (!std::is_floating_point_v<S>) { return n; }
+        auto block_fn = [p](std::size_t i0, std::size_t i1) {
+            return lane_sum<std::size_t> (i0, i1, [p](std::size_t i) { return is_nan (p[i]) ? std::size_t{0} : std::size_t{1}; });
+        };
+        return blocked<std::size_t> (n, block_fn, [](std::size_t a, std::size_t b) { return a + b; });
+    }
+
+    //! The number of elements, their mean and the sum of their squared deviations from the mean
+    template <typename Sy>
+    struct moments
+    {
+        std::size_t n = 0;
+        Sy mean = Sy{0};
+        Sy m2 = Sy{0};
+    };
+
+    /*!
+     * The moments of the n elements of p, computed in one pass through memory. Each block (which
+     * is small enough to stay in cache) finds its own mean and then its squared deviations from
+     * that mean. The blocks are combined with the parallel update of Chan, Golub and LeVeque.
+     * The first number in p is subtracted from every element first, so that data with a large
+     * offset doesn't lose precision in the block means.
+     */
+    template <bool skip_nans = false, typename Sy, typename S>
+    moments<Sy> compute_moments (const S* p, const std::size_t n)
+    {
+        std::size_t i_shift = 0;
+        if constexpr (skip_nans) { while (i_shift < n && is_nan (p[i_shift])) { ++i_shift; } }
+        const Sy shift = i_shift < n ? static_cast<Sy>(p[i_shift]) : Sy{0};
+
+        auto block_fn = [p, shift](std::size_t i0, std::size_t i1) {
+            moments<Sy> m;
+            m.n = skip_nans ? count_numbers (p + i0, i1 - i0) : i1 - i0;
+            if (m.n == 0) { return m; }
+            m.mean = lane_sum<Sy> (i0, i1, [p, shift](std::size_t i) {
+                return (skip_nans && is_nan (p[i])) ? Sy{0} : static_cast<Sy>(p[i]) - shift;
+            }) / static_cast<Sy>(m.n);
+            const Sy mean = m.mean + shift;
+            m.m2 = lane_sum<Sy> (i0, i1, [p, mean](std::size_t i) {
+                const Sy d = static_cast<Sy>(p[i]) - mean;
+                return (skip_nans && is_nan (p[i])) ? Sy{0} : d * d;
+            });
+            return m;
+        };
+        auto combine = [](const moments<Sy>& a, const moments<Sy>& b) {
+            if (a.n == 0) { return b; }
+            if (b.n == 0) { return a; }
+            moments<Sy> m;
+            m.n = a.n + b.n;
+            const Sy na = static_cast<Sy>(a.n);
+            const Sy nb = static_cast<Sy>(b.n);
+            const Sy d = b.mean - a.mean;
+            m.mean = a.mean + d * nb / static_cast<Sy>(m.n);
+            m.m2 = a.m2 + b.m2 + d * d * na * nb / static_cast<Sy>(m.n);
+            return m;
+        };
+        moments<Sy> m = blocked<moments<Sy>> (n, block_fn, combine);
+        m.mean += shift;
+        return m;
+    }
+
+    //! The minimum and maximum elements and the indices of their first occurrences
+    template <typename S>
+    struct extremes
+    {
+        S min = S{0};
+        S max = S{0};
+        std::size_t argmin = 0;
+        std::size_t argmax = 0;
+        //! False if there were no elements (or only NaNs)
+        bool found = false;
+        //! True if any element was NaN
+        bool has_nan = false;
+    };
+
+    /*!
+     * The minimum and maximum of the n elements of p and their indices. In each block, the
+     * minimum and maximum values are found across lanes, then their first indices are found.
+     * NaNs are never chosen as a minimum or maximum, but set has_nan in the result.
+     */
+    template <typename S>
+    extremes<S> compute_extremes (const S* p, const std::size_t n)
+    {
+        constexpr S hi = std::numeric_limits<S>::has_infinity ? std::numeric_limits<S>::infinity() : std::numeric_limits<S>::max();
+        constexpr S lo = std::numeric_limits<S>::has_infinity ? -std::numeric_limits<S>::infinity() : std::numeric_limits<S>::lowest();
+        auto block_fn = [p](std::size_t i0, std::size_t i1) {
+            extremes<S> e;
+            S mn[lanes];
+            S mx[lanes];
+            // Counts of NaNs (x != x only for a NaN)
+            unsigned int nn[lanes];
+            for (std::size_t j = 0; j < lanes; ++j) { mn[j] = hi; mx[j] = lo; nn[j] = 0u; }
+            std::size_t i = i0;
+            // Comparisons with NaN are false, so these skip NaNs
+            for (; i + lanes <= i1; i += lanes) {
+                for (std::size_t j = 0; j < lanes; ++j) {
+                    const S x = p[i + j];
+                    mn[j] = x < mn[j] ? x : mn[j];
+                    mx[j] = x > mx[j] ? x : mx[j];
+                    if constexpr (std::is_floating_point_v<S>) { nn[j] += x != x ? 1u : 0u; }
+                }
+            }
+            for (std::size_t j = 0; i < i1; ++i, ++j) {
+                mn[j] = p[i] < mn[j] ? p[i] : mn[j];
+                mx[j] = p[i] > mx[j] ? p[i] : mx[j];
+                if constexpr (std::is_floating_point_v<S>) { nn[j] += p[i] != p[i] ? 1u : 0u; }
+            }
+            e.min = *std::min_element (mn, mn + lanes);
+            e.max = *std::max_element (mx, mx + lanes);
+            for (std::size_t j = 0; j < lanes; ++j) { e.has_nan = e.has_nan || nn[j] > 0u; }
+            // Locate the first occurrences. A block of NaNs has neither.
+            const S* pmin = std::find (p + i0, p + i1, e.min);
+            if (pmin == p + i1) {
+                extremes<S> none;
+                none.has_nan = e.has_nan;
+                return none;
+            }
+            e.argmin = static_cast<std::size_t>(pmin - p);
+            e.argmax = static_cast<std::size_t>(std::find (p + i0, p + i1, e.max) - p);
+            e.found = true;
+            return e;
+        };
+        auto combine = [](const extremes<S>& a, const extremes<S>& b) {
+            const bool has_nan = a.has_nan || b.has_nan;
+            extremes<S> e = a;
+            if (!a.found) { e = b; }
+            e.has_nan = has_nan;
+            if (!a.found || !b.found) { return e; }
+            // a comes before b, so on a tie keep a's index
+            if (b.min < a.min) { e.min = b.min; e.argmin = b.argmin; }
+            if (b.max > a.max) { e.max = b.max; e.argmax = b.argmax; }
+            return e;
+        };
+        return blocked<extremes<S>> (n, block_fn, combine);
+    }
+
+} // namespace morph::reduce
@@ -0,0 +1,75 @@
+/*!
+ * \file
+ *
+ * Helpers for Gaussian resampling of raster images onto grids (see Grid::resample_image and
+ * HexGrid::resampleImage). Because the 2D Gaussian is separable, the weight that an image
+ * pixel contributes to a target location is the product of an x weight and a y weight, and
+ * only a small window of pixels around the target needs to be visited.
+ */
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+namespace morph::resample {
+
+    /*!
+     * The maximum number of pixels along one axis that can contribute to a target location.
+     *
+     * The resamplers choose sigma to be the pixel spacing and accept a pixel if (target -
+     * pixel) < 3 sigma. That test is one-sided, so pixels on the far side of the target are
+     * accepted too; these are truncated at 6 sigma, where the weight has fallen to exp(-18)
+     * (about 1.5e-8). The window is thus 9 sigma wide, which is at most 10 pixels.
+     */
+    constexpr unsigned int taps = 10;
+
+    //! The first pixel and number of pixels in a window along one image axis
+    struct window
+    {
+        unsigned int first = 0;
+        unsigned int n = 0;
+    };
+
+    /*!
+     * Compute the Gaussian weights along one image axis for the target coordinate \a t.
+     *
+     * The coordinate of pixel i is (dpp * i - centering) + offset, computed exactly as in the
+     * brute force resampling loops so that the pixels accepted by the 3 sigma test are the
+     * same. Weights are written into \a w, which must have capacity for resample::taps
+     * elements.
+     *
+     * \param t The coordinate of the target location
+     * \param dpp Distance per pixel along this axis (also the Gaussian sigma)
+     * \param centering An offset subtracted from the pixel coordinate
+     * \param offset An offset added to the pixel coordinate
+     * \param npix The number of pixels in the image along this axis
+     * \param threesig 3 times sigma
+     * \param param The Gaussian parameter 1/(2 sigma^2)
+     * \param w Output weights
+     *
+     * \return The window of pixels whose weights were written into \a w
+     */
+    inline window axis_weights (const float t, const float dpp, const float centering, const float offset,
+                                const unsigned int npix, const float threesig, const float param, float* w)
+    {
+        window win;
+        if (npix == 0u) { return win; }
+        auto coord = [dpp, centering, offset](unsigned int i) { return (dpp * i - centering) + offset; };
+
+        // Estimate the first accepted pixel, then step onto it with the exact test
+        float est = std::floor ((t - threesig - (offset - centering)) / dpp) - 1.0f;
+        unsigned int i0 = est > 0.0f ? static_cast<unsigned int>(std::min (est, static_cast<float>(npix))) : 0u;
+        while (i0 < npix && !(t - coord (i0) < threesig)) { ++i0; }
+
+        const float sixsig = 2.0f * threesig;
+        win.first = i0;
+        for (unsigned int k = 0; k < taps && i0 + k < npix; ++k) {
+            float _d = t - coord (i0 + k);
+            if (_d < -sixsig) { break; }
+            w[k] = std::exp (-param * _d * _d);
+            ++win.n;
+        }
+        return win;
+    }
+
+} // namespace morph::resample
@@ -5,6 +5,9 @@
 // (each creates a single instance of RandUniform<> in memory) and provide good quality
 // pseudo random numbers based on the mt19937 algorithm.
 //
+// Each thread has its own instance, so randSingle() and randDouble() may be called from
+// OpenMP loops. The numbers are not reproducible; for that, use morph::RandPhilox.
+//
 // Note how you can use defines to determine which of these classes to actually make use
 // of. See also rngs.h and rngd.h for including only randSingle or randDouble.
 //
@@ -22,18 +25,17 @@ namespace morph {
     private:
         srng() {};
         ~srng() {};
-        static srng* pInstance_srng;
     public:
+        // The calling thread's instance
         static srng* i()
         {
-            if (srng::pInstance_srng == 0) { srng::pInstance_srng = new srng; }
-            return srng::pInstance_srng;
+            thread_local srng instance;
+            return &instance;
         }
         float get() { return this->rng.get(); }
         morph::RandUniform<float> rng;
     };
-    srng* srng::pInstance_srng = 0;
-    static float randSingle() { return morph::srng::i()->get(); }
+    inline float randSingle() { return morph::srng::i()->get(); }
 }
 #endif
 
@@ -46,19 +48,16 @@ namespace morph {
     private:
         drng() {};
         ~drng() {};
-        static drng* pInstance_drng;
     public:
-        // The instance public function.
+        // The instance public function. Returns the calling thread's instance.
         static drng* i()
         {
-            if (drng::pInstance_drng == 0) { drng::pInstance_drng = new drng; }
-            return drng::pInstance_drng;
+            thread_local drng instance;
+            return &instance;
         }
         double get() { return this->rng.get(); }
         morph::RandUniform<double> rng;
     };
-    // Globally initialise drng instance pointer to NULL.
-    drng* drng::pInstance_drng = 0;
-    static double randDouble() { return morph::drng::i()->get(); }
+    inline double randDouble() { return morph::drng::i()->get(); }
 }
 #endif
@@ -41,6 +41,7 @@
 #include <stdexcept>
 #include <cmath>
 #include <cstddef>
+#include <span>
 #include <string>
 #include <sstream>
 #include <morph/MathAlgo.h>
@@ -517,6 +518,46 @@ namespace morph {
         //! The output range required. Change if you want to scale to something other than [0, 1]
         morph::range<S> output_range = morph::range<S>(S{0}, S{1});
 
+        // Keep the container transform() from the base class visible alongside the span overload
+        using scale_impl_base<T, S>::transform;
+
+        /*!
+         * \brief Transform a span of scalars.
+         *
+         * This is the fast path for large arrays of data. The params are checked and the scaling
+         * function is chosen just once, then a simple loop (which the compiler can vectorise)
+         * transforms the data. Autoscales from data if do_autoscale is set and the params are not
+         * yet ready.
+         *
+         * \param data The input data
+         * \param output The scaled output. Must be the same size as data.
+         */
+        void transform (std::span<const T> data, std::span<S> output)
+        {
+            if (output.size() != data.size()) {
+                throw std::runtime_error ("scale_impl<1=scalar>::transform(): Ensure data.size()==output.size()");
+            }
+            if (this->do_autoscale == true && !this->ready()) {
+                morph::range<T> mm (morph::range_init::for_search);
+                for (const T& d : data) { mm.update (d); }
+                this->compute_scaling (mm.min, mm.max);
+            } else if (this->do_autoscale == false && !this->ready()) {
+                throw std::runtime_error ("scale_impl<1=scalar>::transform(): Params are not set and do_autoscale is set false. Can't transform.");
+            }
+            const std::size_t n = data.size();
+            const T* in = data.data();
+            S* out = output.data();
+            const S m = this->params[0];
+            const S c = this->params[1];
+            if (this->type == scaling_function::Linear) {
+                for (std::size_t i = 0; i < n; ++i) { out[i] = in[i] * m + c; }
+            } else if (this->type == scaling_function::Logarithmic) {
+                for (std::size_t i = 0; i < n; ++i) { out[i] = std::log (in[i]) * m + c; }
+            } else {
+                throw std::runtime_error ("scale_impl<1=scalar>::transform(): Unknown scaling");
+            }
+        }
+
         S transform_one (const T& datum) const
         {
             S rtn = S{0};
@@ -0,0 +1,307 @@
+/*!
+ * \file
+ *
+ * Sorting, ranking and order statistics for std::vector and morph::vvec: stable argsort, top_k,
+ * median and quantiles (which use std::nth_element, so they don't sort the whole array) and a
+ * multithreaded least-significant-digit radix sort for integer and floating point values.
+ *
+ * argsort and sort use the radix sort for large arrays of arithmetic values and std::stable_sort
+ * otherwise. The radix sort is stable and makes one pass per byte of the key. On each pass, the
+ * array is cut into chunks that are counted and scattered by OpenMP threads. The output of a
+ * stable sort is unique, so it does not depend on the number of threads.
+ *
+ * NaNs have no place in an ordering; remove them first (see vvec::prune_nan).
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <bit>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <morph/vvec.h>
+
+namespace morph::sorting {
+
+    enum class order { ascending, descending };
+
+    //! Arrays with at least this many elements are radix sorted (if they hold arithmetic values)
+    constexpr std::size_t radix_threshold = 1024;
+    //! The radix sort counts and scatters chunks of this many elements in parallel
+    constexpr std::size_t radix_chunk = std::size_t{1} << 16;
+    //! The greatest number of chunks per radix sort pass
+    constexpr std::size_t radix_max_chunks = 64;
+
+    //! True for the types that radix_sort can sort
+    template <typename T>
+    constexpr bool radix_sortable = (std::is_integral_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>)
+                                    && !std::is_same_v<T, bool> && sizeof(T) <= 8;
+
+    //! The unsigned integer radix sort key for a value of type T
+    template <typename T>
+    using radix_key = std::conditional_t<sizeof(T) == 1, std::uint8_t,
+                                         std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                                                            std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+    /*!
+     * Map x to an unsigned key that sorts in the same order as x. If merge_zeros is true, -0.0
+     * and +0.0 get the same key (so that they stay in their original order in a stable sort).
+     */
+    template <bool merge_zeros = false, typename T>
+    constexpr radix_key<T> to_key (const T x) noexcept
+    {
+        using K = radix_key<T>;
+        constexpr K msb = K{1} << (8 * sizeof(K) - 1);
+        if constexpr (std::is_floating_point_v<T>) {
+            const K b = merge_zeros ? std::bit_cast<K>(static_cast<T>(x + T{0})) : std::bit_cast<K>(x);
+            // Negative numbers: flip all bits. Positive numbers: flip the sign bit.
+            return (b & msb) ? static_cast<K>(~b) : static_cast<K>(b | msb);
+        } else if constexpr (std::is_signed_v<T>) {
+            return static_cast<K>(static_cast<K>(x) ^ msb);
+        } else {
+            return static_cast<K>(x);
+        }
+    }
+
+    //! The inverse of to_key<false>
+    template <typename T>
+    constexpr T from_key (const radix_key<T> k) noexcept
+    {
+        using K = radix_key<T>;
+        constexpr K msb = K{1} << (8 * sizeof(K) - 1);
+        if constexpr (std::is_floating_point_v<T>) {
+            return std::bit_cast<T>((k & msb) ? static_cast<K>(k & ~msb) : static_cast<K>(~k));
+        } else if constexpr (std::is_signed_v<T>) {
+            return static_cast<T>(static_cast<K>(k ^ msb));
+        } else {
+            return static_cast<T>(k);
+        }
+    }
+
+    /*!
+     * Stable LSD radix sort of the n unsigned keys, byte by byte. If P is not void, the n
+     * elements of payload are moved with their keys.
+     */
+    template <typename K, typename P = void>
+    void radix_sort_keys (K* keys, [[maybe_unused]] P* payload, const std::size_t n)
+    {
+        constexpr bool has_payload = !std::is_void_v<P>;
+        using Pb = std::conditional_t<has_payload, P, char>;
+        if (n < 2) { return; }
+        const std::size_t n_chunks = std::clamp (n / radix_chunk, std::size_t{1}, radix_max_chunks);
+        auto chunk_start = [n, n_chunks](std::size_t c) { return c * n / n_chunks; };
+
+        std::vector<K> kbuf (n);
+        std::vector<Pb> pbuf (has_payload ? n : 0);
+        K* src = keys;
+        K* dst = kbuf.data();
+        Pb* psrc = nullptr;
+        Pb* pdst = pbuf.data();
+        if constexpr (has_payload) { psrc = payload; }
+
+        std::vector<std::size_t> counts (n_chunks * 256);
+        for (unsigned int d = 0; d < sizeof(K); ++d) {
+            const unsigned int shift = 8 * d;
+            std::fill (counts.begin(), counts.end(), std::size_t{0});
+#pragma omp parallel for schedule(static) if (n_chunks > 1)
+            for (std::size_t c = 0; c < n_chunks; ++c) {
+                std::size_t* cnt = counts.data() + 256 * c;
+                const std::size_t i1 = chunk_start (c + 1);
+                for (std::size_t i = chunk_start (c); i < i1; ++i) { ++cnt[(src[i] >> shift) & 0xff]; }
+            }
+            // If every key has the same digit, this pass would not change the order
+            bool trivial = false;
+            for (std::size_t dg = 0; dg < 256 && !trivial; ++dg) {
+                std::size_t total = 0;
+                for (std::size_t c = 0; c < n_chunks; ++c) { total += counts[256 * c + dg]; }
+                trivial = (total == n);
+            }
+            if (trivial) { continue; }
+            // Where each chunk writes each digit: digits in order, and chunks in order within a digit
+            std::size_t offset = 0;
+            for (std::size_t dg = 0; dg < 256; ++dg) {
+                for (std::size_t c = 0; c < n_chunks; ++c) {
+                    const std::size_t cnt = counts[256 * c + dg];
+                    counts[256 * c + dg] = offset;
+                    offset += cnt;
+                }
+            }
+#pragma omp parallel for schedule(static) if (n_chunks > 1)
+            for (std::size_t c = 0; c < n_chunks; ++c) {
+                std::size_t* off = counts.data() + 256 * c;
+                const std::size_t i1 = chunk_start (c + 1);
+                for (std::size_t i = chunk_start (c); i < i1; ++i) {
+                    const std::size_t o = off[(src[i] >> shift) & 0xff]++;
+                    dst[o] = src[i];
+                    if constexpr (has_payload) { pdst[o] = psrc[i]; }
+                }
+            }
+            std::swap (src, dst);
+            std::swap (psrc, pdst);
+        }
+        if (src != keys) {
+            std::copy (src, src + n, keys);
+            if constexpr (has_payload) { std::copy (psrc, psrc + n, payload); }
+        }
+    }
+
+    //! Sort the arithmetic values in v into ascending order with a radix sort
+    template <typename T, typename Al> requires radix_sortable<T>
+    void radix_sort (std::vector<T, Al>& v)
+    {
+        using K = radix_key<T>;
+        const std::size_t n = v.size();
+        if constexpr (std::is_same_v<T, K>) {
+            radix_sort_keys (v.data(), static_cast<void*>(nullptr), n);
+        } else {
+            std::vector<K> keys (n);
+            for (std::size_t i = 0; i < n; ++i) { keys[i] = to_key (v[i]); }
+            radix_sort_keys (keys.data(), static_cast<void*>(nullptr), n);
+            for (std::size_t i = 0; i < n; ++i) { v[i] = from_key<T> (keys[i]); }
+        }
+    }
+
+    //! Sort v (stably) in the given order, using a radix sort when that is possible
+    template <typename T, typename Al>
+    void sort (std::vector<T, Al>& v, const order o = order::ascending)
+    {
+        if constexpr (radix_sortable<T>) {
+            if (v.size() >= radix_threshold) {
+                radix_sort (v);
+                if (o == order::descending) { std::reverse (v.begin(), v.end()); }
+                return;
+            }
+        }
+        if (o == order::ascending) {
+            std::stable_sort (v.begin(), v.end(), [](const T& a, const T& b) { return b > a; });
+        } else {
+            std::stable_sort (v.begin(), v.end(), [](const T& a, const T& b) { return b < a; });
+        }
+    }
+
+    /*!
+     * The indices that would sort v into the given order. The sort is stable: equal elements
+     * keep the order in which they appear in v, whichever the order.
+     */
+    template <typename T, typename Al>
+    morph::vvec<std::size_t> argsort (const std::vector<T, Al>& v, const order o = order::ascending)
+    {
+        const std::size_t n = v.size();
+        morph::vvec<std::size_t> idx (n);
+        std::iota (idx.begin(), idx.end(), std::size_t{0});
+        if constexpr (radix_sortable<T>) {
+            if (n >= radix_threshold) {
+                using K = radix_key<T>;
+                std::vector<K> keys (n);
+                // Inverting the keys gives a descending order that is still stable
+                const K flip = o == order::descending ? static_cast<K>(~K{0}) : K{0};
+                for (std::size_t i = 0; i < n; ++i) { keys[i] = static_cast<K>(to_key<true> (v[i]) ^ flip); }
+                radix_sort_keys (keys.data(), idx.data(), n);
+                return idx;
+            }
+        }
+        if (o == order::ascending) {
+            std::stable_sort (idx.begin(), idx.end(), [&v](std::size_t a, std::size_t b) { return v[b] > v[a]; });
+        } else {
+            std::stable_sort (idx.begin(), idx.end(), [&v](std::size_t a, std::size_t b) { return v[b] < v[a]; });
+        }
+        return idx;
+    }
+
+    /*!
+     * The indices of the k largest (for order::descending) or smallest (order::ascending)
+     * elements of v, best first. Of equal elements, the one that comes first in v ranks
+     * higher. This costs O(n log k) (or O(n + k log k) for large k) rather than the O(n log n)
+     * of a full argsort.
+     */
+    template <typename T, typename Al>
+    morph::vvec<std::size_t> top_k (const std::vector<T, Al>& v, std::size_t k, const order o = order::descending)
+    {
+        const std::size_t n = v.size();
+        k = std::min (k, n);
+        auto ranks_before = [&v, o](std::size_t a, std::size_t b) {
+            if (v[a] == v[b]) { return a < b; }
+            return o == order::descending ? v[b] < v[a] : v[a] < v[b];
+        };
+        morph::vvec<std::size_t> idx;
+        if (k == 0) { return idx; }
+        if (k * 16 < n) {
+            // Keep the best k so far in a heap whose top is the worst of them. Most elements
+            // are rejected with a single comparison against the top.
+            idx.resize (k);
+            std::iota (idx.begin(), idx.end(), std::size_t{0});
+            std::make_heap (idx.begin(), idx.end(), ranks_before);
+            for (std::size_t i = k; i < n; ++i) {
+                if (ranks_before (i, idx.front())) {
+                    std::pop_heap (idx.begin(), idx.end(), ranks_before);
+                    idx.back() = i;
+                    std::push_heap (idx.begin(), idx.end(), ranks_before);
+                }
+            }
+        } else {
+            idx.resize (n);
+            std::iota (idx.begin(), idx.end(), std::size_t{0});
+            if (k < n) { std::nth_element (idx.begin(), idx.begin() + k, idx.end(), ranks_before); }
+            idx.resize (k);
+        }
+        std::sort (idx.begin(), idx.end(), ranks_before);
+        return idx;
+    }
+
+    //! The floating point type in which quantiles of T are returned
+    template <typename T>
+    using quantile_t = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+    /*!
+     * The quantiles qs (each in [0, 1]) of v, interpolating linearly between the closest
+     * elements (as numpy.quantile does by default). v is copied once, then partitioned with
+     * std::nth_element for each quantile in turn.
+     */
+    template <typename T, typename Al, typename F = quantile_t<T>>
+    morph::vvec<F> quantiles (const std::vector<T, Al>& v, const std::vector<F>& qs)
+    {
+        if (v.empty()) { throw std::runtime_error ("morph::sorting::quantiles: no data"); }
+        for (auto q : qs) {
+            if (!(q >= F{0} && q <= F{1})) { throw std::runtime_error ("morph::sorting::quantiles: quantiles must be in [0, 1]"); }
+        }
+        std::vector<T> w (v.begin(), v.end());
+        const std::size_t n = w.size();
+        // Deal with the quantiles in ascending order; each partition then narrows the next
+        std::vector<std::size_t> qorder (qs.size());
+        std::iota (qorder.begin(), qorder.end(), std::size_t{0});
+        std::sort (qorder.begin(), qorder.end(), [&qs](std::size_t a, std::size_t b) { return qs[a] < qs[b]; });
+
+        morph::vvec<F> rtn (qs.size());
+        auto first = w.begin();
+        for (auto qi : qorder) {
+            const F h = qs[qi] * static_cast<F>(n - 1);
+            const std::size_t lo = static_cast<std::size_t>(std::floor (h));
+            auto nth = w.begin() + lo;
+            std::nth_element (first, nth, w.end());
+            first = nth;
+            const F a = static_cast<F>(*nth);
+            const F frac = h - static_cast<F>(lo);
+            if (frac > F{0} && lo + 1 < n) {
+                // After nth_element, the next element in order is the least of those that follow
+                const F b = static_cast<F>(*std::min_element (nth + 1, w.end()));
+                rtn[qi] = a + (b - a) * frac;
+            } else {
+                rtn[qi] = a;
+            }
+        }
+        return rtn;
+    }
+
+    //! The quantile q (in [0, 1]) of v
+    template <typename T, typename Al, typename F = quantile_t<T>>
+    F quantile (const std::vector<T, Al>& v, const F q) { return quantiles (v, std::vector<F>{ q })[0]; }
+
+    //! The median of v
+    template <typename T, typename Al, typename F = quantile_t<T>>
+    F median (const std::vector<T, Al>& v) { return quantile (v, F{0.5}); }
+
+} // namespace morph::sorting
@@ -0,0 +1,296 @@
+/*
+ * A fixed-capacity, decimating store for a streamed data series
+ */
+#pragma once
+
+#include <type_traits>
+#include <vector>
+#include <deque>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <morph/vec.h>
+#include <morph/range.h>
+
+namespace morph {
+
+    /*!
+     * A store for a data series of (x, y) points that arrive one at a time, with x never
+     * decreasing, such as a metric recorded at each step of a long simulation.
+     *
+     * The points are held in a ring buffer of fixed capacity, so that once it is full, each new
+     * point replaces the oldest. Optionally, only the points with x within xwindow of the newest
+     * point are shown (a sliding window).
+     *
+     * As points arrive they are sorted into columns along the x axis, and the first, minimum,
+     * maximum and last point of each column is kept up to date (M4 decimation). decimate() then
+     * returns at most four points per column. If there is a column per pixel, a line through
+     * the decimated points looks the same as a line through all of them, but costs O(columns)
+     * to draw, however many points have been pushed.
+     *
+     * With a window, the column width is xwindow/columns. Without one, the first 2*columns
+     * points each have a column. After that the column width is set from the x range of the
+     * data and is doubled (merging neighbouring columns) whenever there are more than
+     * 2*columns columns.
+     *
+     * \tparam Flt The floating point type of the data
+     */
+    template <typename Flt> requires std::is_floating_point_v<Flt>
+    struct streamseries
+    {
+        /*!
+         * \param _capacity The greatest number of points to store
+         *
+         * \param _xwindow If > 0, show only the points with x within _xwindow of the newest point
+         *
+         * \param _columns The number of columns into which the points are decimated. Set this to
+         * about the width of the graph in pixels.
+         */
+        streamseries (const std::size_t _capacity, const Flt _xwindow = Flt{0}, const unsigned int _columns = 1024)
+            : cap(_capacity), xwin(_xwindow), ncols(_columns)
+        {
+            if (this->cap < 1) { throw std::runtime_error ("streamseries: capacity must be at least 1"); }
+            if (this->ncols < 1) { throw std::runtime_error ("streamseries: need at least one column"); }
+            if (!(this->xwin >= Flt{0})) { throw std::runtime_error ("streamseries: xwindow must be >= 0"); }
+            this->buf.resize (this->cap);
+            if (this->xwin > Flt{0}) { this->binw = this->xwin / static_cast<Flt>(this->ncols); }
+        }
+
+        //! Add a point. Throws if x is less than the x of the previous point.
+        void push (const Flt x, const Flt y)
+        {
+            if (this->n > 0 && x < this->back()[0]) {
+                throw std::runtime_error ("streamseries::push: x must not decrease");
+            }
+            if (this->n == 0 && this->cols.empty()) { this->origin = x; }
+            // Evict the oldest point from a full buffer
+            if (this->n == this->cap) {
+                this->evict (this->seq - this->n);
+                --this->n;
+            }
+            const std::uint64_t s = this->seq++;
+            this->buf[s % this->cap] = { x, y };
+            ++this->n;
+            this->add_to_column (s, x, y);
+
+            if (this->xwin > Flt{0}) {
+                // Drop the columns that have slid out of the window
+                const std::int64_t kmin = this->key_of (x - this->xwin);
+                while (!this->cols.empty() && this->cols.front().key < kmin) {
+                    this->cols.pop_front();
+                    this->front_dirty = false;
+                }
+            } else if (this->cols.size() > 2u * this->ncols) {
+                if (this->binw == Flt{0}) {
+                    // Choose a column width from the range of the data and re-sort the points
+                    const Flt span = x - (*this)[0][0];
+                    this->binw = span > Flt{0} ? span / static_cast<Flt>(this->ncols) : Flt{1};
+                    this->origin = (*this)[0][0];
+                    this->cols.clear();
+                    this->front_dirty = false;
+                    for (std::uint64_t i = this->seq - this->n; i < this->seq; ++i) {
+                        const morph::vec<Flt, 2>& p = this->buf[i % this->cap];
+                        this->add_to_column (i, p[0], p[1]);
+                    }
+                }
+                while (this->cols.size() > 2u * this->ncols) { this->merge_columns(); }
+            }
+        }
+
+        //! The number of points stored
+        std::size_t size() const { return this->n; }
+
+        //! The greatest number of points that can be stored
+        std::size_t capacity() const { return this->cap; }
+
+        //! The width of the sliding window (0 for no window)
+        Flt xwindow() const { return this->xwin; }
+
+        //! The number of columns presently holding points
+        std::size_t num_columns() const { return this->cols.size(); }
+
+        //! Access the stored points. Element 0 is the oldest.
+        const morph::vec<Flt, 2>& operator[] (const std::size_t i) const
+        {
+            return this->buf[(this->seq - this->n + i) % this->cap];
+        }
+
+        //! The newest point
+        const morph::vec<Flt, 2>& back() const { return this->buf[(this->seq - 1) % this->cap]; }
+
+        /*!
+         * The x range to show. With a window, this is [newest - xwindow, newest]; otherwise it
+         * is from the oldest to the newest stored point.
+         */
+        morph::range<Flt> xrange() const
+        {
+            morph::range<Flt> r;
+            if (this->n == 0) { return r; }
+            r.max = this->back()[0];
+            r.min = this->xwin > Flt{0} ? r.max - this->xwin : (*this)[0][0];
+            return r;
+        }
+
+        //! The y range of the points that are shown
+        morph::range<Flt> yrange()
+        {
+            morph::range<Flt> r (morph::range_init::for_search);
+            this->refresh_front();
+            for (const auto& c : this->cols) {
+                r.update (c.pmin[1]);
+                r.update (c.pmax[1]);
+            }
+            return r;
+        }
+
+        /*!
+         * Write the decimated points (in order) into out: the first, minimum, maximum and last
+         * point of each column.
+         */
+        void decimate (std::vector<morph::vec<Flt, 2>>& out)
+        {
+            out.clear();
+            this->refresh_front();
+            std::uint64_t last_out = 0;
+            bool any = false;
+            auto emit = [&out, &last_out, &any](const std::uint64_t s, const morph::vec<Flt, 2>& p)
+            {
+                if (any && s == last_out) { return; }
+                out.push_back (p);
+                last_out = s;
+                any = true;
+            };
+            for (const auto& c : this->cols) {
+                emit (c.first_seq, c.first);
+                if (c.min_seq < c.max_seq) {
+                    emit (c.min_seq, c.pmin);
+                    emit (c.max_seq, c.pmax);
+                } else {
+                    emit (c.max_seq, c.pmax);
+                    emit (c.min_seq, c.pmin);
+                }
+                emit (c.last_seq, c.last);
+            }
+        }
+
+        //! Remove all the points
+        void clear()
+        {
+            this->n = 0;
+            this->seq = 0;
+            this->cols.clear();
+            this->front_dirty = false;
+            this->binw = this->xwin > Flt{0} ? this->xwin / static_cast<Flt>(this->ncols) : Flt{0};
+        }
+
+    private:
+        //! The first, min, max and last points of a column, with their sequence numbers
+        struct column
+        {
+            std::int64_t key = 0;
+            std::uint64_t first_seq = 0;
+            std::uint64_t last_seq = 0;
+            std::uint64_t min_seq = 0;
+            std::uint64_t max_seq = 0;
+            morph::vec<Flt, 2> first = {};
+            morph::vec<Flt, 2> last = {};
+            morph::vec<Flt, 2> pmin = {};
+            morph::vec<Flt, 2> pmax = {};
+        };
+
+        //! The column key for x. Before a column width is chosen, each point has its own column.
+        std::int64_t key_of (const Flt x) const
+        {
+            return static_cast<std::int64_t>(std::floor ((x - this->origin) / this->binw));
+        }
+
+        void add_to_column (const std::uint64_t s, const Flt x, const Flt y)
+        {
+            std::int64_t k = this->binw > Flt{0} ? this->key_of (x) : static_cast<std::int64_t>(s);
+            // Guard against rounding putting a point in an earlier column than its predecessor
+            if (!this->cols.empty() && k < this->cols.back().key) { k = this->cols.back().key; }
+            const morph::vec<Flt, 2> p = { x, y };
+            if (!this->cols.empty() && this->cols.back().key == k) {
+                column& c = this->cols.back();
+                c.last = p;
+                c.last_seq = s;
+                if (y < c.pmin[1]) { c.pmin = p; c.min_seq = s; }
+                if (y > c.pmax[1]) { c.pmax = p; c.max_seq = s; }
+            } else {
+                this->cols.push_back (column{ k, s, s, s, s, p, p, p, p });
+            }
+        }
+
+        //! Merge pairs of neighbouring columns, doubling the column width
+        void merge_columns()
+        {
+            this->refresh_front();
+            std::deque<column> merged;
+            for (column c : this->cols) {
+                c.key = c.key >= 0 ? c.key / 2 : (c.key - 1) / 2; // floor division
+                if (!merged.empty() && merged.back().key == c.key) {
+                    column& m = merged.back();
+                    m.last = c.last;
+                    m.last_seq = c.last_seq;
+                    if (c.pmin[1] < m.pmin[1]) { m.pmin = c.pmin; m.min_seq = c.min_seq; }
+                    if (c.pmax[1] > m.pmax[1]) { m.pmax = c.pmax; m.max_seq = c.max_seq; }
+                } else {
+                    merged.push_back (c);
+                }
+            }
+            this->cols.swap (merged);
+            this->binw *= Flt{2};
+        }
+
+        //! Remove the point with sequence number s (the oldest) from the front column
+        void evict (const std::uint64_t s)
+        {
+            if (this->cols.empty() || this->cols.front().first_seq != s) { return; }
+            column& c = this->cols.front();
+            if (c.last_seq == s) {
+                this->cols.pop_front();
+                this->front_dirty = false;
+            } else {
+                ++c.first_seq;
+                this->front_dirty = true;
+            }
+        }
+
+        //! After evictions, recompute the front column from the points that remain in it
+        void refresh_front()
+        {
+            if (!this->front_dirty || this->cols.empty()) { return; }
+            column& c = this->cols.front();
+            const morph::vec<Flt, 2>& p0 = this->buf[c.first_seq % this->cap];
+            c.first = c.pmin = c.pmax = p0;
+            c.min_seq = c.max_seq = c.first_seq;
+            for (std::uint64_t i = c.first_seq + 1; i <= c.last_seq; ++i) {
+                const morph::vec<Flt, 2>& p = this->buf[i % this->cap];
+                if (p[1] < c.pmin[1]) { c.pmin = p; c.min_seq = i; }
+                if (p[1] > c.pmax[1]) { c.pmax = p; c.max_seq = i; }
+            }
+            this->front_dirty = false;
+        }
+
+        //! The ring buffer
+        std::vector<morph::vec<Flt, 2>> buf;
+        //! Capacity of buf
+        std::size_t cap = 0;
+        //! The number of points in buf
+        std::size_t n = 0;
+        //! The sequence number of the next point. Point s is at buf[s % cap].
+        std::uint64_t seq = 0;
+        //! Sliding window width
+        Flt xwin = Flt{0};
+        //! Target number of columns
+        unsigned int ncols = 1024;
+        //! Column width (0 before one has been chosen) and the x of the edge of column 0
+        Flt binw = Flt{0};
+        Flt origin = Flt{0};
+        //! The columns, oldest first
+        std::deque<column> cols;
+        //! True if points have been evicted from the front column since it was last computed
+        bool front_dirty = false;
+    };
+
+} // namespace morph
@@ -22,6 +22,7 @@
 #include <cstddef>
 #include <morph/Random.h>
 #include <morph/range.h>
+#include <morph/reduce.h>
 #include <morph/trait_tests.h>
 
 namespace morph {
@@ -68,6 +69,13 @@ namespace morph {
 
         //! Used in functions for which wrapping is important
         enum class wrapdata { none, wrap };
+
+        /*!
+         * True if the statistics functions (sum, mean, variance, dot, max and so on) can use the
+         * blocked, multithreaded reductions in morph/reduce.h. This requires arithmetic elements
+         * in contiguous memory (so not bool).
+         */
+        static constexpr bool blocked_reductions = std::is_arithmetic_v<S> && !std::is_same_v<S, bool>;
         //! Should a function resize the output?
         enum class resize_output { no, yes };
         //! Should a function treat a kernel as symmetric and centralize it?
@@ -442,6 +450,40 @@ namespace morph {
             for (auto& i : *this) { i = rn.get(); }
         }
 
+        /*!
+         * Randomize the vector from the counter-based generator \a rng
+         *
+         * As randomize(), but the numbers come from \a rng, which moves on past the numbers
+         * used. For floating point S, the numbers depend only on the seed, stream and position
+         * of \a rng, and large vvecs are filled by several threads.
+         */
+        void randomize (RandPhilox& rng)
+        {
+            if constexpr (std::is_floating_point_v<S>) {
+                rng.fill_uniform (std::span<S>{ this->data(), this->size() });
+            } else {
+                std::uniform_int_distribution<S> dist (std::numeric_limits<S>::min(), std::numeric_limits<S>::max());
+                for (auto& i : *this) { i = dist (rng); }
+            }
+        }
+
+        //! Randomize the vector in the range [min, max) from the counter-based generator \a rng
+        void randomize (S min, S max, RandPhilox& rng)
+        {
+            if constexpr (std::is_floating_point_v<S>) {
+                rng.fill_uniform (std::span<S>{ this->data(), this->size() }, min, max);
+            } else {
+                std::uniform_int_distribution<S> dist (min, max);
+                for (auto& i : *this) { i = dist (rng); }
+            }
+        }
+
+        //! Randomize the vector from a Gaussian distribution, from the counter-based generator \a rng
+        void randomizeN (S _mean, S _sd, RandPhilox& rng)
+        {
+            rng.fill_normal (std::span<S>{ this->data(), this->size() }, _mean, _sd);
+        }
+
         /*!
          * Re-order the elements in the vvec - shuffle it up. Don't duplicate any
          * entries, so that summary statistics such as mean() and variance() should
@@ -561,6 +603,14 @@ namespace morph {
         template <typename Sy=S>
         Sy length() const noexcept
         {
+            if constexpr (blocked_reductions && std::is_arithmetic_v<Sy>) {
+                const Sy _sos = morph::reduce::sos<false, Sy> (this->data(), this->size());
+                if constexpr (std::is_integral<std::decay_t<Sy>>::value == true) {
+                    return static_cast<Sy>(std::round(std::sqrt(_sos)));
+                } else {
+                    return std::sqrt(_sos);
+                }
+            }
             auto add_squared = [](Sy a, S b) { return a + b * b; };
             // Add check on whether return type Sy is integral or float. If integral, then std::round then cast the result of std::sqrt()
             if constexpr (std::is_integral<std::decay_t<Sy>>::value == true) {
@@ -651,7 +701,9 @@ namespace morph {
         template <bool test_for_nans = false, typename Sy=S>
         Sy sos() const noexcept
         {
-            if constexpr (test_for_nans) {
+            if constexpr (blocked_reductions && std::is_arithmetic_v<Sy>) {
+                return morph::reduce::sos<test_for_nans, Sy> (this->data(), this->size());
+            } else if constexpr (test_for_nans) {
                 auto add_squared = [](Sy a, S b) { return std::isnan(b) ? a : a + b * b; };
                 return std::accumulate (this->begin(), this->end(), Sy{0}, add_squared);
             } else {
@@ -793,6 +845,11 @@ namespace morph {
         template <typename Sy=S, std::enable_if_t<std::is_scalar<std::decay_t<Sy>>::value, int> = 0 >
         S max() const noexcept
         {
+            if constexpr (blocked_reductions) {
+                // With NaNs, the result is left to std::max_element below, as it depends on where they are
+                const morph::reduce::extremes<S> e = morph::reduce::compute_extremes (this->data(), this->size());
+                if (!e.has_nan) { return e.max; }
+            }
             auto themax = std::max_element (this->begin(), this->end());
             return themax == this->end() ? S{0} : *themax;
         }
@@ -811,6 +868,10 @@ namespace morph {
         template <typename Sy=S, std::enable_if_t<std::is_scalar<std::decay_t<Sy>>::value, int> = 0 >
         std::size_t argmax() const noexcept
         {
+            if constexpr (blocked_reductions) {
+                const morph::reduce::extremes<S> e = morph::reduce::compute_extremes (this->data(), this->size());
+                if (!e.has_nan) { return e.argmax; } // as in max()
+            }
             auto themax = std::max_element (this->begin(), this->end());
             std::size_t idx = (themax - this->begin());
             return idx;
@@ -829,6 +890,11 @@ namespace morph {
         template <typename Sy=S, std::enable_if_t<std::is_scalar<std::decay_t<Sy>>::value, int> = 0 >
         S min() const noexcept
         {
+            if constexpr (blocked_reductions) {
+                // With NaNs, the result is left to std::min_element below, as it depends on where they are
+                const morph::reduce::extremes<S> e = morph::reduce::compute_extremes (this->data(), this->size());
+                if (!e.has_nan) { return e.min; }
+            }
             auto themin = std::min_element (this->begin(), this->end());
             return themin == this->end() ? S{0} : *themin;
         }
@@ -841,6 +907,10 @@ namespace morph {
         template <typename Sy=S, std::enable_if_t<std::is_scalar<std::decay_t<Sy>>::value, int> = 0 >
         std::size_t argmin() const noexcept
         {
+            if constexpr (blocked_reductions) {
+                const morph::reduce::extremes<S> e = morph::reduce::compute_extremes (this->data(), this->size());
+                if (!e.has_nan) { return e.argmin; } // as in min()
+            }
             auto themin = std::min_element (this->begin(), this->end());
             std::size_t idx = (themin - this->begin());
             return idx;
@@ -863,6 +933,16 @@ namespace morph {
         morph::range<S> range() const
         {
             morph::range<S> r;
+            if constexpr (blocked_reductions) {
+                // compute_extremes skips NaNs. Without test_for_nans, data with NaNs is left to
+                // std::minmax_element below.
+                const morph::reduce::extremes<S> e = morph::reduce::compute_extremes (this->data(), this->size());
+                if (test_for_nans || !e.has_nan) {
+                    r.min = e.min;
+                    r.max = e.max;
+                    return r;
+                }
+            }
             if constexpr (test_for_nans) {
                 if (this->has_nan()) {
                     // Deal with non-numbers by removing them
@@ -1109,7 +1189,14 @@ namespace morph {
         template<bool test_for_nans = false, typename Sy=S>
         Sy mean() const noexcept
         {
-            if constexpr (test_for_nans) {
+            if constexpr (blocked_reductions && std::is_arithmetic_v<Sy>) {
+                const Sy sum = morph::reduce::sum<test_for_nans, Sy> (this->data(), this->size());
+                if constexpr (test_for_nans) {
+                    return sum / morph::reduce::count_numbers (this->data(), this->size());
+                } else {
+                    return sum / this->size();
+                }
+            } else if constexpr (test_for_nans) {
                 if (this->has_nan()) {
                     // Deal with non-numbers with a special accumulate function
                     std::size_t n_nans = 0u;
@@ -1131,6 +1218,11 @@ namespace morph {
         Sy variance() const noexcept
         {
             if (this->empty()) { return S{0}; }
+            if constexpr (blocked_reductions && std::is_floating_point_v<Sy>) {
+                // Single pass, pairwise (see morph/reduce.h)
+                const morph::reduce::moments<Sy> m = morph::reduce::compute_moments<test_for_nans, Sy> (this->data(), this->size());
+                return m.m2 / (static_cast<Sy>(m.n) - Sy{1});
+            }
             Sy _mean = this->mean<test_for_nans, Sy>();
             Sy sos_deviations = Sy{0};
             std::size_t n_nans = 0u;
@@ -1161,7 +1253,9 @@ namespace morph {
         template<bool test_for_nans = false, typename Sy=S>
         Sy sum() const noexcept
         {
-            if constexpr (test_for_nans) {
+            if constexpr (blocked_reductions && std::is_arithmetic_v<Sy>) {
+                return morph::reduce::sum<test_for_nans, Sy> (this->data(), this->size());
+            } else if constexpr (test_for_nans) {
                 auto _ignoring_nans = [](Sy a, S b) mutable { return std::isnan(b) ? a : a + b; };
                 return std::accumulate (this->begin(), this->end(), Sy{0}, _ignoring_nans);
             } else {
@@ -1876,6 +1970,9 @@ namespace morph {
             if (this->size() != v.size()) {
                 throw std::runtime_error ("vvec::dot(): vectors must have equal size");
             }
+            if constexpr (blocked_reductions && vvec<Sy>::blocked_reductions) {
+                return morph::reduce::dot<S> (this->data(), v.data(), this->size());
+            }
             auto vi = v.begin();
             auto dot_product = [vi](S a, Sy b) mutable -> S { return a + static_cast<S>(b) * static_cast<S>(*vi++); };
             const S rtn = std::accumulate (this->begin(), this->end(), S{0}, dot_product);
@@ -2152,6 +2249,42 @@ namespace morph {
             std::transform (this->begin(), this->end(), this->begin(), subtract_s);
         }
 
+        /*!
+         * Assign from a lazy expression (see morph/vvec_lazy.h), evaluating the whole
+         * expression element by element in one loop. *this is resized if necessary.
+         */
+        template <typename E> requires E::lazy_expression
+        vvec<S, Al>& operator= (const E& e)
+        {
+            const std::size_t n = e.size();
+            if (this->size() != n) { this->resize (n); }
+            S* d = this->data();
+            for (std::size_t i = 0; i < n; ++i) { d[i] = e[i]; }
+            return *this;
+        }
+
+        //! Add a lazy expression to *this in one loop
+        template <typename E> requires E::lazy_expression
+        void operator+= (const E& e)
+        {
+            if (e.size() != this->size()) {
+                throw std::runtime_error ("vvec::operator+=: adding vvecs of different dimensionality is suppressed");
+            }
+            S* d = this->data();
+            for (std::size_t i = 0; i < this->size(); ++i) { d[i] += e[i]; }
+        }
+
+        //! Subtract a lazy expression from *this in one loop
+        template <typename E> requires E::lazy_expression
+        void operator-= (const E& e)
+        {
+            if (e.size() != this->size()) {
+                throw std::runtime_error ("vvec::operator-=: subtracting vvecs of different dimensionality is suppressed");
+            }
+            S* d = this->data();
+            for (std::size_t i = 0; i < this->size(); ++i) { d[i] -= e[i]; }
+        }
+
         //! Concatentate the vvec<S>& a to the end of *this.
         void concat (const vvec<S>& a)
         {
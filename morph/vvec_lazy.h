@@ -0,0 +1,207 @@
+/*!
+ * \file
+ * \brief Opt-in lazy (expression template) arithmetic for morph::vvec
+ *
+ * Each of the arithmetic operators of morph::vvec returns a newly allocated vvec, so a chain
+ * such as a * b + c allocates and fills a temporary for each operator. Wrapping the first
+ * operand in morph::lazy() instead builds an expression object that records the operations.
+ * No arithmetic is carried out until the expression is assigned into a vvec, at which point the
+ * whole chain is evaluated element by element in a single loop, with no temporaries:
+ *
+ *\code{.cpp}
+ * morph::vvec<float> a, b, c, r;
+ * // ...
+ * r = morph::lazy(a) * b + c;          // one loop, no temporary vvecs
+ * r += morph::lazy(a) * 2.0f - c;      // also one loop
+ * float s = morph::lazy_sum (morph::lazy(a) * b); // a dot product without a temporary
+ *\endcode
+ *
+ * An expression refers to the vvecs from which it was made, so it must be evaluated before
+ * they are resized or destroyed. Don't keep an expression made from a temporary vvec in an auto
+ * variable.
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <morph/trait_tests.h>
+#include <morph/vvec.h>
+
+namespace morph {
+
+    //! A leaf of a lazy expression that refers to the elements of a vvec
+    template <typename S>
+    struct lazy_ref
+    {
+        static constexpr bool lazy_expression = true;
+        static constexpr bool is_scalar = false;
+        using value_type = S;
+
+        const S* p = nullptr;
+        std::size_t n = 0;
+
+        std::size_t size() const noexcept { return this->n; }
+        const S& operator[] (const std::size_t i) const noexcept { return this->p[i]; }
+    };
+
+    //! A leaf of a lazy expression that holds a scalar (or fixed size vec) for every element
+    template <typename T>
+    struct lazy_scalar
+    {
+        static constexpr bool lazy_expression = true;
+        static constexpr bool is_scalar = true;
+        using value_type = T;
+
+        T s;
+
+        std::size_t size() const noexcept { return 0; }
+        const T& operator[] (const std::size_t) const noexcept { return this->s; }
+    };
+
+    //! A lazy expression that applies the unary function F to each element of E
+    template <typename E, typename F>
+    struct lazy_unary
+    {
+        static constexpr bool lazy_expression = true;
+        static constexpr bool is_scalar = E::is_scalar;
+        using value_type = std::decay_t<std::invoke_result_t<F, typename E::value_type>>;
+
+        E e;
+        F f;
+
+        std::size_t size() const noexcept { return this->e.size(); }
+        value_type operator[] (const std::size_t i) const { return this->f (this->e[i]); }
+    };
+
+    //! A lazy expression that applies the binary operation Op to the elements of L and R
+    template <typename L, typename R, typename Op>
+    struct lazy_binary
+    {
+        static constexpr bool lazy_expression = true;
+        static constexpr bool is_scalar = L::is_scalar && R::is_scalar;
+        using value_type = std::decay_t<std::invoke_result_t<Op, typename L::value_type, typename R::value_type>>;
+
+        lazy_binary (const L& _l, const R& _r)
+            : l(_l)
+            , r(_r)
+        {
+            if constexpr (!L::is_scalar && !R::is_scalar) {
+                if (this->l.size() != this->r.size()) {
+                    throw std::runtime_error ("morph::lazy: operands have different sizes");
+                }
+            }
+        }
+
+        L l;
+        R r;
+
+        std::size_t size() const noexcept { return L::is_scalar ? this->r.size() : this->l.size(); }
+        value_type operator[] (const std::size_t i) const { return Op{}(this->l[i], this->r[i]); }
+    };
+
+    //! True for the lazy expression types above
+    template <typename E>
+    concept lazy_expr = requires { requires std::decay_t<E>::lazy_expression; };
+
+    //! Types that may appear as the scalar operand of a lazy expression
+    template <typename T>
+    concept lazy_scalar_operand = std::is_scalar_v<std::decay_t<T>> || morph::is_copyable_fixedsize<std::decay_t<T>>::value;
+
+    //! Start a lazy expression from the vvec \a v
+    template <typename S, typename Al>
+    lazy_ref<S> lazy (const vvec<S, Al>& v) noexcept { return lazy_ref<S>{ v.data(), v.size() }; }
+
+    //! Lazily apply the function \a f to each element of the expression \a e
+    template <typename E, typename F> requires lazy_expr<E>
+    lazy_unary<E, F> lazy_map (const E& e, F f) { return lazy_unary<E, F>{ e, f }; }
+
+    //! Wrap an operand of a lazy expression operator as a lazy expression
+    template <typename T>
+    auto as_lazy (const T& t)
+    {
+        if constexpr (lazy_expr<T>) {
+            return t;
+        } else if constexpr (morph::is_copyable_fixedsize<T>::value || std::is_scalar_v<T>) {
+            return lazy_scalar<T>{ t };
+        } else {
+            return lazy (t); // a vvec
+        }
+    }
+
+    /*
+     * The operators. At least one operand must be a lazy expression; the other may be a lazy
+     * expression, a vvec or a scalar.
+     */
+    template <typename T>
+    concept lazy_operand = lazy_expr<T> || lazy_scalar_operand<T>
+                           || requires (const T& t) { { morph::lazy (t) } -> lazy_expr; };
+
+    template <typename L, typename R>
+    concept lazy_operands = lazy_operand<L> && lazy_operand<R> && (lazy_expr<L> || lazy_expr<R>);
+
+    template <typename L, typename R> requires lazy_operands<L, R>
+    auto operator+ (const L& l, const R& r)
+    {
+        using LE = decltype(as_lazy (l));
+        using RE = decltype(as_lazy (r));
+        return lazy_binary<LE, RE, std::plus<>>{ as_lazy (l), as_lazy (r) };
+    }
+
+    template <typename L, typename R> requires lazy_operands<L, R>
+    auto operator- (const L& l, const R& r)
+    {
+        using LE = decltype(as_lazy (l));
+        using RE = decltype(as_lazy (r));
+        return lazy_binary<LE, RE, std::minus<>>{ as_lazy (l), as_lazy (r) };
+    }
+
+    template <typename L, typename R> requires lazy_operands<L, R>
+    auto operator* (const L& l, const R& r)
+    {
+        using LE = decltype(as_lazy (l));
+        using RE = decltype(as_lazy (r));
+        return lazy_binary<LE, RE, std::multiplies<>>{ as_lazy (l), as_lazy (r) };
+    }
+
+    template <typename L, typename R> requires lazy_operands<L, R>
+    auto operator/ (const L& l, const R& r)
+    {
+        using LE = decltype(as_lazy (l));
+        using RE = decltype(as_lazy (r));
+        return lazy_binary<LE, RE, std::divides<>>{ as_lazy (l), as_lazy (r) };
+    }
+
+    //! Unary negation of a lazy expression
+    template <typename E> requires lazy_expr<E>
+    lazy_unary<E, std::negate<>> operator- (const E& e) { return lazy_unary<E, std::negate<>>{ e, {} }; }
+
+    /*!
+     * Evaluate the lazy expression \a e into \a out in a single loop, resizing \a out if
+     * necessary. \a out may also be an operand of \a e, as each element of the result depends
+     * only on the same element of the operands.
+     */
+    template <typename S, typename Al, typename E> requires lazy_expr<E>
+    void lazy_eval (const E& e, vvec<S, Al>& out) { out = e; }
+
+    //! Evaluate a lazy expression into a new vvec
+    template <typename E> requires lazy_expr<E>
+    vvec<typename E::value_type> lazy_eval (const E& e)
+    {
+        vvec<typename E::value_type> rtn;
+        lazy_eval (e, rtn);
+        return rtn;
+    }
+
+    //! Sum the elements of a lazy expression without evaluating it into memory
+    template <typename E> requires lazy_expr<E>
+    typename E::value_type lazy_sum (const E& e)
+    {
+        typename E::value_type s{};
+        const std::size_t n = e.size();
+        for (std::size_t i = 0; i < n; ++i) { s += e[i]; }
+        return s;
+    }
+
+} // namespace morph
@@ -10,6 +10,16 @@ uniform mat4 v_matrix; // scene view matrix
 uniform mat4 p_matrix; // projection matrix
 // alpha - to make a model see-through
 uniform float alpha;
+// true for an instanced model, which applies instposn and instcolor to a template mesh
+uniform bool instanced;
+// true if some vertices are coloured from their scalar. These have a negative red colour component.
+uniform bool scalar_colour;
+// m, c and log flag of the scaling (m * x + c or m * ln(x) + c) that takes a scalar into [0, 1]
+uniform vec3 scalar_params;
+// The colour given to a NaN scalar
+uniform vec3 scalar_nan;
+// The colour map: one row of RGB texels, for scalars evenly spaced from 0 to 1
+uniform sampler2D scalar_cmap;
 // Parameters of our cylindrical screen
 uniform float cyl_radius = 0.005;
 uniform float cyl_height = 0.02;
@@ -21,6 +31,12 @@ layout(location = 0) in vec4 position; // Attrib location 0. vertex position
 layout(location = 1) in vec4 normalin; // Attrib location 1. vertex normal
 layout(location = 2) in vec3 color;    // Attrib location 2. vertex colour
 
+// Per-instance attributes (for instanced models)
+layout(location = 4) in vec4 instposn;  // Attrib location 4. xyz offset, w scale
+layout(location = 5) in vec3 instcolor; // Attrib location 5. instance colour
+// Per-vertex scalar, for vertices coloured with the colour map
+layout(location = 6) in float scalar;   // Attrib location 6
+
 out VERTEX
 {
     vec4 normal;
@@ -28,13 +44,28 @@ out VERTEX
     vec3 fragpos; // fragment position
 } vertex;
 
+// Scale s into [0, 1] and look up the nearest colour in the colour map (as ColourMap::convert does)
+vec3 scalar_to_colour (float s)
+{
+    float u = (scalar_params.z > 0.5 ? log (s) : s) * scalar_params.x + scalar_params.y;
+    if (isnan (u)) { return scalar_nan; }
+    float r = clamp (u, 0.0, 1.0) * float(textureSize (scalar_cmap, 0).x - 1);
+    int i = int(r);
+    if (r - float(i) >= 0.5) { ++i; }
+    return texelFetch (scalar_cmap, ivec2(i, 0), 0).rgb;
+}
+
 void main (void)
 {
     const float pi = 3.1415927;
     const float two_pi = 6.283185307;
     const float heading_offset = 1.570796327; // pi/2 but maybe pass in?
+    // Translate and scale the template mesh for each instance of an instanced model
+    vec4 pos = instanced ? vec4(position.xyz * instposn.w + instposn.xyz, 1.0) : position;
+    vec3 col = instanced ? instcolor : color;
+    if (scalar_colour && col.r < 0.0) { col = scalar_to_colour (scalar); }
     // Transform vertex position with scene view and model view matrices
-    vec4 pv = (v_matrix * m_matrix * position);
+    vec4 pv = (v_matrix * m_matrix * pos);
     vec4 ray = pv - (v_matrix * cyl_cam_pos);
     vec3 rho_phi_z; // polar coordinates of ray
     rho_phi_z[0] = sqrt (ray.x * ray.x + ray.y * ray.y);
@@ -52,13 +83,13 @@ void main (void)
         y_s = (cyl_radius * tan (theta)) / cyl_height;
         gl_PointSize = 1;
         gl_Position = vec4(x_s, y_s, -1.0, 1.0);
-        vertex.color = vec4(color, alpha);
-        vertex.fragpos = vec3(m_matrix * position); // within-model position of fragment, used for lighting
+        vertex.color = vec4(col, alpha);
+        vertex.fragpos = vec3(m_matrix * pos); // within-model position of fragment, used for lighting
         vertex.normal = normalin;
     } else {
         gl_Position = vec4(0.0, 0.0, -100.0, 1.0);
-        vertex.color = vec4(color, 0.0);
-        vertex.fragpos = vec3(m_matrix * position);
+        vertex.color = vec4(col, 0.0);
+        vertex.fragpos = vec3(m_matrix * pos);
         vertex.normal = normalin;
     }
 }
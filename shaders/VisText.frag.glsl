@@ -1,9 +1,9 @@
 // The coded-in shaders tell non-Mac platforms that they use OpenGL 4.5, but Mac limited to 4.1
 #version 410
-in vec2 TexCoords;
+in vec3 TexCoords;
 out vec4 color;
 
-uniform sampler2D text;
+uniform mediump sampler2DArray text; // The glyph atlas
 uniform vec3 textColor;
 
 void main()
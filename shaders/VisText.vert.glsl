@@ -10,10 +10,10 @@ layout(location = 1) in vec4 vnormal;  // Attrib location 1 is vertex normal
 layout(location = 2) in vec4 vcolor;   // Attrib location 2 is vertex colour
 layout(location = 3) in vec4 texture;  // Attrib location 3 is texture map location
 
-out vec2 TexCoords;
+out vec3 TexCoords; // The glyph atlas coordinates and layer
 
 void main()
 {
     gl_Position = p_matrix * v_matrix * m_matrix * position;
-    TexCoords = texture.xy;
+    TexCoords = texture.xyz;
 }
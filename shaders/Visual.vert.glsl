@@ -10,10 +10,25 @@ uniform mat4 v_matrix; // scene view matrix
 uniform mat4 p_matrix; // projection matrix
 // alpha - to make a model see-through
 uniform float alpha;
+// true for an instanced model, which applies instposn and instcolor to a template mesh
+uniform bool instanced;
+// true if some vertices are coloured from their scalar. These have a negative red colour component.
+uniform bool scalar_colour;
+// m, c and log flag of the scaling (m * x + c or m * ln(x) + c) that takes a scalar into [0, 1]
+uniform vec3 scalar_params;
+// The colour given to a NaN scalar
+uniform vec3 scalar_nan;
+// The colour map: one row of RGB texels, for scalars evenly spaced from 0 to 1
+uniform sampler2D scalar_cmap;
 
 layout(location = 0) in vec4 position; // Attrib location 0
 layout(location = 1) in vec4 normalin; // Attrib location 1
 layout(location = 2) in vec3 color;    // Attrib location 2
+// Per-instance attributes (for instanced models)
+layout(location = 4) in vec4 instposn;  // Attrib location 4. xyz offset, w scale
+layout(location = 5) in vec3 instcolor; // Attrib location 5. instance colour
+// Per-vertex scalar, for vertices coloured with the colour map
+layout(location = 6) in float scalar;   // Attrib location 6
 
 out VERTEX
 {
@@ -22,11 +37,26 @@ out VERTEX
     vec3 fragpos; // fragment position
 } vertex;
 
+// Scale s into [0, 1] and look up the nearest colour in the colour map (as ColourMap::convert does)
+vec3 scalar_to_colour (float s)
+{
+    float u = (scalar_params.z > 0.5 ? log (s) : s) * scalar_params.x + scalar_params.y;
+    if (isnan (u)) { return scalar_nan; }
+    float r = clamp (u, 0.0, 1.0) * float(textureSize (scalar_cmap, 0).x - 1);
+    int i = int(r);
+    if (r - float(i) >= 0.5) { ++i; }
+    return texelFetch (scalar_cmap, ivec2(i, 0), 0).rgb;
+}
+
 void main (void)
 {
-    gl_Position = (p_matrix * v_matrix * m_matrix * position);
-    vertex.color = vec4(color, alpha);
-    vertex.fragpos = vec3(m_matrix * position);
+    // Translate and scale the template mesh for each instance of an instanced model
+    vec4 pos = instanced ? vec4(position.xyz * instposn.w + instposn.xyz, 1.0) : position;
+    vec3 col = instanced ? instcolor : color;
+    if (scalar_colour && col.r < 0.0) { col = scalar_to_colour (scalar); }
+    gl_Position = (p_matrix * v_matrix * m_matrix * pos);
+    vertex.color = vec4(col, alpha);
+    vertex.fragpos = vec3(m_matrix * pos);
     // Normals are all automatically computed, so there's no need for
     // this line and the cube program doesn't bother to pass in the
     // normals. Maybe required only for lighting?
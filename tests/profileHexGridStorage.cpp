@@ -0,0 +1,47 @@
+/*
+ * Profile the construction of a large HexGrid and a walk over its neighbour relations. This is
+ * compiled twice; once with the default std::list storage for HexGrid::hexen and once with
+ * HEXGRID_CONTIGUOUS_STORAGE defined, so that the two can be compared.
+ */
+#include <morph/HexGrid.h>
+#include <iostream>
+#include <chrono>
+
+int main()
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+#ifdef HEXGRID_CONTIGUOUS_STORAGE
+    std::cout << "HexGrid storage: morph::hexarena\n";
+#else
+    std::cout << "HexGrid storage: std::list\n";
+#endif
+
+    // The grid and boundary of testbighexgrid
+    sc::time_point t0 = sc::now();
+    morph::HexGrid hg(0.002f, 8.0f, 0.0f);
+    sc::time_point t1 = sc::now();
+    std::cout << "Initial grid of " << hg.num() << " hexes (" << sizeof(morph::Hex) << " bytes per Hex)\n";
+
+    hg.setEllipticalBoundary (1.6f, 2.0f);
+    sc::time_point t2 = sc::now();
+
+    // Walk the grid via the Hex neighbour iterators, as HexGrid::convolve does
+    double sum = 0.0;
+    for (unsigned int rep = 0; rep < 10; ++rep) {
+        for (auto hi = hg.hexen.begin(); hi != hg.hexen.end(); ++hi) {
+            if (hi->has_ne()) { sum += hi->ne->x; }
+            if (hi->has_nne()) { sum += hi->nne->y; }
+            if (hi->has_nsw()) { sum += hi->nsw->x; }
+        }
+    }
+    sc::time_point t3 = sc::now();
+
+    std::cout << "Boundary applied; " << hg.num() << " hexes remain (walk sum " << sum << ")\n"
+              << "  init:                 " << duration_cast<milliseconds>(t1 - t0).count() << " ms\n"
+              << "  setEllipticalBoundary: " << duration_cast<milliseconds>(t2 - t1).count() << " ms\n"
+              << "  10 neighbour walks:   " << duration_cast<milliseconds>(t3 - t2).count() << " ms\n";
+
+    return hg.num() > 0 ? 0 : -1;
+}
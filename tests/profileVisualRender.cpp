@@ -0,0 +1,146 @@
+/*
+ * Profile the frame time of a morph::Visual holding many small VisualModels, some with text
+ * labels, and of a text-heavy scene of four GraphVisuals (as in examples/graph_fouraxes). This renders offscreen into a framebuffer object in a surfaceless EGL context, so it
+ * runs without a display or a GPU (e.g. on Mesa's llvmpipe). It returns 77 (skip) if no EGL
+ * OpenGL 4.1 context can be created.
+ */
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+// VisualOwnable does not depend on any windowing system, but needs a window type
+struct GLFWwindow;
+namespace morph { using win_t = GLFWwindow; }
+
+#include <morph/VisualOwnableNoMX.h>
+#include <morph/TriangleVisual.h>
+#include <morph/GraphVisual.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <string>
+#include <chrono>
+
+constexpr int glver = morph::gl::version_4_1;
+
+// Render one frame to complete the models' GL setup, then return the mean time of some frames in us
+long long mean_frame_time (morph::VisualOwnableNoMX<glver>& v)
+{
+    using sc = std::chrono::steady_clock;
+    v.render();
+    glFinish();
+    constexpr int frames = 50;
+    sc::time_point t0 = sc::now();
+    for (int f = 0; f < frames; ++f) { v.render(); }
+    glFinish();
+    sc::time_point t1 = sc::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() / frames;
+}
+
+int main()
+{
+    using sc = std::chrono::steady_clock;
+
+    // A surfaceless EGL context with a desktop OpenGL core profile
+    auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress ("eglGetPlatformDisplayEXT"));
+    if (get_platform_display == nullptr) { std::cout << "No eglGetPlatformDisplayEXT; skipping\n"; return 77; }
+    EGLDisplay dpy = get_platform_display (EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    EGLint egl_major = 0, egl_minor = 0;
+    if (dpy == EGL_NO_DISPLAY || !eglInitialize (dpy, &egl_major, &egl_minor)) {
+        std::cout << "No surfaceless EGL display; skipping\n";
+        return 77;
+    }
+    eglBindAPI (EGL_OPENGL_API);
+    const EGLint ctx_attribs[] = { EGL_CONTEXT_MAJOR_VERSION, morph::gl::version::major (glver),
+                                   EGL_CONTEXT_MINOR_VERSION, morph::gl::version::minor (glver),
+                                   EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+    EGLContext ctx = eglCreateContext (dpy, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, ctx_attribs);
+    if (ctx == EGL_NO_CONTEXT || !eglMakeCurrent (dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx)) {
+        std::cout << "Could not make an OpenGL context current; skipping\n";
+        eglTerminate (dpy);
+        return 77;
+    }
+
+    int rtn = 0;
+    try {
+        constexpr int width = 640;
+        constexpr int height = 480;
+        morph::VisualOwnableNoMX<glver> v;
+        v.init_glad (reinterpret_cast<GLADloadfunc>(eglGetProcAddress));
+
+        // Render into a framebuffer object, as there is no default framebuffer
+        GLuint fbo = 0;
+        GLuint rbo[2] = { 0, 0 };
+        glGenFramebuffers (1, &fbo);
+        glBindFramebuffer (GL_FRAMEBUFFER, fbo);
+        glGenRenderbuffers (2, rbo);
+        glBindRenderbuffer (GL_RENDERBUFFER, rbo[0]);
+        glRenderbufferStorage (GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbo[0]);
+        glBindRenderbuffer (GL_RENDERBUFFER, rbo[1]);
+        glRenderbufferStorage (GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rbo[1]);
+        if (glCheckFramebufferStatus (GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            throw std::runtime_error ("Framebuffer is incomplete");
+        }
+
+        v.set_winsize (width, height);
+        v.init (nullptr);
+
+        // N small models (single triangles) in a grid. One in ten has a text label.
+        constexpr int N = 1000;
+        constexpr int side = 32;
+        sc::time_point t0 = sc::now();
+        for (int i = 0; i < N; ++i) {
+            morph::vec<float> posn = { 0.1f * (i % side - side / 2), 0.1f * (i / side - side / 2), 0.0f };
+            auto sv = std::make_unique<morph::TriangleVisual<glver>> (posn, morph::vec<float>{ -0.03f, -0.03f, 0.0f },
+                                                                      morph::vec<float>{ 0.03f, -0.03f, 0.0f },
+                                                                      morph::vec<float>{ 0.0f, 0.03f, 0.0f }, morph::colour::crimson);
+            v.bindmodel (sv);
+            if (i % 10 == 0) { sv->addLabel (std::to_string (i), { 0.0f, -0.05f, 0.0f }, morph::TextFeatures(0.02f)); }
+            sv->finalize();
+            v.addVisualModel (sv);
+        }
+        sc::time_point t1 = sc::now();
+
+        std::cout << N << " VisualModels set up in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << " ms; mean frame time "
+                  << mean_frame_time (v) << " us\n";
+
+        // Four graphs with ticks, tick labels and axis labels
+        morph::VisualOwnableNoMX<glver> v2;
+        v2.set_winsize (width, height);
+        v2.init (nullptr);
+        morph::vvec<float> absc;
+        absc.linspace (-0.5f, 0.8f, 14);
+        const morph::axisstyle styles[4] = { morph::axisstyle::L, morph::axisstyle::box,
+                                             morph::axisstyle::boxfullticks, morph::axisstyle::cross };
+        for (int i = 0; i < 4; ++i) {
+            auto gv = std::make_unique<morph::GraphVisual<float, glver>> (morph::vec<float>{ 1.4f * (i % 2), -1.2f * (i / 2), 0.0f });
+            v2.bindmodel (gv);
+            morph::DatasetStyle ds;
+            ds.markerstyle = morph::markerstyle::triangle;
+            gv->setdata (absc, absc.pow (i + 2), ds);
+            gv->axisstyle = styles[i];
+            gv->xlabel = "Abscissa label " + std::to_string (i);
+            gv->ylabel = "Ordinate label " + std::to_string (i);
+            gv->finalize();
+            v2.addVisualModel (gv);
+        }
+        std::cout << "Four GraphVisuals: mean frame time " << mean_frame_time (v2) << " us\n";
+
+        if (glGetError() != GL_NO_ERROR) {
+            std::cout << "GL error\n";
+            rtn = -1;
+        }
+
+        glDeleteRenderbuffers (2, rbo);
+        glDeleteFramebuffers (1, &fbo);
+    } catch (const std::exception& e) {
+        std::cout << "Exception: " << e.what() << std::endl;
+        rtn = -1;
+    }
+
+    eglMakeCurrent (dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext (dpy, ctx);
+    eglTerminate (dpy);
+    return rtn;
+}
@@ -0,0 +1,91 @@
+/*
+ * Benchmark morph::sorting against std::sort and against the bubble sort that MathAlgo used to
+ * rank values. Arrays of 10^3 to 10^N floats are tested, where N is 6 by default or may be
+ * given as the first argument (10^8 floats need around 3 GB of memory).
+ */
+
+#include <morph/sorting.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+
+using sc = std::chrono::steady_clock;
+
+// The old MathAlgo::bubble_sort_hi_to_lo that returned the order in indices
+void bubble_argsort (const std::vector<float>& values, std::vector<unsigned int>& indices)
+{
+    std::vector<float> vcopy = values;
+    std::iota (indices.begin(), indices.end(), 0u);
+    for (unsigned int i = 0; i < vcopy.size(); ++i) {
+        for (unsigned int j = 0; j < vcopy.size() - 1; ++j) {
+            if (vcopy[j] < vcopy[j + 1]) {
+                std::swap (vcopy[j], vcopy[j + 1]);
+                std::swap (indices[j], indices[j + 1]);
+            }
+        }
+    }
+}
+
+double time_ms (const std::function<void()>& f)
+{
+    sc::time_point t0 = sc::now();
+    f();
+    return std::chrono::duration<double, std::milli>(sc::now() - t0).count();
+}
+
+int main (int argc, char** argv)
+{
+    int rtn = 0;
+    const int max_exp = argc > 1 ? std::stoi (argv[1]) : 6;
+
+    std::mt19937 gen (42);
+    std::normal_distribution<float> dist (0.0f, 100.0f);
+
+    std::cout << std::fixed << std::setprecision (3);
+    for (int e = 3; e <= max_exp; ++e) {
+        std::size_t n = 1;
+        for (int i = 0; i < e; ++i) { n *= 10; }
+        morph::vvec<float> v (n);
+        for (auto& x : v) { x = dist (gen); }
+
+        std::cout << "n = 10^" << e << " (times in ms)\n";
+        if (e <= 4) {
+            std::vector<unsigned int> bidx (n);
+            std::cout << "  bubble sort ranking         " << time_ms ([&]() { bubble_argsort (v, bidx); }) << "\n";
+        }
+        std::vector<float> s = v;
+        std::cout << "  std::sort                   " << time_ms ([&]() { std::sort (s.begin(), s.end()); }) << "\n";
+        std::vector<float> r = v;
+        std::cout << "  sorting::radix_sort         " << time_ms ([&]() { morph::sorting::radix_sort (r); }) << "\n";
+        if (r != s) { std::cout << "  radix_sort result differs from std::sort\n"; rtn = -1; }
+
+        std::vector<std::size_t> ref (n);
+        std::cout << "  std::stable_sort of indices " << time_ms ([&]() {
+            std::iota (ref.begin(), ref.end(), std::size_t{0});
+            std::stable_sort (ref.begin(), ref.end(), [&v](std::size_t a, std::size_t b) { return v[b] < v[a]; });
+        }) << "\n";
+        morph::vvec<std::size_t> idx;
+        std::cout << "  sorting::argsort            "
+                  << time_ms ([&]() { idx = morph::sorting::argsort (v, morph::sorting::order::descending); }) << "\n";
+        if (!std::equal (idx.begin(), idx.end(), ref.begin())) { std::cout << "  argsort result differs\n"; rtn = -1; }
+
+        morph::vvec<std::size_t> top;
+        std::cout << "  sorting::top_k (k = 100)    " << time_ms ([&]() { top = morph::sorting::top_k (v, 100); }) << "\n";
+        if (!std::equal (top.begin(), top.end(), ref.begin())) { std::cout << "  top_k result differs\n"; rtn = -1; }
+
+        float med = 0.0f;
+        std::cout << "  sorting::median             " << time_ms ([&]() { med = morph::sorting::median (v); }) << "\n";
+        const float med_ref = (s[(n - 1) / 2] + s[n / 2]) / 2.0f;
+        if (med != med_ref) { std::cout << "  median " << med << " differs from " << med_ref << "\n"; rtn = -1; }
+    }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
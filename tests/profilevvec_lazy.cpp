@@ -0,0 +1,70 @@
+/*
+ * Microbenchmarks of the lazy vvec expressions (morph/vvec_lazy.h) against the eager vvec
+ * operators, which allocate a temporary vvec for each operator. Each benchmark also checks that
+ * the two give the same result, to within rounding.
+ */
+
+#include <morph/vvec.h>
+#include <morph/vvec_lazy.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <functional>
+
+using sc = std::chrono::steady_clock;
+
+// Time f over reps repetitions, returning microseconds per repetition
+double time_us (const std::function<void()>& f, const int reps)
+{
+    f(); // warm up
+    sc::time_point t0 = sc::now();
+    for (int i = 0; i < reps; ++i) { f(); }
+    sc::time_point t1 = sc::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / reps;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    for (std::size_t n : { std::size_t{1000}, std::size_t{100000}, std::size_t{4000000} }) {
+        morph::vvec<float> a (n), b (n), c (n), d (n);
+        a.linspace (-1.0f, 1.0f, n);
+        b.linspace (0.5f, 2.0f, n);
+        c.linspace (3.0f, -3.0f, n);
+        d.linspace (1.0f, 1.5f, n);
+        morph::vvec<float> r_eager (n), r_lazy (n);
+        const int reps = static_cast<int>(std::max (std::size_t{3}, std::size_t{40000000} / n));
+
+        auto bench = [&](const std::string& name, const std::function<void()>& eager, const std::function<void()>& lazy)
+        {
+            const double t_e = time_us (eager, reps);
+            const double t_l = time_us (lazy, reps);
+            std::cout << std::setw (8) << n << "  " << std::setw (22) << std::left << name << std::right
+                      << " eager " << std::setw (10) << t_e << " us, lazy " << std::setw (10) << t_l
+                      << " us (x" << t_e / t_l << ")\n";
+            // The fused loop may contract a * b + c into a fused multiply-add, so allow rounding differences
+            if ((r_eager - r_lazy).abs().max() > 1e-5f * r_eager.abs().max()) {
+                std::cout << "  Results differ for " << name << "\n";
+                rtn = -1;
+            }
+        };
+
+        bench ("a * b + c",
+               [&]() { r_eager = a * b + c; },
+               [&]() { r_lazy = morph::lazy(a) * b + c; });
+        bench ("2a - b / c",
+               [&]() { r_eager = 2.0f * a - b / c; },
+               [&]() { r_lazy = 2.0f * morph::lazy(a) - b / c; });
+        bench ("(a + b) * (c - d) / 2",
+               [&]() { r_eager = (a + b) * (c - d) / 2.0f; },
+               [&]() { r_lazy = (morph::lazy(a) + b) * (morph::lazy(c) - d) / 2.0f; });
+        bench ("r += a * b - c * d",
+               [&]() { r_eager = c; r_eager += a * b - c * d; },
+               [&]() { r_lazy = c; r_lazy += morph::lazy(a) * b - morph::lazy(c) * d; });
+    }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -81,5 +81,49 @@ int main ()
     if (c != mid_jet) { --rtn; std::cout << "ulli fail\n"; }
     std::cout << "(unsigned long long int) Colour: " << c[0] << "," << c[1] << ","<< c[2] << std::endl;
 
+    // The batch convert gives the same colours as convert(T) for every colour map type
+    std::vector<float> data;
+    for (int i = -10; i <= 1010; ++i) { data.push_back (i / 1000.0f); }
+    data.push_back (std::numeric_limits<float>::quiet_NaN());
+    std::vector<float> rgb (3 * data.size());
+    for (uint32_t t = 0; t < static_cast<uint32_t>(morph::ColourMapType::N_entries); ++t) {
+        morph::ColourMap<float> cmb (static_cast<morph::ColourMapType>(t));
+        cmb.convert (data, rgb);
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            std::array<float, 3> c1 = cmb.convert (data[i]);
+            if (c1[0] != rgb[3 * i] || c1[1] != rgb[3 * i + 1] || c1[2] != rgb[3 * i + 2]) {
+                std::cout << "Batch convert differs for " << cmb.getTypeStr() << " at " << data[i] << std::endl;
+                --rtn;
+                break;
+            }
+        }
+    }
+    // and for integer data
+    std::vector<int> idata = { -5, 0, 100, 127, 128, 254, 255, 300 };
+    std::vector<float> irgb (3 * idata.size());
+    cmi.range_max = 255;
+    cmi.convert (idata, irgb);
+    for (std::size_t i = 0; i < idata.size(); ++i) {
+        c = cmi.convert (idata[i]);
+        if (c[0] != irgb[3 * i] || c[1] != irgb[3 * i + 1] || c[2] != irgb[3 * i + 2]) { --rtn; std::cout << "int batch fail\n"; }
+    }
+
+    // rgb_table (the texture for GPU colouring) holds the colours at evenly spaced points in [0,1]
+    for (uint32_t t = 0; t < static_cast<uint32_t>(morph::ColourMapType::N_entries); ++t) {
+        morph::ColourMap<float> cmt (static_cast<morph::ColourMapType>(t));
+        if (cmt.flags.test (morph::ColourMapFlags::two_d)) { continue; }
+        std::vector<float> tbl = cmt.rgb_table();
+        const std::size_t n = tbl.size() / 3;
+        if (n < 2 || tbl.size() != 3 * n) { --rtn; std::cout << "rgb_table size fail\n"; continue; }
+        for (std::size_t i = 0; i < n; ++i) {
+            c = cmt.convert (static_cast<float>(i) / static_cast<float>(n - 1));
+            if (c[0] != tbl[3 * i] || c[1] != tbl[3 * i + 1] || c[2] != tbl[3 * i + 2]) {
+                std::cout << "rgb_table differs for " << cmt.getTypeStr() << " at entry " << i << std::endl;
+                --rtn;
+                break;
+            }
+        }
+    }
+
     return rtn;
 }
@@ -0,0 +1,80 @@
+/*
+ * Test the FrameWriter's raw frame files: frames are written in the order pushed, a later
+ * FrameWriter appends to the file, and a file of a different frame size, or one that is not a
+ * raw frame file, is refused rather than overwritten.
+ */
+#include <morph/FrameWriter.h>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+std::vector<unsigned char> frame_of (int w, int h, unsigned char v)
+{
+    return std::vector<unsigned char> (static_cast<std::size_t>(w) * h * 4, v);
+}
+
+int main()
+{
+    int rtn = 0;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "morph_testFrameWriter";
+    std::filesystem::remove_all (dir);
+    std::filesystem::create_directories (dir);
+    const std::string rawfile = (dir / "frames.rgba").string();
+    constexpr int w = 8;
+    constexpr int h = 6;
+    const std::size_t fbytes = morph::FrameWriter::raw_header_bytes + w * h * 4;
+
+    {
+        morph::FrameWriter fw;
+        for (unsigned char i = 0; i < 5; ++i) { fw.push (frame_of (w, h, i), w, h, rawfile); }
+    }
+    // A later FrameWriter appends
+    {
+        morph::FrameWriter fw;
+        fw.push (frame_of (w, h, 5), w, h, rawfile);
+    }
+    if (std::filesystem::file_size (rawfile) != 6 * fbytes) { std::cout << "Raw file has the wrong size\n"; --rtn; }
+    std::ifstream fin (rawfile, std::ios::binary);
+    std::vector<unsigned char> buf (fbytes);
+    for (unsigned char i = 0; i < 6 && fin.read (reinterpret_cast<char*>(buf.data()), fbytes); ++i) {
+        if (std::string (buf.begin(), buf.begin() + 4) != "MRGB" || buf[fbytes - 2] != i || buf[fbytes - 1] != 255) {
+            std::cout << "Frame " << static_cast<int>(i) << " is wrong\n";
+            --rtn;
+        }
+    }
+    fin.close();
+
+    // Appending frames of another size to the file must fail and leave it untouched
+    {
+        morph::FrameWriter fw;
+        bool threw = false;
+        try {
+            fw.push (frame_of (w + 1, h, 9), w + 1, h, rawfile);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        if (!threw) { std::cout << "Frames of another size were appended\n"; --rtn; }
+    }
+    if (std::filesystem::file_size (rawfile) != 6 * fbytes) { std::cout << "Raw file was modified\n"; --rtn; }
+
+    // As must appending to a file that isn't a raw frame file
+    const std::string notraw = (dir / "notes.txt").string();
+    { std::ofstream fo (notraw); fo << "Not a frame file\n"; }
+    {
+        morph::FrameWriter fw;
+        bool threw = false;
+        try {
+            fw.push (frame_of (w, h, 1), w, h, notraw);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        if (!threw) { std::cout << "A frame was appended to a file that is not a raw frame file\n"; --rtn; }
+    }
+
+    std::filesystem::remove_all (dir);
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
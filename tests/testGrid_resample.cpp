@@ -0,0 +1,76 @@
+/*
+ * Test that the windowed, separable Grid::resample_image gives the same result as a brute
+ * force resample that visits every image pixel for every Grid element.
+ */
+#include <morph/vec.h>
+#include <morph/vvec.h>
+#include <morph/Grid.h>
+#include <morph/Random.h>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+
+// The brute force resample (as Grid::resample_image was originally written)
+morph::vvec<float> resample_brute (const morph::Grid<unsigned int, float>& g, const morph::vvec<float>& image_data,
+                                   const unsigned int image_pixelwidth, const morph::vec<float, 2>& image_scale,
+                                   const morph::vec<float, 2>& image_offset)
+{
+    morph::vvec<float> expr_resampled(g.n(), 0.0f);
+    unsigned int csz = image_data.size();
+    morph::vec<unsigned int, 2> image_pixelsz = {image_pixelwidth, csz / image_pixelwidth};
+    morph::vec<float, 2> image_dims = { 1.0f, 0.0f };
+    image_dims[1] = 1.0f / (image_pixelsz[0] - 1u) * (image_pixelsz[1] - 1u);
+    image_dims *= g.width();
+    image_dims *= image_scale;
+    morph::vec<float, 2> dist_per_pix = image_dims / (image_pixelsz - 1u);
+    morph::vec<float, 2> params = 1.0f / (2.0f * dist_per_pix * dist_per_pix);
+    morph::vec<float, 2> threesig = 3.0f * dist_per_pix;
+    for (unsigned int xi = 0u; xi < g.v_c.size(); ++xi) {
+        float expr = 0.0f;
+        for (unsigned int i = 0; i < csz; ++i) {
+            morph::vec<unsigned int, 2> idx = {(i % image_pixelsz[0]), (i / image_pixelsz[0])};
+            morph::vec<float, 2> posn = (dist_per_pix * idx) + image_offset;
+            morph::vec<float, 2> _v_c = g.v_c[xi] - posn;
+            if (_v_c < threesig) {
+                expr += std::exp ( - ( (params[0] * _v_c[0] * _v_c[0]) + (params[1] * _v_c[1] * _v_c[1]) ) ) * image_data[i];
+            }
+        }
+        expr_resampled[xi] = expr;
+    }
+    expr_resampled /= expr_resampled.max();
+    return expr_resampled;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    // A random image
+    constexpr unsigned int im_w = 160;
+    constexpr unsigned int im_h = 120;
+    morph::vvec<float> image_data (im_w * im_h, 0.0f);
+    morph::RandUniform<float> rng (0.0f, 1.0f, 4242u);
+    for (auto& px : image_data) { px = rng.get(); }
+
+    morph::Grid g(100u, 80u, morph::vec<float, 2>{0.02f, 0.02f}, morph::vec<float, 2>{-0.3f, 0.1f});
+
+    morph::vec<float, 2> image_scale = { 1.2f, 1.2f };
+    morph::vec<float, 2> image_offset = { -0.1f, 0.05f };
+
+    using sc = std::chrono::steady_clock;
+    sc::time_point t0 = sc::now();
+    morph::vvec<float> fast = g.resample_image (image_data, im_w, image_scale, image_offset);
+    sc::time_point t1 = sc::now();
+    morph::vvec<float> brute = resample_brute (g, image_data, im_w, image_scale, image_offset);
+    sc::time_point t2 = sc::now();
+
+    std::cout << "Grid::resample_image: " << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count()
+              << " us; brute force: " << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << " us\n";
+
+    float maxdiff = (fast - brute).abs().max();
+    std::cout << "Max difference: " << maxdiff << std::endl;
+    if (fast.size() != brute.size() || maxdiff > 1e-5f) { rtn = -1; }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,140 @@
+/*
+ * Test morph::RandPhilox: the Philox4x32-10 known answers, streams, positions, bulk uniform and
+ * normal fills (which must not depend on the number of threads) and the vvec::randomize
+ * overloads that use it.
+ */
+
+#include <morph/Random.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <vector>
+#include <span>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+using sc = std::chrono::steady_clock;
+
+int main()
+{
+    int rtn = 0;
+
+    // Known answers from the Random123 library's kat_vectors
+    using b4 = morph::RandPhilox::block_type;
+    using k2 = morph::RandPhilox::key_type;
+    if (morph::RandPhilox::philox4x32_10 (b4{ 0, 0, 0, 0 }, k2{ 0, 0 }) != b4{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }
+        || morph::RandPhilox::philox4x32_10 (b4{ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, k2{ 0xffffffff, 0xffffffff })
+        != b4{ 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd }
+        || morph::RandPhilox::philox4x32_10 (b4{ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, k2{ 0xa4093822, 0x299f31d0 })
+        != b4{ 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }) {
+        std::cout << "Philox4x32-10 known answers are wrong\n";
+        --rtn;
+    }
+
+    // operator() works through the blocks in order; discard and set_position skip numbers
+    morph::RandPhilox rng (1234, 7);
+    std::vector<std::uint32_t> seq (23);
+    for (auto& x : seq) { x = rng(); }
+    morph::RandPhilox rng2 (1234, 7);
+    rng2.discard (5);
+    if (rng2() != seq[5]) { std::cout << "discard (5) is wrong\n"; --rtn; }
+    rng2.discard (10);
+    if (rng2() != seq[16]) { std::cout << "discard (10) is wrong\n"; --rtn; }
+    rng2.set_position (2);
+    if (rng2() != seq[8] || rng2.block (5)[2] != seq[22]) { std::cout << "set_position/block is wrong\n"; --rtn; }
+
+    // Streams are the same seed with a different counter
+    morph::RandPhilox s3 = rng.stream (3);
+    if (s3.get_seed() != 1234 || s3.get_stream() != 3 || s3.position() != 0) { std::cout << "stream (3) is wrong\n"; --rtn; }
+    if (s3() == morph::RandPhilox(1234, 7)()) { std::cout << "Streams 3 and 7 begin with the same number\n"; --rtn; }
+
+    // Fills are element i from block position + i / per_block
+    std::vector<float> f (10);
+    morph::RandPhilox rf (99);
+    rf.fill_uniform (std::span<float>{f});
+    if (rf.position() != 3) { std::cout << "fill of 10 floats should use 3 blocks\n"; --rtn; }
+    for (std::size_t i = 0; i < f.size(); ++i) {
+        const float expected = static_cast<float>(morph::RandPhilox(99).block (i / 4)[i % 4] >> 8) * 0x1p-24f;
+        if (f[i] != expected) { std::cout << "float " << i << " is " << f[i] << ", not " << expected << "\n"; --rtn; }
+    }
+
+    // Large fills must not depend on the number of threads, nor on being done in parts
+    constexpr std::size_t n = 2000001;
+    std::vector<float> u (n), z (n), u_ref, z_ref;
+    std::vector<double> zd (n), zd_ref;
+    auto do_fills = [&]() {
+        morph::RandPhilox r (2024);
+        r.fill_uniform (std::span<float>{u}, -1.0f, 3.0f);
+        r.fill_normal (std::span<float>{z}, 1.0f, 2.0f);
+        r.fill_normal (std::span<double>{zd});
+    };
+    sc::time_point t0 = sc::now();
+    do_fills();
+    sc::time_point t1 = sc::now();
+    u_ref = u; z_ref = z; zd_ref = zd;
+#ifdef _OPENMP
+    for (int nt : { 1, 2, 3, 8 }) {
+        omp_set_num_threads (nt);
+        do_fills();
+        if (u != u_ref || z != z_ref || zd != zd_ref) { std::cout << "Fills differ with " << nt << " threads\n"; --rtn; }
+    }
+#endif
+    {
+        morph::RandPhilox r (2024);
+        std::vector<float> parts (n);
+        r.fill_uniform (std::span<float>{parts}.first (1000), -1.0f, 3.0f);
+        r.fill_uniform (std::span<float>{parts}.subspan (1000), -1.0f, 3.0f);
+        if (parts != u_ref) { std::cout << "A fill in two parts (at a block boundary) differs\n"; --rtn; }
+    }
+
+    // Moments of the distributions
+    morph::vvec<float> vu, vz;
+    morph::vvec<double> vzd;
+    vu.set_from (u); vz.set_from (z); vzd.set_from (zd);
+    std::cout << "uniform [-1,3): mean " << vu.mean() << " var " << vu.variance() << " range " << vu.range()
+              << "; normal(1,2): mean " << vz.mean() << " sd " << vz.std() << "; normal(0,1) double: mean "
+              << vzd.mean() << " sd " << vzd.std() << "\n";
+    if (std::abs (vu.mean() - 1.0f) > 0.01f || std::abs (vu.variance() - 16.0f / 12.0f) > 0.01f
+        || vu.min() < -1.0f || vu.max() >= 3.0f) {
+        std::cout << "uniform fill has the wrong distribution\n";
+        --rtn;
+    }
+    if (std::abs (vz.mean() - 1.0f) > 0.01f || std::abs (vz.std() - 2.0f) > 0.01f) { std::cout << "float normal fill is wrong\n"; --rtn; }
+    if (std::abs (vzd.mean()) > 0.005 || std::abs (vzd.std() - 1.0) > 0.005) { std::cout << "double normal fill is wrong\n"; --rtn; }
+    // Fraction beyond 2 sigma should be 0.0455
+    std::size_t beyond = 0;
+    for (double x : zd) { beyond += std::abs (x) > 2.0 ? 1 : 0; }
+    if (std::abs (static_cast<double>(beyond) / n - 0.0455) > 0.001) { std::cout << "normal tails are wrong\n"; --rtn; }
+
+    // vvec::randomize with a RandPhilox is reproducible, and the integer version is in range
+    morph::vvec<double> va (1000), vb (1000);
+    morph::RandPhilox ra (5), rb (5);
+    va.randomizeN (0.0, 1.0, ra);
+    vb.randomizeN (0.0, 1.0, rb);
+    if (va != vb) { std::cout << "randomizeN with equal generators differs\n"; --rtn; }
+    va.randomize (ra);
+    if (va.min() < 0.0 || va.max() >= 1.0) { std::cout << "randomize (rng) is out of range\n"; --rtn; }
+    morph::vvec<int> vi (1000);
+    vi.randomize (-3, 3, ra);
+    if (vi.min() != -3 || vi.max() != 3) { std::cout << "integer randomize (-3, 3, rng) is wrong: " << vi.range() << "\n"; --rtn; }
+
+    // RandPhilox as the engine of a RandUniform
+    morph::RandUniform<float, morph::RandPhilox> rup (0.0f, 1.0f, 42);
+    morph::RandUniform<float, morph::RandPhilox> rup2 (0.0f, 1.0f, 42);
+    if (rup.get (5) != rup2.get (5)) { std::cout << "RandUniform<float, RandPhilox> is not reproducible\n"; --rtn; }
+
+    std::cout << "Uniform, normal float and normal double fills of " << n << " numbers: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() << " us\n";
+    morph::RandNormal<float, std::mt19937> rnorm (1.0f, 2.0f);
+    sc::time_point t2 = sc::now();
+    for (auto& x : z) { x = rnorm.get(); }
+    sc::time_point t3 = sc::now();
+    std::cout << "(RandNormal<float> takes " << std::chrono::duration_cast<std::chrono::microseconds>(t3 - t2).count()
+              << " us for the normal float fill alone)\n";
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -3,6 +3,7 @@
 #include <list>
 #include <array>
 #include <iostream>
+#include <span>
 #include "morph/scale.h"
 #include <cmath>
 
@@ -318,6 +319,37 @@ int main ()
     if (std::abs(for_scaling.min - r_itfromed.min) > std::numeric_limits<float>::epsilon()
         || std::abs(for_scaling.max - r_itfromed.max) > std::numeric_limits<float>::epsilon()) { --rtn; }
 
+    // The span transform gives the same results as the container transform, and autoscales
+    std::vector<int> ints = { 3, -2, 7, 10, 0, 4 };
+    std::vector<float> by_ctnr (ints.size());
+    std::vector<float> by_span (ints.size());
+    morph::scale<int, float> isc1;
+    isc1.do_autoscale = true;
+    isc1.transform (ints, by_ctnr);
+    morph::scale<int, float> isc2;
+    isc2.do_autoscale = true;
+    isc2.transform (std::span<const int>{ ints }, std::span<float>{ by_span });
+    if (by_span != by_ctnr || by_span[3] != 1.0f || by_span[1] != 0.0f) {
+        std::cout << "span transform differs from container transform\n";
+        --rtn;
+    }
+    std::vector<double> pos = { 0.1, 1.0, 10.0, 100.0 };
+    std::vector<double> log_ctnr (pos.size());
+    std::vector<double> log_span (pos.size());
+    morph::scale<double> lsc;
+    lsc.setlog();
+    lsc.do_autoscale = true;
+    lsc.transform (pos, log_ctnr);
+    lsc.transform (std::span<const double>{ pos }, std::span<double>{ log_span });
+    if (log_span != log_ctnr) { std::cout << "log span transform differs\n"; --rtn; }
+    bool span_threw = false;
+    try {
+        lsc.transform (std::span<const double>{ pos }, std::span<double>{ log_span }.first (2));
+    } catch (const std::exception&) {
+        span_threw = true;
+    }
+    if (!span_threw) { --rtn; }
+
     std::cout << "testScale " << (rtn == 0 ? "Passed" : "Failed") << std::endl;
     return rtn;
 }
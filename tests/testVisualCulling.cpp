@@ -0,0 +1,130 @@
+/*
+ * Test frustum culling and levels of detail. Models out of view must be culled without changing
+ * the rendered image, and a GeodesicVisual with coarser levels of detail must draw at full
+ * detail when it is close and at a coarser level when it is far away. Returns 77 (skip) if no
+ * EGL context can be created.
+ */
+// Include lodepng (with its decoder) before the Visual headers, which leave the decoder out
+#include <morph/lodepng.h>
+#include <morph/VisualHeadless.h>
+#include <morph/SphereVisual.h>
+#include <morph/GeodesicVisual.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <filesystem>
+
+constexpr int glver = morph::gl::version_4_1;
+constexpr int width = 200;
+constexpr int height = 150;
+
+// Render v and return the image
+std::vector<unsigned char> render_image (morph::VisualHeadless<glver>& v, const std::string& fname)
+{
+    v.render();
+    v.saveImage (fname);
+    std::vector<unsigned char> img;
+    unsigned int w = 0, h = 0;
+    if (lodepng::decode (img, w, h, fname) != 0) { throw std::runtime_error ("Failed to decode " + fname); }
+    return img;
+}
+
+int main()
+{
+    int rtn = 0;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "morph_testvisualculling";
+    std::filesystem::remove_all (dir);
+    std::filesystem::create_directories (dir);
+    const std::string fname = (dir / "frame.png").string();
+
+    try {
+        std::unique_ptr<morph::VisualHeadless<glver>> vp;
+        try {
+            vp = std::make_unique<morph::VisualHeadless<glver>> (width, height, "culling");
+        } catch (const std::exception& e) {
+            std::cout << "No headless OpenGL context (" << e.what() << "); skipping\n";
+            std::filesystem::remove_all (dir);
+            return 77;
+        }
+        morph::VisualHeadless<glver>& v = *vp;
+        v.backgroundWhite();
+
+        // A 20 by 20 array of spheres, most of which are out of view
+        std::vector<morph::SphereVisual<glver>*> spheres;
+        for (int i = 0; i < 20; ++i) {
+            for (int j = 0; j < 20; ++j) {
+                auto sv = std::make_unique<morph::SphereVisual<glver>> (morph::vec<float>{ (i - 3) * 0.3f, (j - 3) * 0.3f, -0.2f * (i % 3) },
+                                                                        0.1f, morph::colour::crimson);
+                v.bindmodel (sv);
+                sv->finalize();
+                spheres.push_back (v.addVisualModel (sv));
+            }
+        }
+        for (auto ptype : { morph::perspective_type::perspective, morph::perspective_type::orthographic }) {
+            v.ptype = ptype;
+            v.frustumCulling (true);
+            std::vector<unsigned char> culled = render_image (v, fname);
+            int n_culled = 0;
+            for (auto sv : spheres) { n_culled += sv->isCulled() ? 1 : 0; }
+            v.frustumCulling (false);
+            std::vector<unsigned char> all = render_image (v, fname);
+            std::cout << n_culled << " of " << spheres.size() << " spheres culled\n";
+            if (n_culled < 200 || n_culled == static_cast<int>(spheres.size())) {
+                std::cout << "Wrong number of spheres culled\n";
+                rtn = -1;
+            }
+            if (culled != all) {
+                std::cout << "Culling changed the image\n";
+                rtn = -1;
+            }
+        }
+        v.ptype = morph::perspective_type::perspective;
+        v.frustumCulling (true);
+        for (auto sv : spheres) { v.removeVisualModel (sv); }
+
+        // Geodesics with coarser levels of detail, coloured by face and by vertex
+        for (bool faces : { true, false }) {
+            auto gv = std::make_unique<morph::GeodesicVisual<float, glver>> (morph::vec<float>{ 0.0f, 0.0f, 0.0f }, 1.0f);
+            v.bindmodel (gv);
+            gv->iterations = 4;
+            gv->colourFaces = faces;
+            gv->detail_levels = 3;
+            gv->finalize();
+            gv->data.linspace (0.0f, 1.0f, gv->data.size());
+            gv->reinitColours();
+            auto gp = v.addVisualModel (gv);
+
+            v.setSceneTransZ (-4.0f);
+            render_image (v, fname);
+            const int lod_near = gp->levelOfDetail();
+            v.setSceneTransZ (-80.0f);
+            std::vector<unsigned char> far_lod = render_image (v, fname);
+            const int lod_far = gp->levelOfDetail();
+            std::cout << (faces ? "Face" : "Vertex") << " coloured geodesic: level of detail " << lod_near
+                      << " when near and " << lod_far << " when far\n";
+            if (lod_near != -1 || lod_far < 0) {
+                std::cout << "Wrong levels of detail\n";
+                rtn = -1;
+            }
+            // The coarse level looks much like the full detail model
+            v.frustumCulling (false);
+            std::vector<unsigned char> far_full = render_image (v, fname);
+            v.frustumCulling (true);
+            int n_diff = 0;
+            for (std::size_t i = 0; i < far_lod.size(); ++i) { n_diff += far_lod[i] != far_full[i] ? 1 : 0; }
+            if (gp->levelOfDetail() != -1 || n_diff > static_cast<int>(far_lod.size() / 100)) {
+                std::cout << "Coarse level of detail differs from full detail in " << n_diff << " bytes\n";
+                rtn = -1;
+            }
+            v.removeVisualModel (gp);
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Exception: " << e.what() << std::endl;
+        rtn = -1;
+    }
+
+    std::filesystem::remove_all (dir);
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
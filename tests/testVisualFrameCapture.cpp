@@ -0,0 +1,190 @@
+/*
+ * Test VisualOwnable::saveImageAsync, which reads frames back through pixel buffer objects and
+ * writes them on FrameWriter's worker threads. The PNG frames must match those written by
+ * saveImage, and frames appended to a raw frame file must hold the same pixels. This renders
+ * offscreen in a surfaceless EGL context and returns 77 (skip) if none can be created.
+ */
+// Include lodepng (with its decoder) before the Visual headers, which leave the decoder out
+#include <morph/lodepng.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+// VisualOwnable does not depend on any windowing system, but needs a window type
+struct GLFWwindow;
+namespace morph { using win_t = GLFWwindow; }
+
+#include <morph/VisualOwnableNoMX.h>
+#include <morph/TriangleVisual.h>
+#include <morph/FrameWriter.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <filesystem>
+
+constexpr int glver = morph::gl::version_4_1;
+
+int main()
+{
+    using sc = std::chrono::steady_clock;
+
+    auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress ("eglGetPlatformDisplayEXT"));
+    if (get_platform_display == nullptr) { std::cout << "No eglGetPlatformDisplayEXT; skipping\n"; return 77; }
+    EGLDisplay dpy = get_platform_display (EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    EGLint egl_major = 0, egl_minor = 0;
+    if (dpy == EGL_NO_DISPLAY || !eglInitialize (dpy, &egl_major, &egl_minor)) {
+        std::cout << "No surfaceless EGL display; skipping\n";
+        return 77;
+    }
+    eglBindAPI (EGL_OPENGL_API);
+    const EGLint ctx_attribs[] = { EGL_CONTEXT_MAJOR_VERSION, morph::gl::version::major (glver),
+                                   EGL_CONTEXT_MINOR_VERSION, morph::gl::version::minor (glver),
+                                   EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+    EGLContext ctx = eglCreateContext (dpy, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, ctx_attribs);
+    if (ctx == EGL_NO_CONTEXT || !eglMakeCurrent (dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx)) {
+        std::cout << "Could not make an OpenGL context current; skipping\n";
+        eglTerminate (dpy);
+        return 77;
+    }
+
+    int rtn = 0;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "morph_testframecapture";
+    std::filesystem::remove_all (dir);
+    std::filesystem::create_directories (dir);
+
+    try {
+        constexpr int width = 320;
+        constexpr int height = 240;
+        constexpr int frames = 20;
+        morph::VisualOwnableNoMX<glver> v;
+        v.init_glad (reinterpret_cast<GLADloadfunc>(eglGetProcAddress));
+
+        GLuint fbo = 0;
+        GLuint rbo[2] = { 0, 0 };
+        glGenFramebuffers (1, &fbo);
+        glBindFramebuffer (GL_FRAMEBUFFER, fbo);
+        glGenRenderbuffers (2, rbo);
+        glBindRenderbuffer (GL_RENDERBUFFER, rbo[0]);
+        glRenderbufferStorage (GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbo[0]);
+        glBindRenderbuffer (GL_RENDERBUFFER, rbo[1]);
+        glRenderbufferStorage (GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rbo[1]);
+        if (glCheckFramebufferStatus (GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            throw std::runtime_error ("Framebuffer is incomplete");
+        }
+
+        v.set_winsize (width, height);
+        v.init (nullptr);
+        v.backgroundBlack();
+
+        // A triangle that moves between frames, so that each frame differs
+        auto tv = std::make_unique<morph::TriangleVisual<glver>> (morph::vec<float>{ 0.0f, 0.0f, 0.0f },
+                                                                  morph::vec<float>{ -0.3f, -0.2f, 0.0f },
+                                                                  morph::vec<float>{ 0.3f, -0.2f, 0.0f },
+                                                                  morph::vec<float>{ 0.0f, 0.4f, 0.0f }, morph::colour::crimson);
+        v.bindmodel (tv);
+        tv->addLabel ("frame capture", { -0.3f, -0.3f, 0.0f }, morph::TextFeatures(0.05f));
+        tv->finalize();
+        auto tvp = v.addVisualModel (tv);
+
+        auto frame_name = [&dir](const std::string& prefix, int f) { return (dir / (prefix + std::to_string (f) + ".png")).string(); };
+        const std::string rawfile = (dir / "frames.rgba").string();
+
+        // Each frame with saveImage (which waits for the GPU and the PNG encoder)
+        sc::duration t_sync{0};
+        for (int f = 0; f < frames; ++f) {
+            tvp->setViewTranslation ({ 0.02f * f, 0.0f, 0.0f });
+            v.render();
+            sc::time_point t0 = sc::now();
+            v.saveImage (frame_name ("sync", f));
+            t_sync += sc::now() - t0;
+        }
+        // The same frames with saveImageAsync, as PNGs and into a raw frame file
+        sc::duration t_async{0};
+        for (int f = 0; f < frames; ++f) {
+            tvp->setViewTranslation ({ 0.02f * f, 0.0f, 0.0f });
+            v.render();
+            sc::time_point t0 = sc::now();
+            v.saveImageAsync (frame_name ("async", f));
+            v.saveImageAsync (rawfile);
+            t_async += sc::now() - t0;
+        }
+        v.finishImageWrites();
+        std::cout << frames << " frames; time in saveImage: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(t_sync).count() << " ms; in saveImageAsync (PNG and raw): "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(t_async).count() << " ms\n";
+
+        // Compare the PNGs
+        std::vector<std::vector<unsigned char>> sync_frames (frames);
+        for (int f = 0; f < frames && rtn == 0; ++f) {
+            std::vector<unsigned char> a;
+            unsigned int w = 0, h = 0, w2 = 0, h2 = 0;
+            if (lodepng::decode (sync_frames[f], w, h, frame_name ("sync", f)) != 0
+                || lodepng::decode (a, w2, h2, frame_name ("async", f)) != 0) {
+                std::cout << "Failed to decode frame " << f << std::endl;
+                rtn = -1;
+            } else if (w != width || h != height || w2 != w || h2 != h || a != sync_frames[f]) {
+                std::cout << "Async frame " << f << " differs from the saveImage frame\n";
+                rtn = -1;
+            }
+        }
+        if (rtn == 0 && sync_frames[0] == sync_frames[frames - 1]) {
+            std::cout << "The frames should differ\n";
+            rtn = -1;
+        }
+
+        // Check the raw frames. Each is a header followed by the same pixels as the PNG.
+        const std::size_t fbytes = morph::FrameWriter::raw_header_bytes + width * height * 4;
+        if (rtn == 0 && std::filesystem::file_size (rawfile) != frames * fbytes) {
+            std::cout << "Raw frame file is the wrong size\n";
+            rtn = -1;
+        }
+        std::ifstream fin (rawfile, std::ios::binary);
+        for (int f = 0; f < frames && rtn == 0; ++f) {
+            std::uint32_t hdr[4];
+            std::vector<unsigned char> px (width * height * 4);
+            fin.read (reinterpret_cast<char*>(hdr), sizeof (hdr));
+            fin.read (reinterpret_cast<char*>(px.data()), px.size());
+            if (std::memcmp (hdr, "MRGB", 4) != 0 || hdr[1] != width || hdr[2] != height || hdr[3] != 4) {
+                std::cout << "Bad header on raw frame " << f << std::endl;
+                rtn = -1;
+            } else if (px != sync_frames[f]) {
+                std::cout << "Raw frame " << f << " differs\n";
+                rtn = -1;
+            }
+        }
+        fin.close();
+
+        // A later session (a new FrameWriter) appends to the raw frame file
+        if (rtn == 0) {
+            morph::FrameWriter fw (1);
+            fw.push (std::move (sync_frames[0]), width, height, rawfile);
+            fw.wait();
+            if (fw.written() != 1 || std::filesystem::file_size (rawfile) != (frames + 1) * fbytes) {
+                std::cout << "Frame was not appended to the raw frame file\n";
+                rtn = -1;
+            }
+        }
+
+        if (glGetError() != GL_NO_ERROR) {
+            std::cout << "GL error\n";
+            rtn = -1;
+        }
+
+        v.deconstructCommon();
+        glDeleteRenderbuffers (2, rbo);
+        glDeleteFramebuffers (1, &fbo);
+    } catch (const std::exception& e) {
+        std::cout << "Exception: " << e.what() << std::endl;
+        rtn = -1;
+    }
+
+    std::filesystem::remove_all (dir);
+    eglMakeCurrent (dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext (dpy, ctx);
+    eglTerminate (dpy);
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,270 @@
+/*
+ * Test morph::VisualHeadless, which renders without a window into a framebuffer object. Images
+ * must have the requested size (which may be larger than any screen), a supersampled image must
+ * show the same scene with smoother edges, and two headless Visuals must be usable together,
+ * as must EGL contexts made in several threads. saveImageAsync must write the same pixels to PNG
+ * and raw frame files as saveImage.
+ * Returns 77 (skip) if no EGL context can be created.
+ */
+// Include lodepng (with its decoder) before the Visual headers, which leave the decoder out
+#include <morph/lodepng.h>
+#include <morph/VisualHeadless.h>
+#include <morph/TriangleVisual.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <morph/gl/egl_context.h>
+#include <morph/FrameWriter.h>
+
+constexpr int glver = morph::gl::version_4_1;
+
+// Add a triangle with a label to v
+void add_scene (morph::VisualHeadless<glver>& v)
+{
+    v.backgroundWhite();
+    auto tv = std::make_unique<morph::TriangleVisual<glver>> (morph::vec<float>{ 0.0f, 0.0f, 0.0f },
+                                                              morph::vec<float>{ -0.3f, -0.2f, 0.0f },
+                                                              morph::vec<float>{ 0.35f, -0.25f, 0.0f },
+                                                              morph::vec<float>{ 0.05f, 0.4f, 0.0f }, morph::colour::navy);
+    v.bindmodel (tv);
+    tv->addLabel ("headless", { -0.3f, -0.35f, 0.0f }, morph::TextFeatures(0.06f));
+    tv->finalize();
+    v.addVisualModel (tv);
+}
+
+// A triangle whose render() is overridden; it counts the calls and optionally calls the default render()
+struct counted_triangle : public morph::TriangleVisual<glver>
+{
+    counted_triangle (bool _call_base)
+        : morph::TriangleVisual<glver> (morph::vec<float>{ 0.0f, 0.0f, 0.0f }, morph::vec<float>{ -0.3f, -0.2f, 0.0f },
+                                        morph::vec<float>{ 0.35f, -0.25f, 0.0f }, morph::vec<float>{ 0.05f, 0.4f, 0.0f },
+                                        morph::colour::navy)
+        , call_base (_call_base) {}
+    void render() override
+    {
+        ++this->calls;
+        if (this->call_base) { morph::TriangleVisual<glver>::render(); }
+    }
+    bool call_base = true;
+    int calls = 0;
+};
+
+// Count the pixels that are neither pure white (background) nor the triangle's colour
+int count_edge_pixels (const std::vector<unsigned char>& img)
+{
+    int n = 0;
+    for (std::size_t i = 0; i < img.size(); i += 4) {
+        const bool white = img[i] == 255 && img[i + 1] == 255 && img[i + 2] == 255;
+        const bool navy = img[i] == 0 && img[i + 1] == 0 && img[i + 2] == 128;
+        if (!white && !navy) { ++n; }
+    }
+    return n;
+}
+
+int main()
+{
+    int rtn = 0;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "morph_testvisualheadless";
+    std::filesystem::remove_all (dir);
+    std::filesystem::create_directories (dir);
+
+    try {
+        constexpr int width = 200;
+        constexpr int height = 150;
+        std::unique_ptr<morph::VisualHeadless<glver>> vp;
+        try {
+            vp = std::make_unique<morph::VisualHeadless<glver>> (width, height, "plain");
+        } catch (const std::exception& e) {
+            std::cout << "No headless OpenGL context (" << e.what() << "); skipping\n";
+            std::filesystem::remove_all (dir);
+            return 77;
+        }
+        // A second Visual, rendering at 4x4 times the size and filtering down
+        morph::VisualHeadless<glver> vss (width, height, "supersampled", 4);
+        add_scene (*vp);
+        add_scene (vss);
+
+        const std::string f_plain = (dir / "plain.png").string();
+        const std::string f_ss = (dir / "ss.png").string();
+        const std::string f_ss_async = (dir / "ss_async.png").string();
+        vp->render();
+        vss.render();
+        morph::vec<int, 2> d1 = vp->saveImage (f_plain);
+        morph::vec<int, 2> d2 = vss.saveImage (f_ss);
+        vss.saveImageAsync (f_ss_async);
+        vss.finishImageWrites();
+        if (d1 != morph::vec<int, 2>{ width, height } || d2 != morph::vec<int, 2>{ width, height }) {
+            std::cout << "saveImage returned the wrong size: " << d1 << " and " << d2 << std::endl;
+            rtn = -1;
+        }
+
+        std::vector<unsigned char> plain, ss, ss_async;
+        unsigned int w = 0, h = 0, w2 = 0, h2 = 0, w3 = 0, h3 = 0;
+        if (lodepng::decode (plain, w, h, f_plain) != 0 || lodepng::decode (ss, w2, h2, f_ss) != 0
+            || lodepng::decode (ss_async, w3, h3, f_ss_async) != 0) {
+            throw std::runtime_error ("Failed to decode the images");
+        }
+        if (w != width || h != height || w2 != width || h2 != height || w3 != width || h3 != height) {
+            std::cout << "Saved images are the wrong size\n";
+            rtn = -1;
+        }
+        if (ss_async != ss) {
+            std::cout << "saveImageAsync differs from saveImage when supersampling\n";
+            rtn = -1;
+        }
+        // The same scene: the images differ only a little, at the edges
+        double mean_diff = 0.0;
+        for (std::size_t i = 0; i < plain.size() && i < ss.size(); ++i) {
+            mean_diff += std::abs (static_cast<int>(plain[i]) - static_cast<int>(ss[i]));
+        }
+        mean_diff /= static_cast<double>(plain.size());
+        const int edges_plain = count_edge_pixels (plain);
+        const int edges_ss = count_edge_pixels (ss);
+        std::cout << "Mean difference between plain and supersampled images: " << mean_diff
+                  << "; blended pixels: " << edges_plain << " (plain) " << edges_ss << " (supersampled)\n";
+        if (mean_diff > 8.0) {
+            std::cout << "Supersampled image differs too much\n";
+            rtn = -1;
+        }
+        // Supersampling blends the triangle's edges into the background
+        if (edges_ss <= edges_plain) {
+            std::cout << "Supersampled image has no smoother edges\n";
+            rtn = -1;
+        }
+
+        // The label doesn't overlap the triangle, so drawing all the texts after all the triangles
+        // (deferTexts) must give the same image as drawing each model's texts after its triangles
+        {
+            vp->options.set (morph::visual_options::deferTexts);
+            vp->render();
+            const std::string f_deferred = (dir / "deferred.png").string();
+            vp->saveImage (f_deferred);
+            vp->options.reset (morph::visual_options::deferTexts);
+            std::vector<unsigned char> deferred;
+            unsigned int wd = 0, hd = 0;
+            if (lodepng::decode (deferred, wd, hd, f_deferred) != 0 || deferred != plain) {
+                std::cout << "Image with deferred texts differs from the image with per-model texts\n";
+                rtn = -1;
+            }
+        }
+
+        // saveImageAsync into a raw frame file holds the same pixels as the PNG
+        const std::string f_raw = (dir / "ss.rgba").string();
+        vss.saveImageAsync (f_raw);
+        vss.finishImageWrites();
+        {
+            std::vector<unsigned char> raw (morph::FrameWriter::raw_header_bytes + ss.size());
+            std::ifstream fin (f_raw, std::ios::binary);
+            fin.read (reinterpret_cast<char*>(raw.data()), raw.size());
+            if (!fin || !std::equal (ss.begin(), ss.end(), raw.begin() + morph::FrameWriter::raw_header_bytes)) {
+                std::cout << "Raw frame from saveImageAsync differs from saveImage\n";
+                rtn = -1;
+            }
+        }
+
+        // An image larger than a typical screen
+        constexpr int big_w = 3000;
+        constexpr int big_h = 2000;
+        morph::VisualHeadless<glver> vbig (big_w, big_h, "big");
+        add_scene (vbig);
+        vbig.render();
+        const std::string f_big = (dir / "big.png").string();
+        if (vbig.saveImage (f_big) != morph::vec<int, 2>{ big_w, big_h }) {
+            std::cout << "Large image has the wrong size\n";
+            rtn = -1;
+        }
+
+        // Each Visual's context is still usable after the others have rendered
+        vp->render();
+        if (vp->saveImage (f_plain) != morph::vec<int, 2>{ width, height }) { rtn = -1; }
+
+        // EGL contexts made and destroyed in several threads at once share the display safely
+        {
+            std::atomic<int> failures = 0;
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back ([&failures]() {
+                    for (int i = 0; i < 5; ++i) {
+                        morph::gl::egl_context ctx;
+                        try {
+                            ctx.init (glver);
+                        } catch (const std::exception&) {
+                            ++failures;
+                        }
+                        ctx.deinit();
+                    }
+                });
+            }
+            for (auto& t : threads) { t.join(); }
+            if (failures > 0) {
+                std::cout << failures << " EGL contexts could not be made in threads\n";
+                rtn = -1;
+            }
+            // The Visuals' own contexts survive the threads' contexts coming and going
+            vp->render();
+            if (vp->saveImage (f_plain) != morph::vec<int, 2>{ width, height }) { rtn = -1; }
+        }
+
+        // Models that override render() are still rendered; one that calls the default render() is drawn
+        {
+            morph::VisualHeadless<glver> vo (width, height, "overridden");
+            vo.backgroundWhite();
+            auto t1 = std::make_unique<counted_triangle> (true);
+            auto t2 = std::make_unique<counted_triangle> (false);
+            vo.bindmodel (t1);
+            vo.bindmodel (t2);
+            t1->finalize();
+            t2->finalize();
+            counted_triangle* t1p = vo.addVisualModel (t1);
+            counted_triangle* t2p = vo.addVisualModel (t2);
+            vo.render();
+            const std::string f_over = (dir / "overridden.png").string();
+            vo.saveImage (f_over);
+            std::vector<unsigned char> over;
+            unsigned int wo = 0, ho = 0;
+            lodepng::decode (over, wo, ho, f_over);
+            int navy = 0;
+            for (std::size_t i = 0; i + 3 < over.size(); i += 4) {
+                if (over[i] == 0 && over[i + 1] == 0 && over[i + 2] == 128) { ++navy; }
+            }
+            if (t1p->calls != 1 || t2p->calls != 1 || navy == 0) {
+                std::cout << "Overridden render() calls: " << t1p->calls << " and " << t2p->calls
+                          << "; navy pixels: " << navy << std::endl;
+                rtn = -1;
+            }
+        }
+
+        // A pending saveImageAsync frame that can't be written is reported, not thrown, when the Visual is destroyed
+        {
+            morph::VisualHeadless<glver> vu (width, height, "unwritable");
+            add_scene (vu);
+            vu.render();
+            vu.saveImageAsync ((dir / "no_such_dir" / "frames.rgba").string());
+        }
+
+        // Bad sizes and supersample factors are rejected
+        bool threw = false;
+        try {
+            morph::VisualHeadless<glver> vbad (width, height, "bad", 3);
+        } catch (const std::exception&) {
+            threw = true;
+        }
+        if (!threw) {
+            std::cout << "A supersample factor of 3 was accepted\n";
+            rtn = -1;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Exception: " << e.what() << std::endl;
+        rtn = -1;
+    }
+
+    std::filesystem::remove_all (dir);
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,166 @@
+/*
+ * Test that HexGridVisual::updateData and GridVisual::reinitColours upload only the range of the
+ * vertex data that changes. Before each update, the GPU copies of the vertex buffers are filled
+ * with a sentinel value. After the update, the buffers must hold the new values over the
+ * changed range and the sentinel everywhere else. Returns 77 (skip) if no EGL context can be
+ * created.
+ */
+#include <morph/VisualHeadless.h>
+#include <morph/HexGrid.h>
+#include <morph/HexGridVisual.h>
+#include <morph/Grid.h>
+#include <morph/GridVisual.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+constexpr int glver = morph::gl::version_4_1;
+constexpr float sentinel = -7.0f;
+
+// A model M that can fill and read back the GPU copies of its position, normal and colour buffers
+template <typename M>
+struct Probed : public M
+{
+    template <typename... Args>
+    Probed (Args&&... args) : M (std::forward<Args>(args)...) {}
+
+    using VBOPos = typename M::VBOPos;
+    static constexpr VBOPos probed[3] = { M::posnVBO, M::normVBO, M::colVBO };
+
+    const std::vector<float>& cpu (const VBOPos vp) const
+    {
+        return vp == M::posnVBO ? this->vertexPositions : (vp == M::normVBO ? this->vertexNormals : this->vertexColors);
+    }
+
+    void fill_gpu()
+    {
+        this->setContext (this->parentVis);
+        GladGLContext* _glfn = this->get_glfn (this->parentVis);
+        for (VBOPos vp : probed) {
+            std::vector<float> s (this->cpu (vp).size(), sentinel);
+            _glfn->BindBuffer (GL_ARRAY_BUFFER, this->vbos[vp]);
+            _glfn->BufferSubData (GL_ARRAY_BUFFER, 0, s.size() * sizeof(float), s.data());
+        }
+        _glfn->BindBuffer (GL_ARRAY_BUFFER, 0);
+    }
+
+    std::vector<float> read_gpu (const VBOPos vp)
+    {
+        this->setContext (this->parentVis);
+        GladGLContext* _glfn = this->get_glfn (this->parentVis);
+        std::vector<float> g (this->cpu (vp).size());
+        _glfn->BindBuffer (GL_ARRAY_BUFFER, this->vbos[vp]);
+        _glfn->GetBufferSubData (GL_ARRAY_BUFFER, 0, g.size() * sizeof(float), g.data());
+        _glfn->BindBuffer (GL_ARRAY_BUFFER, 0);
+        return g;
+    }
+
+    /*!
+     * Check that the buffers hold every element that changed since \a before, and that the
+     * uploaded elements (those that are not the sentinel) are the single range from the first
+     * to the last change. Returns the number of elements uploaded, or -1 on failure.
+     */
+    int check (const std::array<std::vector<float>, 3>& before, const std::string& what)
+    {
+        int uploaded = 0;
+        for (unsigned int b = 0; b < 3; ++b) {
+            const std::vector<float>& c = this->cpu (probed[b]);
+            const std::vector<float> g = this->read_gpu (probed[b]);
+            std::size_t first = c.size();
+            std::size_t last = 0;
+            for (std::size_t i = 0; i < c.size(); ++i) {
+                if (c[i] != before[b][i]) { first = std::min (first, i); last = i; }
+            }
+            for (std::size_t i = 0; i < c.size(); ++i) {
+                const bool in_range = first <= last && i >= first && i <= last;
+                if ((in_range && g[i] != c[i]) || (!in_range && g[i] != sentinel)) {
+                    std::cerr << what << ": buffer " << b << " element " << i << " is " << g[i]
+                              << (in_range ? " but should have been uploaded\n" : " but should not have been uploaded\n");
+                    return -1;
+                }
+            }
+            if (first <= last) { uploaded += static_cast<int>(last - first + 1); }
+        }
+        return uploaded;
+    }
+
+    std::array<std::vector<float>, 3> snapshot() const
+    {
+        return { this->vertexPositions, this->vertexNormals, this->vertexColors };
+    }
+};
+
+int main()
+{
+    int rtn = 0;
+
+    std::unique_ptr<morph::VisualHeadless<glver>> vp;
+    try {
+        vp = std::make_unique<morph::VisualHeadless<glver>> (100, 100, "partial upload");
+    } catch (const std::exception& e) {
+        std::cout << "No headless OpenGL context (" << e.what() << "); skipping\n";
+        return 77;
+    }
+
+    // Changing one datum (within the range of the data) must change a few vertices of a flat model
+    auto run = [&rtn](auto& model, std::vector<float>& data, auto update, const std::string& what) {
+        const auto before = model.snapshot();
+        const std::size_t total = before[0].size() + before[1].size() + before[2].size();
+        model.fill_gpu();
+        data[data.size() / 2] = data[data.size() / 4];
+        update();
+        const int uploaded = model.check (before, what);
+        std::cout << what << ": uploaded " << uploaded << " of " << total << " floats\n";
+        if (uploaded <= 0 || static_cast<std::size_t>(uploaded) > total / 20) {
+            std::cerr << what << ": wrong amount of data uploaded\n";
+            rtn -= 1;
+        }
+    };
+
+    morph::HexGrid hg (0.02f, 1.0f, 0.0f);
+    hg.setCircularBoundary (0.3f);
+    for (morph::HexVisMode mode : { morph::HexVisMode::Triangles, morph::HexVisMode::HexInterp }) {
+        std::vector<float> data (hg.num());
+        for (unsigned int i = 0; i < hg.num(); ++i) { data[i] = static_cast<float>(i) / hg.num(); }
+        auto hgvp = std::make_unique<Probed<morph::HexGridVisual<float, glver>>> (&hg, morph::vec<float>{ 0.0f, 0.0f, 0.0f });
+        vp->bindmodel (hgvp);
+        hgvp->hexVisMode = mode;
+        hgvp->zScale.setParams (0.0f, 0.0f);
+        hgvp->setScalarData (&data);
+        hgvp->finalize();
+        auto hgv = vp->addVisualModel (hgvp);
+        vp->render(); // creates the buffers
+        run (*hgv, data, [&]() { hgv->updateData (&data); },
+             mode == morph::HexVisMode::Triangles ? "HexGridVisual (Triangles)" : "HexGridVisual (HexInterp)");
+        // Nothing changes, so nothing is uploaded
+        hgv->fill_gpu();
+        const auto before = hgv->snapshot();
+        hgv->updateData (&data);
+        if (hgv->check (before, "HexGridVisual, unchanged data") != 0) {
+            std::cerr << "HexGridVisual uploaded unchanged data\n";
+            rtn -= 1;
+        }
+    }
+
+    morph::Grid grid (40u, 30u, morph::vec<float, 2>{ 0.02f, 0.02f });
+    for (morph::GridVisMode mode : { morph::GridVisMode::Triangles, morph::GridVisMode::RectInterp }) {
+        std::vector<float> data (grid.n());
+        for (std::size_t i = 0; i < data.size(); ++i) { data[i] = static_cast<float>(i) / data.size(); }
+        auto gvp = std::make_unique<Probed<morph::GridVisual<float, unsigned int, float, glver>>> (&grid, morph::vec<float>{ 0.0f, 0.0f, 0.0f });
+        vp->bindmodel (gvp);
+        gvp->gridVisMode = mode;
+        gvp->setScalarData (&data);
+        gvp->finalize();
+        auto gv = vp->addVisualModel (gvp);
+        vp->render();
+        run (*gv, data, [&]() { gv->reinitColours(); },
+             mode == morph::GridVisMode::Triangles ? "GridVisual (Triangles)" : "GridVisual (RectInterp)");
+    }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
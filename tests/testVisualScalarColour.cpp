@@ -0,0 +1,98 @@
+/*
+ * Test colouring in the shader (VisualDataModel::gpuColourMap). Colours exported for glTF must be
+ * the colours the CPU gives, not the scalar_colour_flag, and a model with vertexScalars but no
+ * colour map must throw from finalize() (not from render(), which is noexcept). Returns 77 (skip)
+ * if no EGL context can be created.
+ */
+#include <morph/VisualHeadless.h>
+#include <morph/GridVisual.h>
+#include <morph/Grid.h>
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <cmath>
+
+constexpr int glver = morph::gl::version_4_1;
+
+// A model whose vertices are flagged for shader colouring, but which sets no colour map
+struct NoMapModel : public morph::VisualModel<glver>
+{
+    NoMapModel() : morph::VisualModel<glver> (morph::vec<float>{ 0.0f, 0.0f, 0.0f }) {}
+    void initializeVertices()
+    {
+        this->computeTetrahedron ({ 0.0f, 0.0f, 0.0f }, 0.1f, morph::colour::black);
+        this->vertexScalars.assign (this->vertexColors.size() / 3u, 0.5f);
+        for (std::size_t v = 0; v < this->vertexScalars.size(); ++v) { this->vertexColors[3 * v] = this->scalar_colour_flag; }
+    }
+};
+
+int main()
+{
+    int rtn = 0;
+
+    std::unique_ptr<morph::VisualHeadless<glver>> vp;
+    try {
+        vp = std::make_unique<morph::VisualHeadless<glver>> (100, 100, "scalar colour");
+    } catch (const std::exception& e) {
+        std::cout << "No headless OpenGL context (" << e.what() << "); skipping\n";
+        return 77;
+    }
+
+    morph::Grid grid (20u, 10u, morph::vec<float, 2>{ 0.05f, 0.05f });
+    std::vector<float> data (grid.n());
+    for (std::size_t i = 0; i < data.size(); ++i) { data[i] = static_cast<float>(i) / data.size(); }
+    data[7] = std::numeric_limits<float>::quiet_NaN();
+
+    // The same data, coloured on the CPU and in the shader
+    auto gv_cpu = std::make_unique<morph::GridVisual<float>> (&grid, morph::vec<float>{ 0.0f, 0.0f, 0.0f });
+    auto gv_gpu = std::make_unique<morph::GridVisual<float>> (&grid, morph::vec<float>{ 0.0f, 0.0f, 0.0f });
+    vp->bindmodel (gv_cpu);
+    vp->bindmodel (gv_gpu);
+    gv_gpu->gpuColourMap = true;
+    for (auto* gv : { gv_cpu.get(), gv_gpu.get() }) {
+        gv->gridVisMode = morph::GridVisMode::Triangles;
+        gv->cm.setType (morph::ColourMapType::Viridis);
+        gv->setScalarData (&data);
+        gv->finalize();
+    }
+    const std::vector<float> c_cpu = gv_cpu->export_colours();
+    const std::vector<float> c_gpu = gv_gpu->export_colours();
+    if (c_cpu.size() != c_gpu.size()) {
+        std::cerr << "Different numbers of exported colours\n";
+        rtn -= 1;
+    } else {
+        for (std::size_t i = 0; i < c_cpu.size(); ++i) {
+            if (c_gpu[i] < 0.0f) {
+                std::cerr << "scalar_colour_flag in exported colours at " << i << "\n";
+                rtn -= 1;
+                break;
+            }
+            if (std::abs (c_cpu[i] - c_gpu[i]) > 1e-6f) {
+                std::cerr << "Exported colour " << i << " is " << c_gpu[i] << ", not " << c_cpu[i] << "\n";
+                rtn -= 1;
+                break;
+            }
+        }
+    }
+    vp->addVisualModel (gv_cpu);
+    vp->addVisualModel (gv_gpu);
+
+    // No colour map for the flagged vertices
+    auto nm = std::make_unique<NoMapModel>();
+    vp->bindmodel (nm);
+    bool threw = false;
+    try {
+        nm->finalize();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        std::cerr << "finalize() did not throw for vertexScalars without a colour map\n";
+        rtn -= 1;
+    }
+
+    vp->render();
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,101 @@
+/*
+ * Test bootstrap::resample_statistic: results for a given seed must not depend on the number of
+ * threads, a custom statistic (including a bool one) may be used and the bootstrapped errors
+ * must match the parametric ones.
+ */
+
+#include <morph/bootstrap.h>
+#include <morph/sorting.h>
+#include <morph/vvec.h>
+#include <morph/vec.h>
+#include <iostream>
+#include <random>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+using sc = std::chrono::steady_clock;
+
+int main()
+{
+    int rtn = 0;
+
+    std::mt19937_64 gen (2023);
+    std::normal_distribution<double> dist (5.0, 1.0);
+    morph::vvec<double> data (2000);
+    for (auto& x : data) { x = dist (gen); }
+
+    constexpr std::uint64_t seed = 12345;
+    constexpr unsigned int B = 1000;
+
+    // A custom statistic: the median of each resample
+    auto median = [](const morph::vvec<double>& r) { return morph::sorting::median (r); };
+    std::vector<double> medians = morph::bootstrap<double>::resample_statistic (data, B, median, seed);
+    if (medians.size() != B) { std::cout << "Wrong number of resampled medians\n"; --rtn; }
+
+    // A bool statistic (which must not be written to a std::vector<bool> from several threads)
+    auto median_above = [median](const morph::vvec<double>& r) { return median (r) > 5.0; };
+    std::vector<bool> above = morph::bootstrap<double>::resample_statistic (data, B, median_above, seed);
+    bool above_ok = above.size() == B;
+    for (unsigned int b = 0; above_ok && b < B; ++b) { above_ok = above[b] == (medians[b] > 5.0); }
+    if (!above_ok) { std::cout << "bool statistic is wrong\n"; --rtn; }
+
+    // Same seed, same results, for any number of threads
+    const double eom = morph::bootstrap<double>::error_of_mean (data, B, seed);
+    const double eos = morph::bootstrap<double>::error_of_std (data, B, seed);
+    const morph::vec<double, 2> asl = morph::bootstrap<double>::ttest_equalityofmeans (data, data + 0.05, B, seed);
+#ifdef _OPENMP
+    for (int nt : { 1, 2, 3, 8 }) {
+        omp_set_num_threads (nt);
+        if (morph::bootstrap<double>::resample_statistic (data, B, median, seed) != medians
+            || morph::bootstrap<double>::resample_statistic (data, B, median_above, seed) != above
+            || morph::bootstrap<double>::error_of_mean (data, B, seed) != eom
+            || morph::bootstrap<double>::error_of_std (data, B, seed) != eos
+            || morph::bootstrap<double>::ttest_equalityofmeans (data, data + 0.05, B, seed) != asl) {
+            std::cout << "Results differ with " << nt << " threads\n";
+            --rtn;
+        }
+    }
+#endif
+    // A different seed gives different resamples
+    if (morph::bootstrap<double>::error_of_mean (data, B, seed + 1) == eom) { std::cout << "Seed has no effect\n"; --rtn; }
+
+    // The bootstrapped errors against the parametric ones: sigma/sqrt(n) for the mean and
+    // roughly sigma/sqrt(2(n-1)) for the standard deviation of normal data.
+    const double sd = data.std();
+    const double eom_ref = sd / std::sqrt (static_cast<double>(data.size()));
+    const double eos_ref = sd / std::sqrt (2.0 * static_cast<double>(data.size() - 1));
+    std::cout << "error of mean " << eom << " (expect " << eom_ref << "), error of std " << eos << " (expect " << eos_ref << ")\n";
+    if (std::abs (eom - eom_ref) > 0.1 * eom_ref) { std::cout << "error_of_mean is wrong\n"; --rtn; }
+    if (std::abs (eos - eos_ref) > 0.15 * eos_ref) { std::cout << "error_of_std is wrong\n"; --rtn; }
+    // The error of the median of normal data is about 1.2533 times the error of the mean
+    morph::vvec<double> vmedians;
+    vmedians.set_from (medians);
+    if (std::abs (vmedians.std() - 1.2533 * eom_ref) > 0.15 * 1.2533 * eom_ref) {
+        std::cout << "bootstrapped error of median " << vmedians.std() << " is wrong\n";
+        --rtn;
+    }
+    if (asl[0] < 0.01) { std::cout << "Means differing by 0.05 sigma were found significantly different\n"; --rtn; }
+
+    // Empty data gives default statistics
+    morph::vvec<double> empty;
+    std::vector<double> emeans = morph::bootstrap<double>::resample_statistic (empty, 10, [](const morph::vvec<double>& r) { return r.mean(); }, seed);
+    if (emeans.size() != 10 || emeans[0] != 0.0) { std::cout << "Empty data is not handled\n"; --rtn; }
+
+    // A large problem, where storing every resample would need B * n * 8 bytes (800 MB here)
+    morph::vvec<double> big (100000);
+    for (auto& x : big) { x = dist (gen); }
+    sc::time_point t0 = sc::now();
+    const double eom_big = morph::bootstrap<double>::error_of_mean (big, B, seed);
+    sc::time_point t1 = sc::now();
+    std::cout << "error_of_mean with " << B << " resamples of " << big.size() << " values: " << eom_big << " in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << " ms\n";
+    const double eom_big_ref = big.std() / std::sqrt (static_cast<double>(big.size()));
+    if (std::abs (eom_big - eom_big_ref) > 0.1 * eom_big_ref) { std::cout << "error_of_mean of large data is wrong\n"; --rtn; }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,131 @@
+/*
+ * Test the extendable, chunked and compressed series datasets of HdfData (create_series,
+ * append_frame and read_frames) and compare the file size with the one dataset per frame
+ * approach.
+ */
+#include "morph/HdfData.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <filesystem>
+
+// A smooth test frame, like an RD model variable
+std::vector<float> make_frame (unsigned int f, unsigned int n)
+{
+    std::vector<float> frame (n);
+    for (unsigned int i = 0; i < n; ++i) {
+        frame[i] = std::sin (0.01f * static_cast<float>(i) + 0.1f * static_cast<float>(f));
+    }
+    return frame;
+}
+
+int main()
+{
+    int rtn = 0;
+    constexpr unsigned int n = 20000;
+    constexpr unsigned int nframes = 40;
+
+    try {
+        // Write a series of frames, and the same frames as one dataset per frame
+        {
+            morph::HdfData data ("testseries.h5");
+            data.create_series<float> ("/model/c", { n }, 8, 4, true);
+            data.create_series<float> ("/model/c_wide", { n }, 8, 0, false, false);
+            for (unsigned int f = 0; f < nframes / 2; ++f) {
+                data.append_frame ("/model/c", make_frame (f, n));
+                data.append_frame ("/model/c_wide", make_frame (f, n));
+            }
+            // The frames written so far are readable before the file is closed
+            if (data.series_length ("/model/c") != nframes / 2) {
+                std::cout << "Wrong series length while writing\n";
+                rtn = -1;
+            }
+        }
+        // Append to the series in a later session
+        {
+            morph::HdfData data ("testseries.h5", morph::FileAccess::ReadWrite);
+            for (unsigned int f = nframes / 2; f < nframes; ++f) {
+                data.append_frame ("/model/c", make_frame (f, n));
+            }
+            std::vector<float> two = make_frame (0, n);
+            std::vector<float> two2 = make_frame (1, n);
+            two.insert (two.end(), two2.begin(), two2.end());
+            data.append_frames ("/model/c_wide", two.data(), two.size());
+            // A partial frame is an error
+            bool threw = false;
+            try {
+                data.append_frames ("/model/c", two.data(), n / 2);
+            } catch (const std::exception&) {
+                threw = true;
+            }
+            if (!threw) {
+                std::cout << "Partial frame was accepted\n";
+                rtn = -1;
+            }
+        }
+        {
+            morph::HdfData data ("testframes.h5");
+            for (unsigned int f = 0; f < nframes; ++f) {
+                std::string path = "/model/c_" + std::to_string (f);
+                data.add_contained_vals (path.c_str(), make_frame (f, n));
+            }
+        }
+
+        const auto ssize = std::filesystem::file_size ("testseries.h5");
+        const auto fsize = std::filesystem::file_size ("testframes.h5");
+        std::cout << nframes << " frames of " << n << " floats. Series (with a widened, uncompressed copy of "
+                  << (nframes / 2 + 2) << " frames): " << ssize << " bytes; one dataset per frame: " << fsize << " bytes\n";
+
+        // Read back a range of frames
+        {
+            morph::HdfData data ("testseries.h5", morph::FileAccess::ReadOnly);
+            if (data.series_length ("/model/c") != nframes || data.series_length ("/model/c_wide") != nframes / 2 + 2) {
+                std::cout << "Wrong series lengths\n";
+                rtn = -1;
+            }
+            std::vector<float> got;
+            data.read_frames ("/model/c", 17, 6, got);
+            if (got.size() != 6 * n) {
+                std::cout << "Wrong number of values read\n";
+                rtn = -1;
+            } else {
+                for (unsigned int f = 0; f < 6; ++f) {
+                    std::vector<float> expected = make_frame (17 + f, n);
+                    if (!std::equal (expected.begin(), expected.end(), got.begin() + f * n)) {
+                        std::cout << "Frame " << (17 + f) << " differs\n";
+                        rtn = -1;
+                    }
+                }
+            }
+            // The widened (64 bit) series reads back into doubles or floats
+            std::vector<double> gotd;
+            data.read_frames ("/model/c_wide", nframes / 2, 2, gotd);
+            std::vector<float> expected = make_frame (0, n);
+            for (unsigned int i = 0; i < n; ++i) {
+                if (gotd[i] != static_cast<double>(expected[i])) {
+                    std::cout << "Widened frame differs\n";
+                    rtn = -1;
+                    break;
+                }
+            }
+            // Out of range reads throw
+            bool threw = false;
+            try {
+                data.read_frames ("/model/c", nframes - 1, 2, got);
+            } catch (const std::exception&) {
+                threw = true;
+            }
+            if (!threw) {
+                std::cout << "Out of range read did not throw\n";
+                rtn = -1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Exception: " << e.what() << std::endl;
+        rtn = -1;
+    }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,109 @@
+/*
+ * Test the HdfData writes from std::span (straight from the caller's memory) and
+ * HdfData::read_into, which reads into caller-owned buffers.
+ */
+#include "morph/HdfData.h"
+#include <morph/vvec.h>
+#include <morph/vec.h>
+#include <iostream>
+#include <vector>
+#include <list>
+#include <span>
+
+int main()
+{
+    int rtn = 0;
+
+    std::vector<float> vf (1000);
+    for (unsigned int i = 0; i < vf.size(); ++i) { vf[i] = 0.5f * i; }
+    morph::vvec<morph::vec<double, 3>> vv3 (100);
+    for (unsigned int i = 0; i < vv3.size(); ++i) { vv3[i] = { 1.0 * i, 2.0 * i, 3.0 * i }; }
+    int carray[6] = { 1, 2, 3, 4, 5, 6 };
+
+    try {
+        {
+            morph::HdfData data ("testspan.h5");
+            data.add_contained_vals ("/vf", std::span<const float>(vf));
+            data.add_contained_vals ("/vf_part", std::span<float>(vf).subspan (100, 50));
+            data.add_contained_vals ("/vf_2d", std::span<const float>(vf), 10);
+            data.add_contained_vals ("/vv3", std::span<morph::vec<double, 3>>(vv3));
+            // Writing from a const buffer
+            const morph::vvec<morph::vec<double, 3>>& cvv3 = vv3;
+            data.add_contained_vals ("/vv3_const", std::span<const morph::vec<double, 3>>(cvv3));
+            const int ccarray[4] = { 7, 8, 9, 10 };
+            data.add_contained_vals ("/ccarray", std::span<const int, 4>(ccarray));
+            data.add_contained_vals ("/carray", std::span<int, 6>(carray), 3);
+            // The Container overload writes a std::vector or vvec without a copy, too
+            data.add_contained_vals ("/vf_container", vf);
+        }
+
+        morph::HdfData data ("testspan.h5", morph::FileAccess::ReadOnly);
+
+        std::vector<float> buf (1000);
+        data.read_into ("/vf", std::span<float>(buf));
+        if (buf != vf) { std::cout << "/vf differs\n"; rtn = -1; }
+
+        // Read a 2D dataset into a flat buffer, and a 1D dataset into part of a buffer
+        std::vector<float> buf2 (1000, 0.0f);
+        data.read_into ("/vf_2d", std::span<float>(buf2));
+        if (buf2 != vf) { std::cout << "/vf_2d differs\n"; rtn = -1; }
+        std::vector<float> buf3 (200, -1.0f);
+        data.read_into ("/vf_part", std::span<float>(buf3).subspan (10, 50));
+        if (buf3[9] != -1.0f || buf3[10] != vf[100] || buf3[59] != vf[149] || buf3[60] != -1.0f) {
+            std::cout << "/vf_part differs\n";
+            rtn = -1;
+        }
+
+        morph::vvec<morph::vec<double, 3>> vv3read (100);
+        data.read_into ("/vv3", std::span<morph::vec<double, 3>>(vv3read));
+        if (vv3read != vv3) { std::cout << "/vv3 differs\n"; rtn = -1; }
+        data.read_into ("/vv3_const", std::span<morph::vec<double, 3>>(vv3read));
+        if (vv3read != vv3) { std::cout << "/vv3_const differs\n"; rtn = -1; }
+        std::vector<int> cbuf (4);
+        data.read_into ("/ccarray", std::span<int>(cbuf));
+        if (cbuf != std::vector<int>{ 7, 8, 9, 10 }) { std::cout << "/ccarray differs\n"; rtn = -1; }
+        // Which is the same data as read_contained_vals gives
+        morph::vvec<morph::vec<double, 3>> vv3read2;
+        data.read_contained_vals ("/vv3", vv3read2);
+        if (vv3read2 != vv3) { std::cout << "/vv3 (read_contained_vals) differs\n"; rtn = -1; }
+
+        std::array<int, 6> ci;
+        data.read_into ("/carray", std::span<int>(ci));
+        if (ci[0] != 1 || ci[5] != 6) { std::cout << "/carray differs\n"; rtn = -1; }
+
+        morph::vvec<float> vvf;
+        data.read_contained_vals ("/vf_container", vvf);
+        std::list<float> lf;
+        data.read_contained_vals ("/vf_container", lf);
+        if (vvf.size() != vf.size() || !std::equal (vf.begin(), vf.end(), vvf.begin())
+            || !std::equal (vf.begin(), vf.end(), lf.begin())) {
+            std::cout << "/vf_container differs\n";
+            rtn = -1;
+        }
+
+        // Buffers of the wrong size are errors
+        bool threw = false;
+        try {
+            std::vector<float> small (999);
+            data.read_into ("/vf", std::span<float>(small));
+        } catch (const std::exception&) {
+            threw = true;
+        }
+        if (!threw) { std::cout << "Wrong size buffer was accepted\n"; rtn = -1; }
+        threw = false;
+        try {
+            std::vector<morph::vec<float, 2>> wrongcols (150);
+            data.read_into ("/vv3", std::span<morph::vec<float, 2>>(wrongcols));
+        } catch (const std::exception&) {
+            threw = true;
+        }
+        if (!threw) { std::cout << "Wrong number of columns was accepted\n"; rtn = -1; }
+
+    } catch (const std::exception& e) {
+        std::cout << "Exception: " << e.what() << std::endl;
+        rtn = -1;
+    }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,51 @@
+/*
+ * Test morph::hexarena: list order, erase, and the reserve() guarantee that held iterators
+ * are never invalidated by the storage growing.
+ */
+#include <morph/hexarena.h>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+int main()
+{
+    int rtn = 0;
+
+    morph::hexarena<int> a;
+    for (int i = 0; i < 10; ++i) { a.push_back (i); }
+    // Erase the odd numbers; the storage is not reclaimed
+    for (auto it = a.begin(); it != a.end();) { it = (*it % 2) ? a.erase (it) : ++it; }
+    std::vector<int> got (a.begin(), a.end());
+    if (got != std::vector<int>{ 0, 2, 4, 6, 8 } || a.size() != 5 || a.capacity_used() != 10) {
+        std::cout << "push_back/erase gave the wrong list\n";
+        --rtn;
+    }
+
+    // reserve counts the elements already held, erased ones included, so n more fit without
+    // reallocating and held iterators stay valid
+    a.reserve (20);
+    auto held = a.begin();
+    const int* held_ptr = &*held;
+    for (int i = 0; i < 20; ++i) { a.emplace_back (100 + i); }
+    if (&*held != held_ptr || *held != 0 || a.size() != 25 || a.back() != 119) {
+        std::cout << "Iterators were invalidated within the reserved storage\n";
+        --rtn;
+    }
+
+    // Growing past the reservation would invalidate held iterators, so it throws
+    bool threw = false;
+    try {
+        while (true) { a.push_back (-1); }
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw || *held != 0) { std::cout << "Insertion beyond the reserved storage didn't throw\n"; --rtn; }
+
+    // clear() lifts the restriction
+    a.clear();
+    for (int i = 0; i < 1000; ++i) { a.push_back (i); }
+    if (a.size() != 1000 || a.front() != 0 || a.back() != 999) { std::cout << "clear() didn't reset the arena\n"; --rtn; }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,79 @@
+/*
+ * Test that a precompiled HexGrid::convolution_plan gives the same result as
+ * HexGrid::convolve with a kernel HexGrid.
+ */
+#include <morph/HexGrid.h>
+#include <morph/Random.h>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+int main()
+{
+    int rtn = 0;
+
+    morph::HexGrid hg(0.01f, 3.0f, 0.0f);
+    hg.setEllipticalBoundary (0.45f, 0.3f);
+
+    std::vector<float> data (hg.num(), 0.0f);
+    morph::RandUniform<float> rng;
+    for (float& d : data) { d = rng.get(); }
+
+    // Gaussian kernel on a small circular HexGrid
+    float sigma = 0.025f;
+    morph::HexGrid kernel(0.01f, 20.0f * sigma, 0.0f);
+    kernel.setCircularBoundary (6.0f * sigma);
+    std::vector<float> kerneldata (kernel.num(), 0.0f);
+    float ksum = 0.0f;
+    for (auto& k : kernel.hexen) {
+        kerneldata[k.vi] = std::exp (-(k.r * k.r) / (2.0f * sigma * sigma));
+        ksum += kerneldata[k.vi];
+    }
+    for (auto& k : kernel.hexen) { kerneldata[k.vi] /= ksum; }
+
+    std::vector<float> convolved (hg.num(), 0.0f);
+    using sc = std::chrono::steady_clock;
+    sc::time_point t0 = sc::now();
+    hg.convolve (kernel, kerneldata, data, convolved);
+    sc::time_point t1 = sc::now();
+
+    morph::HexGrid::convolution_plan<float> plan = hg.compile_convolution (kernel, kerneldata);
+    sc::time_point t2 = sc::now();
+
+    std::vector<float> convolved_p (hg.num(), 0.0f);
+    hg.convolve (plan, data, convolved_p);
+    sc::time_point t3 = sc::now();
+
+    std::cout << "Convolution of " << hg.num() << " hexes with a " << kernel.num() << " hex kernel:\n"
+              << "  convolve (kernelgrid...): " << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() << " us\n"
+              << "  compile_convolution:      " << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << " us\n"
+              << "  convolve (plan...):       " << std::chrono::duration_cast<std::chrono::microseconds>(t3 - t2).count() << " us\n";
+
+    if (plan.start.size() != hg.num() + 1 || plan.idx.size() != plan.w.size()) {
+        std::cout << "Plan has wrong shape\n";
+        rtn = -1;
+    }
+
+    for (unsigned int i = 0; i < hg.num(); ++i) {
+        if (std::abs (convolved[i] - convolved_p[i]) > 1e-5f) {
+            std::cout << "Mismatch at " << i << ": " << convolved[i] << " vs " << convolved_p[i] << std::endl;
+            rtn = -1;
+            break;
+        }
+    }
+
+    // A delta kernel must reproduce the data exactly
+    morph::HexGrid delta(0.01f, 0.05f, 0.0f);
+    std::vector<float> deltadata (delta.num(), 0.0f);
+    for (auto& k : delta.hexen) { if (k.ri == 0 && k.gi == 0) { deltadata[k.vi] = 1.0f; } }
+    morph::HexGrid::convolution_plan<float> dplan = hg.compile_convolution (delta, deltadata);
+    hg.convolve (dplan, data, convolved_p);
+    if (convolved_p != data) {
+        std::cout << "Delta kernel did not reproduce the data\n";
+        rtn = -1;
+    }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
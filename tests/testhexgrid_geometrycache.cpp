@@ -0,0 +1,125 @@
+/*
+ * Test HexGrid::save_geometry and HexGrid::load_geometry: a grid loaded from a geometry cache
+ * file must match the grid that was saved, and a cache file with the wrong key or a damaged
+ * cache file must be rejected.
+ */
+#include <morph/HexGrid.h>
+#include <morph/ReadCurves.h>
+#include <morph/gridcache.h>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <list>
+#include <algorithm>
+
+using sc = std::chrono::steady_clock;
+
+int compare (const morph::HexGrid& a, const morph::HexGrid& b)
+{
+    if (a.num() != b.num() || a.getd() != b.getd() || a.getv() != b.getv()) { return -1; }
+    if (a.d_x != b.d_x || a.d_y != b.d_y || a.d_ri != b.d_ri || a.d_gi != b.d_gi || a.d_bi != b.d_bi
+        || a.d_flags != b.d_flags || a.d_distToBoundary != b.d_distToBoundary
+        || a.d_ne != b.d_ne || a.d_nne != b.d_nne || a.d_nnw != b.d_nnw
+        || a.d_nw != b.d_nw || a.d_nsw != b.d_nsw || a.d_nse != b.d_nse || a.d_nbr != b.d_nbr) {
+        std::cout << "d_ vectors differ\n";
+        return -1;
+    }
+    if (a.originalBoundaryCentroid != b.originalBoundaryCentroid || a.boundaryCentroid != b.boundaryCentroid) {
+        std::cout << "Boundary centroids differ\n";
+        return -1;
+    }
+    // The boundary hexes, in order
+    std::list<morph::Hex> ba = a.getBoundary();
+    std::list<morph::Hex> bb = b.getBoundary();
+    if (ba.empty() || ba.size() != bb.size()
+        || !std::equal (ba.begin(), ba.end(), bb.begin(), [](const morph::Hex& p, const morph::Hex& q) { return p.vi == q.vi; })) {
+        std::cout << "Boundary hexes differ (" << ba.size() << " vs " << bb.size() << ")\n";
+        return -1;
+    }
+    auto ha = a.hexen.begin();
+    auto hb = b.hexen.begin();
+    for (; ha != a.hexen.end(); ++ha, ++hb) {
+        if (ha->ri != hb->ri || ha->gi != hb->gi || ha->x != hb->x || ha->y != hb->y || ha->vi != hb->vi
+            || ha->getFlags() != hb->getFlags() || ha->distToBoundary != hb->distToBoundary) {
+            std::cout << "Hexes differ\n";
+            return -1;
+        }
+        for (unsigned short n = 0; n < 6; ++n) {
+            if (ha->has_neighbour (n) && ha->get_neighbour (n)->vi != hb->get_neighbour (n)->vi) {
+                std::cout << "Hex neighbours differ\n";
+                return -1;
+            }
+        }
+    }
+    if (b.vhexen.size() != b.num() || b.vhexen[b.num() - 1] != &b.hexen.back()) { return -1; }
+    return 0;
+}
+
+int main()
+{
+    int rtn = 0;
+    const std::string svg = "../../tests/trial.svg";
+    const std::string dir = (std::filesystem::temp_directory_path() / "morph_testgridcache").string();
+    std::filesystem::create_directories (dir);
+
+    try {
+        const float d = 0.005f;
+        const float span = 3.0f;
+        const std::uint64_t key = morph::gridcache::key (d, span, morph::gridcache::hash_file (svg));
+        const std::string cachefile = morph::gridcache::filename (dir, "hexgrid", key);
+
+        sc::time_point t0 = sc::now();
+        morph::ReadCurves r(svg);
+        morph::HexGrid hg (d, span, 0.0f);
+        hg.setBoundary (r.getCorticalPath());
+        hg.computeDistanceToBoundary();
+        sc::time_point t1 = sc::now();
+        hg.save_geometry (cachefile, key);
+
+        sc::time_point t2 = sc::now();
+        morph::HexGrid hg2;
+        if (!hg2.load_geometry (cachefile, key)) {
+            std::cout << "Failed to load " << cachefile << std::endl;
+            rtn = -1;
+        }
+        sc::time_point t3 = sc::now();
+        std::cout << hg.num() << " hexes. Build: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << " ms; load from cache: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(t3 - t2).count() << " us\n";
+        if (rtn == 0 && compare (hg, hg2) != 0) {
+            std::cout << "Loaded grid differs from saved grid\n";
+            rtn = -1;
+        }
+        // The loaded grid must be usable; e.g. for neighbour walks and nearest-hex lookups
+        if (rtn == 0 && hg2.findHexNearest ({0.1f, 0.1f})->vi != hg.findHexNearest ({0.1f, 0.1f})->vi) {
+            std::cout << "findHexNearest differs\n";
+            rtn = -1;
+        }
+
+        // A different key must not load
+        morph::HexGrid hg3;
+        if (hg3.load_geometry (cachefile, key + 1) || hg3.num() != 0) {
+            std::cout << "Loaded with the wrong key\n";
+            rtn = -1;
+        }
+        // Nor must a missing file
+        if (hg3.load_geometry (dir + "/nonexistent.bin", key)) {
+            std::cout << "Loaded a missing file\n";
+            rtn = -1;
+        }
+        // Nor a truncated file
+        std::filesystem::resize_file (cachefile, std::filesystem::file_size (cachefile) / 2);
+        if (hg3.load_geometry (cachefile, key)) {
+            std::cout << "Loaded a truncated file\n";
+            rtn = -1;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Exception: " << e.what() << std::endl;
+        rtn = -1;
+    }
+
+    std::filesystem::remove_all (dir);
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
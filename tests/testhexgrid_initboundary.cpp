@@ -0,0 +1,227 @@
+/*
+ * Test that building a HexGrid directly from a boundary (HexGrid::init with boundary points,
+ * or the HexGrid constructor that takes a BezCurvePath) gives the same hexes, boundary flags
+ * and neighbour relations as building the full hexagonal grid and then calling setBoundary.
+ * Also reports the startup time of each approach.
+ */
+#include <morph/HexGrid.h>
+#include <morph/ReadCurves.h>
+#include <iostream>
+#include <map>
+#include <set>
+#include <cmath>
+#include <array>
+#include <chrono>
+
+using sc = std::chrono::steady_clock;
+
+// The hexes of a HexGrid keyed by (ri, gi), with boundary flag and neighbour (ri, gi)s
+using hexsummary = std::map<std::array<int, 2>, std::array<int, 13>>;
+
+hexsummary summarise (const morph::HexGrid& hg)
+{
+    hexsummary s;
+    for (const morph::Hex& h : hg.hexen) {
+        std::array<int, 13> v;
+        v.fill (0);
+        v[0] = h.testFlags (HEX_IS_BOUNDARY) ? 1 : 0;
+        for (unsigned short n = 0; n < 6; ++n) {
+            if (h.has_neighbour (n)) {
+                v[1 + 2 * n] = h.get_neighbour (n)->ri;
+                v[2 + 2 * n] = h.get_neighbour (n)->gi;
+            } else {
+                v[1 + 2 * n] = 9999;
+            }
+        }
+        s[{h.ri, h.gi}] = v;
+    }
+    return s;
+}
+
+int compare (const morph::HexGrid& a, const morph::HexGrid& b, const std::string& what)
+{
+    if (a.num() != b.num()) {
+        std::cout << what << ": " << a.num() << " hexes vs " << b.num() << std::endl;
+        return -1;
+    }
+    if (summarise (a) != summarise (b)) {
+        std::cout << what << ": hexes, boundary flags or neighbours differ\n";
+        return -1;
+    }
+    // The boundary hexes found by the contiguity check
+    if (a.getBoundary().size() != b.getBoundary().size()) {
+        std::cout << what << ": " << a.getBoundary().size() << " boundary hexes vs " << b.getBoundary().size() << std::endl;
+        return -1;
+    }
+    // d_ vectors must be consistent with hexen
+    for (const morph::Hex& h : b.hexen) {
+        if (b.d_x[h.vi] != h.x || b.d_y[h.vi] != h.y) {
+            std::cout << what << ": d_ vectors inconsistent\n";
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    int rtn = 0;
+    auto ms = [](sc::time_point t0, sc::time_point t1) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+    };
+
+    // An elliptical boundary
+    {
+        constexpr float d = 0.004f;
+        sc::time_point t0 = sc::now();
+        morph::HexGrid hg (d, 3.0f, 0.0f);
+        hg.setEllipticalBoundary (1.2f, 0.9f);
+        sc::time_point t1 = sc::now();
+
+        std::vector<morph::BezCoord<float>> bpoints = hg.ellipseCompute (1.2f, 0.9f);
+        sc::time_point t2 = sc::now();
+        morph::HexGrid hg2;
+        hg2.init (d, 3.0f, 0.0f, bpoints);
+        sc::time_point t3 = sc::now();
+
+        std::cout << "Ellipse, " << hg.num() << " hexes:\n"
+                  << "  HexGrid + setEllipticalBoundary: " << ms (t0, t1) << " ms\n"
+                  << "  HexGrid::init with boundary:     " << ms (t2, t3) << " ms\n";
+        rtn += compare (hg, hg2, "Ellipse");
+
+        t0 = sc::now();
+        hg.computeDistanceToBoundary();
+        t1 = sc::now();
+        std::cout << "  computeDistanceToBoundary:       " << ms (t0, t1) << " ms\n";
+    }
+
+    // findHexAt and getRegion walk from the hex at the origin, which init_from_boundary does not
+    // create first. They must give the same hexes on both grids.
+    {
+        constexpr float d = 0.02f;
+        morph::HexGrid hg (d, 3.0f, 0.0f);
+        hg.setEllipticalBoundary (1.2f, 0.9f);
+        std::vector<morph::BezCoord<float>> bpoints = hg.ellipseCompute (1.2f, 0.9f);
+        morph::HexGrid hg2;
+        hg2.init (d, 3.0f, 0.0f, bpoints);
+
+        for (morph::vec<int, 3> rgb : { morph::vec<int, 3>{ 0, 0, 0 }, morph::vec<int, 3>{ 2, 1, 0 },
+                                        morph::vec<int, 3>{ -5, 3, 0 }, morph::vec<int, 3>{ 4, -7, 2 } }) {
+            auto h = hg.findHexAt (rgb);
+            auto h2 = hg2.findHexAt (rgb);
+            bool found = h != hg.hexen.end();
+            bool found2 = h2 != hg2.hexen.end();
+            if (found != found2 || (found && (h->ri != h2->ri || h->gi != h2->gi))) {
+                std::cout << "findHexAt " << rgb << " differs\n";
+                rtn = -1;
+            }
+        }
+
+        auto region_of = [](morph::HexGrid& g) {
+            std::vector<morph::BezCoord<float>> rpoints;
+            for (float a = 0.0f; a < morph::mathconst<float>::two_pi; a += 0.05f) {
+                rpoints.push_back (morph::BezCoord<float>(morph::vec<float, 2>{ 0.3f + 0.2f * std::cos (a), -0.2f + 0.2f * std::sin (a) }));
+            }
+            morph::vec<float, 2> rc;
+            std::set<std::array<int, 2>> rset;
+            for (auto hi : g.getRegion (rpoints, rc, false)) { rset.insert ({ hi->ri, hi->gi }); }
+            return rset;
+        };
+        std::set<std::array<int, 2>> r1 = region_of (hg);
+        std::set<std::array<int, 2>> r2 = region_of (hg2);
+        if (r1.empty() || r1 != r2) {
+            std::cout << "getRegion differs: " << r1.size() << " vs " << r2.size() << " hexes\n";
+            rtn = -1;
+        }
+    }
+
+    // A boundary from an SVG file
+    try {
+        morph::ReadCurves r("../../tests/trial.svg");
+        constexpr float d = 0.005f;
+        sc::time_point t0 = sc::now();
+        morph::HexGrid hg (d, 3.0f, 0.0f);
+        hg.setBoundary (r.getCorticalPath());
+        sc::time_point t1 = sc::now();
+        morph::HexGrid hg2 (d, 3.0f, 0.0f, r.getCorticalPath());
+        sc::time_point t2 = sc::now();
+
+        std::cout << "trial.svg, " << hg.num() << " hexes:\n"
+                  << "  HexGrid + setBoundary:           " << ms (t0, t1) << " ms\n"
+                  << "  HexGrid constructed on boundary: " << ms (t1, t2) << " ms\n";
+        rtn += compare (hg, hg2, "trial.svg");
+        if (hg.originalBoundaryCentroid != hg2.originalBoundaryCentroid) {
+            std::cout << "Boundary centroids differ\n";
+            rtn = -1;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Exception: " << e.what() << std::endl;
+        rtn = -1;
+    }
+
+    // A boundary of four points far apart. Both routes must run the same contiguity check, so
+    // they must both throw, or both accept it and find the same boundary hexes.
+    {
+        auto corners = []() {
+            std::vector<morph::BezCoord<float>> c;
+            for (morph::vec<float, 2> p : { morph::vec<float, 2>{ -0.5f, -0.5f }, morph::vec<float, 2>{ 0.5f, -0.5f },
+                                            morph::vec<float, 2>{ 0.5f, 0.5f }, morph::vec<float, 2>{ -0.5f, 0.5f } }) {
+                c.push_back (morph::BezCoord<float>(p));
+            }
+            return c;
+        };
+        int threw = 0;
+        std::size_t nb = 0, nb2 = 0;
+        try {
+            morph::HexGrid hg (0.01f, 3.0f, 0.0f);
+            std::vector<morph::BezCoord<float>> c = corners();
+            hg.setBoundary (c);
+            nb = hg.getBoundary().size();
+        } catch (const std::runtime_error&) { ++threw; }
+        try {
+            morph::HexGrid hg2;
+            std::vector<morph::BezCoord<float>> c = corners();
+            hg2.init (0.01f, 3.0f, 0.0f, c);
+            nb2 = hg2.getBoundary().size();
+        } catch (const std::runtime_error&) { ++threw; }
+        if (threw == 1 || nb != nb2) {
+            std::cout << "Sparse boundary: setBoundary and init disagree\n";
+            rtn = -1;
+        }
+    }
+
+    // A long, thin strip on a large grid. Its boundary has several hundred thousand hexes, far
+    // more than a recursive boundary walk could follow without overflowing the stack.
+    {
+        constexpr float d = 0.002f;
+        constexpr float len = 200.0f;
+        constexpr float wid = 0.006f;
+        std::vector<morph::BezCoord<float>> bpoints;
+        const unsigned int nl = static_cast<unsigned int>(len / (d / 2.0f));
+        const unsigned int nw = static_cast<unsigned int>(wid / (d / 2.0f));
+        for (unsigned int i = 0; i < nl; ++i) { bpoints.push_back (morph::BezCoord<float>(morph::vec<float, 2>{ i * len / nl, 0.0f })); }
+        for (unsigned int i = 0; i < nw; ++i) { bpoints.push_back (morph::BezCoord<float>(morph::vec<float, 2>{ len, i * wid / nw })); }
+        for (unsigned int i = 0; i < nl; ++i) { bpoints.push_back (morph::BezCoord<float>(morph::vec<float, 2>{ len - i * len / nl, wid })); }
+        for (unsigned int i = 0; i < nw; ++i) { bpoints.push_back (morph::BezCoord<float>(morph::vec<float, 2>{ 0.0f, wid - i * wid / nw })); }
+        try {
+            sc::time_point t0 = sc::now();
+            morph::HexGrid hg;
+            hg.init (d, 2.0f * len + 1.0f, 0.0f, bpoints);
+            sc::time_point t1 = sc::now();
+            std::size_t nflagged = 0;
+            for (const morph::Hex& h : hg.hexen) { if (h.testFlags (HEX_IS_BOUNDARY)) { ++nflagged; } }
+            std::cout << "Long strip, " << hg.num() << " hexes, " << hg.getBoundary().size()
+                      << " boundary hexes: " << ms (t0, t1) << " ms\n";
+            if (hg.getBoundary().size() < 200000 || hg.getBoundary().size() != nflagged) {
+                std::cout << "Long strip: walked " << hg.getBoundary().size() << " of " << nflagged << " boundary hexes\n";
+                rtn = -1;
+            }
+        } catch (const std::exception& e) {
+            std::cout << "Long strip: exception: " << e.what() << std::endl;
+            rtn = -1;
+        }
+    }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,75 @@
+/*
+ * Test that the windowed HexGrid::resampleImage gives the same result as a brute force
+ * resample that visits every image pixel for every hex.
+ */
+#include <morph/HexGrid.h>
+#include <morph/vec.h>
+#include <morph/vvec.h>
+#include <morph/Random.h>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+
+// The brute force resample (as HexGrid::resampleImage was originally written)
+morph::vvec<float> resample_brute (const morph::HexGrid& hg, const morph::vvec<float>& image_data,
+                                   const unsigned int image_pixelwidth, const morph::vec<float, 2>& image_scale,
+                                   const morph::vec<float, 2>& image_offset)
+{
+    unsigned int csz = image_data.size();
+    morph::vec<unsigned int, 2> image_pixelsz = {image_pixelwidth, csz / image_pixelwidth};
+    morph::vvec<float> expr_resampled(hg.num(), 0.0f);
+    morph::vec<float, 2> dist_per_pix = image_scale / (image_pixelsz[0] - 1u);
+    morph::vec<float, 2> input_centering_offset = dist_per_pix * image_pixelsz * 0.5f;
+    morph::vec<float, 2> params = 1.0f / (2.0f * dist_per_pix * dist_per_pix);
+    morph::vec<float, 2> threesig = 3.0f * dist_per_pix;
+    for (unsigned int xi = 0u; xi < hg.d_x.size(); ++xi) {
+        float expr = 0.0f;
+        for (unsigned int i = 0; i < csz; ++i) {
+            morph::vec<unsigned int, 2> idx = {(i % image_pixelsz[0]), (i / image_pixelsz[0])};
+            morph::vec<float, 2> posn = (dist_per_pix * idx) - input_centering_offset + image_offset;
+            float _d_x = hg.d_x[xi] - posn[0];
+            float _d_y = hg.d_y[xi] - posn[1];
+            if (_d_x < threesig[0] && _d_y < threesig[1]) {
+                expr += std::exp ( - ( (params[0] * _d_x * _d_x) + (params[1] * _d_y * _d_y) ) ) * image_data[i];
+            }
+        }
+        expr_resampled[xi] = expr;
+    }
+    expr_resampled /= expr_resampled.max();
+    return expr_resampled;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    constexpr unsigned int im_w = 128;
+    constexpr unsigned int im_h = 96;
+    morph::vvec<float> image_data (im_w * im_h, 0.0f);
+    morph::RandUniform<float> rng (0.0f, 1.0f, 2424u);
+    for (auto& px : image_data) { px = rng.get(); }
+
+    morph::HexGrid hg(0.01f, 3.0f, 0.0f);
+    hg.setEllipticalBoundary (0.5f, 0.35f);
+
+    morph::vec<float, 2> image_scale = { 1.2f, 1.2f };
+    morph::vec<float, 2> image_offset = { 0.05f, -0.02f };
+
+    using sc = std::chrono::steady_clock;
+    sc::time_point t0 = sc::now();
+    morph::vvec<float> fast = hg.resampleImage (image_data, im_w, image_scale, image_offset);
+    sc::time_point t1 = sc::now();
+    morph::vvec<float> brute = resample_brute (hg, image_data, im_w, image_scale, image_offset);
+    sc::time_point t2 = sc::now();
+
+    std::cout << "HexGrid::resampleImage (" << hg.num() << " hexes): "
+              << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count()
+              << " us; brute force: " << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << " us\n";
+
+    float maxdiff = (fast - brute).abs().max();
+    std::cout << "Max difference: " << maxdiff << std::endl;
+    if (fast.size() != brute.size() || maxdiff > 1e-5f) { rtn = -1; }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,89 @@
+/*
+ * Test that HexGridVisual calls an overridden setColour() for scalar data, and that the batch
+ * colour path (batchcolours = true) gives the same colours as the per-hex path. Returns 77 (skip)
+ * if no EGL context can be created.
+ */
+#include <morph/VisualHeadless.h>
+#include <morph/HexGrid.h>
+#include <morph/HexGridVisual.h>
+#include <iostream>
+#include <array>
+#include <vector>
+#include <memory>
+
+constexpr int glver = morph::gl::version_4_1;
+
+// A HexGridVisual that gives every hex the same colour and exposes its vertex colours
+struct FixedColourHexGridVisual : public morph::HexGridVisual<float, glver>
+{
+    FixedColourHexGridVisual (const morph::HexGrid* _hg, const morph::vec<float> _offset)
+        : morph::HexGridVisual<float, glver> (_hg, _offset) {}
+
+    const std::vector<float>& colours() const { return this->vertexColors; }
+
+protected:
+    std::array<float, 3> setColour (unsigned int) override { return { 0.25f, 0.5f, 0.75f }; }
+};
+
+// A HexGridVisual that exposes its vertex colours
+struct OpenHexGridVisual : public morph::HexGridVisual<float, glver>
+{
+    OpenHexGridVisual (const morph::HexGrid* _hg, const morph::vec<float> _offset)
+        : morph::HexGridVisual<float, glver> (_hg, _offset) {}
+
+    const std::vector<float>& colours() const { return this->vertexColors; }
+};
+
+int main()
+{
+    int rtn = 0;
+
+    std::unique_ptr<morph::VisualHeadless<glver>> vp;
+    try {
+        vp = std::make_unique<morph::VisualHeadless<glver>> (100, 100, "setColour");
+    } catch (const std::exception& e) {
+        std::cout << "No headless OpenGL context (" << e.what() << "); skipping\n";
+        return 77;
+    }
+
+    morph::HexGrid hg (0.02f, 1.0f, 0.0f);
+    hg.setCircularBoundary (0.2f);
+    std::vector<float> data (hg.num(), 0.0f);
+    for (unsigned int i = 0; i < hg.num(); ++i) { data[i] = static_cast<float>(i) / hg.num(); }
+
+    // The overriding subclass must get its own colour for every hex
+    auto fv = std::make_unique<FixedColourHexGridVisual> (&hg, morph::vec<float>{ 0.0f, 0.0f, 0.0f });
+    vp->bindmodel (fv);
+    fv->hexVisMode = morph::HexVisMode::Triangles;
+    fv->setScalarData (&data);
+    fv->finalize();
+    const std::vector<float>& c = fv->colours();
+    if (c.empty()) { std::cerr << "No vertex colours\n"; rtn -= 1; }
+    for (std::size_t i = 0; i + 2 < c.size(); i += 3) {
+        if (c[i] != 0.25f || c[i + 1] != 0.5f || c[i + 2] != 0.75f) {
+            std::cerr << "Overridden setColour was not used (vertex " << i / 3 << ")\n";
+            rtn -= 1;
+            break;
+        }
+    }
+
+    // With the base class setColour, the batch path must give the same colours as the per-hex path
+    auto v_perhex = std::make_unique<OpenHexGridVisual> (&hg, morph::vec<float>{ 0.0f, 0.0f, 0.0f });
+    auto v_batch = std::make_unique<OpenHexGridVisual> (&hg, morph::vec<float>{ 0.0f, 0.0f, 0.0f });
+    vp->bindmodel (v_perhex);
+    vp->bindmodel (v_batch);
+    v_batch->batchcolours = true;
+    for (auto* v : { v_perhex.get(), v_batch.get() }) {
+        v->hexVisMode = morph::HexVisMode::Triangles;
+        v->cm.setType (morph::ColourMapType::Plasma);
+        v->setScalarData (&data);
+        v->finalize();
+    }
+    if (v_perhex->colours() != v_batch->colours()) {
+        std::cerr << "Batch colours differ from per-hex colours\n";
+        rtn -= 1;
+    }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
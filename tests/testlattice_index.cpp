@@ -0,0 +1,121 @@
+/*
+ * Test (and benchmark) morph::lattice_index against the linear scans of
+ * HexGrid::findHexNearest and a linear scan of a CartGrid.
+ */
+#include <morph/HexGrid.h>
+#include <morph/CartGrid.h>
+#include <morph/lattice_index.h>
+#include <morph/Random.h>
+#include <morph/vec.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+using sc = std::chrono::steady_clock;
+
+// The linear scan nearest element search (as in CartGrid::findRectNearest)
+unsigned int linear_scan (const morph::CartGrid& cg, const morph::vec<float, 2>& pos)
+{
+    unsigned int nearest = 0;
+    float dist = std::numeric_limits<float>::max();
+    for (unsigned int k = 0; k < cg.d_x.size(); ++k) {
+        float dl = morph::vec<float, 2>{ pos[0] - cg.d_x[k], pos[1] - cg.d_y[k] }.length();
+        if (dl < dist) {
+            dist = dl;
+            nearest = k;
+        }
+    }
+    return nearest;
+}
+
+// Compare within_radius against a brute force search
+template <typename G>
+int test_within_radius (const G& grid, const morph::lattice_index& li, const morph::vec<float, 2>& pos, const float r)
+{
+    std::vector<unsigned int> wr = li.within_radius (pos, r);
+    std::vector<unsigned int> brute;
+    for (unsigned int k = 0; k < grid.d_x.size(); ++k) {
+        float dx = grid.d_x[k] - pos[0];
+        float dy = grid.d_y[k] - pos[1];
+        if (dx * dx + dy * dy <= r * r) { brute.push_back (k); }
+    }
+    std::sort (wr.begin(), wr.end());
+    if (wr != brute) {
+        std::cout << "within_radius mismatch at " << pos << ": " << wr.size() << " vs " << brute.size() << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    // Random query positions, some of which lie outside the grids' boundaries
+    constexpr unsigned int nq = 5000;
+    morph::RandUniform<float> rng (-0.55f, 0.55f, 321u);
+    std::vector<morph::vec<float, 2>> queries (nq);
+    for (auto& q : queries) { q = { rng.get(), rng.get() }; }
+
+    // HexGrid
+    morph::HexGrid hg(0.01f, 3.0f, 0.0f);
+    hg.setEllipticalBoundary (0.5f, 0.35f);
+
+    sc::time_point t0 = sc::now();
+    morph::lattice_index hi = hg.spatial_index();
+    sc::time_point t1 = sc::now();
+    std::vector<unsigned int> fast = hi.nearest (std::span<const morph::vec<float, 2>>(queries));
+    sc::time_point t2 = sc::now();
+    std::vector<unsigned int> slow (nq);
+    for (unsigned int k = 0; k < nq; ++k) { slow[k] = hg.findHexNearest (queries[k])->vi; }
+    sc::time_point t3 = sc::now();
+
+    std::cout << "HexGrid of " << hg.num() << " hexes; " << nq << " queries\n"
+              << "  build index:        " << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() << " us\n"
+              << "  lattice_index:      " << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << " us\n"
+              << "  findHexNearest:     " << std::chrono::duration_cast<std::chrono::microseconds>(t3 - t2).count() << " us\n";
+
+    for (unsigned int k = 0; k < nq; ++k) {
+        if (fast[k] != slow[k] || hi.nearest (queries[k]) != fast[k]) {
+            std::cout << "HexGrid nearest mismatch for " << queries[k] << ": " << fast[k] << " vs " << slow[k] << std::endl;
+            rtn = -1;
+            break;
+        }
+    }
+    rtn += test_within_radius (hg, hi, {0.1f, -0.05f}, 0.073f);
+    rtn += test_within_radius (hg, hi, {0.6f, 0.3f}, 0.2f);
+    // A position far from the grid
+    if (hi.nearest ({50.0f, 0.0f}) != hg.findHexNearest ({50.0f, 0.0f})->vi) { rtn = -1; }
+
+    // CartGrid
+    morph::CartGrid cg(0.01f, 0.02f, -0.5f, -0.5f, 0.5f, 0.5f);
+    cg.setBoundaryOnOuterEdge();
+
+    t0 = sc::now();
+    morph::lattice_index ci = cg.spatial_index();
+    t1 = sc::now();
+    fast = ci.nearest (std::span<const morph::vec<float, 2>>(queries));
+    t2 = sc::now();
+    for (unsigned int k = 0; k < nq; ++k) { slow[k] = linear_scan (cg, queries[k]); }
+    t3 = sc::now();
+
+    std::cout << "CartGrid of " << cg.num() << " elements; " << nq << " queries\n"
+              << "  build index:        " << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() << " us\n"
+              << "  lattice_index:      " << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << " us\n"
+              << "  linear scan:        " << std::chrono::duration_cast<std::chrono::microseconds>(t3 - t2).count() << " us\n";
+
+    for (unsigned int k = 0; k < nq; ++k) {
+        if (fast[k] != slow[k]) {
+            std::cout << "CartGrid nearest mismatch for " << queries[k] << ": " << fast[k] << " vs " << slow[k] << std::endl;
+            rtn = -1;
+            break;
+        }
+    }
+    rtn += test_within_radius (cg, ci, {0.0f, 0.0f}, 0.1f);
+    rtn += test_within_radius (cg, ci, {-0.55f, 0.2f}, 0.25f);
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
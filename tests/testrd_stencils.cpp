@@ -0,0 +1,174 @@
+/*
+ * Test that the branch-free stencils in RD_Base (compute_laplace, spacegrad2D and
+ * compute_divergence) give the same results as the neighbour-testing loops that they
+ * replaced, and report timings for each.
+ */
+#include <morph/RD_Base.h>
+#include <morph/Random.h>
+#include <iostream>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <cmath>
+
+using sc = std::chrono::steady_clock;
+
+// A minimal RD system so that the protected members of RD_Base are available.
+template <typename Flt>
+struct rd_stencil_test : public morph::RD_Base<Flt>
+{
+    void init() {}
+    void step() {}
+
+    // Change the hex spacing after allocate()
+    void rescale (Flt f)
+    {
+        this->set_d (this->d * f);
+        this->set_v (this->v * f);
+    }
+
+    // The Laplacian as it was computed before the padded neighbour table
+    void reference_laplace (const std::vector<Flt>& F, std::vector<Flt>& lapF)
+    {
+        Flt norm  = Flt{2} / (Flt{3.0} * this->d * this->d);
+        for (unsigned int hi=0; hi<this->nhex; ++hi) {
+            Flt thesum = Flt{-6} * F[hi];
+            thesum += HAS_NE(hi) ? F[NE(hi)] : F[hi];
+            thesum += HAS_NNE(hi) ? F[NNE(hi)] : F[hi];
+            thesum += HAS_NNW(hi) ? F[NNW(hi)] : F[hi];
+            thesum += HAS_NW(hi) ? F[NW(hi)] : F[hi];
+            thesum += HAS_NSW(hi) ? F[NSW(hi)] : F[hi];
+            thesum += HAS_NSE(hi) ? F[NSE(hi)] : F[hi];
+            lapF[hi] = norm * thesum;
+        }
+    }
+
+    // The gradient as it was computed before the precomputed gradient stencil
+    void reference_grad (const std::vector<Flt>& f, std::array<std::vector<Flt>, 2>& gradf)
+    {
+        for (unsigned int hi=0; hi<this->nhex; ++hi) {
+            if (HAS_NE(hi) && HAS_NW(hi)) {
+                gradf[0][hi] = (f[NE(hi)] - f[NW(hi)]) * this->oneover2d;
+            } else if (HAS_NE(hi)) {
+                gradf[0][hi] = (f[NE(hi)] - f[hi]) * this->oneoverd;
+            } else if (HAS_NW(hi)) {
+                gradf[0][hi] = (f[hi] - f[NW(hi)]) * this->oneoverd;
+            } else {
+                gradf[0][hi] = Flt{0};
+            }
+
+            if (HAS_NNW(hi) && HAS_NNE(hi) && HAS_NSW(hi) && HAS_NSE(hi)) {
+                gradf[1][hi] = ( (f[NNE(hi)] - f[NSE(hi)]) + (f[NNW(hi)] - f[NSW(hi)]) ) * this->oneover4v;
+            } else if (HAS_NNW(hi) && HAS_NNE(hi)) {
+                gradf[1][hi] = ( (f[NNE(hi)] + f[NNW(hi)]) * Flt{0.5} - f[hi]) * this->oneoverv;
+            } else if (HAS_NSW(hi) && HAS_NSE(hi)) {
+                gradf[1][hi] = (f[hi] - (f[NSE(hi)] + f[NSW(hi)]) * Flt{0.5}) * this->oneoverv;
+            } else if (HAS_NNW(hi) && HAS_NSW(hi)) {
+                gradf[1][hi] = (f[NNW(hi)] - f[NSW(hi)]) * this->oneover2v;
+            } else if (HAS_NNE(hi) && HAS_NSE(hi)) {
+                gradf[1][hi] = (f[NNE(hi)] - f[NSE(hi)]) * this->oneover2v;
+            } else {
+                gradf[1][hi] = Flt{0};
+            }
+        }
+    }
+};
+
+template <typename Flt>
+int compare (const std::vector<Flt>& a, const std::vector<Flt>& b, const Flt tol, const std::string& what)
+{
+    Flt maxabs = Flt{0};
+    for (auto _a : a) { maxabs = std::max (maxabs, std::abs (_a)); }
+    for (unsigned int i = 0; i < a.size(); ++i) {
+        if (std::abs (a[i] - b[i]) > tol * maxabs) {
+            std::cout << what << " mismatch at " << i << ": " << a[i] << " vs " << b[i] << std::endl;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    rd_stencil_test<float> rd;
+    rd.svgpath = "";
+    rd.ellipse_a = 0.8f;
+    rd.ellipse_b = 0.6f;
+    rd.hextohex_d = 0.005f;
+    rd.allocate();
+
+    std::vector<float> F (rd.nhex, 0.0f);
+    morph::RandUniform<float> rng (0.0f, 1.0f, 1234u);
+    for (float& f : F) { f = rng.get(); }
+    // Also a smooth field, for which the one sided differences matter
+    std::vector<float> G (rd.nhex, 0.0f);
+    for (unsigned int i = 0; i < rd.nhex; ++i) {
+        G[i] = std::sin (3.0f * rd.hg->d_x[i]) * std::cos (2.0f * rd.hg->d_y[i]);
+    }
+
+    // The padded neighbour table
+    if (rd.hg->d_nbr.size() != 6 * rd.nhex || rd.hg->d_size_nbr != rd.nhex) {
+        std::cout << "d_nbr has the wrong size\n";
+        rtn = -1;
+    }
+
+    std::vector<float> lap_ref (rd.nhex, 0.0f);
+    std::vector<float> lap (rd.nhex, 0.0f);
+    sc::time_point t0 = sc::now();
+    rd.reference_laplace (F, lap_ref);
+    sc::time_point t1 = sc::now();
+    rd.compute_laplace (F, lap);
+    sc::time_point t2 = sc::now();
+    // The Laplacian performs the same arithmetic, so should be exact
+    if (lap != lap_ref) {
+        std::cout << "Laplacian differs from reference\n";
+        rtn = -1;
+    }
+    std::cout << "Laplacian on " << rd.nhex << " hexes: reference "
+              << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() << " us; branch-free "
+              << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << " us\n";
+
+    std::array<std::vector<float>, 2> grad_ref;
+    std::array<std::vector<float>, 2> grad;
+    rd.resize_gradient_field (grad_ref);
+    rd.resize_gradient_field (grad);
+    for (const std::vector<float>* field : { &F, &G }) {
+        t0 = sc::now();
+        rd.reference_grad (*field, grad_ref);
+        t1 = sc::now();
+        rd.spacegrad2D (*field, grad);
+        t2 = sc::now();
+        // One sided y differences are computed as ((a - f) + (b - f)) rather than ((a + b)/2 - f)
+        // so may differ in rounding
+        rtn += compare (grad_ref[0], grad[0], 1e-6f, "grad x");
+        rtn += compare (grad_ref[1], grad[1], 1e-4f, "grad y");
+        std::cout << "Gradient: reference "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() << " us; branch-free "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << " us\n";
+    }
+
+    // The divergence is the x derivative of V[0] plus the y derivative of V[1]
+    std::array<std::vector<float>, 2> V = { G, F };
+    std::vector<float> div (rd.nhex, 0.0f);
+    rd.compute_divergence (V, div);
+    std::array<std::vector<float>, 2> gG, gF;
+    rd.resize_gradient_field (gG);
+    rd.resize_gradient_field (gF);
+    rd.reference_grad (G, gG);
+    rd.reference_grad (F, gF);
+    std::vector<float> div_ref (rd.nhex, 0.0f);
+    for (unsigned int i = 0; i < rd.nhex; ++i) { div_ref[i] = gG[0][i] + gF[1][i]; }
+    rtn += compare (div_ref, div, 1e-4f, "divergence");
+
+    // The stencil weights depend on d and v, so must follow a change in the hex spacing
+    rd.rescale (2.0f);
+    rd.reference_grad (G, grad_ref);
+    rd.spacegrad2D (G, grad);
+    rtn += compare (grad_ref[0], grad[0], 1e-6f, "grad x after set_d");
+    rtn += compare (grad_ref[1], grad[1], 1e-4f, "grad y after set_v");
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
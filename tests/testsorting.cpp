@@ -0,0 +1,126 @@
+/*
+ * Test morph::sorting: radix sort, sort, argsort, top_k, median and quantiles, on small arrays
+ * (which use std::stable_sort) and large ones (which use the radix sort).
+ */
+
+#include <morph/sorting.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <cmath>
+
+// Random values of type T with plenty of repeats
+template <typename T>
+std::vector<T> random_values (std::size_t n, std::mt19937& gen)
+{
+    std::vector<T> v (n);
+    if constexpr (std::is_floating_point_v<T>) {
+        std::uniform_int_distribution<int> d (-500, 500);
+        for (auto& x : v) { x = static_cast<T>(d (gen)) / T{8}; }
+        if (n > 3) { v[1] = T{-0.0}; v[2] = T{0.0}; v[3] = -std::numeric_limits<T>::max(); }
+    } else {
+        std::uniform_int_distribution<long long> d (std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
+        for (auto& x : v) { x = static_cast<T>(d (gen) / (n > 1000 ? 1 : 1000)); }
+    }
+    return v;
+}
+
+template <typename T>
+int test_type (const char* name, std::mt19937& gen)
+{
+    int rtn = 0;
+    for (std::size_t n : { std::size_t{0}, std::size_t{1}, std::size_t{37}, std::size_t{5000}, std::size_t{300000} }) {
+        const std::vector<T> v = random_values<T> (n, gen);
+
+        // radix_sort against std::sort
+        std::vector<T> r = v;
+        morph::sorting::radix_sort (r);
+        std::vector<T> s = v;
+        std::sort (s.begin(), s.end());
+        if (!std::equal (r.begin(), r.end(), s.begin(), [](T a, T b) { return a == b; })) {
+            std::cout << name << " n=" << n << ": radix_sort differs from std::sort\n";
+            --rtn;
+        }
+        std::vector<T> sd = v;
+        morph::sorting::sort (sd, morph::sorting::order::descending);
+        if (!std::is_sorted (sd.begin(), sd.end(), [](T a, T b) { return b < a; })) {
+            std::cout << name << " n=" << n << ": sort(descending) is not in order\n";
+            --rtn;
+        }
+
+        // argsort against std::stable_sort of indices, in both orders
+        for (auto o : { morph::sorting::order::ascending, morph::sorting::order::descending }) {
+            const bool asc = o == morph::sorting::order::ascending;
+            morph::vvec<std::size_t> idx = morph::sorting::argsort (v, o);
+            std::vector<std::size_t> ref (n);
+            std::iota (ref.begin(), ref.end(), std::size_t{0});
+            std::stable_sort (ref.begin(), ref.end(), [&v, asc](std::size_t a, std::size_t b) { return asc ? v[a] < v[b] : v[b] < v[a]; });
+            if (!std::equal (idx.begin(), idx.end(), ref.begin(), ref.end())) {
+                std::cout << name << " n=" << n << ": argsort(" << (asc ? "ascending" : "descending") << ") is wrong\n";
+                --rtn;
+            }
+            // top_k is the start of the stable argsort
+            const std::size_t k = std::min (n, std::size_t{25});
+            morph::vvec<std::size_t> top = morph::sorting::top_k (v, k, o);
+            if (top.size() != k || !std::equal (top.begin(), top.end(), ref.begin())) {
+                std::cout << name << " n=" << n << ": top_k is wrong\n";
+                --rtn;
+            }
+        }
+
+        // Quantiles against interpolation into the sorted values
+        if (n > 0) {
+            const std::vector<double> qs = { 0.9, 0.0, 0.25, 0.5, 0.5, 0.999, 1.0 };
+            morph::vvec<double> q = morph::sorting::quantiles (v, qs);
+            for (std::size_t i = 0; i < qs.size(); ++i) {
+                const double h = qs[i] * (n - 1);
+                const std::size_t lo = static_cast<std::size_t>(std::floor (h));
+                const std::size_t hi = std::min (lo + 1, n - 1);
+                const double expected = static_cast<double>(s[lo]) + (static_cast<double>(s[hi]) - static_cast<double>(s[lo])) * (h - lo);
+                if (std::abs (q[i] - expected) > 1e-9 * std::max (1.0, std::abs (expected))) {
+                    std::cout << name << " n=" << n << ": quantile " << qs[i] << " is " << q[i] << ", not " << expected << "\n";
+                    --rtn;
+                }
+            }
+        }
+    }
+    return rtn;
+}
+
+int main()
+{
+    int rtn = 0;
+    std::mt19937 gen (12345);
+
+    rtn += test_type<float> ("float", gen);
+    rtn += test_type<double> ("double", gen);
+    rtn += test_type<int> ("int", gen);
+    rtn += test_type<std::int8_t> ("int8", gen);
+    rtn += test_type<std::uint16_t> ("uint16", gen);
+    rtn += test_type<std::int64_t> ("int64", gen);
+    rtn += test_type<unsigned int> ("unsigned int", gen);
+
+    // Median of odd and even counts, and of a vvec of ints
+    morph::vvec<float> odd = { 5, 1, 4, 2, 3 };
+    morph::vvec<float> even = { 4, 1, 3, 2 };
+    morph::vvec<int> ints = { 7, 1, 4, 2 };
+    if (morph::sorting::median (odd) != 3.0f || morph::sorting::median (even) != 2.5f || morph::sorting::median (ints) != 3.0) {
+        std::cout << "median is wrong\n";
+        --rtn;
+    }
+
+    // Non-arithmetic elements use std::stable_sort
+    std::vector<std::string> words = { "pear", "apple", "fig", "apple", "date" };
+    morph::vvec<std::size_t> widx = morph::sorting::argsort (words);
+    if (widx != morph::vvec<std::size_t>{ 1, 3, 4, 2, 0 }) { std::cout << "argsort of strings is wrong: " << widx << "\n"; --rtn; }
+    widx = morph::sorting::top_k (words, 2);
+    if (widx != morph::vvec<std::size_t>{ 0, 2 }) { std::cout << "top_k of strings is wrong: " << widx << "\n"; --rtn; }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,135 @@
+/*
+ * Test morph::streamseries, the decimating ring buffer behind GraphVisual's streaming datasets.
+ * The stored points must be the latest ones, and the decimated points must be stored points that
+ * include the extremes, with no more than four per column.
+ */
+#include <morph/streamseries.h>
+#include <morph/range.h>
+#include <morph/vec.h>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <random>
+#include <cmath>
+
+// Check s against the points that were pushed (the latest of which are in ref)
+int check (morph::streamseries<double>& s, const std::deque<morph::vec<double, 2>>& ref, const unsigned int columns)
+{
+    int rtn = 0;
+    if (s.size() != ref.size()) {
+        std::cout << "size " << s.size() << " != " << ref.size() << std::endl;
+        return -1;
+    }
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+        if (s[i] != ref[i]) { std::cout << "point " << i << " is wrong\n"; return -1; }
+    }
+    if (s.num_columns() > 2u * columns + 1u) {
+        std::cout << "too many columns: " << s.num_columns() << std::endl;
+        rtn = -1;
+    }
+
+    std::vector<morph::vec<double, 2>> d;
+    s.decimate (d);
+    if (d.size() > 4u * s.num_columns()) {
+        std::cout << d.size() << " decimated points for " << s.num_columns() << " columns\n";
+        rtn = -1;
+    }
+    // Decimated points are stored points, in order
+    std::size_t j = 0;
+    for (const auto& p : d) {
+        while (j < ref.size() && ref[j] != p) { ++j; }
+        if (j == ref.size()) { std::cout << "decimated point " << p << " is not stored (or out of order)\n"; return -1; }
+    }
+
+    // The extremes of the points in the window are shown
+    const morph::range<double> xr = s.xrange();
+    morph::range<double> yr_win (morph::range_init::for_search);
+    morph::range<double> yr_all (morph::range_init::for_search);
+    for (const auto& p : ref) {
+        yr_all.update (p[1]);
+        if (p[0] >= xr.min) { yr_win.update (p[1]); }
+    }
+    morph::range<double> yr_dec (morph::range_init::for_search);
+    for (const auto& p : d) { yr_dec.update (p[1]); }
+    const morph::range<double> yr = s.yrange();
+    if (!yr.contains (yr_win) || !yr_all.contains (yr) || yr_dec != yr) {
+        std::cout << "y range " << yr << " (decimated " << yr_dec << ") should lie between " << yr_win << " and " << yr_all << std::endl;
+        rtn = -1;
+    }
+    if (s.xwindow() == 0.0 && yr != yr_all) {
+        std::cout << "Without a window, the y range " << yr << " should be " << yr_all << std::endl;
+        rtn = -1;
+    }
+    if (xr.max != ref.back()[0]) { rtn = -1; }
+    return rtn;
+}
+
+// Push npts points into a streamseries and check it as it fills
+int run (const std::size_t capacity, const double xwindow, const unsigned int columns, const std::size_t npts, const double dx_repeat)
+{
+    int rtn = 0;
+    morph::streamseries<double> s (capacity, xwindow, columns);
+    std::deque<morph::vec<double, 2>> ref;
+    std::mt19937 rng (42);
+    std::normal_distribution<double> noise (0.0, 1.0);
+    std::bernoulli_distribution repeat (dx_repeat);
+    double x = -3.0;
+    double y = 0.0;
+    for (std::size_t i = 0; i < npts && rtn == 0; ++i) {
+        // Occasionally repeat x and add spikes
+        if (!repeat (rng)) { x += 0.01; }
+        y += noise (rng);
+        const double yy = (i % 997 == 0) ? y + 100.0 : y;
+        s.push (x, yy);
+        ref.push_back ({ x, yy });
+        if (ref.size() > capacity) { ref.pop_front(); }
+        if (i % 131 == 0 || i == npts - 1) { rtn = check (s, ref, columns); }
+    }
+    std::cout << "capacity " << capacity << ", window " << xwindow << ", " << columns << " columns: "
+              << s.size() << " points in " << s.num_columns() << " columns " << (rtn == 0 ? "OK" : "FAILED") << std::endl;
+    return rtn;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    // Everything fits in the ring buffer
+    rtn += run (100000, 0.0, 64, 20000, 0.0);
+    // Ring buffer wraps, without and with a sliding window
+    rtn += run (5000, 0.0, 64, 30000, 0.2);
+    rtn += run (5000, 10.0, 64, 30000, 0.2);
+    // Window wider than the buffer holds
+    rtn += run (500, 1000.0, 32, 10000, 0.0);
+    // Tiny buffer
+    rtn += run (1, 0.0, 4, 100, 0.0);
+    rtn += run (3, 0.5, 4, 100, 0.5);
+
+    // All points at one x
+    morph::streamseries<float> same (1000, 0.0f, 16);
+    for (int i = 0; i < 500; ++i) { same.push (1.0f, static_cast<float>(i % 7)); }
+    std::vector<morph::vec<float, 2>> d;
+    same.decimate (d);
+    if (d.size() > 4u || same.yrange() != morph::range<float>{ 0.0f, 6.0f }) {
+        std::cout << "Points at one x decimated to " << d.size() << " points, y range " << same.yrange() << std::endl;
+        --rtn;
+    }
+
+    // x must not decrease
+    bool threw = false;
+    try {
+        same.push (0.5f, 0.0f);
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    if (!threw) { std::cout << "A decreasing x was accepted\n"; --rtn; }
+
+    same.clear();
+    same.decimate (d);
+    if (same.size() != 0u || !d.empty()) { --rtn; }
+    same.push (-2.0f, 1.0f);
+    if (same.size() != 1u || same.xrange() != morph::range<float>{ -2.0f, -2.0f }) { --rtn; }
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
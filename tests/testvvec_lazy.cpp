@@ -0,0 +1,86 @@
+/*
+ * Test the lazy expression layer for vvec against the eager vvec operators
+ */
+
+#include <morph/vvec.h>
+#include <morph/vvec_lazy.h>
+#include <morph/vec.h>
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+
+int main()
+{
+    int rtn = 0;
+
+    morph::vvec<float> a = { 1, 2, 3, 4, 5 };
+    morph::vvec<float> b = { 2, 3, 4, 5, 6 };
+    morph::vvec<float> c = { -1, 0, 1, 2, 3 };
+
+    // Chains of operators with vvecs and scalars, on the left and the right
+    morph::vvec<float> r;
+    r = morph::lazy(a) * b + c;
+    if (r != a * b + c) { std::cout << "a * b + c failed: " << r << std::endl; --rtn; }
+
+    r = 2.0f * morph::lazy(a) - b / 4.0f;
+    if (r != 2.0f * a - b / 4.0f) { std::cout << "2a - b/4 failed: " << r << std::endl; --rtn; }
+
+    r = -(morph::lazy(a) + 1.0f) / c + 3.0f;
+    morph::vvec<float> expected = -(a + 1.0f) / c + 3.0f;
+    for (std::size_t i = 0; i < r.size(); ++i) {
+        if (r[i] != expected[i] && !(std::isinf (r[i]) && r[i] == expected[i])) {
+            std::cout << "-(a+1)/c + 3 failed: " << r << " not " << expected << std::endl;
+            --rtn;
+            break;
+        }
+    }
+
+    r = 1.0f - morph::lazy(a) * morph::lazy(a);
+    if (r != 1.0f - a * a) { std::cout << "1 - a*a failed: " << r << std::endl; --rtn; }
+
+    // Compound assignment and aliasing of the output with an operand
+    morph::vvec<float> s = c;
+    s += morph::lazy(a) * 2.0f;
+    if (s != c + a * 2.0f) { std::cout << "+= failed: " << s << std::endl; --rtn; }
+    s -= morph::lazy(b) - a;
+    if (s != c + a * 2.0f - (b - a)) { std::cout << "-= failed: " << s << std::endl; --rtn; }
+    s = morph::lazy(s) * s;
+    if (s != (c + a * 2.0f - (b - a)) * (c + a * 2.0f - (b - a))) { std::cout << "s = s*s failed: " << s << std::endl; --rtn; }
+
+    // lazy_map, lazy_sum and lazy_eval
+    r = morph::lazy_map (morph::lazy(a) - 3.0f, [](float x) { return std::abs (x); });
+    if (r != morph::vvec<float>{ 2, 1, 0, 1, 2 }) { std::cout << "lazy_map failed: " << r << std::endl; --rtn; }
+    if (morph::lazy_sum (morph::lazy(a) * b) != a.dot (b)) { std::cout << "lazy_sum failed\n"; --rtn; }
+    morph::vvec<float> e = morph::lazy_eval (morph::lazy(a) + b);
+    if (e != a + b) { std::cout << "lazy_eval failed: " << e << std::endl; --rtn; }
+
+    // Assignment resizes the output
+    morph::vvec<float> empty;
+    empty = morph::lazy(a) * 1.0f;
+    if (empty != a) { std::cout << "assignment did not resize: " << empty << std::endl; --rtn; }
+
+    // vvecs of vecs work as well as vvecs of scalars
+    morph::vvec<morph::vec<float, 2>> va = { { 1, 2 }, { 3, 4 } };
+    morph::vvec<morph::vec<float, 2>> vb = { { 10, 20 }, { 30, 40 } };
+    morph::vvec<morph::vec<float, 2>> vr;
+    vr = morph::lazy(va) + vb * 2.0f;
+    if (vr != va + vb * 2.0f) { std::cout << "vvec of vecs failed: " << vr << std::endl; --rtn; }
+    vr = morph::lazy(va) + morph::vec<float, 2>{ 1, -1 };
+    if (vr != va + morph::vec<float, 2>{ 1, -1 }) { std::cout << "vvec of vecs + vec failed: " << vr << std::endl; --rtn; }
+
+    // Operands of different sizes are rejected, as they are by the eager operators
+    morph::vvec<float> d = { 1, 2, 3 };
+    try {
+        r = morph::lazy(a) + d;
+        std::cout << "Expected an exception for different sizes\n";
+        --rtn;
+    } catch (const std::runtime_error&) {}
+    try {
+        d += morph::lazy(a) * 2.0f;
+        std::cout << "Expected an exception for += with different sizes\n";
+        --rtn;
+    } catch (const std::runtime_error&) {}
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}
@@ -0,0 +1,167 @@
+/*
+ * Test (and time) the blocked, multithreaded reductions that vvec uses for sum, mean,
+ * variance, dot, length and the extrema. Results are checked against double precision
+ * references and must be identical for any number of threads.
+ */
+
+#include <morph/vvec.h>
+#include <iostream>
+#include <limits>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+using sc = std::chrono::steady_clock;
+
+struct results
+{
+    float sum = 0.0f;
+    float mean = 0.0f;
+    float variance = 0.0f;
+    float dot = 0.0f;
+    float sum_nan = 0.0f;
+    float variance_nan = 0.0f;
+    morph::range<float> r;
+    std::size_t argmax = 0;
+    std::size_t argmin = 0;
+    bool operator== (const results&) const = default;
+};
+
+results compute (const morph::vvec<float>& v, const morph::vvec<float>& w, const morph::vvec<float>& vn)
+{
+    results res;
+    res.sum = v.sum();
+    res.mean = v.mean();
+    res.variance = v.variance();
+    res.dot = v.dot (w);
+    res.sum_nan = vn.sum<true>();
+    res.variance_nan = vn.variance<true>();
+    res.r = v.range();
+    res.argmax = v.argmax();
+    res.argmin = v.argmin();
+    return res;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    // Large enough to be shared between threads. An offset makes the variance hard to compute
+    // accurately in single precision.
+    constexpr std::size_t n = 3000001;
+    morph::vvec<float> v (n);
+    morph::vvec<float> w (n);
+    morph::vvec<float> vn (n);
+    for (std::size_t i = 0; i < n; ++i) {
+        v[i] = 1000.0f + std::sin (0.001f * static_cast<float>(i));
+        w[i] = std::cos (0.003f * static_cast<float>(i));
+    }
+    // Repeated extrema: argmax and argmin must find the first
+    v[1234567] = 1002.0f;
+    v[2345678] = 1002.0f;
+    v[234567] = 998.0f;
+    v[2999999] = 998.0f;
+    for (std::size_t i = 0; i < n; ++i) { vn[i] = (i % 7 == 3) ? std::numeric_limits<float>::quiet_NaN() : v[i]; }
+
+    // Double precision references
+    double s = 0.0, sd = 0.0, sn = 0.0;
+    std::size_t nn = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        s += v[i];
+        sd += static_cast<double>(v[i]) * w[i];
+        if (!std::isnan (vn[i])) { sn += vn[i]; ++nn; }
+    }
+    const double mean = s / n;
+    const double mean_n = sn / nn;
+    double var = 0.0, var_n = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        var += (v[i] - mean) * (v[i] - mean);
+        if (!std::isnan (vn[i])) { var_n += (vn[i] - mean_n) * (vn[i] - mean_n); }
+    }
+    var /= (n - 1);
+    var_n /= (nn - 1);
+
+    sc::time_point t0 = sc::now();
+    results res = compute (v, w, vn);
+    sc::time_point t1 = sc::now();
+
+    auto close = [](double a, double ref, double rel) { return std::abs (a - ref) <= rel * std::abs (ref); };
+    if (!close (res.sum, s, 1e-6)) { std::cout << "sum " << res.sum << " != " << s << "\n"; --rtn; }
+    if (!close (res.mean, mean, 1e-6)) { std::cout << "mean " << res.mean << " != " << mean << "\n"; --rtn; }
+    if (!close (res.variance, var, 1e-4)) { std::cout << "variance " << res.variance << " != " << var << "\n"; --rtn; }
+    if (!close (res.dot, sd, 1e-4)) { std::cout << "dot " << res.dot << " != " << sd << "\n"; --rtn; }
+    if (!close (res.sum_nan, sn, 1e-6)) { std::cout << "sum<true> " << res.sum_nan << " != " << sn << "\n"; --rtn; }
+    if (!close (res.variance_nan, var_n, 1e-4)) { std::cout << "variance<true> " << res.variance_nan << " != " << var_n << "\n"; --rtn; }
+    if (res.r.min != 998.0f || res.r.max != 1002.0f) { std::cout << "range " << res.r << " is wrong\n"; --rtn; }
+    if (res.argmax != 1234567 || res.argmin != 234567) {
+        std::cout << "argmax " << res.argmax << " / argmin " << res.argmin << " are not the first extrema\n";
+        --rtn;
+    }
+    if (v.max() != 1002.0f || v.min() != 998.0f) { std::cout << "max/min are wrong\n"; --rtn; }
+    if (!close (vn.mean<true>(), mean_n, 1e-6)) { std::cout << "mean<true> " << vn.mean<true>() << " != " << mean_n << "\n"; --rtn; }
+    if (vn.range<true>() != res.r) { std::cout << "range<true> " << vn.range<true>() << " != " << res.r << "\n"; --rtn; }
+
+    // The result must not depend on the number of threads
+#ifdef _OPENMP
+    for (int nt : { 1, 2, 3, 8 }) {
+        omp_set_num_threads (nt);
+        if (!(compute (v, w, vn) == res)) { std::cout << "Results differ with " << nt << " threads\n"; --rtn; }
+    }
+#endif
+
+    // Without test_for_nans, the extrema of data with NaNs are those of the std algorithms (NaNs
+    // are not skipped), wherever the NaNs are
+    auto same = [](float a, float b) { return a == b || (std::isnan (a) && std::isnan (b)); };
+    morph::vvec<float> nanfirst = { std::numeric_limits<float>::quiet_NaN(), 2.0f, -1.0f, 5.0f };
+    for (const morph::vvec<float>* p : { &vn, &nanfirst }) {
+        const morph::vvec<float>& d = *p;
+        const auto mx = std::max_element (d.begin(), d.end());
+        const auto mn = std::min_element (d.begin(), d.end());
+        const auto mm = std::minmax_element (d.begin(), d.end());
+        if (!same (d.max(), *mx) || !same (d.min(), *mn)
+            || d.argmax() != static_cast<std::size_t>(mx - d.begin())
+            || d.argmin() != static_cast<std::size_t>(mn - d.begin())
+            || !same (d.range().min, *mm.first) || !same (d.range().max, *mm.second)) {
+            std::cout << "Extrema of data with NaNs differ from the std algorithms\n";
+            --rtn;
+        }
+    }
+    if (nanfirst.range<true>() != morph::range<float>{ -1.0f, 5.0f }) { std::cout << "range<true> did not skip the NaN\n"; --rtn; }
+
+    // Small and empty vvecs
+    morph::vvec<float> e;
+    if (e.sum() != 0.0f || e.max() != 0.0f || e.argmax() != 0u || e.range() != morph::range<float>{0.0f, 0.0f}) {
+        std::cout << "Empty vvec reductions are wrong\n";
+        --rtn;
+    }
+    morph::vvec<float> allnan (10, std::numeric_limits<float>::quiet_NaN());
+    if (allnan.range<true>() != morph::range<float>{0.0f, 0.0f}) { std::cout << "All-NaN range is wrong\n"; --rtn; }
+    morph::vvec<int> vi = { 3, -1, 4, 1, -5, 9, 2, 6 };
+    if (vi.sum() != 19 || vi.max() != 9 || vi.argmin() != 4u || vi.dot (vi) != 173) {
+        std::cout << "int vvec reductions are wrong\n";
+        --rtn;
+    }
+
+    // Time the reductions against the std::accumulate based versions
+    sc::time_point t2 = sc::now();
+    float acc_sum = std::accumulate (v.begin(), v.end(), 0.0f);
+    float acc_mean = acc_sum / n;
+    float acc_sos = 0.0f;
+    for (float x : v) { acc_sos += (x - acc_mean) * (x - acc_mean); }
+    sc::time_point t3 = sc::now();
+    float red_var = v.variance();
+    sc::time_point t4 = sc::now();
+    std::cout << "Sum, mean, variance, dot and extrema of " << n << " floats: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() << " us\n";
+    std::cout << "Two-pass serial variance " << acc_sos / (n - 1) << " in "
+              << std::chrono::duration_cast<std::chrono::microseconds>(t3 - t2).count() << " us; blocked variance "
+              << red_var << " in " << std::chrono::duration_cast<std::chrono::microseconds>(t4 - t3).count()
+              << " us (double precision: " << var << ")\n";
+
+    std::cout << (rtn == 0 ? "PASS\n" : "FAIL\n");
+    return rtn;
+}